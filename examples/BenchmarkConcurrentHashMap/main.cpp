@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <slib/core.h>
+
+using namespace slib;
+
+// Throughput of ConcurrentHashMap and CHashMap from 1 to 64 threads, on 64K keys (best of 3 runs)
+
+#define KEYS_COUNT 65536
+#define TOTAL_OPERATIONS 4000000
+
+static volatile sl_bool g_flagStart = sl_false;
+
+template <class MAP>
+static void RunWorker(MAP* map, sl_uint32 index, sl_uint32 nOperations, sl_uint32 writePercent)
+{
+	while (!g_flagStart) {
+		Thread::sleep(0);
+	}
+	sl_uint64 x = index * 7919 + 1;
+	sl_uint64 sum = 0;
+	for (sl_uint32 i = 0; i < nOperations; i++) {
+		x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+		sl_uint64 key = (x >> 33) % KEYS_COUNT;
+		if ((x >> 57) % 100 < writePercent) {
+			map->put(key, x);
+		} else {
+			sl_uint64 value;
+			if (map->get(key, &value)) {
+				sum += value;
+			}
+		}
+	}
+	static volatile sl_uint64 sink;
+	sink = sum;
+}
+
+// returns millions of operations per second
+template <class MAP>
+static double RunOnce(sl_uint32 nThreads, sl_uint32 writePercent)
+{
+	MAP map;
+	for (sl_uint64 i = 0; i < KEYS_COUNT; i++) {
+		map.put(i, i);
+	}
+	sl_uint32 nOperations = TOTAL_OPERATIONS / nThreads;
+	g_flagStart = sl_false;
+	List< Ref<Thread> > threads;
+	for (sl_uint32 i = 0; i < nThreads; i++) {
+		MAP* pMap = &map;
+		threads.add_NoLock(Thread::start([pMap, i, nOperations, writePercent]() {
+			RunWorker(pMap, i, nOperations, writePercent);
+		}));
+	}
+	Time t = Time::now();
+	g_flagStart = sl_true;
+	for (auto& thread : threads) {
+		thread->join();
+	}
+	double ms = (Time::now() - t).getMillisecondsCountf();
+	return (double)(nOperations * nThreads) / ms / 1000.0;
+}
+
+// best of 3 runs
+template <class MAP>
+static double Run(sl_uint32 nThreads, sl_uint32 writePercent)
+{
+	double best = 0;
+	for (int i = 0; i < 3; i++) {
+		double r = RunOnce<MAP>(nThreads, writePercent);
+		if (r > best) {
+			best = r;
+		}
+	}
+	return best;
+}
+
+int main(int argc, const char * argv[])
+{
+	sl_uint32 listWritePercent[] = {5, 50};
+	for (sl_uint32 writePercent : listWritePercent) {
+		Println("%d%% put / %d%% get, Mops/s", writePercent, 100 - writePercent);
+		for (sl_uint32 nThreads = 1; nThreads <= 64; nThreads *= 2) {
+			double a = Run< ConcurrentHashMap<sl_uint64, sl_uint64> >(nThreads, writePercent);
+			double b = Run< CHashMap<sl_uint64, sl_uint64> >(nThreads, writePercent);
+			Println("threads %2d: ConcurrentHashMap %6.2f  CHashMap %6.2f", nThreads, a, b);
+		}
+	}
+	return 0;
+}
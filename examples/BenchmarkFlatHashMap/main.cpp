@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <slib/core.h>
+
+using namespace slib;
+
+// Compares FlatHashMap with HashMap for insert, hit and miss lookups (best of 5 rounds)
+
+#define ROUNDS 5
+
+static double GetElapsedMilliseconds(const Time& start)
+{
+	return (Time::now() - start).getMillisecondsCountf();
+}
+
+// HashMap::put() takes the object lock, which FlatHashMap does not have
+template <class KT, class VT>
+static void PutItem(FlatHashMap<KT, VT>& map, const KT& key, const VT& value)
+{
+	map.put(key, value);
+}
+
+template <class KT, class VT>
+static void PutItem(HashMap<KT, VT>& map, const KT& key, const VT& value)
+{
+	map.put_NoLock(key, value);
+}
+
+template <class MAP, class KT>
+static void Run(const char* name, const KT* keys, const KT* missingKeys, sl_uint32 n)
+{
+	volatile sl_uint64 sink = 0;
+	double dInsert = 0, dHit = 0, dMiss = 0;
+	for (int round = 0; round < ROUNDS; round++) {
+		MAP map;
+		Time t = Time::now();
+		for (sl_uint32 i = 0; i < n; i++) {
+			PutItem(map, keys[i], (sl_uint64)i);
+		}
+		double d = GetElapsedMilliseconds(t);
+		if (!round || d < dInsert) {
+			dInsert = d;
+		}
+		t = Time::now();
+		for (sl_uint32 i = 0; i < n; i++) {
+			sink += *(map.getItemPointer(keys[(i * 7919) % n]));
+		}
+		d = GetElapsedMilliseconds(t);
+		if (!round || d < dHit) {
+			dHit = d;
+		}
+		t = Time::now();
+		for (sl_uint32 i = 0; i < n; i++) {
+			sink += map.getItemPointer(missingKeys[i]) != sl_null;
+		}
+		d = GetElapsedMilliseconds(t);
+		if (!round || d < dMiss) {
+			dMiss = d;
+		}
+	}
+	Println("%s: insert %.1f ms, hit %.1f ms, miss %.1f ms", name, dInsert, dHit, dMiss);
+}
+
+int main(int argc, const char * argv[])
+{
+	sl_uint32 n = 1000000;
+	if (argc > 1) {
+		n = String(argv[1]).parseUint32();
+	}
+	
+	{
+		Println("%d random 64-bit keys", n);
+		sl_uint64* keys = new sl_uint64[n];
+		sl_uint64* missingKeys = new sl_uint64[n];
+		for (sl_uint32 i = 0; i < n; i++) {
+			// odd keys are inserted, even keys are missing
+			keys[i] = (((sl_uint64)i * 0x9E3779B97F4A7C15ULL) >> 7) | 1;
+			missingKeys[i] = keys[i] + 1;
+		}
+		Run< FlatHashMap<sl_uint64, sl_uint64> >("FlatHashMap", keys, missingKeys, n);
+		Run< HashMap<sl_uint64, sl_uint64> >("HashMap    ", keys, missingKeys, n);
+		delete[] keys;
+		delete[] missingKeys;
+	}
+	
+	{
+		n /= 4;
+		Println("%d string keys", n);
+		String* keys = new String[n];
+		String* missingKeys = new String[n];
+		for (sl_uint32 i = 0; i < n; i++) {
+			keys[i] = String::format("key-%d-%x", i, i * 2654435761u);
+			missingKeys[i] = String::format("none-%d", i);
+		}
+		Run< FlatHashMap<String, sl_uint64> >("FlatHashMap", keys, missingKeys, n);
+		Run< HashMap<String, sl_uint64> >("HashMap    ", keys, missingKeys, n);
+		delete[] keys;
+		delete[] missingKeys;
+	}
+	return 0;
+}
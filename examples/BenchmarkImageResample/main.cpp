@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <slib/core.h>
+#include <slib/graphics.h>
+
+using namespace slib;
+
+/*
+	Throughput of Image::scale() over a fixed corpus of generated images, for the filters drawn
+	by Image::draw() (Linear, Box) and the separable filters (Bicubic, Mitchell, Lanczos3),
+	on the calling thread and split into row bands on a ThreadPool.
+*/
+
+struct ResampleCase
+{
+	const char* name;
+	sl_uint32 widthSource;
+	sl_uint32 heightSource;
+	sl_uint32 widthTarget;
+	sl_uint32 heightTarget;
+};
+
+static const ResampleCase g_cases[] = {
+	{"12MP photo -> thumbnail", 4000, 3000, 400, 300},
+	{"12MP photo -> 1280x960", 4000, 3000, 1280, 960},
+	{"4K -> 1080p", 3840, 2160, 1920, 1080},
+	{"1080p -> 320x180", 1920, 1080, 320, 180},
+	{"1080p -> 720p", 1920, 1080, 1280, 720},
+	{"640x480 -> 1280x960", 640, 480, 1280, 960}
+};
+
+// smooth gradients with noise, and a translucent border
+static Ref<Image> CreateSourceImage(sl_uint32 width, sl_uint32 height)
+{
+	Ref<Image> image = Image::create(width, height);
+	if (image.isNull()) {
+		return sl_null;
+	}
+	sl_uint32 seed = width * 31 + height;
+	for (sl_uint32 y = 0; y < height; y++) {
+		Color* row = image->getColors() + (sl_reg)(image->getStride()) * y;
+		for (sl_uint32 x = 0; x < width; x++) {
+			seed = seed * 1103515245 + 12345;
+			sl_uint32 noise = (seed >> 24) & 15;
+			Color& c = row[x];
+			c.r = (sl_uint8)(x * 255 / width);
+			c.g = (sl_uint8)(y * 255 / height);
+			c.b = (sl_uint8)((((x >> 4) ^ (y >> 4)) & 1) * 200 + noise);
+			c.a = (x < 8 || y < 8) ? 128 : 255;
+		}
+	}
+	return image;
+}
+
+// returns milliseconds per image, best of 3 runs
+static double Measure(const Ref<Image>& source, const ResampleCase& c, StretchMode mode, const Ref<ThreadPool>& pool)
+{
+	double best = 0;
+	for (int round = 0; round < 3; round++) {
+		Time t = Time::now();
+		Ref<Image> result = source->scale(c.widthTarget, c.heightTarget, mode, pool);
+		double ms = (Time::now() - t).getMillisecondsCountf();
+		if (result.isNull()) {
+			return 0;
+		}
+		if (!round || ms < best) {
+			best = ms;
+		}
+	}
+	return best;
+}
+
+int main(int argc, const char * argv[])
+{
+	Println("SSE4.1: %s, AVX2: %s", Cpu::isSupportingSSE41() ? "yes" : "no", Cpu::isSupportingAVX2() ? "yes" : "no");
+	struct {
+		const char* name;
+		StretchMode mode;
+	} modes[] = {
+		{"Linear", StretchMode::Linear},
+		{"Box", StretchMode::Box},
+		{"Bicubic", StretchMode::Bicubic},
+		{"Mitchell", StretchMode::Mitchell},
+		{"Lanczos3", StretchMode::Lanczos}
+	};
+	Ref<ThreadPool> pool = ThreadPool::create(4, 4);
+	for (auto& c : g_cases) {
+		Ref<Image> source = CreateSourceImage(c.widthSource, c.heightSource);
+		if (source.isNull()) {
+			return 1;
+		}
+		double mpix = (double)(c.widthSource) * (double)(c.heightSource) / 1000000.0;
+		Println("%s (%dx%d -> %dx%d)", c.name, c.widthSource, c.heightSource, c.widthTarget, c.heightTarget);
+		for (auto& m : modes) {
+			double ms = Measure(source, c, m.mode, sl_null);
+			double msPool = Measure(source, c, m.mode, pool);
+			Println("  %-9s %8.2f ms %8.1f Mpix/s | 4 threads %8.2f ms %8.1f Mpix/s", m.name, ms, mpix * 1000 / ms, msPool, mpix * 1000 / msPool);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <slib/core.h>
+#include <slib/network.h>
+
+using namespace slib;
+
+// Size, heap usage and construction cost of Object, LightObject and the types derived from LightObject
+
+class CountingAllocator : public MemoryAllocator
+{
+public:
+	sl_uint64 countAllocations = 0;
+	sl_uint64 sizeAllocated = 0;
+
+public:
+	void* createMemory(sl_size size) noexcept override
+	{
+		countAllocations++;
+		sizeAllocated += size;
+		return MemoryAllocator::getSystem()->createMemory(size);
+	}
+
+	void* reallocMemory(void* ptr, sl_size sizeNew) noexcept override
+	{
+		countAllocations++;
+		sizeAllocated += sizeNew;
+		return MemoryAllocator::getSystem()->reallocMemory(ptr, sizeNew);
+	}
+
+	void freeMemory(void* ptr) noexcept override
+	{
+		MemoryAllocator::getSystem()->freeMemory(ptr);
+	}
+
+};
+
+static CountingAllocator g_allocator;
+
+// the constructor of HttpServiceContext is protected
+class ExampleContext : public HttpServiceContext
+{
+};
+
+#define ITERATIONS 1000000
+
+template <class T>
+static void Run(const char* name, sl_bool flagLock)
+{
+	double best = 0;
+	sl_uint64 countAllocations = 0;
+	sl_uint64 sizeAllocated = 0;
+	for (int round = 0; round < 5; round++) {
+		sl_uint64 countStart = g_allocator.countAllocations;
+		sl_uint64 sizeStart = g_allocator.sizeAllocated;
+		Time t = Time::now();
+		for (sl_uint32 i = 0; i < ITERATIONS; i++) {
+			Ref<T> object = new T;
+			if (flagLock) {
+				ObjectLocker lock(object.get());
+			}
+		}
+		double ns = (Time::now() - t).getMicrosecondsCountf() * 1000 / ITERATIONS;
+		if (!round || ns < best) {
+			best = ns;
+		}
+		countAllocations = (g_allocator.countAllocations - countStart) / ITERATIONS;
+		sizeAllocated = (g_allocator.sizeAllocated - sizeStart) / ITERATIONS;
+	}
+	Println("%s: sizeof %d, heap %d bytes in %d blocks, new/delete %.1f ns", name, (sl_uint32)(sizeof(T)), (sl_uint32)sizeAllocated, (sl_uint32)countAllocations, best);
+}
+
+int main(int argc, const char * argv[])
+{
+	MemoryAllocator::setDefault(&g_allocator);
+
+	// warms up the allocator
+	for (sl_uint32 i = 0; i < ITERATIONS; i++) {
+		Ref<Object> object = new Object;
+	}
+	Run<Object>("Object              ", sl_false);
+	Run<Object>("Object + lock       ", sl_true);
+	Run<LightObject>("LightObject         ", sl_false);
+	Run<LightObject>("LightObject + lock  ", sl_true);
+	Run<MemoryQueue>("MemoryQueue         ", sl_false);
+	Run<MemoryBuffer>("MemoryBuffer        ", sl_false);
+	Run<ExampleContext>("HttpServiceContext  ", sl_false);
+	Println("sizeof Referable %d, Mutex %d, AsyncOutput %d, AsyncStreamRequest %d", (sl_uint32)(sizeof(Referable)), (sl_uint32)(sizeof(Mutex)), (sl_uint32)(sizeof(AsyncOutput)), (sl_uint32)(sizeof(AsyncStreamRequest)));
+	return 0;
+}
@@ -0,0 +1,161 @@
+/*
+ *  Copyright (c) 2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <slib/core.h>
+#include <slib/network.h>
+
+using namespace slib;
+
+/*
+	Per-request cost of an HttpService handler allocating from the heap or from a MemoryArena.
+	The handler parses the JSON body, builds a JSON response and serializes it. In arena mode the
+	work runs in an ArenaScope, the response is copied out in an ArenaScope(sl_null), and the arena
+	is reset after each request. Only the handler is timed, because the loopback round trips are
+	dominated by the network stack.
+*/
+
+#define SERVER_PORT 18200
+#define CONNECTIONS_COUNT 100
+#define ROUNDS_COUNT 100
+
+static const char* g_body = "{\"user\":{\"id\":12345,\"name\":\"alice\",\"tags\":[\"a\",\"b\",\"c\"],\"score\":12.5},\"items\":[{\"k\":1,\"v\":\"x\"},{\"k\":2,\"v\":\"y\"},{\"k\":3,\"v\":\"z\"},{\"k\":4,\"v\":\"w\"}],\"flag\":true}";
+
+static sl_bool g_flagUseArena = sl_false;
+// requests are processed on the only I/O loop of the service, so one arena is enough
+static MemoryArena g_arena;
+static double g_timeHandler = 0;
+
+static String BuildResponse(HttpServiceContext* context)
+{
+	Memory mem = context->getRequestBody();
+	Json request = Json::parseJson(String((sl_char8*)(mem.getData()), mem.getSize()));
+	JsonMap response = JsonMap::create();
+	response.put_NoLock("id", request["user"]["id"]);
+	response.put_NoLock("name", request["user"]["name"]);
+	List<Json> values;
+	Json items = request["items"];
+	for (sl_size i = 0; i < items.getElementsCount(); i++) {
+		values.add_NoLock(items[i]["v"]);
+	}
+	response.put_NoLock("values", Json(values));
+	response.put_NoLock("agent", Json(context->getRequestHeader("User-Agent")));
+	response.put_NoLock("path", Json(context->getPath()));
+	return Json(response).toJsonString();
+}
+
+static sl_bool OnRequest(HttpService*, HttpServiceContext* context)
+{
+	Time t = Time::now();
+	String response;
+	if (g_flagUseArena) {
+		{
+			ArenaScope scope(&g_arena);
+			String s = BuildResponse(context);
+			ArenaScope scopeOutside(sl_null);
+			response = String(s.getData(), s.getLength());
+		}
+		g_arena.reset();
+	} else {
+		response = BuildResponse(context);
+	}
+	g_timeHandler += (Time::now() - t).getMicrosecondsCountf();
+	context->setResponseContentType(ContentType::Json);
+	context->write(response);
+	return sl_true;
+}
+
+static sl_bool ReadResponse(Socket* socket)
+{
+	char buf[4096];
+	sl_uint32 size = 0;
+	sl_reg posBody = -1;
+	sl_uint32 sizeContent = 0;
+	for (;;) {
+		sl_int32 n = socket->receive(buf + size, (sl_uint32)(sizeof(buf) - 1 - size));
+		if (n <= 0) {
+			return sl_false;
+		}
+		size += n;
+		if (posBody < 0) {
+			String header(buf, size);
+			sl_reg pos = header.indexOf("\r\n\r\n");
+			if (pos >= 0) {
+				posBody = pos + 4;
+				sl_reg posLength = header.indexOf("Content-Length: ");
+				if (posLength >= 0) {
+					sizeContent = header.substring(posLength + 16, header.indexOf("\r\n", posLength)).parseUint32();
+				}
+			}
+		}
+		if (posBody >= 0 && size >= posBody + sizeContent) {
+			return sl_true;
+		}
+	}
+}
+
+// sends one request on each of the keep-alive connections, then reads the responses, for `nRounds` times
+static sl_bool RunClient(sl_uint32 nConnections, sl_uint32 nRounds)
+{
+	List< Ref<Socket> > sockets;
+	for (sl_uint32 i = 0; i < nConnections; i++) {
+		Ref<Socket> socket = Socket::openTcp();
+		if (socket.isNull() || !(socket->connectAndWait(SocketAddress(IPv4Address(127, 0, 0, 1), SERVER_PORT), 5000))) {
+			Println("Failed to connect");
+			return sl_false;
+		}
+		socket->setNonBlockingMode(sl_false);
+		socket->setOption_TcpNoDelay(sl_true);
+		sockets.add_NoLock(socket);
+	}
+	String request = String::format("POST /api/users HTTP/1.1\r\nHost: localhost\r\nUser-Agent: bench/1.0\r\nContent-Type: application/json\r\nContent-Length: %d\r\n\r\n%s", Base::getStringLength(g_body), g_body);
+	for (sl_uint32 i = 0; i < nRounds; i++) {
+		for (auto& socket : sockets) {
+			if (socket->send(request.getData(), (sl_uint32)(request.getLength())) != (sl_int32)(request.getLength())) {
+				Println("Failed to send");
+				return sl_false;
+			}
+		}
+		for (auto& socket : sockets) {
+			if (!(ReadResponse(socket.get()))) {
+				Println("Failed to receive");
+				return sl_false;
+			}
+		}
+	}
+	return sl_true;
+}
+
+int main(int argc, const char * argv[])
+{
+	HttpServiceParam param;
+	param.port = SERVER_PORT;
+	param.ioLoopsCount = 1;
+	param.flagProcessByThreads = sl_false;
+	param.onRequest = &OnRequest;
+	Ref<HttpService> service = HttpService::create(param);
+	if (service.isNull()) {
+		Println("Failed to start the service");
+		return 1;
+	}
+	RunClient(CONNECTIONS_COUNT, 10);
+	for (int round = 0; round < 3; round++) {
+		for (int mode = 0; mode < 2; mode++) {
+			g_flagUseArena = mode == 1;
+			g_timeHandler = 0;
+			if (!(RunClient(CONNECTIONS_COUNT, ROUNDS_COUNT))) {
+				return 1;
+			}
+			Println("%s: %.2f us/request in the handler", g_flagUseArena ? "arena" : "heap ", g_timeHandler / (CONNECTIONS_COUNT * ROUNDS_COUNT));
+		}
+	}
+	Println("Arena chunks reserved: %d bytes", g_arena.getReservedSize());
+	service->release();
+	return 0;
+}
@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <slib/core.h>
+#include <slib/graphics.h>
+
+using namespace slib;
+
+// Frames per second of the pixel-format conversions and of alpha blending, at 1080p and 4K
+
+static BitmapData CreateFrame(sl_uint32 width, sl_uint32 height, BitmapFormat format)
+{
+	BitmapData bd;
+	bd.width = width;
+	bd.height = height;
+	bd.format = format;
+	Memory mem = Memory::create(bd.getTotalSize());
+	sl_uint8* p = (sl_uint8*)(mem.getData());
+	sl_size n = mem.getSize();
+	sl_uint32 x = 1;
+	for (sl_size i = 0; i < n; i++) {
+		x = x * 1103515245 + 12345;
+		p[i] = (sl_uint8)(x >> 24);
+	}
+	bd.data = p;
+	bd.ref = mem.ref;
+	bd.fillDefaultValues();
+	return bd;
+}
+
+// converts I420 pixel by pixel, as BitmapData::copyPixelsFrom did before the row kernels
+static void ConvertI420ToRGBAPerPixel(const BitmapData& dst, const BitmapData& src)
+{
+	for (sl_uint32 y = 0; y < src.height; y++) {
+		const sl_uint8* Y = (const sl_uint8*)(src.data) + src.pitch * y;
+		const sl_uint8* U = (const sl_uint8*)(src.data1) + src.pitch1 * (y >> 1);
+		const sl_uint8* V = (const sl_uint8*)(src.data2) + src.pitch2 * (y >> 1);
+		sl_uint8* D = (sl_uint8*)(dst.data) + dst.pitch * y;
+		for (sl_uint32 x = 0; x < src.width; x++) {
+			YUV::convertYUVToRGB(Y[x], U[x >> 1], V[x >> 1], D[0], D[1], D[2]);
+			D[3] = 255;
+			D += 4;
+		}
+	}
+}
+
+static void BlendRows(const BitmapData& dst, const BitmapData& src)
+{
+	for (sl_uint32 y = 0; y < src.height; y++) {
+		Color::blend_PA_NPA((Color*)((sl_uint8*)(dst.data) + dst.pitch * y), (const Color*)((const sl_uint8*)(src.data) + src.pitch * y), src.width);
+	}
+}
+
+static void CopyPixels(const BitmapData& dst, const BitmapData& src)
+{
+	dst.copyPixelsFrom(src);
+}
+
+static void Run(const char* name, sl_uint32 width, sl_uint32 height, BitmapFormat formatSrc, BitmapFormat formatDst, void (*convert)(const BitmapData& dst, const BitmapData& src))
+{
+	BitmapData src = CreateFrame(width, height, formatSrc);
+	BitmapData dst = CreateFrame(width, height, formatDst);
+	sl_uint32 nFrames = width > 2000 ? 10 : 40;
+	double best = 0;
+	for (int round = 0; round < 3; round++) {
+		Time t = Time::now();
+		for (sl_uint32 i = 0; i < nFrames; i++) {
+			convert(dst, src);
+		}
+		double ms = (Time::now() - t).getMillisecondsCountf() / nFrames;
+		if (!round || ms < best) {
+			best = ms;
+		}
+	}
+	Println("%-32s %6.2f ms/frame %8.1f fps", name, best, 1000 / best);
+}
+
+static void RunAll(sl_uint32 width, sl_uint32 height)
+{
+	Println("%dx%d", width, height);
+	Run("I420 -> RGBA (per pixel)", width, height, BitmapFormat::YUV_I420, BitmapFormat::RGBA, ConvertI420ToRGBAPerPixel);
+	Run("I420 -> RGBA", width, height, BitmapFormat::YUV_I420, BitmapFormat::RGBA, CopyPixels);
+	Run("NV12 -> BGRA", width, height, BitmapFormat::YUV_NV12, BitmapFormat::BGRA, CopyPixels);
+	Run("RGBA -> I420", width, height, BitmapFormat::RGBA, BitmapFormat::YUV_I420, CopyPixels);
+	Run("RGBA -> BGRA", width, height, BitmapFormat::RGBA, BitmapFormat::BGRA, CopyPixels);
+	Run("RGBA -> RGBA_PA (premultiply)", width, height, BitmapFormat::RGBA, BitmapFormat::RGBA_PA, CopyPixels);
+	Run("RGBA_PA -> RGBA (unpremultiply)", width, height, BitmapFormat::RGBA_PA, BitmapFormat::RGBA, CopyPixels);
+	Run("blend RGBA over RGBA_PA", width, height, BitmapFormat::RGBA, BitmapFormat::RGBA_PA, BlendRows);
+}
+
+int main(int argc, const char * argv[])
+{
+	Println("SSE4.1: %s, AVX2: %s", Cpu::isSupportingSSE41() ? "yes" : "no", Cpu::isSupportingAVX2() ? "yes" : "no");
+	RunAll(1920, 1080);
+	RunAll(3840, 2160);
+	return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ *  Copyright (c) 2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <slib/core.h>
+#include <slib/network/http_common.h>
+
+using namespace slib;
+
+// Counts the allocations of short strings, JSON parsing and HTTP header parsing with StringInterner
+
+class CountingAllocator : public MemoryAllocator
+{
+public:
+	sl_uint64 countAllocations = 0;
+
+public:
+	void* createMemory(sl_size size) noexcept override
+	{
+		countAllocations++;
+		return MemoryAllocator::getSystem()->createMemory(size);
+	}
+
+	void* reallocMemory(void* ptr, sl_size sizeNew) noexcept override
+	{
+		countAllocations++;
+		return MemoryAllocator::getSystem()->reallocMemory(ptr, sizeNew);
+	}
+
+	void freeMemory(void* ptr) noexcept override
+	{
+		MemoryAllocator::getSystem()->freeMemory(ptr);
+	}
+
+};
+
+static CountingAllocator g_allocator;
+
+class Measure
+{
+public:
+	Measure(): m_countStart(g_allocator.countAllocations), m_timeStart(Time::now()) {}
+
+	void print(const char* name, sl_uint64 nIterations)
+	{
+		double ms = (Time::now() - m_timeStart).getMillisecondsCountf();
+		sl_uint64 n = g_allocator.countAllocations - m_countStart;
+		Println("%s: %d allocations (%.2f per iteration), %.1f ms", name, n, (double)n / (double)nIterations, ms);
+	}
+
+private:
+	sl_uint64 m_countStart;
+	Time m_timeStart;
+};
+
+int main(int argc, const char * argv[])
+{
+	MemoryAllocator::setDefault(&g_allocator);
+
+	// 1M short keys taken from 8 distinct names
+	{
+		const char* names[] = {"id", "name", "email", "created_at", "updated_at", "status", "owner", "tags"};
+		const sl_uint32 n = 1000000;
+		{
+			Measure m;
+			for (sl_uint32 i = 0; i < n; i++) {
+				const char* s = names[i & 7];
+				String key(s, Base::getStringLength(s));
+			}
+			m.print("String      x1M", n);
+		}
+		{
+			StringInterner interner(sl_false);
+			Measure m;
+			for (sl_uint32 i = 0; i < n; i++) {
+				const char* s = names[i & 7];
+				String key = interner.intern(s, Base::getStringLength(s));
+			}
+			m.print("intern      x1M", n);
+		}
+	}
+
+	// JSON array of 20K objects, 8 keys each; the keys of all the objects are interned per parse
+	{
+		StringBuffer sb;
+		sb.addStatic("[", 1);
+		const sl_uint32 n = 20000;
+		for (sl_uint32 i = 0; i < n; i++) {
+			if (i) {
+				sb.addStatic(",", 1);
+			}
+			sb.add(String::format("{\"id\":%d,\"name\":\"user %d\",\"tags\":[\"a\",\"b\"],\"score\":%d,\"active\":true,\"nested\":{\"x\":1,\"y\":2}}", i, i, i / 2));
+		}
+		sb.addStatic("]", 1);
+		String text = sb.merge();
+		Json json;
+		{
+			Measure m;
+			json = Json::parseJson(text);
+			m.print("parseJson   20K objects", n);
+		}
+		// the same key of different objects shares one container
+		String key1 = json[0].getJsonMap().getFirstNode()->key;
+		String key2 = json[n - 1].getJsonMap().getFirstNode()->key;
+		Println("Keys shared between objects: %s (\"%s\")", key1.getData() == key2.getData() ? "yes" : "no", key1);
+	}
+
+	// HTTP request header of 8 fields; the names are shared with the global atoms
+	{
+		const char* header = "Host: example.com\r\nUser-Agent: bench/1.0\r\nAccept: */*\r\nAccept-Encoding: gzip\r\nConnection: keep-alive\r\nContent-Type: application/json\r\nContent-Length: 12\r\nX-Custom: 1\r\n\r\n";
+		sl_size size = Base::getStringLength(header);
+		const sl_uint32 n = 20000;
+		Measure m;
+		for (sl_uint32 i = 0; i < n; i++) {
+			HttpHeaderMap map;
+			HttpHeaders::parseHeaders(map, header, size);
+		}
+		m.print("parseHeaders x20K", n);
+	}
+	return 0;
+}
@@ -0,0 +1,161 @@
+/*
+ *  Copyright (c) 2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <slib/core.h>
+#include <slib/network.h>
+
+using namespace slib;
+
+/*
+	Throughput and thread count of UrlRequest with 1000 requests issued at once against a local
+	HttpService, which answers after a configurable latency without blocking its I/O loop.
+	Compared modes:
+		async        UrlRequest::send(), driven by the shared request engine
+		async, 64    the same, with at most 64 connections per host
+		blocking     UrlRequest::sendSynchronous() on a ThreadPool with 30 threads, one thread per
+		             request in flight, as the requests were processed before the engine
+	On Linux, the number of threads of the process is sampled every 5ms and the peak is printed.
+*/
+
+#define SERVER_PORT 18210
+#define REQUESTS_COUNT 1000
+
+static sl_uint32 g_latency = 0;
+static sl_int32 g_nCompleted = 0;
+static sl_int32 g_nErrors = 0;
+static Ref<Event> g_eventDone;
+
+static sl_bool OnRequest(HttpService*, HttpServiceContext* context)
+{
+	context->setResponseContentType(ContentType::TextPlain);
+	if (!g_latency) {
+		context->write(String("ok"));
+		return sl_true;
+	}
+	// completes the response later in the I/O loop of the connection, so the loop keeps serving the others
+	context->setAsynchronousResponse(sl_true);
+	Ref<HttpServiceContext> ref = context;
+	Dispatch::setTimeout([ref]() {
+		Ref<AsyncIoLoop> loop = ref->getAsyncIoLoop();
+		if (loop.isNotNull()) {
+			loop->addTask([ref]() {
+				ref->write(String("ok"));
+				ref->completeResponse();
+			});
+		}
+	}, g_latency);
+	return sl_true;
+}
+
+static void OnComplete(UrlRequest* request)
+{
+	if (request->isError() || request->getResponseStatus() != HttpStatus::OK) {
+		Base::interlockedIncrement32(&g_nErrors);
+	}
+	if (Base::interlockedIncrement32(&g_nCompleted) == REQUESTS_COUNT) {
+		g_eventDone->set();
+	}
+}
+
+static sl_uint32 GetThreadsCount()
+{
+#if defined(SLIB_PLATFORM_IS_LINUX)
+	// the files of procfs report zero size, so they are read into a buffer
+	Ref<File> file = File::openForRead("/proc/self/status");
+	if (file.isNull()) {
+		return 0;
+	}
+	char buf[4096];
+	sl_reg n = file->read(buf, sizeof(buf));
+	if (n <= 0) {
+		return 0;
+	}
+	String status(buf, n);
+	sl_reg pos = status.indexOf("Threads:");
+	if (pos >= 0) {
+		return status.substring(pos + 8, status.indexOf('\n', pos)).trim().parseUint32();
+	}
+#endif
+	return 0;
+}
+
+static void Run(const char* name, sl_uint32 mode, const String& url)
+{
+	UrlRequest::setMaximumConnectionsPerHost(mode == 1 ? 64 : 0);
+	g_nCompleted = 0;
+	g_nErrors = 0;
+	g_eventDone = Event::create();
+	sl_uint32 nThreadsMax = GetThreadsCount();
+	Ref<Thread> sampler = Thread::start([&nThreadsMax]() {
+		while (Thread::isNotStoppingCurrent()) {
+			sl_uint32 n = GetThreadsCount();
+			if (n > nThreadsMax) {
+				nThreadsMax = n;
+			}
+			Thread::sleep(5);
+		}
+	});
+	Ref<ThreadPool> pool;
+	if (mode == 2) {
+		pool = ThreadPool::create();
+	}
+	Time t = Time::now();
+	for (sl_uint32 i = 0; i < REQUESTS_COUNT; i++) {
+		if (pool.isNotNull()) {
+			pool->addTask([url]() {
+				Ref<UrlRequest> request = UrlRequest::sendSynchronous(url);
+				if (request.isNotNull()) {
+					OnComplete(request.get());
+				}
+			});
+		} else {
+			UrlRequest::send(url, &OnComplete);
+		}
+	}
+	sl_bool flagDone = g_eventDone->wait(120000);
+	double seconds = (Time::now() - t).getSecondsCountf();
+	sampler->finishAndWait();
+	if (pool.isNotNull()) {
+		pool->release();
+	}
+	if (!flagDone) {
+		Println("%-14s timed out: %d of %d completed", name, g_nCompleted, REQUESTS_COUNT);
+		return;
+	}
+	Println("%-14s %8.0f req/s  %6.1f ms  peak threads %3d  errors %d", name, REQUESTS_COUNT / seconds, seconds * 1000, nThreadsMax, g_nErrors);
+}
+
+int main(int argc, const char * argv[])
+{
+	HttpServiceParam param;
+	param.port = SERVER_PORT;
+	param.ioLoopsCount = 1;
+	param.flagProcessByThreads = sl_false;
+	param.onRequest = &OnRequest;
+	Ref<HttpService> service = HttpService::create(param);
+	if (service.isNull()) {
+		Println("Failed to start the service");
+		return 1;
+	}
+	String url = String::format("http://127.0.0.1:%d/", SERVER_PORT);
+	// warms up the engine and the dispatch loop of the service
+	UrlRequest::sendSynchronous(url);
+	Println("%d requests at once, process threads before: %d", REQUESTS_COUNT, GetThreadsCount());
+	sl_uint32 latencies[] = { 0, 50 };
+	for (sl_uint32 latency : latencies) {
+		g_latency = latency;
+		Println("server latency %d ms", latency);
+		Run("async", 0, url);
+		Run("async, 64", 1, url);
+		Run("blocking", 2, url);
+	}
+	service->release();
+	return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ *  Copyright (c) 2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <slib/core.h>
+#include <slib/network.h>
+
+using namespace slib;
+
+/*
+	Checks of HttpRequestParser on requests which must be accepted or rejected (400).
+	Each request is parsed at once and byte by byte. Returns non-zero when any check fails.
+*/
+
+static sl_uint32 g_nFailed = 0;
+
+// parses `request` in pieces of `step` bytes, and returns sl_false on a parse error
+static sl_bool Parse(HttpRequestParser& parser, const String& request, sl_size step, sl_size& consumed)
+{
+	parser.reset();
+	const sl_char8* data = request.getData();
+	sl_size size = request.getLength();
+	consumed = 0;
+	while (consumed < size && !(parser.isCompleted())) {
+		sl_size n = size - consumed;
+		if (n > step) {
+			n = step;
+		}
+		sl_size m = parser.parse(data + consumed, n);
+		if (parser.isError()) {
+			return sl_false;
+		}
+		consumed += m;
+		if (m < n && !(parser.isHeaderCompleted())) {
+			return sl_false;
+		}
+	}
+	return parser.isCompleted();
+}
+
+static void Accept(const char* name, const String& request, sl_uint64 contentLength, sl_bool flagChunked, sl_size sizeRequest)
+{
+	HttpRequestParser parser;
+	sl_size steps[] = { SLIB_SIZE_MAX, 1 };
+	for (sl_size step : steps) {
+		sl_size consumed;
+		sl_bool flagOk = Parse(parser, request, step, consumed);
+		if (flagOk) {
+			flagOk = parser.getContentLength() == contentLength && parser.isChunked() == flagChunked && consumed == sizeRequest;
+		}
+		if (!flagOk) {
+			Println("FAIL %s (step %d): not accepted as expected", name, step == 1 ? 1 : 0);
+			g_nFailed++;
+			return;
+		}
+	}
+	Println("ok   %s", name);
+}
+
+static void Reject(const char* name, const String& request)
+{
+	HttpRequestParser parser;
+	sl_size steps[] = { SLIB_SIZE_MAX, 1 };
+	for (sl_size step : steps) {
+		sl_size consumed;
+		if (Parse(parser, request, step, consumed) || !(parser.isError())) {
+			Println("FAIL %s (step %d): accepted", name, step == 1 ? 1 : 0);
+			g_nFailed++;
+			return;
+		}
+	}
+	Println("ok   %s", name);
+}
+
+int main(int argc, const char * argv[])
+{
+	String simple = "GET /index.html?a=1 HTTP/1.1\r\nHost: localhost\r\n\r\n";
+	Accept("simple GET", simple, 0, sl_false, simple.getLength());
+	String post = "POST /api HTTP/1.1\r\nHost: localhost\r\nContent-Length: 5\r\n\r\nhello";
+	Accept("Content-Length body", post, 5, sl_false, post.getLength());
+	String chunked = "POST /api HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nhello\r\n0\r\n\r\n";
+	Accept("chunked body", chunked, 5, sl_true, chunked.getLength());
+	String tokens = "M-SEARCH * HTTP/1.1\r\nX-Custom_Field.1~!: value with spaces \r\n\r\n";
+	Accept("token characters", tokens, 0, sl_false, tokens.getLength());
+	String pipelined = simple + simple;
+	Accept("pipelined requests stop at the first", pipelined, 0, sl_false, simple.getLength());
+
+	Reject("space before colon (Content-Length)", "POST /api HTTP/1.1\r\nHost: localhost\r\nContent-Length : 5\r\n\r\nhello");
+	Reject("space before colon (TE.CL)", "POST /api HTTP/1.1\r\nTransfer-Encoding : chunked\r\nContent-Length: 3\r\n\r\n0\r\n\r\n");
+	Reject("tab before colon", "GET / HTTP/1.1\r\nHost\t: localhost\r\n\r\n");
+	Reject("space inside field name", "GET / HTTP/1.1\r\nHo st: localhost\r\n\r\n");
+	Reject("non-token in field name", "GET / HTTP/1.1\r\nHo@st: localhost\r\n\r\n");
+	Reject("field without colon", "GET / HTTP/1.1\r\nHost\r\n\r\n");
+	Reject("empty field name", "GET / HTTP/1.1\r\n: localhost\r\n\r\n");
+	Reject("obsolete line folding", "GET / HTTP/1.1\r\nHost: localhost\r\n folded\r\n\r\n");
+	Reject("non-token in method", "G@T / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+	Reject("tab in method", "GE\tT / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+	Reject("empty method", " / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+
+	if (g_nFailed) {
+		Println("%d checks failed", g_nFailed);
+		return 1;
+	}
+	Println("All checks passed");
+	return 0;
+}
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <slib/core.h>
+
+using namespace slib;
+
+/*
+	Checks of the reference counts of the atoms returned by StringInterner.
+	Returns non-zero when any check fails.
+*/
+
+static sl_uint32 g_nFailed = 0;
+
+// String is a one-pointer handle to its container
+static StringContainer* GetContainer(const String& str)
+{
+	return *((StringContainer* const*)(&str));
+}
+
+static void Check(const char* name, sl_bool flagOk)
+{
+	if (flagOk) {
+		Println("ok   %s", name);
+	} else {
+		Println("FAIL %s", name);
+		g_nFailed++;
+	}
+}
+
+static void Run(sl_bool flagThreadSafe)
+{
+	Println(flagThreadSafe ? "thread-safe interner" : "single-thread interner");
+	SLIB_STATIC_STRING(keyStatic, "user")
+	SLIB_STATIC_STRING(keyOther, "session")
+	StringInterner interner(flagThreadSafe);
+
+	String a = interner.intern("user", 4);
+	StringContainer* container = GetContainer(a);
+	// one reference for the table and one for `a`
+	Check("intern(sz, len) adds a reference", container->ref == 2);
+	{
+		String b = interner.intern(keyStatic);
+		Check("intern(String) returns the existing atom", GetContainer(b) == container);
+		Check("intern(String) adds a reference to the existing atom", container->ref == 3);
+		String c = interner.intern(String("user"));
+		Check("intern(String) of a heap string returns the existing atom", GetContainer(c) == container);
+		Check("intern(String) of a heap string adds a reference", container->ref == 4);
+	}
+	Check("released copies give back their references", container->ref == 2);
+	a.setNull();
+	Check("the table keeps its reference", container->ref == 1);
+	String d = interner.find("user", 4);
+	Check("find() returns the kept atom", GetContainer(d) == container && container->ref == 2);
+
+	String e = interner.intern(keyOther);
+	Check("intern(String) adopts a static string", GetContainer(e) == GetContainer(keyOther));
+	String f = interner.intern("session", 7);
+	Check("intern(sz, len) returns the adopted static string", GetContainer(f) == GetContainer(keyOther));
+}
+
+int main(int argc, const char * argv[])
+{
+	Run(sl_false);
+	Run(sl_true);
+	if (g_nFailed) {
+		Println("%d checks failed", g_nFailed);
+		return 1;
+	}
+	Println("All checks passed");
+	return 0;
+}
@@ -39,8 +39,11 @@
 #include "core/spin_lock.h"
 #include "core/mutex.h"
 #include "core/string.h"
+#include "core/string_interner.h"
 #include "core/string_buffer.h"
 #include "core/memory.h"
+#include "core/memory_allocator.h"
+#include "core/memory_arena.h"
 #include "core/time.h"
 #include "core/variant.h"
 
@@ -55,6 +58,8 @@
 #include "core/map.h"
 #include "core/hash_map.h"
 #include "core/hash_table.h"
+#include "core/flat_hash_map.h"
+#include "core/concurrent_hash_map.h"
 #include "core/linked_list.h"
 #include "core/queue.h"
 #include "core/queue_channel.h"
@@ -68,6 +73,7 @@
 #include "core/animation.h"
 
 #include "core/system.h"
+#include "core/cpu.h"
 #include "core/event.h"
 #include "core/thread.h"
 #include "core/thread_pool.h"
@@ -76,6 +82,7 @@
 
 #include "core/io.h"
 #include "core/file.h"
+#include "core/file_btree.h"
 #include "core/pipe.h"
 #include "core/async.h"
 #include "core/dispatch.h"
@@ -93,6 +100,9 @@
 #include "core/setting.h"
 
 #include "core/json.h"
+#include "core/json_view.h"
+#include "core/json_writer.h"
+#include "core/cache.h"
 #include "core/xml.h"
 #include "core/base64.h"
 
@@ -73,6 +73,9 @@ namespace slib
 
 		sl_bool dispatch(const Function<void()>& callback, sl_uint64 delay_ms) override;
 
+		// completion-based file I/O (io_uring) is available on this loop
+		sl_bool isSupportingFileCompletion();
+
 	protected:
 		sl_bool m_flagInit;
 		sl_bool m_flagRunning;
@@ -93,11 +96,15 @@ namespace slib
 		sl_bool _native_attachInstance(AsyncIoInstance* instance, AsyncIoMode mode);
 		void _native_detachInstance(AsyncIoInstance* instance);
 		void _native_wake();
+		void* _native_getIoUring();
 
 	protected:
 		void _stepBegin();
 		void _stepEnd();
+		void _processIoUringCompletions();
 	
+		friend class AsyncFile;
+
 	};
 	
 	
@@ -155,6 +162,8 @@ namespace slib
 			sl_bool flagIn;
 			sl_bool flagOut;
 			sl_bool flagError;
+			void* pCompletion; // io_uring
+			sl_int32 result; // io_uring
 #endif
 		};
 		virtual void onEvent(EventDesc* pev) = 0;
@@ -229,6 +238,10 @@ namespace slib
 		Ref<Referable> userObject;
 		Function<void(AsyncStreamResult*)> callback;
 		sl_bool flagRead;
+		
+		// file region to be sent directly by the stream (`data` is null)
+		Ref<File> file;
+		sl_uint64 fileOffset;
 
 	protected:
 		AsyncStreamRequest(void* data, sl_uint32 size, Referable* userObject, const Function<void(AsyncStreamResult*)>& callback, sl_bool flagRead);
@@ -238,6 +251,8 @@ namespace slib
 
 		static Ref<AsyncStreamRequest> createWrite(void* data, sl_uint32 size, Referable* userObject, const Function<void(AsyncStreamResult*)>& callback);
 
+		static Ref<AsyncStreamRequest> createSendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, Referable* userObject, const Function<void(AsyncStreamResult*)>& callback);
+
 	public:
 		void runCallback(AsyncStream* stream, sl_uint32 resultSize, sl_bool flagError);
 
@@ -258,6 +273,10 @@ namespace slib
 
 		virtual sl_bool write(void* data, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject);
 
+		virtual sl_bool isSupportingSendFile();
+
+		virtual sl_bool sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject);
+
 		virtual sl_bool isSeekable();
 
 		virtual sl_bool seek(sl_uint64 pos);
@@ -309,6 +328,11 @@ namespace slib
 
 		virtual sl_bool write(void* data, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject = sl_null) = 0;
 
+		// zero-copy transfer of a file region; only available on streams returning sl_true from isSupportingSendFile()
+		virtual sl_bool isSupportingSendFile();
+
+		virtual sl_bool sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject = sl_null);
+
 		virtual sl_bool isSeekable();
 
 		virtual sl_bool seek(sl_uint64 pos);
@@ -339,6 +363,10 @@ namespace slib
 
 		sl_bool write(void* data, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject = sl_null) override;
 
+		sl_bool isSupportingSendFile() override;
+
+		sl_bool sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject = sl_null) override;
+
 		sl_bool isSeekable() override;
 
 		sl_bool seek(sl_uint64 pos) override;
@@ -497,6 +525,16 @@ namespace slib
 
 		static Ref<AsyncStream> openIOCP(const String& path, FileMode mode);
 #endif
+
+		// returns null when io_uring is not supported by the platform or by the running kernel
+		static Ref<AsyncStream> openIoUring(const String& path, FileMode mode, const Ref<AsyncIoLoop>& loop);
+
+		static Ref<AsyncStream> openIoUring(const String& path, FileMode mode);
+
+		// completion-based stream on `loop` when the platform supports it, otherwise `AsyncFile` running on `dispatcher`
+		static Ref<AsyncStream> openStream(const String& path, FileMode mode, const Ref<AsyncIoLoop>& loop, const Ref<Dispatcher>& dispatcher);
+
+		static Ref<AsyncStream> openStream(const String& path, FileMode mode);
 	
 	public:
 		void close() override;
@@ -658,21 +696,31 @@ namespace slib
 		sl_bool addHeader(const Memory& header);
 
 		void setBody(AsyncStream* stream, sl_uint64 size);
+
+		void setBodyFile(const Ref<File>& file, sl_uint64 offset, sl_uint64 size);
 	
 		MemoryQueue& getHeader();
 	
 		Ref<AsyncStream> getBody();
 	
 		sl_uint64 getBodySize();
+
+		Ref<File> getBodyFile();
+
+		sl_uint64 getBodyFileOffset();
+
+		void skipBody(sl_uint64 size);
 	
 	protected:
 		MemoryQueue m_header;
 		sl_uint64 m_sizeBody;
 		AtomicRef<AsyncStream> m_body;
+		AtomicRef<File> m_fileBody;
+		sl_uint64 m_offsetFileBody;
 
 	};
 	
-	class SLIB_EXPORT AsyncOutputBuffer: public Object
+	class SLIB_EXPORT AsyncOutputBuffer: public LightObject
 	{
 	public:
 		AsyncOutputBuffer();
@@ -692,6 +740,9 @@ namespace slib
 
 		sl_bool copyFromFile(const String& path, const Ref<Dispatcher>& dispatcher);
 
+		// the region is sent by AsyncStream::sendFile() when the output stream supports it
+		sl_bool copyFromFile(const Ref<File>& file, sl_uint64 offset, sl_uint64 size);
+
 		sl_uint64 getOutputLength() const;
 	
 	protected:
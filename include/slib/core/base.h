@@ -221,5 +221,13 @@ namespace slib
 
 }
 
+// allocates the instances of the class with Base::createMemory, so that they follow MemoryAllocator and ArenaScope
+#define SLIB_DECLARE_MEMORY_OPERATORS \
+	public: \
+		static void* operator new(decltype(sizeof(0)) size) noexcept { return slib::Base::createMemory(size); } \
+		static void operator delete(void* ptr) noexcept { slib::Base::freeMemory(ptr); } \
+		static void* operator new(decltype(sizeof(0)), void* ptr) noexcept { return ptr; } \
+		static void operator delete(void*, void*) noexcept {}
+
 #endif
 
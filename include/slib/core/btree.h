@@ -222,11 +222,15 @@ namespace slib
 		sl_uint64 m_totalCount;
 		KEY_COMPARE m_compare;
 	
-	private:
+	protected:
 		NodeData* _createNodeData();
 
 		void _freeNodeData(NodeData* data);
 
+		// reloads the cached depth and count from the nodes, after the storage has changed underneath the tree (e.g. rollback)
+		void _reloadCachedState();
+
+	private:
 		sl_bool _insertItemInNode(const BTreeNode& node, sl_uint32 at, const BTreeNode& after, const KT& key, const VT& value, const BTreeNode& link, BTreePosition* pPosition);
 
 		void _changeTotalCount(const BTreeNode& node, sl_int64 n);
@@ -0,0 +1,308 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_CACHE
+#define CHECKHEADER_SLIB_CORE_CACHE
+
+#include "definition.h"
+
+#include "flat_hash_map.h"
+#include "spin_lock.h"
+#include "function.h"
+#include "event.h"
+#include "system.h"
+
+/*
+	Bounded, thread-safe cache.
+
+	Unlike ExpiringMap, which only drops the entries that were not accessed for a while,
+	Cache keeps the total weight of the entries under `maximumWeight` by evicting entries:
+		- LRU: evicts the least recently used entry
+		- TinyLFU (W-TinyLFU): new entries enter a small LRU window (1% of the weight). When they
+		  leave the window, they are admitted to the main segmented LRU only if a count-min
+		  sketch estimates them more frequently used than the entry they would evict, so bursts of
+		  one-time keys cannot flush the frequently used entries.
+	The weight of an entry is given by the weigher (e.g. size in bytes), or 1 without weigher.
+
+	The keys are spread over independently locked shards, and each shard holds its part of
+	the maximum weight. Entries can have a time-to-live: expired entries are removed when they
+	are accessed, or by removeExpired().
+	Time-to-live is measured with System::getTickCount(), so it should be less than 2^31 milliseconds.
+*/
+
+#define SLIB_CACHE_DEFAULT_SHARDS 16
+
+namespace slib
+{
+
+	enum class CachePolicy
+	{
+		LRU = 0,
+		TinyLFU = 1
+	};
+
+	class SLIB_EXPORT CacheParam
+	{
+	public:
+		CachePolicy policy; // default: TinyLFU
+
+		// default: 10000. Without weigher, this is the maximum number of the entries
+		sl_uint64 maximumWeight;
+
+		// milliseconds, default: 0 (no expiration)
+		sl_uint32 timeToLive;
+
+		// rounded up to a power of two, default: SLIB_CACHE_DEFAULT_SHARDS
+		sl_uint32 shardsCount;
+
+	public:
+		CacheParam();
+
+		~CacheParam();
+
+	};
+
+	class SLIB_EXPORT CacheStatistics
+	{
+	public:
+		sl_uint64 hitCount;
+		sl_uint64 missCount;
+		sl_uint64 loadSuccessCount;
+		sl_uint64 loadFailureCount;
+		sl_uint64 evictionCount;
+		sl_uint64 expirationCount;
+
+		sl_size count;
+		sl_uint64 weight;
+
+	public:
+		CacheStatistics();
+
+		~CacheStatistics();
+
+	public:
+		double getHitRate() const;
+
+	};
+
+	// Count-min sketch with 4-bit counters, halved periodically so that old accesses fade out
+	class SLIB_EXPORT CacheFrequencySketch
+	{
+	public:
+		CacheFrequencySketch();
+
+		~CacheFrequencySketch();
+
+	public:
+		sl_size getCapacity() const;
+
+		// resizes the table for `capacity` entries. The counters are cleared when resized
+		void ensureCapacity(sl_size capacity);
+
+		void increment(sl_size hash);
+
+		// 0 ~ 15
+		sl_uint32 getFrequency(sl_size hash) const;
+
+		void clear();
+
+	protected:
+		sl_uint64* m_table;
+		sl_size m_capacity;
+		sl_size m_mask;
+		sl_size m_size;
+		sl_size m_sampleSize;
+
+	};
+
+	template <class KT, class VT>
+	class SLIB_EXPORT CacheEntry
+	{
+	public:
+		KT key;
+		VT value;
+		sl_size hash;
+		sl_uint64 weight;
+		sl_uint32 timeExpire;
+		sl_bool flagExpire;
+		sl_uint8 queue;
+		CacheEntry* prev;
+		CacheEntry* next;
+
+	public:
+		template <class KEY, class VALUE>
+		CacheEntry(KEY&& _key, VALUE&& _value) noexcept;
+
+	};
+
+	template <class VT>
+	class SLIB_EXPORT CacheLoading : public Referable
+	{
+	public:
+		Ref<Event> event;
+		VT value;
+		sl_bool flagSuccess;
+
+	public:
+		CacheLoading() noexcept;
+
+	};
+
+	template < class KT, class VT, class HASH = Hash<KT>, class KEY_EQUALS = Equals<KT> >
+	class SLIB_EXPORT Cache
+	{
+	public:
+		typedef CacheEntry<KT, VT> ENTRY;
+		typedef Function<sl_uint64(const KT& key, const VT& value)> WEIGHER;
+		typedef Function<sl_bool(const KT& key, VT* _out)> LOADER;
+
+	public:
+		Cache(const CacheParam& param = CacheParam(), const WEIGHER& weigher = sl_null, const HASH& hash = HASH(), const KEY_EQUALS& key_equals = KEY_EQUALS()) noexcept;
+
+		Cache(const Cache& other) = delete;
+
+		~Cache() noexcept;
+
+	public:
+		Cache& operator=(const Cache& other) = delete;
+
+	public:
+		const CacheParam& getParam() const noexcept;
+
+		sl_uint32 getShardsCount() const noexcept;
+
+		sl_bool get(const KT& key, VT* _out = sl_null) noexcept;
+
+		VT getValue(const KT& key) noexcept;
+
+		VT getValue(const KT& key, const VT& def) noexcept;
+
+		// does not update the statistics and the order of the entries
+		sl_bool contains(const KT& key) noexcept;
+
+		// returns `sl_false` when the entry is heavier than a shard can hold
+		template <class KEY, class VALUE>
+		sl_bool put(KEY&& key, VALUE&& value) noexcept;
+
+		// `timeToLive`: milliseconds, 0 for no expiration
+		template <class KEY, class VALUE>
+		sl_bool put(KEY&& key, VALUE&& value, sl_uint32 timeToLive) noexcept;
+
+		/*
+			Returns the cached value, or loads the value with `loader` and caches it.
+			Concurrent misses on the same key are coalesced: only one thread calls `loader`,
+			and the others wait for its result. `loader` is called without holding any lock.
+		*/
+		sl_bool getOrLoad(const KT& key, const LOADER& loader, VT* _out = sl_null) noexcept;
+
+		sl_bool remove(const KT& key, VT* _out = sl_null) noexcept;
+
+		void removeAll() noexcept;
+
+		// returns the number of the removed entries
+		sl_size removeExpired() noexcept;
+
+		sl_size getCount() noexcept;
+
+		sl_uint64 getWeight() noexcept;
+
+		void getStatistics(CacheStatistics* _out) noexcept;
+
+		void resetStatistics() noexcept;
+
+	protected:
+		enum
+		{
+			QUEUE_WINDOW = 0,
+			QUEUE_PROBATION = 1,
+			QUEUE_PROTECTED = 2
+		};
+
+		// doubly linked list of the entries, from the most recently used (front) to the least (back)
+		struct Queue
+		{
+			ENTRY* front;
+			ENTRY* back;
+			sl_uint64 weight;
+
+			Queue() noexcept;
+
+			void pushFront(ENTRY* entry) noexcept;
+
+			void remove(ENTRY* entry) noexcept;
+
+			void moveToFront(ENTRY* entry) noexcept;
+		};
+
+		struct Shard
+		{
+			SpinLock lock;
+			FlatHashMap<KT, ENTRY*, HASH, KEY_EQUALS> map;
+			FlatHashMap< KT, Ref< CacheLoading<VT> >, HASH, KEY_EQUALS > loadings;
+
+			// LRU uses only the window
+			Queue window;
+			Queue probation;
+			Queue protect;
+			CacheFrequencySketch sketch;
+
+			sl_uint64 maxWeight;
+			sl_uint64 maxWindowWeight;
+			sl_uint64 maxProtectedWeight;
+
+			sl_uint64 hitCount;
+			sl_uint64 missCount;
+			sl_uint64 loadSuccessCount;
+			sl_uint64 loadFailureCount;
+			sl_uint64 evictionCount;
+			sl_uint64 expirationCount;
+
+			// keeps the locks of the neighboring shards out of this cache line
+			sl_uint8 _padding[64];
+
+			Shard(const HASH& hash, const KEY_EQUALS& key_equals) noexcept;
+		};
+
+	protected:
+		Shard& _getShard(sl_size hash) const noexcept;
+
+		sl_uint64 _getWeight(const KT& key, const VT& value) noexcept;
+
+		static sl_bool _isExpired(ENTRY* entry, sl_uint32 now) noexcept;
+
+		// the removed entries are chained to `garbage`, to be freed after the shard is unlocked
+		void _removeEntry(Shard& shard, ENTRY* entry, ENTRY*& garbage) noexcept;
+
+		static Queue& _getQueue(Shard& shard, ENTRY* entry) noexcept;
+
+		void _onAccess(Shard& shard, ENTRY* entry) noexcept;
+
+		template <class KEY, class VALUE>
+		sl_bool _put(Shard& shard, sl_size hash, sl_uint64 weight, KEY&& key, VALUE&& value, sl_uint32 timeToLive, ENTRY*& garbage) noexcept;
+
+		void _evict(Shard& shard, ENTRY*& garbage) noexcept;
+
+		static void _freeEntries(ENTRY* garbage) noexcept;
+
+	protected:
+		CacheParam m_param;
+		WEIGHER m_weigher;
+		HASH m_hash;
+		Shard* m_shards;
+		sl_uint32 m_shardsCount;
+		sl_uint32 m_shardsMask;
+
+	};
+
+}
+
+#include "detail/cache.inc"
+
+#endif
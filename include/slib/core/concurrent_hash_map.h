@@ -0,0 +1,116 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_CONCURRENT_HASH_MAP
+#define CHECKHEADER_SLIB_CORE_CONCURRENT_HASH_MAP
+
+#include "definition.h"
+
+#include "flat_hash_map.h"
+#include "spin_lock.h"
+#include "list.h"
+#include "pair.h"
+
+/*
+	Thread-safe hash map split into independently locked shards.
+
+	The shard of a key is chosen from its hash, and each shard is a FlatHashMap guarded by
+	a ReadWriteSpinLock, so lookups on any shard run in parallel and updates only serialize
+	with the operations on the same shard. Values are returned by copy: no pointer into
+	the map is exposed because another thread may move or remove the entry at any time.
+*/
+
+#define SLIB_CONCURRENT_HASH_MAP_DEFAULT_SHARDS 64
+
+namespace slib
+{
+
+	template < class KT, class VT, class HASH = Hash<KT>, class KEY_EQUALS = Equals<KT> >
+	class SLIB_EXPORT ConcurrentHashMap
+	{
+	public:
+		typedef FlatHashMap<KT, VT, HASH, KEY_EQUALS> SHARD_MAP;
+
+	public:
+		// `shardsCount` is rounded up to a power of two. 0 selects SLIB_CONCURRENT_HASH_MAP_DEFAULT_SHARDS
+		ConcurrentHashMap(sl_uint32 shardsCount = 0, const HASH& hash = HASH(), const KEY_EQUALS& key_equals = KEY_EQUALS()) noexcept;
+
+		ConcurrentHashMap(const ConcurrentHashMap& other) = delete;
+
+		~ConcurrentHashMap() noexcept;
+
+	public:
+		ConcurrentHashMap& operator=(const ConcurrentHashMap& other) = delete;
+
+	public:
+		sl_uint32 getShardsCount() const noexcept;
+
+		// sum of the shard counts, which may change while they are being added
+		sl_size getCount() const noexcept;
+
+		sl_bool isEmpty() const noexcept;
+
+		sl_bool isNotEmpty() const noexcept;
+
+		sl_bool find(const KT& key) const noexcept;
+
+		sl_bool get(const KT& key, VT* outValue = sl_null) const noexcept;
+
+		VT getValue(const KT& key) const noexcept;
+
+		VT getValue(const KT& key, const VT& def) const noexcept;
+
+		template <class KEY, class VALUE>
+		sl_bool put(KEY&& key, VALUE&& value, sl_bool* isInsertion = sl_null) noexcept;
+
+		template <class KEY, class VALUE>
+		sl_bool replace(const KEY& key, VALUE&& value) noexcept;
+
+		// returns `sl_true` when a new entry is inserted
+		template <class KEY, class... VALUE_ARGS>
+		sl_bool emplace(KEY&& key, VALUE_ARGS&&... value_args) noexcept;
+
+		// the removed value is destroyed after the shard is unlocked
+		sl_bool remove(const KT& key, VT* outValue = sl_null) noexcept;
+
+		sl_size removeAll() noexcept;
+
+		List<KT> getAllKeys() const noexcept;
+
+		List<VT> getAllValues() const noexcept;
+
+		List< Pair<KT, VT> > toList() const noexcept;
+
+	private:
+		struct Shard
+		{
+			ReadWriteSpinLock lock;
+			SHARD_MAP map;
+			// keeps the locks of the neighboring shards out of this cache line
+			sl_uint8 _padding[64];
+
+			Shard(const HASH& hash, const KEY_EQUALS& key_equals) noexcept;
+		};
+
+		Shard& _getShard(const KT& key) const noexcept;
+
+	private:
+		Shard* m_shards;
+		sl_uint32 m_shardsCount;
+		sl_uint32 m_shardsMask;
+		HASH m_hash;
+
+	};
+
+}
+
+#include "detail/concurrent_hash_map.inc"
+
+#endif
@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_CPU
+#define CHECKHEADER_SLIB_CORE_CPU
+
+#include "definition.h"
+
+/*
+	Instruction sets supported by the running processor, for choosing
+	the SIMD implementations at runtime.
+
+	The features are detected once, on the first call. AVX2 is reported
+	only when the operating system also saves the YMM registers.
+*/
+
+// marks the functions compiled for AVX2 in the translation units built without `-mavx2`
+#if defined(SLIB_COMPILER_IS_GCC) && (defined(SLIB_ARCH_IS_X64) || defined(SLIB_ARCH_IS_X86))
+#	define SLIB_TARGET_AVX2 __attribute__((target("avx2")))
+#	define SLIB_TARGET_SSSE3 __attribute__((target("ssse3")))
+#	define SLIB_TARGET_SSE41 __attribute__((target("sse4.1")))
+#else
+#	define SLIB_TARGET_AVX2
+#	define SLIB_TARGET_SSSE3
+#	define SLIB_TARGET_SSE41
+#endif
+
+namespace slib
+{
+
+	class SLIB_EXPORT Cpu
+	{
+	public:
+		static sl_bool isSupportingSSE2() noexcept;
+
+		static sl_bool isSupportingSSSE3() noexcept;
+
+		static sl_bool isSupportingSSE41() noexcept;
+
+		static sl_bool isSupportingAVX2() noexcept;
+
+		static sl_bool isSupportingNEON() noexcept;
+
+	};
+
+}
+
+#endif
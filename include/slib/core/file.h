@@ -147,6 +147,9 @@ namespace slib
 	
 		// works only if the file is already opened
 		sl_bool setSize(sl_uint64 size) override;
+		
+		// writes the buffered data and metadata of the file to the storage device
+		sl_bool flush();
 
 		sl_bool lock();
 
@@ -0,0 +1,217 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_FILE_BTREE
+#define CHECKHEADER_SLIB_CORE_FILE_BTREE
+
+#include "definition.h"
+
+#include "btree.h"
+#include "file.h"
+#include "hash_map.h"
+
+namespace slib
+{
+
+	class SLIB_EXPORT FilePageStorageParam
+	{
+	public:
+		// maximum number of pages kept in the page cache. Dirty pages are never evicted before commit
+		sl_uint32 cachePagesCount;
+
+		// reads clean pages from a read-only mapping of the data file (Unix only)
+		sl_bool flagUseMemoryMap;
+
+		// synchronizes the log and the data file to the storage device on every commit
+		sl_bool flagSynchronous;
+
+	public:
+		FilePageStorageParam();
+
+		~FilePageStorageParam();
+
+	};
+
+	/*
+		Stores fixed-size pages in a single file.
+
+		Page 0 is the header page. Modified pages stay in the page cache until `commit()`,
+		which appends their images to the write-ahead log ("<path>-wal"), synchronizes the log,
+		and then writes the pages into the data file. A committed log left by a crash is
+		replayed on the next `open()`, and an incomplete log is discarded.
+	*/
+	class SLIB_EXPORT FilePageStorage : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		FilePageStorage();
+
+		~FilePageStorage();
+
+	public:
+		// `signature` identifies the layout of the pages and must match the one used to create the file
+		static Ref<FilePageStorage> open(const String& filePath, sl_uint32 pageSize, sl_uint64 signature, const FilePageStorageParam& param);
+
+		static Ref<FilePageStorage> open(const String& filePath, sl_uint32 pageSize, sl_uint64 signature);
+
+	public:
+		String getFilePath();
+
+		sl_uint32 getPageSize();
+
+		sl_uint64 getPagesCount();
+
+		sl_uint64 getFreePagesCount();
+
+		sl_uint64 getRootPage();
+
+		void setRootPage(sl_uint64 index);
+
+		// returns 0 on failure
+		sl_uint64 allocatePage();
+
+		sl_bool freePage(sl_uint64 index);
+
+		// the returned pointer is valid until the next call on this storage
+		const sl_uint8* readPage(sl_uint64 index);
+
+		// marks the page as dirty and returns its cached image. the returned pointer is valid until the next call on this storage
+		sl_uint8* writePage(sl_uint64 index);
+
+		sl_bool commit();
+
+		void rollback();
+
+	protected:
+		struct PageSlot
+		{
+			sl_uint64 index; // 0: empty slot
+			sl_uint8* data;
+			sl_bool flagDirty;
+			sl_bool flagReferenced;
+		};
+
+		sl_bool _initialize();
+
+		sl_bool _readHeader();
+
+		void _writeHeader(sl_uint8* page);
+
+		sl_bool _replayLog();
+
+		sl_bool _applyLog(const sl_uint8* log, sl_size nPages);
+
+		PageSlot* _getSlot(sl_uint64 index);
+
+		PageSlot* _loadSlot(sl_uint64 index);
+
+		PageSlot* _allocateSlot();
+
+		void _freeSlots();
+
+		sl_bool _readPageFromFile(sl_uint64 index, sl_uint8* data);
+
+		void _mapFile();
+
+		void _unmapFile();
+
+	protected:
+		String m_path;
+		Ref<File> m_file;
+		Ref<File> m_fileLog;
+		sl_uint32 m_sizePage;
+		sl_uint64 m_signature;
+		FilePageStorageParam m_param;
+
+		sl_uint64 m_countPages;
+		sl_uint64 m_rootPage;
+		sl_uint64 m_freePageHead;
+		sl_uint64 m_countFreePages;
+		sl_bool m_flagHeaderDirty;
+		sl_uint64 m_countPagesInFile;
+
+		PageSlot* m_slots;
+		sl_size m_countSlots;
+		sl_size m_capacitySlots;
+		sl_size m_countDirtySlots;
+		sl_size m_indexClock;
+		CHashMap<sl_uint64, sl_size> m_mapSlots;
+
+		sl_uint8* m_mapData;
+		sl_size m_sizeMap;
+
+	};
+
+	/*
+		BTree whose nodes are stored in the pages of a FilePageStorage.
+
+		KT and VT must be trivially copyable types: keys and values are stored in their in-memory layout.
+		Modifications are made durable by `commit()`, which is also called on destruction.
+	*/
+	template < class KT, class VT, class KEY_COMPARE = Compare<KT> >
+	class SLIB_EXPORT FileBTree : public BTree<KT, VT, KEY_COMPARE>
+	{
+	public:
+		typedef typename BTree<KT, VT, KEY_COMPARE>::NodeData NodeData;
+
+	public:
+		FileBTree(const String& filePath, sl_uint32 order = SLIB_BTREE_DEFAULT_ORDER);
+
+		FileBTree(const String& filePath, const FilePageStorageParam& param, sl_uint32 order = SLIB_BTREE_DEFAULT_ORDER);
+
+		FileBTree(const String& filePath, const KEY_COMPARE& compare, const FilePageStorageParam& param, sl_uint32 order = SLIB_BTREE_DEFAULT_ORDER);
+
+		~FileBTree();
+
+	public:
+		sl_bool isOpened() const noexcept;
+
+		const Ref<FilePageStorage>& getStorage() const noexcept;
+
+		sl_bool commit();
+
+		void rollback();
+
+		static sl_uint32 getPageSize(sl_uint32 order) noexcept;
+
+	protected:
+		BTreeNode getRootNode() const override;
+
+		sl_bool setRootNode(BTreeNode node) override;
+
+		BTreeNode createNode(NodeData* data) override;
+
+		sl_bool deleteNode(BTreeNode node) override;
+
+		NodeData* readNodeData(const BTreeNode& node) const override;
+
+		sl_bool writeNodeData(const BTreeNode& node, NodeData* data) override;
+
+		void releaseNodeData(NodeData* data) override;
+
+	private:
+		void _open(const String& filePath, const FilePageStorageParam& param);
+
+		void _encodeNodeData(NodeData* data, sl_uint8* page);
+
+		sl_bool _decodeNodeData(const sl_uint8* page, NodeData* data) const;
+
+	private:
+		Ref<FilePageStorage> m_storage;
+		List<NodeData*> m_poolNodeData;
+
+	};
+
+}
+
+#include "detail/file_btree.inc"
+
+#endif
@@ -57,12 +57,58 @@ namespace slib
 #endif
 	}
 	
+	/*
+		HashBytes functions without `seed` use a random seed chosen once in each process, so that
+		the keys coming from the network can not be prepared to collide in the hash tables.
+		Pass a seed to get the same value in every process.
+	*/
 	sl_uint32 HashBytes32(const void* buf, sl_size n) noexcept;
 	
 	sl_uint64 HashBytes64(const void* buf, sl_size n) noexcept;
 	
 	sl_size HashBytes(const void* buf, sl_size n) noexcept;
 
+	sl_uint32 HashBytes32(const void* buf, sl_size n, sl_uint64 seed) noexcept;
+
+	sl_uint64 HashBytes64(const void* buf, sl_size n, sl_uint64 seed) noexcept;
+
+	sl_uint64 GetHashSeed() noexcept;
+
+#define SLIB_BYTES_HASHER_BUFFER_SIZE 1088
+
+	// computes HashBytes64() of the concatenated parts
+	class SLIB_EXPORT BytesHasher
+	{
+	public:
+		BytesHasher() noexcept;
+
+		BytesHasher(sl_uint64 seed) noexcept;
+
+	public:
+		void start() noexcept;
+
+		void start(sl_uint64 seed) noexcept;
+
+		void update(const void* buf, sl_size n) noexcept;
+
+		sl_uint64 finish() noexcept;
+
+	protected:
+		void _consumeStripes() noexcept;
+
+	protected:
+		sl_uint64 m_seed;
+		sl_uint64 m_sizeTotal;
+		sl_size m_sizeBuffer;
+		sl_size m_posConsumed;
+		sl_bool m_flagLong;
+		sl_uint32 m_nStripesInBlock;
+		sl_uint64 m_acc[8];
+		sl_uint8 m_secret[192];
+		sl_uint8 m_buffer[SLIB_BYTES_HASHER_BUFFER_SIZE];
+
+	};
+
 	template <>
 	class Hash<char>
 	{
@@ -42,6 +42,8 @@ namespace slib
 	template <class KT, class VT>
 	class SLIB_EXPORT HashMapNode
 	{
+		SLIB_DECLARE_MEMORY_OPERATORS
+
 	public:
 		HashMapNode* parent;
 		HashMapNode* left;
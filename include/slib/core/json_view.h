@@ -0,0 +1,199 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_JSON_VIEW
+#define CHECKHEADER_SLIB_CORE_JSON_VIEW
+
+#include "definition.h"
+
+#include "json.h"
+#include "memory.h"
+
+/*
+	On-demand access to JSON documents.
+
+	JsonDocument indexes the positions of the structural characters ({ } [ ] : , and the
+	starts of strings and literals) with SIMD instructions, validates the grammar, and links
+	each bracket to its closing pair. JsonView then reads only the values that are accessed:
+	skipping an object or an array is a single jump, and no String, List or Map is allocated
+	until a value is requested or `toJson()` is called.
+
+	Only standard JSON (RFC 8259) is accepted: comments, single-quoted strings and unquoted
+	keys, which Json::parseJson supports, are reported as errors. Strings and numbers are
+	decoded when they are read.
+*/
+
+namespace slib
+{
+
+	class JsonDocument;
+	class StringInterner;
+
+	class SLIB_EXPORT JsonView
+	{
+	public:
+		JsonView() noexcept;
+
+		JsonView(const JsonDocument* document, sl_uint32 index) noexcept;
+
+		JsonView(const JsonView& other) noexcept = default;
+
+	public:
+		JsonView& operator=(const JsonView& other) noexcept = default;
+
+		// returns the member value for objects
+		JsonView operator[](const String& key) const noexcept;
+
+		// returns the element for arrays
+		JsonView operator[](sl_size index) const noexcept;
+
+	public:
+		// `false` for the missing members and elements
+		sl_bool isValid() const noexcept;
+
+		// `true` for JSON null, and for the missing members and elements
+		sl_bool isNull() const noexcept;
+
+		sl_bool isNotNull() const noexcept;
+
+		sl_bool isObject() const noexcept;
+
+		sl_bool isArray() const noexcept;
+
+		sl_bool isString() const noexcept;
+
+		sl_bool isNumber() const noexcept;
+
+		sl_bool isBoolean() const noexcept;
+
+		String getString(const String& def) const noexcept;
+
+		String getString() const noexcept;
+
+		sl_int32 getInt32(sl_int32 def = 0) const noexcept;
+
+		sl_uint32 getUint32(sl_uint32 def = 0) const noexcept;
+
+		sl_int64 getInt64(sl_int64 def = 0) const noexcept;
+
+		sl_uint64 getUint64(sl_uint64 def = 0) const noexcept;
+
+		float getFloat(float def = 0) const noexcept;
+
+		double getDouble(double def = 0) const noexcept;
+
+		sl_bool getBoolean(sl_bool def = sl_false) const noexcept;
+
+		// the source text of the value
+		String getRawText() const noexcept;
+
+		JsonView getItem(const String& key) const noexcept;
+
+		JsonView getElement(sl_size index) const noexcept;
+
+		// number of members of an object, or elements of an array
+		sl_size getElementsCount() const noexcept;
+
+		// first member value of an object, or first element of an array
+		JsonView getFirstChild() const noexcept;
+
+		// next member value, or next element, within the same parent
+		JsonView getNextSibling() const noexcept;
+
+		// member name, when this view is a member value of an object
+		String getKey() const noexcept;
+
+		Json toJson() const noexcept;
+
+	protected:
+		sl_char8 _getFirstChar() const noexcept;
+
+		sl_bool _getNumberText(const sl_char8*& start, const sl_char8*& end) const noexcept;
+
+	protected:
+		const JsonDocument* m_document;
+		sl_uint32 m_index;
+
+		friend class JsonDocument;
+
+	};
+
+	class SLIB_EXPORT JsonDocument : public Referable
+	{
+		SLIB_DECLARE_OBJECT
+
+	public:
+		JsonDocument();
+
+		~JsonDocument();
+
+	public:
+		// `json` is referenced by the document without copying
+		static Ref<JsonDocument> parse(const String& json, JsonParseParam& param);
+
+		static Ref<JsonDocument> parse(const String& json);
+
+		// `mem` is referenced by the document without copying
+		static Ref<JsonDocument> parse(const Memory& mem, JsonParseParam& param);
+
+		static Ref<JsonDocument> parse(const Memory& mem);
+
+		static Ref<JsonDocument> parse(const sl_char8* sz, sl_size len, JsonParseParam& param);
+
+		static Ref<JsonDocument> parse(const sl_char8* sz, sl_size len);
+
+	public:
+		// views are valid while the document is alive
+		JsonView getRoot() const noexcept;
+
+		const sl_char8* getData() const noexcept;
+
+		sl_size getLength() const noexcept;
+
+		sl_uint32 getStructuralsCount() const noexcept;
+
+	protected:
+		static Ref<JsonDocument> _parse(const String& str, const Memory& mem, const sl_char8* sz, sl_size len, JsonParseParam& param);
+
+		sl_bool _buildIndex(String& errorMessage, sl_size& errorPosition);
+
+		sl_bool _validate(String& errorMessage, sl_size& errorPosition);
+
+		sl_uint32 _getEndOfValue(sl_uint32 index) const noexcept;
+
+		sl_size _getEndOfString(sl_size pos) const noexcept;
+
+		sl_size _getEndOfLiteral(sl_size pos) const noexcept;
+
+		String _getString(sl_size pos) const noexcept;
+
+		sl_bool _equalsKey(sl_size pos, const String& key) const noexcept;
+
+		Json _toJson(sl_uint32 index, StringInterner& keys) const noexcept;
+
+	protected:
+		String m_str;
+		Memory m_mem;
+		const sl_char8* m_data;
+		sl_size m_length;
+
+		// positions of the structural characters
+		sl_uint32* m_structurals;
+		sl_uint32 m_countStructurals;
+		// index of the matching closing bracket, for the opening brackets
+		sl_uint32* m_pairs;
+
+		friend class JsonView;
+
+	};
+
+}
+
+#endif
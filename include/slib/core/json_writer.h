@@ -0,0 +1,149 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_JSON_WRITER
+#define CHECKHEADER_SLIB_CORE_JSON_WRITER
+
+#include "definition.h"
+
+#include "json.h"
+#include "memory.h"
+#include "function.h"
+
+/*
+	Streaming JSON serializer.
+
+	JsonWriter formats the values into fixed-size chunks and hands each chunk to the output
+	as soon as it is full, so serializing a large Variant never builds the whole text in one
+	String. The chunks are passed by reference to MemoryQueue and to the chunk callbacks
+	(no copy), and written to IWriter outputs.
+
+	The output is compact standard JSON (RFC 8259):
+		- strings are escaped with \" \\ \b \f \n \r \t and \u00XX for the other control characters
+		- floating point numbers use the shortest digits (Grisu2) that read back to the same value
+		- NaN and infinity, which JSON cannot represent, are written as null
+*/
+
+#define SLIB_JSON_WRITER_DEFAULT_CHUNK_SIZE 16384
+
+// required size of the buffers passed to the number formatting functions
+#define SLIB_JSON_WRITER_NUMBER_BUFFER_SIZE 32
+
+namespace slib
+{
+
+	class IWriter;
+	class MemoryQueue;
+
+	class SLIB_EXPORT JsonWriter
+	{
+	public:
+		JsonWriter(IWriter* writer, sl_size chunkSize = SLIB_JSON_WRITER_DEFAULT_CHUNK_SIZE) noexcept;
+
+		JsonWriter(MemoryQueue* queue, sl_size chunkSize = SLIB_JSON_WRITER_DEFAULT_CHUNK_SIZE) noexcept;
+
+		JsonWriter(const Function<void(const Memory&)>& onChunk, sl_size chunkSize = SLIB_JSON_WRITER_DEFAULT_CHUNK_SIZE) noexcept;
+
+		// flushes the remaining output
+		~JsonWriter() noexcept;
+
+	public:
+		sl_bool write(const Variant& value) noexcept;
+
+		// the following functions build the values piece by piece. Commas are inserted automatically
+		sl_bool beginObject() noexcept;
+
+		sl_bool endObject() noexcept;
+
+		sl_bool beginArray() noexcept;
+
+		sl_bool endArray() noexcept;
+
+		// writes a member name. The next call writes the member value
+		sl_bool writeKey(const String& key) noexcept;
+
+		sl_bool writeKey(const sl_char8* key, sl_size length) noexcept;
+
+		sl_bool writeNull() noexcept;
+
+		sl_bool writeBoolean(sl_bool value) noexcept;
+
+		sl_bool writeInt32(sl_int32 value) noexcept;
+
+		sl_bool writeUint32(sl_uint32 value) noexcept;
+
+		sl_bool writeInt64(sl_int64 value) noexcept;
+
+		sl_bool writeUint64(sl_uint64 value) noexcept;
+
+		sl_bool writeFloat(float value) noexcept;
+
+		sl_bool writeDouble(double value) noexcept;
+
+		sl_bool writeString(const String& value) noexcept;
+
+		sl_bool writeString(const sl_char8* value, sl_size length) noexcept;
+
+		// writes already formatted JSON text as a value
+		sl_bool writeRaw(const sl_char8* json, sl_size length) noexcept;
+
+		// passes the buffered output to the destination
+		sl_bool flush() noexcept;
+
+		sl_bool isError() const noexcept;
+
+		// total bytes of the formatted output, including the buffered bytes
+		sl_uint64 getOutputSize() const noexcept;
+
+	public:
+		// The functions below write to `buf` (at least SLIB_JSON_WRITER_NUMBER_BUFFER_SIZE bytes) and return the end of the text
+		static sl_char8* formatUint64(sl_char8* buf, sl_uint64 value) noexcept;
+
+		static sl_char8* formatInt64(sl_char8* buf, sl_int64 value) noexcept;
+
+		// NaN and infinity are formatted as `null`
+		static sl_char8* formatDouble(sl_char8* buf, double value) noexcept;
+
+		static sl_char8* formatFloat(sl_char8* buf, float value) noexcept;
+
+	protected:
+		void _init(sl_size chunkSize) noexcept;
+
+		sl_bool _prepareValue() noexcept;
+
+		sl_bool _reserve(sl_size size) noexcept;
+
+		sl_bool _flushChunk() noexcept;
+
+		sl_bool _writeBytes(const void* data, sl_size size) noexcept;
+
+		sl_bool _writeEscapedString(const sl_char8* str, sl_size length) noexcept;
+
+		sl_bool _writeVariant(const Variant& value) noexcept;
+
+	protected:
+		IWriter* m_writer;
+		MemoryQueue* m_queue;
+		Function<void(const Memory&)> m_onChunk;
+
+		Memory m_chunk;
+		sl_char8* m_buf;
+		sl_size m_sizeChunk;
+		sl_size m_pos;
+		sl_uint64 m_sizeFlushed;
+
+		sl_bool m_flagNeedComma;
+		sl_bool m_flagError;
+
+	};
+
+}
+
+#endif
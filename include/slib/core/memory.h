@@ -148,7 +148,7 @@ namespace slib
 	
 	
 	// MemoryBuffer is not thread-safe
-	class SLIB_EXPORT MemoryBuffer : public Object
+	class SLIB_EXPORT MemoryBuffer : public LightObject
 	{
 	public:
 		MemoryBuffer();
@@ -176,7 +176,7 @@ namespace slib
 
 	};
 	
-	class SLIB_EXPORT MemoryQueue : public Object
+	class SLIB_EXPORT MemoryQueue : public LightObject
 	{
 	public:
 		MemoryQueue();
@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_MEMORY_ALLOCATOR
+#define CHECKHEADER_SLIB_CORE_MEMORY_ALLOCATOR
+
+#include "definition.h"
+
+/*
+	Allocator behind Base::createMemory, Base::reallocMemory and Base::freeMemory.
+
+	The system allocator (malloc) is used by default. The pooled allocator serves the blocks up to
+	SLIB_MEMORY_ALLOCATOR_MAX_POOLED_SIZE from 64KB slabs split into size classes. Each thread keeps
+	its own free lists, so most allocations and frees take no lock, and the blocks move between the
+	threads and the shared lists in batches. Larger blocks are passed to the system allocator.
+
+	Switch the allocator once, at the start of `main()` before other threads are started:
+
+		MemoryAllocator::setDefault(MemoryAllocator::getPooled());
+
+	The memory allocated before the switch is still freed correctly, because an allocator passes
+	the pointers it does not own to the system allocator. Switching back is not supported.
+*/
+
+#define SLIB_MEMORY_ALLOCATOR_SIZE_CLASSES_COUNT 20
+#define SLIB_MEMORY_ALLOCATOR_MAX_POOLED_SIZE 1024
+
+namespace slib
+{
+
+	class SLIB_EXPORT MemorySizeClassStatistics
+	{
+	public:
+		sl_size blockSize;
+		// total count of the allocated blocks
+		sl_uint64 countAllocated;
+		// count of the blocks not freed yet
+		sl_uint64 countLive;
+
+	};
+
+	class SLIB_EXPORT MemoryAllocatorStatistics
+	{
+	public:
+		sl_uint32 countSizeClasses;
+		MemorySizeClassStatistics sizeClasses[SLIB_MEMORY_ALLOCATOR_SIZE_CLASSES_COUNT];
+
+		// allocations passed to the system allocator
+		sl_uint64 countLargeAllocated;
+		sl_uint64 sizeLargeAllocated;
+
+		// memory taken from the system for the slabs
+		sl_uint64 sizeReserved;
+
+		sl_uint32 countThreadCaches;
+
+	public:
+		MemoryAllocatorStatistics() noexcept;
+
+	public:
+		sl_uint64 getLiveBlocksCount() const noexcept;
+
+		sl_uint64 getLiveBlocksSize() const noexcept;
+
+	};
+
+	class SLIB_EXPORT MemoryAllocator
+	{
+	public:
+		constexpr MemoryAllocator() noexcept {}
+
+		virtual ~MemoryAllocator() noexcept;
+
+	public:
+		virtual void* createMemory(sl_size size) noexcept = 0;
+
+		virtual void* reallocMemory(void* ptr, sl_size sizeNew) noexcept = 0;
+
+		// must also accept the pointers allocated by the system allocator
+		virtual void freeMemory(void* ptr) noexcept = 0;
+
+		// counters are read without stopping the other threads, so they are approximate
+		virtual sl_bool getStatistics(MemoryAllocatorStatistics& statistics) noexcept;
+
+	public:
+		static MemoryAllocator* getDefault() noexcept;
+
+		static void setDefault(MemoryAllocator* allocator) noexcept;
+
+		static MemoryAllocator* getSystem() noexcept;
+
+		static MemoryAllocator* getPooled() noexcept;
+
+	};
+
+}
+
+#endif
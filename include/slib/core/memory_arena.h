@@ -0,0 +1,119 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_MEMORY_ARENA
+#define CHECKHEADER_SLIB_CORE_MEMORY_ARENA
+
+#include "definition.h"
+
+/*
+	Region allocation for the objects living as long as a request or a frame.
+
+	MemoryArena hands out blocks by moving a cursor through large chunks, and frees all of them
+	at once in `reset()` or in the destructor. While an ArenaScope is alive, Base::createMemory
+	on the same thread allocates from its arena, so String, Memory, List, Map, HashMap, Variant
+	and the other Referable objects created in the scope are placed in the arena. Freeing a block
+	of an arena is a no-op; the destructors of the objects still run as usual.
+
+		{
+			MemoryArena arena;
+			ArenaScope scope(&arena);
+			... handle the request ...
+		}
+
+	All the objects created in the scope must be released before the arena is reset or destroyed,
+	so the results kept after the request should be created in an `ArenaScope(sl_null)`, which
+	suspends the arena. The static objects initialized by SLIB_SAFE_STATIC, the global string
+	atoms and the weak reference blocks are always allocated outside of the arenas, but other
+	long-lived caches filled in the scope are not.
+
+	An arena is used by one thread at a time. The blocks may be released on other threads, but
+	they must not be reallocated there.
+*/
+
+#define SLIB_MEMORY_ARENA_DEFAULT_CHUNK_SIZE 0x10000
+
+namespace slib
+{
+
+	class SLIB_EXPORT MemoryArena
+	{
+	public:
+		MemoryArena(sl_size sizeChunk = SLIB_MEMORY_ARENA_DEFAULT_CHUNK_SIZE) noexcept;
+
+		MemoryArena(const MemoryArena& other) = delete;
+
+		~MemoryArena() noexcept;
+
+	public:
+		MemoryArena& operator=(const MemoryArena& other) = delete;
+
+	public:
+		// returned blocks are aligned to 16 bytes
+		void* allocate(sl_size size) noexcept;
+
+		// grows the last allocated block in place when the chunk has room
+		void* reallocate(void* ptr, sl_size sizeNew) noexcept;
+
+		// frees all the blocks, and keeps the first chunk for the next use
+		void reset() noexcept;
+
+		// total size of the blocks allocated after the last reset
+		sl_size getAllocatedSize() const noexcept;
+
+		// total size of the chunks taken from the system
+		sl_size getReservedSize() const noexcept;
+
+	public:
+		static sl_bool isArenaMemory(const void* ptr) noexcept;
+
+		// returns the arena owning the block allocated by `allocate()`
+		static MemoryArena* getArena(const void* ptr) noexcept;
+
+	protected:
+		sl_bool _createChunk(sl_size sizeMinimum) noexcept;
+
+		void _freeChunks(sl_bool flagKeepFirst) noexcept;
+
+	protected:
+		void* m_chunks;
+		sl_uint8* m_cursor;
+		sl_uint8* m_end;
+		sl_uint8* m_lastBlock;
+		sl_size m_sizeChunk;
+		sl_size m_sizeAllocated;
+		sl_size m_sizeReserved;
+
+	};
+
+	class SLIB_EXPORT ArenaScope
+	{
+	public:
+		// `sl_null` suspends the current arena until the scope ends
+		ArenaScope(MemoryArena* arena) noexcept;
+
+		ArenaScope(const ArenaScope& other) = delete;
+
+		~ArenaScope() noexcept;
+
+	public:
+		ArenaScope& operator=(const ArenaScope& other) = delete;
+
+	public:
+		static MemoryArena* getCurrent() noexcept;
+
+	protected:
+		MemoryArena* m_arenaPrevious;
+
+	};
+
+}
+
+#endif
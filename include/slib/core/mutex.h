@@ -40,12 +40,15 @@ namespace slib
 		Mutex& operator=(Mutex&& other) noexcept;
 		
 	private:
+		// created on the first lock
 		mutable void* m_pObject;
 
 	private:
-		void _init() noexcept;
+		void* _getObject() const noexcept;
 
-		void _free() noexcept;
+		static void* _createObject() noexcept;
+
+		static void _freeObject(void* object) noexcept;
 
 	};
 	
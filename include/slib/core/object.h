@@ -62,6 +62,39 @@ namespace slib
 
 	};
 	
+	// Object without the property map, for the small objects created in large numbers
+	class SLIB_EXPORT LightObject : public Referable
+	{
+		SLIB_DECLARE_OBJECT
+
+	public:
+		LightObject() noexcept;
+		
+		LightObject(const LightObject& other) = delete;
+		
+		LightObject(LightObject&& other) = delete;
+
+		~LightObject() noexcept;
+
+	public:
+		Mutex* getLocker() const noexcept;
+
+		void lock() const noexcept;
+	
+		void unlock() const noexcept;
+	
+		sl_bool tryLock() const noexcept;
+		
+	public:
+		LightObject& operator=(const LightObject& other) = delete;
+		
+		LightObject& operator=(LightObject&& other) = delete;
+	
+	private:
+		Mutex m_locker;
+
+	};
+	
 	class SLIB_EXPORT ObjectLocker : public MutexLocker
 	{
 	public:
@@ -71,6 +104,10 @@ namespace slib
 	
 		ObjectLocker(const Object* object1, const Object* object2) noexcept;
 
+		ObjectLocker(const LightObject* object) noexcept;
+	
+		ObjectLocker(const LightObject* object1, const LightObject* object2) noexcept;
+
 		~ObjectLocker() noexcept;
 
 	public:
@@ -78,6 +115,10 @@ namespace slib
 
 		void lock(const Object* object1, const Object* object2) noexcept;
 
+		void lock(const LightObject* object) noexcept;
+
+		void lock(const LightObject* object1, const LightObject* object2) noexcept;
+
 	};
 
 }
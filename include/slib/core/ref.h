@@ -30,6 +30,8 @@ namespace slib
 	
 	class SLIB_EXPORT Referable
 	{
+		SLIB_DECLARE_MEMORY_OPERATORS
+
 	public:
 		Referable() noexcept;
 
@@ -83,8 +85,8 @@ namespace slib
 	private:
 		sl_reg m_nRefCount;
 		sl_bool m_flagWeakRef;
+		// created on the first weak reference
 		CWeakRef* m_weak;
-		SpinLock m_lockWeak;
 
 		friend class CWeakRef;
 		
@@ -14,6 +14,7 @@
 #include "definition.h"
 
 #include "spin_lock.h"
+#include "memory_arena.h"
 
 #include <new>
 
@@ -40,6 +41,7 @@
 	if (_static_safeflag_##NAME == 0) { \
 		_static_safelock_##NAME.lock(); \
 		if (_static_safeflag_##NAME == 0) { \
+			slib::ArenaScope _static_safearena_##NAME(sl_null); \
 			new (&NAME) TYPE(__VA_ARGS__); \
 			_static_safeflag_##NAME = 1; \
 		} \
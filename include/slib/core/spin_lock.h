@@ -21,7 +21,7 @@ namespace slib
 	public:
 		constexpr SpinLock() noexcept: m_flagLock(0) {}
 
-		constexpr SpinLock(const SpinLock& other) noexcept: m_flagLock(0) {}
+		constexpr SpinLock(const SpinLock&) noexcept: m_flagLock(0) {}
 
 	public:
 		void lock() const noexcept;
@@ -31,7 +31,7 @@ namespace slib
 		void unlock() const noexcept;
 	
 	public:
-		SpinLock& operator=(const SpinLock& other) noexcept;
+		SpinLock& operator=(const SpinLock&) noexcept;
 	
 	private:
 		sl_int32 m_flagLock;
@@ -73,6 +73,69 @@ namespace slib
 		
 	};
 	
+	/*
+		Spin lock shared by any number of readers (up to 2^20) or held by one writer.
+		Waiting writers are counted, and block new readers until all of them have acquired the lock,
+		so writers are not starved by a stream of readers. Writers are not ordered among themselves.
+	*/
+	class SLIB_EXPORT ReadWriteSpinLock
+	{
+	public:
+		constexpr ReadWriteSpinLock() noexcept: m_state(0) {}
+		
+		constexpr ReadWriteSpinLock(const ReadWriteSpinLock&) noexcept: m_state(0) {}
+		
+	public:
+		void lockRead() const noexcept;
+		
+		sl_bool tryLockRead() const noexcept;
+		
+		void unlockRead() const noexcept;
+		
+		void lockWrite() const noexcept;
+		
+		sl_bool tryLockWrite() const noexcept;
+		
+		void unlockWrite() const noexcept;
+		
+	public:
+		ReadWriteSpinLock& operator=(const ReadWriteSpinLock&) noexcept;
+		
+	private:
+		sl_int32 m_state;
+		
+	};
+	
+	class SLIB_EXPORT ReadSpinLocker
+	{
+	public:
+		ReadSpinLocker(const ReadWriteSpinLock* lock) noexcept;
+		
+		~ReadSpinLocker() noexcept;
+		
+	public:
+		void unlock() noexcept;
+		
+	private:
+		const ReadWriteSpinLock* m_lock;
+		
+	};
+	
+	class SLIB_EXPORT WriteSpinLocker
+	{
+	public:
+		WriteSpinLocker(const ReadWriteSpinLock* lock) noexcept;
+		
+		~WriteSpinLocker() noexcept;
+		
+	public:
+		void unlock() noexcept;
+		
+	private:
+		const ReadWriteSpinLock* m_lock;
+		
+	};
+	
 #define SLIB_SPINLOCK_POOL_SIZE 971
 	
 	template <int CATEGORY>
@@ -37,6 +37,12 @@ namespace slib
 	class StringData;
 	class Variant;
 
+	/*
+		Short strings are not stored inline (no small-string optimization), and String stays a single StringContainer pointer:
+		Variant constructs Strings in its 8-byte value slot, Atomic<String> swaps the container pointer under its spin lock,
+		and the pointer returned by getData() must stay valid while any copy of the string is alive.
+		Repeated short strings can share one container through StringInterner instead.
+	*/
 	class SLIB_EXPORT StringContainer
 	{
 	public:
@@ -1214,6 +1220,7 @@ namespace slib
 		
 	public:
 		friend class Atomic<String>;
+		friend class StringInterner;
 		
 	};
 	
@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_STRING_INTERNER
+#define CHECKHEADER_SLIB_CORE_STRING_INTERNER
+
+#include "definition.h"
+
+#include "string.h"
+#include "spin_lock.h"
+
+/*
+	Table of unique strings (atoms).
+
+	Interning the same text twice returns the same string container, so repeated keys share
+	one allocation, equal atoms compare by pointer, and their hash codes are computed once.
+
+	The global interner never frees its atoms, and copying or releasing them does not touch
+	the reference count. Only bounded sets of strings (names, keywords, known header fields)
+	should be added to it; use a local instance for the strings coming from the input.
+*/
+
+namespace slib
+{
+
+	class SLIB_EXPORT StringInterner
+	{
+	public:
+		// `flagThreadSafe`: set `sl_false` for the instances used by one thread only
+		StringInterner(sl_bool flagThreadSafe = sl_true) noexcept;
+
+		StringInterner(const StringInterner& other) = delete;
+
+		~StringInterner() noexcept;
+
+	public:
+		StringInterner& operator=(const StringInterner& other) = delete;
+
+	public:
+		static StringInterner* getGlobal() noexcept;
+
+	public:
+		String intern(const sl_char8* sz, sl_size len) noexcept;
+
+		String intern(const String& str) noexcept;
+
+		// returns null if the text is not interned
+		String find(const sl_char8* sz, sl_size len) const noexcept;
+
+		String find(const String& str) const noexcept;
+
+		sl_size getCount() const noexcept;
+
+	protected:
+		StringInterner(sl_bool flagThreadSafe, sl_bool flagImmortal) noexcept;
+
+		StringContainer* _find(const sl_char8* sz, sl_size len, sl_size hash) const noexcept;
+
+		sl_bool _insert(StringContainer* container) noexcept;
+
+	protected:
+		StringContainer** m_table;
+		sl_size m_capacity;
+		sl_size m_count;
+		sl_bool m_flagThreadSafe;
+		sl_bool m_flagImmortal;
+		ReadWriteSpinLock m_lock;
+
+	};
+
+}
+
+#endif
@@ -59,6 +59,9 @@ namespace slib
 		static void yield();
 
 		static void yield(sl_uint32 elapsed);
+
+		// number of online logical processors (at least 1)
+		static sl_uint32 getProcessorsCount();
 	
 
 		static void abort(const String& msg, const String& file, sl_uint32 line);
@@ -16,6 +16,11 @@
 #include "queue.h"
 #include "thread.h"
 #include "dispatch.h"
+#include "spin_lock.h"
+#include "time.h"
+
+#define SLIB_THREAD_POOL_TIMER_SLOTS 512
+#define SLIB_THREAD_POOL_TIMER_TICK 4 // milliseconds
 
 namespace slib
 {
@@ -42,18 +47,129 @@ namespace slib
 		sl_bool addTask(const Function<void()>& task);
 
 		sl_bool dispatch(const Function<void()>& callback, sl_uint64 delay_ms = 0) override;
+		
+		// tasks waiting in the injection queue and in the queues of the workers
+		sl_size getQueuedTasksCount();
+		
+		// tasks waiting for their delay to be expired
+		sl_size getDelayedTasksCount();
+		
+		sl_uint32 getParkedThreadsCount();
+
+		// tasks taken by a worker from the queue of another worker
+		sl_uint64 getStolenTasksCount();
+		
+		// accumulated time spent by the workers while parked
+		sl_uint64 getParkedMilliseconds();
 	
 	public:
 		SLIB_PROPERTY(sl_uint32, MinimumThreadsCount)
 		SLIB_PROPERTY(sl_uint32, MaximumThreadsCount)
 		SLIB_PROPERTY(sl_uint32, ThreadStackSize)
+		// milliseconds that an extra worker (above the minimum) stays parked before exiting
+		SLIB_PROPERTY(sl_uint32, IdleTimeout)
 	
 	protected:
-		void onRunWorker();
+		class TaskQueue
+		{
+		public:
+			TaskQueue();
+
+			~TaskQueue();
+
+		public:
+			sl_size getCount();
+
+			sl_bool pushBack(const Function<void()>& task);
+
+			sl_bool popBack(Function<void()>* _out);
+
+			sl_bool popFront(Function<void()>* _out);
+
+			void removeAll();
+
+		protected:
+			Function<void()>* m_tasks;
+			sl_size m_capacity;
+			sl_size m_first;
+			sl_size m_count;
+			SpinLock m_lock;
+
+		};
+
+		class Worker
+		{
+		public:
+			sl_uint32 index;
+			Ref<Thread> thread;
+			Ref<Event> eventWake;
+			TaskQueue tasks;
+			sl_int32 flagParked;
+			sl_uint32 seed;
+
+		public:
+			Worker();
+
+		};
+
+		struct DelayedTask
+		{
+			sl_uint64 tick;
+			Function<void()> task;
+			DelayedTask* next;
+		};
+		
+	protected:
+		void onRunWorker(Worker* worker);
+
+		void onRunTimer();
 	
 	protected:
-		CList< Ref<Thread> > m_threadWorkers;
-		LinkedQueue< Function<void()> > m_tasks;
+		sl_bool _initWorkers();
+
+		sl_bool _findTask(Worker* worker, Function<void()>* _out);
+
+		sl_bool _hasTasks();
+
+		sl_bool _park(Worker* worker, sl_int32 timeout);
+
+		// returns sl_false if the worker was already unparked by `_unparkWorker`
+		sl_bool _removeParked(Worker* worker);
+
+		sl_bool _unparkWorker();
+
+		sl_bool _startWorker();
+
+		sl_bool _addDelayedTask(const Function<void()>& task, sl_uint64 delay_ms);
+
+		void _processTimerWheel(sl_uint64 tickNow);
+
+		sl_int32 _getTimerTimeout();
+
+		void _clearDelayedTasks();
+		
+	protected:
+		Worker* m_workers;
+		sl_uint32 m_nWorkers;
+		sl_uint32 m_nThreads;
+		
+		TaskQueue m_tasks;
+		
+		sl_uint32* m_parkedWorkers;
+		sl_int32 m_nParkedWorkers;
+		SpinLock m_lockParkedWorkers;
+
+		DelayedTask* m_timerSlots[SLIB_THREAD_POOL_TIMER_SLOTS];
+		sl_uint64 m_tickTimer;
+		sl_uint64 m_tickTimerNext;
+		sl_size m_nDelayedTasks;
+		Mutex m_lockTimer;
+		Ref<Thread> m_threadTimer;
+		Ref<Event> m_eventTimer;
+		TimeCounter m_timeCounter;
+		
+		sl_int64 m_nStolenTasks;
+		sl_int64 m_nParkedMilliseconds;
 	
 		sl_bool m_flagRunning;
 
@@ -22,7 +22,7 @@ namespace slib
 	class DispatchLoop;
 	class Dispatcher;
 	
-	class SLIB_EXPORT Timer : public Object
+	class SLIB_EXPORT Timer : public LightObject
 	{
 		SLIB_DECLARE_OBJECT
 
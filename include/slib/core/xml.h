@@ -20,7 +20,8 @@
  XML 1.1 => http://www.w3.org/TR/2006/REC-xml11-20060816/
  
  
- Supports DOM & SAX parsers
+ Supports DOM & SAX parsers, and incremental SAX parsing of
+ UTF-8 streams (XmlStreamParser)
  
 ************************************************************/
 
@@ -28,6 +29,7 @@
 
 #include "variant.h"
 #include "ptr.h"
+#include "function.h"
 
 namespace slib
 {
@@ -40,6 +42,8 @@ namespace slib
 	class XmlComment;
 	class XmlParseControl;
 	class StringBuffer;
+	class IReader;
+	class AsyncStream;
 	
 	enum class XmlNodeType
 	{
@@ -516,6 +520,51 @@ namespace slib
 
 	};
 	
+	/*
+		Incremental SAX parser for UTF-8 XML streams.
+
+		The document is fed in chunks of any size and the events of `XmlParseParam::listener`
+		are emitted as soon as each markup is complete. Only the unfinished markup and the stack
+		of open elements are kept in memory, so the memory usage does not grow with the document size.
+		No XmlDocument is built: the events receive stand-alone nodes, and the `XmlParseControl`
+		passed to the listener only supports `flagStopParsing` (`parsingPosition` is the offset in the stream).
+	*/
+	class SLIB_EXPORT XmlStreamParser : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		XmlStreamParser();
+
+		~XmlStreamParser();
+
+	public:
+		static Ref<XmlStreamParser> create(const XmlParseParam& param);
+
+	public:
+		// returns `false` when the document has an error or the listener stopped parsing
+		virtual sl_bool parse(const void* data, sl_size size) = 0;
+
+		// notifies the end of the stream and checks that the document is complete
+		virtual sl_bool end() = 0;
+
+		virtual sl_bool isError() = 0;
+
+		virtual sl_bool isEnded() = 0;
+
+		// error information is stored in the output fields
+		virtual XmlParseParam& getParam() = 0;
+
+		String getErrorText();
+
+		// reads `stream` in background until its end, and calls `onEnd` on completion or error
+		virtual sl_bool parseFromAsyncStream(const Ref<AsyncStream>& stream, const Function<void(XmlStreamParser*)>& onEnd, sl_uint32 sizeChunk = 0) = 0;
+
+		// reads `reader` until the end of the stream
+		sl_bool parseFromReader(const Ptr<IReader>& reader, sl_uint32 sizeChunk = 0);
+
+	};
+	
 	/**
 	 * @class Xml
 	 * @brief provides utilities for parsing and build XML.
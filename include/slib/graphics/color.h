@@ -322,6 +322,25 @@ namespace slib
 		void convertPAtoNPA() noexcept;
 
 
+		/*
+			The functions for the rows of pixels. The alpha is the last byte of the pixels, so they also work on BGRA pixels.
+			`dst` may be same as `src`.
+		*/
+
+		static void convertNPAtoPA(Color* dst, const Color* src, sl_size count) noexcept;
+
+		static void convertPAtoNPA(Color* dst, const Color* src, sl_size count) noexcept;
+
+		// converts between RGBA and BGRA
+		static void swapRedBlue(Color* dst, const Color* src, sl_size count) noexcept;
+
+		// assume that dst is premultiplied alpha, and src is non-premultiplied alpha
+		static void blend_PA_NPA(Color* dst, const Color* src, sl_size count) noexcept;
+
+		// assume that dst is premultiplied alpha, and src is premultiplied alpha
+		static void blend_PA_PA(Color* dst, const Color* src, sl_size count) noexcept;
+
+
 		String toString() const noexcept;
 
 
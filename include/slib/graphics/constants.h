@@ -97,6 +97,10 @@ namespace slib
 		Nearest = 0,
 		Linear = 1,
 		Box = 2,
+		// separable filters, see `Image::resample()`
+		Bicubic = 3, // Catmull-Rom
+		Mitchell = 4, // Mitchell-Netravali (B = C = 1/3)
+		Lanczos = 5, // Lanczos3
 		
 		Default = Box
 	};
@@ -20,10 +20,13 @@
 #include "../core/object.h"
 #include "../core/memory.h"
 #include "../core/string.h"
+#include "../core/function.h"
 
 namespace slib
 {
 	
+	class ThreadPool;
+
 	class SLIB_EXPORT ImageDesc
 	{
 	public:
@@ -41,6 +44,29 @@ namespace slib
 
 	};
 	
+	// parameters of the streaming decoding, see `Image::decode()`
+	class SLIB_EXPORT ImageDecodeParam
+	{
+	public:
+		// JPEG is decoded at the smallest DCT scale (1/8 to 1) keeping the image at least this size. 0 means the original size
+		sl_uint32 minimumWidth;
+		sl_uint32 minimumHeight;
+		// size of the tiles passed to `onTile`. 0 means the whole width, and the default band height
+		sl_uint32 tileWidth;
+		sl_uint32 tileHeight;
+
+		// called once, with the size of the decoded image, before any tile. returning false cancels the decoding
+		Function<sl_bool(sl_uint32 width, sl_uint32 height)> onStart;
+		// called for the tiles in the row-major order. the colors are valid only during the call. returning false cancels the decoding
+		Function<sl_bool(sl_uint32 x, sl_uint32 y, const ImageDesc& tile)> onTile;
+
+	public:
+		ImageDecodeParam();
+
+		~ImageDecodeParam();
+
+	};
+
 	class SLIB_EXPORT Image : public Bitmap
 	{
 		SLIB_DECLARE_OBJECT
@@ -110,6 +136,12 @@ namespace slib
 
 		static void draw(ImageDesc& dst, const ImageDesc& src, BlendMode blend = BlendMode::Copy, StretchMode stretch = StretchMode::Default);
 
+		// resamples by the separable filters (Bicubic, Mitchell, Lanczos); other modes are drawn by `draw()`
+		static void resample(ImageDesc& dst, const ImageDesc& src, StretchMode stretch, BlendMode blend = BlendMode::Copy);
+
+		// large images are split into row bands, processed in parallel on `threadPool`
+		static void resample(ImageDesc& dst, const ImageDesc& src, StretchMode stretch, BlendMode blend, const Ref<ThreadPool>& threadPool);
+
 		void drawImage(sl_int32 dx, sl_int32 dy, sl_int32 dw, sl_int32 dh,
 					   const Ref<Image>& src, sl_int32 sx, sl_int32 sy, sl_int32 sw, sl_int32 sh,
 					   BlendMode blend = BlendMode::Copy, StretchMode stretch = StretchMode::Default);
@@ -129,6 +161,8 @@ namespace slib
 
 		Ref<Image> scale(sl_uint32 width, sl_uint32 height, StretchMode stretch = StretchMode::Default) const;
 
+		Ref<Image> scale(sl_uint32 width, sl_uint32 height, StretchMode stretch, const Ref<ThreadPool>& threadPool) const;
+
 		Ref<Image> scaleToSmall(sl_uint32 requiredWidth, sl_uint32 requiredHeight, StretchMode stretch = StretchMode::Default) const;
 
 
@@ -143,6 +177,14 @@ namespace slib
 		static Ref<Image> loadFromFile(const String& filePath, sl_uint32 width = 0, sl_uint32 height = 0);
 
 		static Ref<Image> loadFromAsset(const String& path, sl_uint32 width = 0, sl_uint32 height = 0);
+
+
+		// decodes JPEG and PNG band by band, keeping only one band of the image in memory
+		static sl_bool decode(const void* content, sl_size size, const ImageDecodeParam& param);
+
+		static sl_bool decodePNG(const void* content, sl_size size, const ImageDecodeParam& param);
+
+		static sl_bool decodeJPEG(const void* content, sl_size size, const ImageDecodeParam& param);
 	
 		
 		static Ref<Image> loadFromPNG(const void* content, sl_size size);
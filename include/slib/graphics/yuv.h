@@ -23,6 +23,18 @@ namespace slib
 
 		static void convertYUVToRGB(sl_uint8 Y, sl_uint8 U, sl_uint8 V, sl_uint8& R, sl_uint8& G, sl_uint8& B);
 
+		/*
+			Converts a row of the 4:2:0 image into 4-byte pixels (RGBA, or BGRA when `flagBGRA` is set) with opaque alpha.
+			Two neighboring pixels share a chroma sample, and `strideUV` is the distance in bytes between the chroma samples (1: I420/YV12, 2: NV12/NV21).
+		*/
+		static void convertYUV420ToRGBA(const sl_uint8* Y, const sl_uint8* U, const sl_uint8* V, sl_int32 strideUV, sl_uint8* RGBA, sl_uint32 width, sl_bool flagBGRA = sl_false);
+
+		/*
+			Converts two rows of 4-byte pixels (RGBA, or BGRA when `flagBGRA` is set) into two rows of luma and one row of chroma.
+			The chroma samples are the average over 2x2 pixels, and `width` should be even.
+		*/
+		static void convertRGBAToYUV420(const sl_uint8* RGBA0, const sl_uint8* RGBA1, sl_uint8* Y0, sl_uint8* Y1, sl_uint8* U, sl_uint8* V, sl_int32 strideUV, sl_uint32 width, sl_bool flagBGRA = sl_false);
+
 	};
 
 }
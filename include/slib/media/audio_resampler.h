@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_MEDIA_AUDIO_RESAMPLER
+#define CHECKHEADER_SLIB_MEDIA_AUDIO_RESAMPLER
+
+#include "definition.h"
+
+#include "audio_data.h"
+
+#include "../core/object.h"
+#include "../core/array.h"
+
+/*
+	Polyphase windowed-sinc (Kaiser) sample rate converter
+ -----------------------------------------------------------
+ 
+ The rates are reduced to L/M, and one filter phase is prepared for each of the L output positions
+ between two input samples (up to 1024 phases, the nearest phase is used beyond that).
+ The cutoff is the lower Nyquist frequency of both rates.
+ The converter keeps its history between the calls, so a stream can be fed in blocks of any size.
+ The output is aligned to the input, but the last output frames are held back until the input
+ covers the half length of the filter (`filterLength` samples at the lower rate).
+ 
+*/
+
+namespace slib
+{
+	class SLIB_EXPORT AudioResamplerParam
+	{
+	public:
+		sl_uint32 samplesPerSecondInput;
+		sl_uint32 samplesPerSecondOutput;
+		sl_uint32 channelsCount;
+		
+		// zero crossings of the sinc kernel on each side (at the lower rate); longer filters have steeper transition bands
+		sl_uint32 filterLength;
+		
+	public:
+		AudioResamplerParam();
+		
+		~AudioResamplerParam();
+		
+	};
+	
+	class SLIB_EXPORT AudioResampler : public Object
+	{
+		SLIB_DECLARE_OBJECT
+		
+	public:
+		AudioResampler();
+		
+		~AudioResampler();
+		
+	public:
+		static Ref<AudioResampler> create(const AudioResamplerParam& param);
+		
+	public:
+		sl_uint32 getInputSamplesCountPerSecond() const;
+		
+		sl_uint32 getOutputSamplesCountPerSecond() const;
+		
+		sl_uint32 getChannelsCount() const;
+		
+		// maximum count of the output frames produced from `countInput` input frames
+		sl_size getMaxOutputCount(sl_size countInput) const;
+		
+		// `input` and `output` are interleaved frames. Returns the count of the output frames
+		sl_size process(const float* input, sl_size countInput, float* output);
+		
+		sl_size process(const sl_int16* input, sl_size countInput, sl_int16* output);
+		
+		// converts the sample types and the channels (mono, stereo) of both sides as needed. `output.count` should not be less than `getMaxOutputCount(input.count)`
+		sl_size process(const AudioData& input, const AudioData& output);
+		
+		// clears the history
+		void reset();
+		
+	protected:
+		sl_size _processPlanar(sl_size countInput, float* output);
+		
+	protected:
+		sl_uint32 m_nSamplesPerSecondInput;
+		sl_uint32 m_nSamplesPerSecondOutput;
+		sl_uint32 m_nChannels;
+		
+		// output step is `M/L` input samples
+		sl_uint32 m_L;
+		sl_uint32 m_M;
+		sl_uint32 m_nPhases;
+		sl_uint32 m_nTaps;
+		Array<float> m_filters; // (m_nPhases + 1) * m_nTaps
+		
+		// planar history of each channel
+		Array<float> m_buffer;
+		sl_size m_nBufferCapacity;
+		sl_size m_nBuffered;
+		// next output is at `m_pos + m_frac / m_L` in the buffer
+		sl_size m_pos;
+		sl_uint32 m_frac;
+		
+		Array<float> m_bufOutput;
+		
+	};
+	
+}
+
+#endif
@@ -161,6 +161,21 @@ namespace slib
 		
 		static void mixSamples(float in1, float in2, float& _out);
 		
+		
+		static void mixSamples(sl_size count, const sl_int16* in1, const sl_int16* in2, sl_int16* _out);
+		
+		static void mixSamples(sl_size count, const float* in1, const float* in2, float* _out);
+		
+		// interleaved stereo => mono
+		static void mixStereoToMono(sl_size count, const sl_int16* _in, sl_int16* _out);
+		
+		static void mixStereoToMono(sl_size count, const float* _in, float* _out);
+		
+		// mono => interleaved stereo
+		static void copyMonoToStereo(sl_size count, const sl_int16* _in, sl_int16* _out);
+		
+		static void copyMonoToStereo(sl_size count, const float* _in, float* _out);
+		
 	};
 	
 }
@@ -31,6 +31,9 @@ namespace slib
 	public:
 		virtual Memory encode(const VideoFrame& input) = 0;
 		
+		// writes the encoded data into `output`, and returns the written size. Returns 0 on failure or when `sizeOutput` is not enough
+		virtual sl_size encode(const VideoFrame& input, void* output, sl_size sizeOutput);
+		
 	public:
 		sl_uint32 getBitrate();
 		
@@ -54,6 +57,7 @@ namespace slib
 		~VideoDecoder();
 		
 	public:
+		// when `output.image.data` is null, `output.image` refers to the internal buffer of the decoder, which is valid until the next call
 		virtual sl_bool decode(const void* input, const sl_uint32& inputSize, VideoFrame& output) = 0;
 		
 	protected:
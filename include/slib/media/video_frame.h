@@ -15,6 +15,8 @@
 
 #include "../graphics/color.h"
 #include "../graphics/bitmap.h"
+#include "../core/object.h"
+#include "../core/list.h"
 
 namespace slib
 {
@@ -30,6 +32,49 @@ namespace slib
 		
 		~VideoFrame();
 		
+	public:
+		// refers to the planes of a YUV I420 image without copying. `ref` keeps the planes alive, if given
+		void setI420(sl_uint32 width, sl_uint32 height, const void* dataY, sl_int32 pitchY, const void* dataU, sl_int32 pitchU, const void* dataV, sl_int32 pitchV, const Ref<Referable>& ref = sl_null);
+		
+	};
+	
+	/*
+		Recycles the pixel buffers of the frames having the same size and format.
+		A buffer returns to the pool when all the frames referring to it (`image.ref`) are released.
+	*/
+	class SLIB_EXPORT VideoFramePool : public Object
+	{
+		SLIB_DECLARE_OBJECT
+		
+	public:
+		VideoFramePool();
+		
+		~VideoFramePool();
+		
+	public:
+		// `maxBuffersCount`: zero means unlimited
+		static Ref<VideoFramePool> create(sl_uint32 width, sl_uint32 height, BitmapFormat format = BitmapFormat::YUV_I420, sl_uint32 maxBuffersCount = 0);
+		
+	public:
+		// returns `sl_false` when all of `maxBuffersCount` buffers are in use
+		sl_bool getFrame(VideoFrame& frame);
+		
+		sl_uint32 getWidth() const;
+		
+		sl_uint32 getHeight() const;
+		
+		BitmapFormat getFormat() const;
+		
+		sl_size getBuffersCount() const;
+		
+	protected:
+		sl_uint32 m_width;
+		sl_uint32 m_height;
+		BitmapFormat m_format;
+		sl_size m_sizeBuffer;
+		sl_uint32 m_nMaxBuffers;
+		CList<Memory> m_buffers;
+		
 	};	
 }
 
@@ -0,0 +1,233 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_NETWORK_HTTP_CLIENT
+#define CHECKHEADER_SLIB_NETWORK_HTTP_CLIENT
+
+#include "definition.h"
+
+#include "http_common.h"
+#include "http_io.h"
+#include "socket_address.h"
+
+#include "../core/hash_map.h"
+#include "../core/spin_lock.h"
+
+/*
+	Latency buckets (microseconds): 0~7 are exact, and each power of two above is split into 4 buckets.
+	The last bucket collects everything above 2^40 microseconds.
+*/
+#define SLIB_HTTP_CLIENT_LATENCY_BUCKETS 156
+
+namespace slib
+{
+
+	class HttpClient;
+	class HttpClientOrigin;
+	class HttpClientConnection;
+
+	class SLIB_EXPORT HttpClientLatencyHistogram
+	{
+	public:
+		sl_uint64 count;
+		sl_uint64 countErrors;
+		sl_uint64 sum;
+		sl_uint64 min;
+		sl_uint64 max;
+		sl_uint64 buckets[SLIB_HTTP_CLIENT_LATENCY_BUCKETS];
+
+	public:
+		HttpClientLatencyHistogram();
+
+		~HttpClientLatencyHistogram();
+
+	public:
+		void add(sl_uint64 latency);
+
+		void clear();
+
+		sl_uint64 getMean() const;
+
+		// `percent`: 0~100. Returns the upper bound of the bucket containing the percentile
+		sl_uint64 getPercentile(double percent) const;
+
+		static sl_uint32 getBucketIndex(sl_uint64 latency);
+
+		static sl_uint64 getBucketUpperBound(sl_uint32 index);
+
+	};
+
+	class SLIB_EXPORT HttpClientParam
+	{
+	public:
+		// optional, a new loop is created when not specified
+		Ref<AsyncIoLoop> ioLoop;
+
+		sl_uint32 maxConnectionsPerOrigin; // default: 8
+		sl_uint32 maxPipelinedRequests; // default: 1 (no pipelining), only idempotent requests (GET, HEAD, OPTIONS, TRACE) are pipelined
+		sl_uint32 maxIdleTime; // milliseconds, default: 30000. Idle connections older than this are not reused
+		sl_uint32 readBufferSize; // default: 64KB
+		sl_uint32 maxResponseHeaderSize; // default: 64KB
+		sl_bool flagLogError; // default: true
+
+	public:
+		HttpClientParam();
+
+		~HttpClientParam();
+
+	};
+
+	/*
+		Callbacks are invoked on the I/O loop of the client.
+		The content is delivered to `OnReceiveContent` as it arrives, and is stored only when `StoringResponseContent` is set.
+	*/
+	class SLIB_EXPORT HttpClientRequest : public Object, public HttpRequest, public HttpResponse
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		HttpClientRequest();
+
+		~HttpClientRequest();
+
+	public:
+		static Ref<HttpClientRequest> create(HttpMethod method, const String& url);
+
+	public:
+		String getUrl() const;
+
+		const Memory& getRequestBody() const;
+
+		void setRequestBody(const Memory& body);
+
+		Memory getResponseContent() const;
+
+		sl_uint64 getResponseContentSize() const;
+
+		sl_bool isCompleted() const;
+
+		sl_bool isError() const;
+
+		String getErrorMessage() const;
+
+		// microseconds from sending the request to the first byte of the response
+		sl_uint64 getTimeToFirstByte() const;
+
+		// microseconds from sending the request to the end of the response
+		sl_uint64 getLatency() const;
+
+		void cancel();
+
+	public:
+		SLIB_BOOLEAN_PROPERTY(StoringResponseContent)
+		SLIB_PROPERTY(AtomicFunction<void(HttpClientRequest*)>, OnResponse)
+		SLIB_PROPERTY(AtomicFunction<void(HttpClientRequest*, const void*, sl_size)>, OnReceiveContent)
+		SLIB_PROPERTY(AtomicFunction<void(HttpClientRequest*)>, OnComplete)
+
+	protected:
+		void _onResponse();
+
+		void _onReceiveContent(const void* data, sl_size size);
+
+		void _onComplete(sl_bool flagError, const String& errorMessage);
+
+		sl_bool _isIdempotent() const;
+
+	protected:
+		String m_url;
+		Memory m_requestBody;
+		MemoryBuffer m_bufResponseContent;
+		sl_uint64 m_sizeResponseContent;
+
+		sl_bool m_flagCompleted;
+		sl_bool m_flagError;
+		sl_bool m_flagCancelled;
+		AtomicString m_errorMessage;
+
+		sl_uint64 m_timeSent;
+		sl_uint64 m_timeToFirstByte;
+		sl_uint64 m_latency;
+		sl_uint32 m_nRetries;
+
+		WeakRef<HttpClient> m_client;
+		Ref<HttpClientOrigin> m_origin;
+		HttpClientConnection* m_connection;
+
+		friend class HttpClient;
+		friend class HttpClientOrigin;
+		friend class HttpClientConnection;
+
+	};
+
+	/*
+		HTTP/1.1 client running on an AsyncIoLoop.
+		Connections are kept alive in per-origin pools, and idempotent requests can be pipelined on them.
+		Only `http` urls are supported.
+		When sharing the loop, call release() before dropping the last reference, so that the connections are closed in the loop.
+	*/
+	class SLIB_EXPORT HttpClient : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		HttpClient();
+
+		~HttpClient();
+
+	public:
+		static Ref<HttpClient> create(const HttpClientParam& param);
+
+		static Ref<HttpClient> create();
+
+	public:
+		void release();
+
+		sl_bool isReleased();
+
+		const HttpClientParam& getParam();
+
+		Ref<AsyncIoLoop> getAsyncIoLoop();
+
+		sl_bool send(const Ref<HttpClientRequest>& request);
+
+		Ref<HttpClientRequest> send(HttpMethod method, const String& url, const Function<void(HttpClientRequest*)>& onComplete);
+
+		// origins are represented as "host:port"
+		List<String> getOrigins();
+
+		sl_bool getLatencyHistogram(const String& origin, HttpClientLatencyHistogram* _out);
+
+		void clearLatencyHistograms();
+
+	protected:
+		void _send(const Ref<HttpClientRequest>& request);
+
+		void _cancel(const Ref<HttpClientRequest>& request);
+
+		void _release();
+
+	protected:
+		HttpClientParam m_param;
+		Ref<AsyncIoLoop> m_ioLoop;
+		sl_bool m_flagOwnLoop;
+		sl_bool m_flagReleased;
+
+		// origins are created in the loop, and looked up from any thread
+		CHashMap< String, Ref<HttpClientOrigin> > m_origins;
+
+		friend class HttpClientRequest;
+		friend class HttpClientOrigin;
+		friend class HttpClientConnection;
+
+	};
+
+}
+
+#endif
@@ -145,6 +145,7 @@ namespace slib
 		static const String& AcceptEncoding;
 		static const String& TransferEncoding;
 		static const String& ContentEncoding;
+		static const String& Connection;
 		
 		static const String& Range;
 		static const String& ContentRange;
@@ -163,6 +164,9 @@ namespace slib
 		 */
 		static sl_reg parseHeaders(HttpHeaderMap& outMap, const void* headers, sl_size size);
 		
+		// the names of the common fields are shared, instead of being allocated for each message
+		static String getName(const sl_char8* name, sl_size len);
+		
 	};
 	
 	
@@ -263,6 +267,8 @@ namespace slib
 		
 		sl_bool containsParameter(const String& name) const;
 		
+		void setParameter(const String& name, const String& value);
+		
 		const HashMap<String, String>& getQueryParameters() const;
 		
 		String getQueryParameter(String name) const;
@@ -16,8 +16,12 @@
 #include "../core/string.h"
 #include "../crypto/zlib.h"
 
+#include "http_common.h"
 #include "async.h"
 
+// default limit of the header fields in a request
+#define SLIB_HTTP_REQUEST_PARSER_MAX_HEADERS 100
+
 namespace slib
 {
 	
@@ -37,12 +41,17 @@ namespace slib
 		
 		void write(const Memory& mem);
 		
+		// serializes `value` directly into the output chunks, without building the whole JSON text
+		void writeJson(const Variant& value);
+		
 		void copyFrom(AsyncStream* stream, sl_uint64 size);
 		
 		void copyFromFile(const String& path);
 		
 		void copyFromFile(const String& path, const Ref<Dispatcher>& dispatcher);
 		
+		void copyFromFile(const Ref<File>& file, sl_uint64 offset, sl_uint64 size);
+		
 		sl_uint64 getOutputLength() const;
 		
 	protected:
@@ -73,6 +82,134 @@ namespace slib
 		
 	};
 	
+	/*
+		Resumable HTTP/1.1 request parser.
+		Request line and header fields are recorded as offsets into the header section,
+		and the body (Content-Length or chunked) is assembled without intermediate queues.
+	*/
+	class SLIB_EXPORT HttpRequestParser
+	{
+	public:
+		struct Range
+		{
+			sl_uint32 offset;
+			sl_uint32 length;
+		};
+		
+		struct HeaderField
+		{
+			Range name;
+			Range value;
+		};
+		
+	public:
+		HttpRequestParser();
+		
+		HttpRequestParser(const HttpRequestParser& other) = delete;
+		
+		~HttpRequestParser();
+		
+	public:
+		HttpRequestParser& operator=(const HttpRequestParser& other) = delete;
+		
+	public:
+		/*
+		 Returns the number of consumed bytes.
+		 Parsing stops after the header section and at the end of the request,
+		 so the bytes remained in `data` belong to the body or to the next (pipelined) request.
+		*/
+		sl_size parse(const void* data, sl_size size);
+		
+		sl_bool isHeaderCompleted() const;
+		
+		sl_bool isCompleted() const;
+		
+		sl_bool isError() const;
+		
+		// raw header section, available after the header is completed
+		Memory getHeader() const;
+		
+		const Range& getMethod() const;
+		
+		const Range& getPath() const;
+		
+		const Range& getQuery() const;
+		
+		const Range& getVersion() const;
+		
+		sl_uint32 getHeaderFieldsCount() const;
+		
+		const HeaderField* getHeaderFields() const;
+		
+		sl_bool isChunked() const;
+		
+		// declared length, or the decoded length of a chunked body
+		sl_uint64 getContentLength() const;
+		
+		Memory getBody() const;
+		
+		void applyRequest(HttpRequest& request) const;
+		
+		void setMaxHeaderSize(sl_size size);
+		
+		void setMaxBodySize(sl_uint64 size);
+		
+		// requests with more header fields are rejected. default: SLIB_HTTP_REQUEST_PARSER_MAX_HEADERS
+		void setMaxHeaderFieldsCount(sl_uint32 count);
+		
+		void reset();
+		
+	protected:
+		sl_bool _parseHeader(const sl_char8* data, sl_size size, sl_size& pos);
+		
+		sl_bool _completeHeader();
+		
+		sl_bool _parseBody(const sl_char8* data, sl_size size, sl_size& pos);
+		
+		sl_bool _appendHeader(const void* data, sl_size size);
+		
+		sl_bool _appendBody(const void* data, sl_size size);
+		
+		sl_bool _reserveField();
+		
+		void _addField(sl_uint32 endValue);
+		
+	protected:
+		sl_uint32 m_state;
+		sl_bool m_flagHeaderCompleted;
+		
+		sl_size m_maxHeaderSize;
+		sl_uint64 m_maxBodySize;
+		
+		sl_uint32 m_sizeHeader;
+		Memory m_header;
+		Memory m_bufHeader;
+		
+		Range m_method;
+		Range m_path;
+		Range m_query;
+		Range m_version;
+		sl_uint32 m_posQuery;
+		
+		// grows on demand up to `m_maxFields`
+		HeaderField* m_fields;
+		sl_uint32 m_nFields;
+		sl_uint32 m_nFieldsCapacity;
+		sl_uint32 m_maxFields;
+		sl_uint32 m_posToken;
+		sl_uint32 m_posValue;
+		sl_uint32 m_endValue;
+		
+		sl_bool m_flagChunked;
+		sl_uint64 m_contentLength;
+		sl_uint64 m_sizeChunkRemain;
+		sl_bool m_flagChunkSize;
+		
+		Memory m_body;
+		sl_size m_sizeBody;
+		
+	};
+	
 	class SLIB_EXPORT IHttpContentReaderListener
 	{
 	public:
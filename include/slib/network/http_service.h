@@ -18,6 +18,7 @@
 #include "socket_address.h"
 
 #include "../core/thread_pool.h"
+#include "../core/concurrent_hash_map.h"
 
 namespace slib
 {
@@ -25,7 +26,7 @@ namespace slib
 	class HttpService;
 	class HttpServiceConnection;
 	
-	class SLIB_EXPORT HttpServiceContext : public Object, public HttpRequest, public HttpResponse, public HttpOutputBuffer
+	class SLIB_EXPORT HttpServiceContext : public LightObject, public HttpRequest, public HttpResponse, public HttpOutputBuffer
 	{
 		SLIB_DECLARE_OBJECT
 		
@@ -71,10 +72,8 @@ namespace slib
 		SLIB_BOOLEAN_PROPERTY(ProcessingByThread);
 		
 	protected:
-		HttpHeaderReader m_requestHeaderReader;
 		AtomicMemory m_requestHeader;
 		sl_uint64 m_requestContentLength;
-		MemoryQueue m_requestBodyBuffer;
 		AtomicMemory m_requestBody;
 		sl_bool m_flagAsynchronousResponse;
 		
@@ -139,11 +138,23 @@ namespace slib
 		Memory m_bufRead;
 		sl_bool m_flagReading;
 		
+		HttpRequestParser m_parser;
+		// input following a completed request, processed after its response (pipelining)
+		Memory m_memInputPending;
+		const sl_uint8* m_dataInputPending;
+		sl_uint32 m_sizeInputPending;
+		sl_bool m_flagProcessingInput;
+		sl_bool m_flagResumingInput;
+		
 	protected:
 		void _read();
 		
 		void _processInput(const void* data, sl_uint32 size);
 		
+		void _processInput(const void* data, sl_uint32 size, const Memory& mem);
+		
+		sl_bool _processRequest(HttpService* service, const sl_uint8*& data, sl_uint32& size, Memory& mem);
+		
 		void _processContext(const Ref<HttpServiceContext>& context);
 		
 		void _completeResponse(HttpServiceContext* context);
@@ -201,10 +212,14 @@ namespace slib
 		sl_uint32 maxThreadsCount;
 		sl_bool flagProcessByThreads;
 		
+		// number of I/O loops serving the connections (0: number of processors). On Linux, each loop accepts on its own SO_REUSEPORT listener
+		sl_uint32 ioLoopsCount;
+		
 		sl_bool flagUseAsset;
 		String prefixAsset;
 		
 		sl_uint64 maxRequestHeadersSize;
+		sl_uint32 maxRequestHeaderFieldsCount;
 		sl_uint64 maxRequestBodySize;
 		
 		sl_bool flagAllowCrossOrigin;
@@ -243,6 +258,8 @@ namespace slib
 		
 		Ref<AsyncIoLoop> getAsyncIoLoop();
 		
+		List< Ref<AsyncIoLoop> > getAsyncIoLoops();
+		
 		Ref<ThreadPool> getThreadPool();
 		
 		const HttpServiceParam& getParam();
@@ -292,10 +309,11 @@ namespace slib
 		
 	protected:
 		AtomicRef<AsyncIoLoop> m_ioLoop;
+		CList< Ref<AsyncIoLoop> > m_ioLoops;
 		AtomicRef<ThreadPool> m_threadPool;
 		sl_bool m_flagRunning;
 		
-		CHashMap< HttpServiceConnection*, Ref<HttpServiceConnection> > m_connections;
+		ConcurrentHashMap< HttpServiceConnection*, Ref<HttpServiceConnection> > m_connections;
 		
 		CList< Ptr<IHttpServiceProcessor> > m_processors;
 		AtomicList< Ptr<IHttpServiceProcessor> > m_processorsCached;
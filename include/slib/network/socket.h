@@ -17,6 +17,8 @@
 #include "socket_address.h"
 #include "mac_address.h"
 
+#include "../core/file.h"
+
 typedef int sl_socket;
 #define SLIB_SOCKET_INVALID_HANDLE (-1)
 
@@ -112,6 +114,7 @@ namespace slib
 		SendPacketIsNotSupported = 113,
 		SendPacketInvalidAddress = 114,
 		ReceivePacketIsNotSupported = 115,
+		SendFileIsNotSupported = 116,
 		
 		Unknown = 10000
 		
@@ -187,6 +190,11 @@ namespace slib
 		
 		sl_int32 send(const void* buf, sl_uint32 size);
 		
+		// sends `size` bytes of `file` starting at `offset` without copying through user space (Linux, macOS). returns 0 when the socket would block
+		sl_int32 sendFile(sl_file file, sl_uint64 offset, sl_uint32 size);
+		
+		static sl_bool isSupportingSendFile();
+		
 		sl_int32 receive(void* buf, sl_uint32 size);
 		
 		sl_int32 sendTo(const SocketAddress& address, const void* buf, sl_uint32 size);
@@ -219,6 +219,12 @@ namespace slib
 
 		sl_bool isClosed();
 		
+	public:
+		// 0 means no limit. Used by the libcurl backend (Linux, Tizen): the requests over the limit wait for a free connection to the host
+		static sl_uint32 getMaximumConnectionsPerHost();
+		
+		static void setMaximumConnectionsPerHost(sl_uint32 n);
+		
 	protected:
 		static Ref<UrlRequest> _create(const UrlRequestParam& param, const String& url);
 		
@@ -13,6 +13,7 @@
 
 #include "web/constants.h"
 #include "web/service.h"
+#include "web/router.h"
 #include "web/controller.h"
 
 #endif
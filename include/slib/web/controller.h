@@ -13,17 +13,13 @@
 
 #include "definition.h"
 
-#include "../core/function.h"
-#include "../core/variant.h"
-#include "../network/http_service.h"
-
-#define SWEB_HANDLER_PARAMS_LIST const slib::Ref<slib::HttpServiceContext>& context, HttpMethod method, const slib::String& path
+#include "router.h"
 
 namespace slib
 {
 
-	typedef Function<Variant(SWEB_HANDLER_PARAMS_LIST)> WebHandler;
-
+	// Handlers are matched by the radix tree of WebRouter, so the paths can contain named segments (`/users/:id`) and a trailing wildcard (`/files/*path`).
+	// The matched segments are set to the parameters of the context.
 	class WebController : public Object, public IHttpServiceProcessor
 	{
 		SLIB_DECLARE_OBJECT
@@ -31,20 +27,34 @@ namespace slib
 	protected:
 		WebController();
 		
+		~WebController();
+		
 	public:
 		static Ref<WebController> create();
 		
 	public:
 		void registerHandler(HttpMethod method, const String& path, const WebHandler& handler);
 		
+		// compiles the registered handlers. Called on the first request after registering handlers
+		void buildRouter();
+		
+		Ref<WebRouter> getRouter();
+		
 	protected:
 		sl_bool onHttpRequest(const Ref<HttpServiceContext>& context) override;
 		
 	protected:
-		static String _getHandlerSignature(HttpMethod method, const String& path);
+		struct _Route
+		{
+			HttpMethod method;
+			String path;
+			WebHandler handler;
+		};
+		CList<_Route> m_routes;
+		volatile sl_bool m_flagRoutesChanged;
 		
-	protected:
-		CMap<String, WebHandler> m_handlers;
+		// each request holds a reference to the router it matched with, so a replaced router is freed after the requests in flight
+		AtomicRef<WebRouter> m_router;
 		
 		friend class WebModule;
 		
@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_WEB_ROUTER
+#define CHECKHEADER_SLIB_WEB_ROUTER
+
+#include "definition.h"
+
+#include "../core/function.h"
+#include "../core/variant.h"
+#include "../network/http_service.h"
+
+#define SWEB_HANDLER_PARAMS_LIST const slib::Ref<slib::HttpServiceContext>& context, HttpMethod method, const slib::String& path
+
+#define SLIB_WEB_ROUTER_MAX_PARAMS 16
+
+namespace slib
+{
+
+	typedef Function<Variant(SWEB_HANDLER_PARAMS_LIST)> WebHandler;
+
+	class WebRouterNode;
+
+	class SLIB_EXPORT WebRouteParam
+	{
+	public:
+		// points to the name stored in the router
+		const String* name;
+
+		// range of the value in the matched path
+		sl_size offset;
+		sl_size length;
+
+	};
+
+	class SLIB_EXPORT WebRouteMatch
+	{
+	public:
+		// points to the handler stored in the router
+		const WebHandler* handler;
+
+		sl_uint32 countParams;
+		WebRouteParam params[SLIB_WEB_ROUTER_MAX_PARAMS];
+
+	public:
+		WebRouteMatch();
+
+		~WebRouteMatch();
+
+	public:
+		String getParameter(const String& path, sl_uint32 index) const;
+
+		String getParameter(const String& path, const String& name) const;
+
+	};
+
+	// Compressed radix tree of the routes.
+	//
+	// Patterns are made of static text, named segments and a trailing wildcard:
+	//	/users/:id/posts	- `:id` matches one non-empty segment (up to the next '/')
+	//	/files/*path		- `*path` matches the rest of the path, and should be the last token
+	// `:` and `*` are special only at the beginning of a segment.
+	// On lookup, static children are tried first, then the named segment and the wildcard.
+	//
+	// Routes are added while building, and the built router is read-only,
+	// so that any number of threads can call match() without locking.
+	// match() does not allocate: the parameters are returned as ranges of the path.
+	class SLIB_EXPORT WebRouter : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		WebRouter();
+
+		~WebRouter();
+
+	public:
+		static Ref<WebRouter> create();
+
+	public:
+		// not thread-safe, and should not be called after the router is shared with the readers
+		sl_bool add(HttpMethod method, const String& pattern, const WebHandler& handler);
+
+		sl_bool match(HttpMethod method, const sl_char8* path, sl_size length, WebRouteMatch* _out) const;
+
+		sl_bool match(HttpMethod method, const String& path, WebRouteMatch* _out) const;
+
+		sl_size getRoutesCount() const;
+
+		sl_size getNodesCount() const;
+
+	protected:
+		WebRouterNode* m_root;
+		sl_size m_nRoutes;
+		sl_size m_nNodes;
+
+	};
+
+}
+
+#endif
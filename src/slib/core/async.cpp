@@ -10,6 +10,8 @@
 
 #include "slib/core/async.h"
 
+#include "async_config.h"
+
 #include "slib/core/safe_static.h"
 
 namespace slib
@@ -132,6 +134,15 @@ namespace slib
 		return addTask(callback);
 	}
 
+	sl_bool AsyncIoLoop::isSupportingFileCompletion()
+	{
+#if defined(ASYNC_USE_IOCP)
+		return sl_true;
+#else
+		return _native_getIoUring() != sl_null;
+#endif
+	}
+
 	void AsyncIoLoop::wake()
 	{
 		ObjectLocker lock(this);
@@ -182,7 +193,7 @@ namespace slib
 			LinkedQueue< Function<void()> > tasks;
 			tasks.merge(&m_queueTasks);
 			Function<void()> task;
-			while (m_queueTasks.pop(&task)) {
+			while (tasks.pop_NoLock(&task)) {
 				task();
 			}
 		}
@@ -384,7 +395,7 @@ namespace slib
 		Referable* _userObject,
 		const Function<void(AsyncStreamResult*)>& _callback,
 		sl_bool _flagRead)
-	 : data(_data), size(_size), userObject(_userObject), callback(_callback), flagRead(_flagRead)
+	 : data(_data), size(_size), userObject(_userObject), callback(_callback), flagRead(_flagRead), fileOffset(0)
 	{
 	}
 
@@ -406,6 +417,21 @@ namespace slib
 		return new AsyncStreamRequest(data, size, userObject, callback, sl_false);
 	}
 
+	Ref<AsyncStreamRequest> AsyncStreamRequest::createSendFile(
+		const Ref<File>& file,
+		sl_uint64 offset,
+		sl_uint32 size,
+		Referable* userObject,
+		const Function<void(AsyncStreamResult*)>& callback)
+	{
+		Ref<AsyncStreamRequest> ret = new AsyncStreamRequest(sl_null, size, userObject, callback, sl_false);
+		if (ret.isNotNull()) {
+			ret->file = file;
+			ret->fileOffset = offset;
+		}
+		return ret;
+	}
+
 	void AsyncStreamRequest::runCallback(AsyncStream* stream, sl_uint32 resultSize, sl_bool flagError)
 	{
 		if (callback.isNotNull()) {
@@ -457,6 +483,27 @@ namespace slib
 		return sl_false;
 	}
 
+	sl_bool AsyncStreamInstance::isSupportingSendFile()
+	{
+		return sl_false;
+	}
+
+	sl_bool AsyncStreamInstance::sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject)
+	{
+		if (size == 0 || file.isNull()) {
+			return sl_false;
+		}
+		if (!(isSupportingSendFile())) {
+			return sl_false;
+		}
+		Ref<AsyncStreamRequest> req = AsyncStreamRequest::createSendFile(file, offset, size, userObject, callback);
+		if (req.isNotNull()) {
+			m_requestsWrite.push(req);
+			return sl_true;
+		}
+		return sl_false;
+	}
+
 	sl_bool AsyncStreamInstance::isSeekable()
 	{
 		return sl_false;
@@ -551,6 +598,16 @@ namespace slib
 		return sl_null;
 	}
 
+	sl_bool AsyncStream::isSupportingSendFile()
+	{
+		return sl_false;
+	}
+
+	sl_bool AsyncStream::sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject)
+	{
+		return sl_false;
+	}
+
 	sl_bool AsyncStream::isSeekable()
 	{
 		return sl_false;
@@ -664,6 +721,31 @@ namespace slib
 		return sl_false;
 	}
 
+	sl_bool AsyncStreamBase::isSupportingSendFile()
+	{
+		Ref<AsyncStreamInstance> instance = getIoInstance();
+		if (instance.isNotNull()) {
+			return instance->isSupportingSendFile();
+		}
+		return sl_false;
+	}
+
+	sl_bool AsyncStreamBase::sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject)
+	{
+		Ref<AsyncIoLoop> loop = getIoLoop();
+		if (loop.isNull()) {
+			return sl_false;
+		}
+		Ref<AsyncStreamInstance> instance = getIoInstance();
+		if (instance.isNotNull()) {
+			if (instance->sendFile(file, offset, size, callback, userObject)) {
+				loop->requestOrder(instance.get());
+				return sl_true;
+			}
+		}
+		return sl_false;
+	}
+
 	sl_bool AsyncStreamBase::isSeekable()
 	{
 		Ref<AsyncStreamInstance> instance = getIoInstance();
@@ -1046,6 +1128,46 @@ namespace slib
 		return AsyncFile::open(path, FileMode::Append, dispatcher);
 	}
 
+#if !defined(ASYNC_USE_URING)
+	Ref<AsyncStream> AsyncFile::openIoUring(const String& path, FileMode mode, const Ref<AsyncIoLoop>& loop)
+	{
+		return sl_null;
+	}
+#endif
+
+	Ref<AsyncStream> AsyncFile::openIoUring(const String& path, FileMode mode)
+	{
+		return AsyncFile::openIoUring(path, mode, AsyncIoLoop::getDefault());
+	}
+
+	Ref<AsyncStream> AsyncFile::openStream(const String& path, FileMode mode, const Ref<AsyncIoLoop>& _loop, const Ref<Dispatcher>& dispatcher)
+	{
+		Ref<AsyncIoLoop> loop = _loop;
+		if (loop.isNull()) {
+			loop = AsyncIoLoop::getDefault();
+		}
+		if (loop.isNotNull()) {
+#if defined(SLIB_PLATFORM_IS_WIN32)
+			Ref<AsyncStream> stream = AsyncFile::openIOCP(path, mode, loop);
+#else
+			Ref<AsyncStream> stream = AsyncFile::openIoUring(path, mode, loop);
+#endif
+			if (stream.isNotNull()) {
+				return stream;
+			}
+		}
+		if (dispatcher.isNotNull()) {
+			return AsyncFile::open(path, mode, dispatcher);
+		} else {
+			return AsyncFile::open(path, mode);
+		}
+	}
+
+	Ref<AsyncStream> AsyncFile::openStream(const String& path, FileMode mode)
+	{
+		return AsyncFile::openStream(path, mode, Ref<AsyncIoLoop>::null(), Ref<Dispatcher>::null());
+	}
+
 	Ref<File> AsyncFile::getFile()
 	{
 		return m_file;
@@ -1442,18 +1564,21 @@ namespace slib
 	AsyncOutputBufferElement::AsyncOutputBufferElement()
 	{
 		m_sizeBody = 0;
+		m_offsetFileBody = 0;
 	}
 
 	AsyncOutputBufferElement::AsyncOutputBufferElement(const Memory& header)
 	{
 		m_header.add(header);
 		m_sizeBody = 0;
+		m_offsetFileBody = 0;
 	}
 
 	AsyncOutputBufferElement::AsyncOutputBufferElement(AsyncStream* stream, sl_uint64 size)
 	{
 		m_body = stream;
 		m_sizeBody = size;
+		m_offsetFileBody = 0;
 	}
 
 	AsyncOutputBufferElement::~AsyncOutputBufferElement()
@@ -1462,7 +1587,7 @@ namespace slib
 
 	sl_bool AsyncOutputBufferElement::isEmpty() const
 	{
-		if (m_header.getSize() == 0 && (m_sizeBody == 0 || m_body.isNull())) {
+		if (m_header.getSize() == 0 && isEmptyBody()) {
 			return sl_true;
 		}
 		return sl_false;
@@ -1470,7 +1595,7 @@ namespace slib
 
 	sl_bool AsyncOutputBufferElement::isEmptyBody() const
 	{
-		if (m_sizeBody == 0 || m_body.isNull()) {
+		if (m_sizeBody == 0 || (m_body.isNull() && m_fileBody.isNull())) {
 			return sl_true;
 		}
 		return sl_false;
@@ -1484,6 +1609,15 @@ namespace slib
 	void AsyncOutputBufferElement::setBody(AsyncStream* stream, sl_uint64 size)
 	{
 		m_body = stream;
+		m_fileBody.setNull();
+		m_sizeBody = size;
+	}
+
+	void AsyncOutputBufferElement::setBodyFile(const Ref<File>& file, sl_uint64 offset, sl_uint64 size)
+	{
+		m_body.setNull();
+		m_fileBody = file;
+		m_offsetFileBody = offset;
 		m_sizeBody = size;
 	}
 
@@ -1502,6 +1636,25 @@ namespace slib
 		return m_sizeBody;
 	}
 
+	Ref<File> AsyncOutputBufferElement::getBodyFile()
+	{
+		return m_fileBody;
+	}
+
+	sl_uint64 AsyncOutputBufferElement::getBodyFileOffset()
+	{
+		return m_offsetFileBody;
+	}
+
+	void AsyncOutputBufferElement::skipBody(sl_uint64 size)
+	{
+		if (size > m_sizeBody) {
+			size = m_sizeBody;
+		}
+		m_sizeBody -= size;
+		m_offsetFileBody += size;
+	}
+
 
 /**********************************************
 		AsyncOutputBuffer
@@ -1602,6 +1755,35 @@ namespace slib
 		return sl_true;
 	}
 
+	sl_bool AsyncOutputBuffer::copyFromFile(const Ref<File>& file, sl_uint64 offset, sl_uint64 size)
+	{
+		if (size == 0) {
+			return sl_true;
+		}
+		if (file.isNull()) {
+			return sl_false;
+		}
+		ObjectLocker lock(this);
+		Link< Ref<AsyncOutputBufferElement> >* link = m_queueOutput.getBack();
+		if (link && link->value->isEmptyBody()) {
+			link->value->setBodyFile(file, offset, size);
+			m_lengthOutput += size;
+		} else {
+			Ref<AsyncOutputBufferElement> data = new AsyncOutputBufferElement;
+			if (data.isNotNull()) {
+				data->setBodyFile(file, offset, size);
+				if (m_queueOutput.push(data)) {
+					m_lengthOutput += size;
+				} else {
+					return sl_false;
+				}
+			} else {
+				return sl_false;
+			}
+		}
+		return sl_true;
+	}
+
 	sl_uint64 AsyncOutputBuffer::getOutputLength() const
 	{
 		return m_lengthOutput;
@@ -1738,6 +1920,26 @@ namespace slib
 		} else {
 			sl_uint64 sizeBody = m_elementWriting->getBodySize();
 			Ref<AsyncStream> body = m_elementWriting->getBody();
+			Ref<File> fileBody = m_elementWriting->getBodyFile();
+			if (sizeBody != 0 && fileBody.isNotNull()) {
+				sl_uint64 offset = m_elementWriting->getBodyFileOffset();
+				if (m_streamOutput->isSupportingSendFile()) {
+					sl_uint32 size = sizeBody > 0x40000000 ? 0x40000000 : (sl_uint32)sizeBody;
+					m_elementWriting->skipBody(size);
+					m_flagWriting = sl_true;
+					if (!(m_streamOutput->sendFile(fileBody, offset, size, SLIB_FUNCTION_WEAKREF(AsyncOutput, onWriteStream, this)))) {
+						m_flagWriting = sl_false;
+						_onError();
+					}
+					return;
+				}
+				// the output stream can't take file descriptors, so the region is copied through buffers
+				body = AsyncFile::create(fileBody);
+				if (body.isNull() || !(body->seek(offset))) {
+					_onError();
+					return;
+				}
+			}
 			if (sizeBody != 0 && body.isNotNull()) {
 				m_flagWriting = sl_true;
 				m_elementWriting.setNull();
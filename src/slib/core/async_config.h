@@ -23,6 +23,18 @@
 #define ASYNC_USE_KEVENT
 #endif
 
+#if defined(ASYNC_USE_EPOLL) && !defined(SLIB_PLATFORM_IS_ANDROID)
+#	if defined(__has_include)
+#		if __has_include(<linux/io_uring.h>)
+// completion queue beside epoll, used when the running kernel supports it
+#			define ASYNC_USE_URING
+#		endif
+#	endif
+#endif
+
 #define ASYNC_MAX_WAIT_EVENT 256
 
+#define ASYNC_URING_ENTRIES 256
+#define ASYNC_URING_FILE_MAX_OPERATIONS 8
+
 #endif
@@ -15,6 +15,10 @@
 #include "slib/core/async.h"
 #include "slib/core/pipe.h"
 
+#if defined(ASYNC_USE_URING)
+#include "async_uring.h"
+#endif
+
 #include <unistd.h>
 #include <sys/epoll.h>
 #include <sys/errno.h>
@@ -30,6 +34,9 @@ namespace slib
 	{
 		int fdEpoll;
 		Ref<PipeEvent> eventWake;
+#if defined(ASYNC_USE_URING)
+		_AsyncIoUring* ring;
+#endif
 	};
 
 	void* AsyncIoLoop::_native_createHandle()
@@ -54,6 +61,18 @@ namespace slib
 				ev.data.ptr = sl_null;
 				ev.events = EPOLLIN | EPOLLPRI | EPOLLET;
 				if (0 == epoll_ctl(fdEpoll, EPOLL_CTL_ADD, (int)(pipe->getReadPipeHandle()), &ev)) {
+#if defined(ASYNC_USE_URING)
+					// optional: falls back to the readiness-only loop when the kernel does not support io_uring
+					handle->ring = _AsyncIoUring::create(ASYNC_URING_ENTRIES);
+					if (handle->ring) {
+						ev.data.ptr = handle->ring;
+						ev.events = EPOLLIN | EPOLLET;
+						if (0 != epoll_ctl(fdEpoll, EPOLL_CTL_ADD, handle->ring->getEventHandle(), &ev)) {
+							delete handle->ring;
+							handle->ring = sl_null;
+						}
+					}
+#endif
 					return handle;
 				}
 				delete handle;
@@ -67,9 +86,25 @@ namespace slib
 	{
 		_AsyncIoLoopHandle* handle = (_AsyncIoLoopHandle*)_handle;
 		::close(handle->fdEpoll);
+#if defined(ASYNC_USE_URING)
+		if (handle->ring) {
+			delete handle->ring;
+		}
+#endif
 		delete handle;
 	}
 
+	void* AsyncIoLoop::_native_getIoUring()
+	{
+#if defined(ASYNC_USE_URING)
+		_AsyncIoLoopHandle* handle = (_AsyncIoLoopHandle*)m_handle;
+		if (handle) {
+			return handle->ring;
+		}
+#endif
+		return sl_null;
+	}
+
 	void AsyncIoLoop::_native_runLoop()
 	{
 		_AsyncIoLoopHandle* handle = (_AsyncIoLoopHandle*)m_handle;
@@ -80,6 +115,13 @@ namespace slib
 
 			_stepBegin();
 
+#if defined(ASYNC_USE_URING)
+			if (handle->ring) {
+				// one system call for all the entries prepared by this step
+				handle->ring->submit();
+			}
+#endif
+
 			int nEvents = ::epoll_wait(handle->fdEpoll, waitEvents, ASYNC_MAX_WAIT_EVENT, -1);
 			if (nEvents == 0) {
 				m_queueInstancesClosed.removeAll();
@@ -93,6 +135,12 @@ namespace slib
 
 			for (int i = 0; m_flagRunning && i < nEvents; i++) {
 				epoll_event& ev = waitEvents[i];
+#if defined(ASYNC_USE_URING)
+				if (handle->ring && ev.data.ptr == handle->ring) {
+					_processIoUringCompletions();
+					continue;
+				}
+#endif
 				AsyncIoInstance* instance = (AsyncIoInstance*)(ev.data.ptr);
 				if (instance) {
 					if (!(instance->isClosing())) {
@@ -100,6 +148,8 @@ namespace slib
 						desc.flagIn = sl_false;
 						desc.flagOut = sl_false;
 						desc.flagError = sl_false;
+						desc.pCompletion = sl_null;
+						desc.result = 0;
 						int re = ev.events;
 						if (re & (EPOLLIN | EPOLLPRI)) {
 							desc.flagIn = sl_true;
@@ -128,6 +178,35 @@ namespace slib
 
 	}
 
+	void AsyncIoLoop::_processIoUringCompletions()
+	{
+#if defined(ASYNC_USE_URING)
+		_AsyncIoLoopHandle* handle = (_AsyncIoLoopHandle*)m_handle;
+		_AsyncIoUring* ring = handle->ring;
+		ring->clearEvent();
+		_AsyncIoUring::Completion completions[ASYNC_MAX_WAIT_EVENT];
+		for (;;) {
+			sl_uint32 n = ring->popCompletions(completions, ASYNC_MAX_WAIT_EVENT);
+			if (!n) {
+				break;
+			}
+			for (sl_uint32 i = 0; i < n; i++) {
+				_AsyncIoUringCompletion* completion = completions[i].completion;
+				if (completion && completion->instance) {
+					// delivered even to closing instances, which release their in-flight operations
+					AsyncIoInstance::EventDesc desc;
+					desc.flagIn = sl_false;
+					desc.flagOut = sl_false;
+					desc.flagError = completions[i].result < 0;
+					desc.pCompletion = completion;
+					desc.result = completions[i].result;
+					completion->instance->onEvent(&desc);
+				}
+			}
+		}
+#endif
+	}
+
 	void AsyncIoLoop::_native_wake()
 	{
 		_AsyncIoLoopHandle* handle = (_AsyncIoLoopHandle*)m_handle;
@@ -109,6 +109,11 @@ namespace slib
 
 	}
 
+	void* AsyncIoLoop::_native_getIoUring()
+	{
+		return sl_null;
+	}
+
 	void AsyncIoLoop::_native_wake()
 	{
 		_AsyncIoLoopHandle* handle = (_AsyncIoLoopHandle*)m_handle;
@@ -86,6 +86,8 @@ namespace slib
 						desc.flagIn = sl_false;
 						desc.flagOut = sl_false;
 						desc.flagError = sl_false;
+						desc.pCompletion = sl_null;
+						desc.result = 0;
 						int re = ev.filter;
 						if (re == EVFILT_READ) {
 							desc.flagIn = sl_true;
@@ -111,6 +113,11 @@ namespace slib
 
 	}
 
+	void* AsyncIoLoop::_native_getIoUring()
+	{
+		return sl_null;
+	}
+
 	void AsyncIoLoop::_native_wake()
 	{
 		_AsyncIoLoopHandle* handle = (_AsyncIoLoopHandle*)m_handle;
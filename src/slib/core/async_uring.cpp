@@ -0,0 +1,464 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "async_uring.h"
+
+#if defined(ASYNC_USE_URING)
+
+#include <unistd.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+
+namespace slib
+{
+
+/*************************************
+			_AsyncIoUring
+*************************************/
+
+	static int _AsyncIoUring_setup(unsigned entries, io_uring_params* params)
+	{
+		return (int)(::syscall(__NR_io_uring_setup, entries, params));
+	}
+
+	static int _AsyncIoUring_enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+	{
+		return (int)(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, sl_null, 0));
+	}
+
+	static int _AsyncIoUring_register(int fd, unsigned opcode, const void* arg, unsigned nArgs)
+	{
+		return (int)(::syscall(__NR_io_uring_register, fd, opcode, arg, nArgs));
+	}
+
+	_AsyncIoUring::_AsyncIoUring()
+	{
+		m_fd = -1;
+		m_fdEvent = -1;
+		m_ringSq = MAP_FAILED;
+		m_sizeRingSq = 0;
+		m_ringCq = MAP_FAILED;
+		m_sizeRingCq = 0;
+		m_sqes = (io_uring_sqe*)MAP_FAILED;
+		m_sizeSqes = 0;
+		m_sqTailLocal = 0;
+		m_nPending = 0;
+	}
+
+	_AsyncIoUring::~_AsyncIoUring()
+	{
+		if (m_sqes != MAP_FAILED) {
+			::munmap(m_sqes, m_sizeSqes);
+		}
+		if (m_ringCq != MAP_FAILED && m_ringCq != m_ringSq) {
+			::munmap(m_ringCq, m_sizeRingCq);
+		}
+		if (m_ringSq != MAP_FAILED) {
+			::munmap(m_ringSq, m_sizeRingSq);
+		}
+		if (m_fdEvent >= 0) {
+			::close(m_fdEvent);
+		}
+		if (m_fd >= 0) {
+			::close(m_fd);
+		}
+	}
+
+	_AsyncIoUring* _AsyncIoUring::create(sl_uint32 nEntries)
+	{
+		io_uring_params params;
+		Base::zeroMemory(&params, sizeof(params));
+		int fd = _AsyncIoUring_setup(nEntries, &params);
+		if (fd < 0) {
+			// ENOSYS: old kernel, EPERM: disabled by sysctl or seccomp
+			return sl_null;
+		}
+		_AsyncIoUring* ring = new _AsyncIoUring;
+		if (!ring) {
+			::close(fd);
+			return sl_null;
+		}
+		ring->m_fd = fd;
+
+		ring->m_sizeRingSq = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		ring->m_sizeRingCq = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		sl_bool flagSingleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+		if (flagSingleMap) {
+			if (ring->m_sizeRingCq > ring->m_sizeRingSq) {
+				ring->m_sizeRingSq = ring->m_sizeRingCq;
+			}
+			ring->m_sizeRingCq = ring->m_sizeRingSq;
+		}
+		ring->m_ringSq = ::mmap(sl_null, ring->m_sizeRingSq, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+		if (ring->m_ringSq == MAP_FAILED) {
+			delete ring;
+			return sl_null;
+		}
+		if (flagSingleMap) {
+			ring->m_ringCq = ring->m_ringSq;
+		} else {
+			ring->m_ringCq = ::mmap(sl_null, ring->m_sizeRingCq, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+			if (ring->m_ringCq == MAP_FAILED) {
+				delete ring;
+				return sl_null;
+			}
+		}
+		ring->m_sizeSqes = params.sq_entries * sizeof(io_uring_sqe);
+		ring->m_sqes = (io_uring_sqe*)(::mmap(sl_null, ring->m_sizeSqes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+		if (ring->m_sqes == MAP_FAILED) {
+			delete ring;
+			return sl_null;
+		}
+
+		sl_uint8* sq = (sl_uint8*)(ring->m_ringSq);
+		ring->m_sqHead = (unsigned*)(sq + params.sq_off.head);
+		ring->m_sqTail = (unsigned*)(sq + params.sq_off.tail);
+		ring->m_sqMask = *((unsigned*)(sq + params.sq_off.ring_mask));
+		ring->m_sqArray = (unsigned*)(sq + params.sq_off.array);
+		ring->m_sqEntries = params.sq_entries;
+		ring->m_sqTailLocal = *(ring->m_sqTail);
+
+		sl_uint8* cq = (sl_uint8*)(ring->m_ringCq);
+		ring->m_cqHead = (unsigned*)(cq + params.cq_off.head);
+		ring->m_cqTail = (unsigned*)(cq + params.cq_off.tail);
+		ring->m_cqMask = *((unsigned*)(cq + params.cq_off.ring_mask));
+		ring->m_cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+
+		ring->m_fdEvent = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (ring->m_fdEvent < 0) {
+			delete ring;
+			return sl_null;
+		}
+		if (_AsyncIoUring_register(fd, IORING_REGISTER_EVENTFD, &(ring->m_fdEvent), 1) != 0) {
+			delete ring;
+			return sl_null;
+		}
+		return ring;
+	}
+
+	int _AsyncIoUring::getEventHandle()
+	{
+		return m_fdEvent;
+	}
+
+	io_uring_sqe* _AsyncIoUring::getSubmissionEntry()
+	{
+		unsigned head = __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+		if (m_sqTailLocal - head >= m_sqEntries) {
+			// flush the batch to make a room
+			submit();
+			head = __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+			if (m_sqTailLocal - head >= m_sqEntries) {
+				return sl_null;
+			}
+		}
+		unsigned index = m_sqTailLocal & m_sqMask;
+		io_uring_sqe* sqe = m_sqes + index;
+		Base::zeroMemory(sqe, sizeof(io_uring_sqe));
+		return sqe;
+	}
+
+	void _AsyncIoUring::pushSubmissionEntry()
+	{
+		unsigned index = m_sqTailLocal & m_sqMask;
+		m_sqArray[index] = index;
+		m_sqTailLocal++;
+		m_nPending++;
+	}
+
+	void _AsyncIoUring::submit()
+	{
+		if (!m_nPending) {
+			return;
+		}
+		__atomic_store_n(m_sqTail, m_sqTailLocal, __ATOMIC_RELEASE);
+		int n = _AsyncIoUring_enter(m_fd, m_nPending, 0, 0);
+		if (n > 0) {
+			if ((unsigned)n >= m_nPending) {
+				m_nPending = 0;
+			} else {
+				m_nPending -= n;
+			}
+		}
+	}
+
+	sl_uint32 _AsyncIoUring::popCompletions(Completion* completions, sl_uint32 nMax)
+	{
+		unsigned head = *m_cqHead;
+		unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+		sl_uint32 n = 0;
+		while (head != tail && n < nMax) {
+			io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+			completions[n].completion = (_AsyncIoUringCompletion*)(void*)(sl_size)(cqe.user_data);
+			completions[n].result = cqe.res;
+			n++;
+			head++;
+		}
+		__atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+		return n;
+	}
+
+	void _AsyncIoUring::clearEvent()
+	{
+		eventfd_t value;
+		::eventfd_read(m_fdEvent, &value);
+	}
+
+/*************************************
+	_AsyncIoUringFileStreamInstance
+*************************************/
+
+	class _AsyncIoUringFileStreamInstance : public AsyncStreamInstance
+	{
+	public:
+		struct Operation : public _AsyncIoUringCompletion
+		{
+			Ref<AsyncStreamRequest> request;
+			struct iovec iov;
+			sl_uint64 offset;
+			sl_uint32 sizeDone;
+			sl_bool flagRead;
+			sl_bool flagDone;
+			sl_int32 result;
+		};
+
+		_AsyncIoUring* m_ring;
+		Ref<File> m_file;
+		sl_uint64 m_offset;
+
+		// in-flight operations, completed in submission order
+		Operation m_operations[ASYNC_URING_FILE_MAX_OPERATIONS];
+		sl_uint32 m_indexFirstOperation;
+		sl_uint32 m_nOperations;
+		sl_bool m_flagReadOperations;
+
+	public:
+		_AsyncIoUringFileStreamInstance()
+		{
+			m_ring = sl_null;
+			m_offset = 0;
+			m_indexFirstOperation = 0;
+			m_nOperations = 0;
+			m_flagReadOperations = sl_true;
+			for (sl_uint32 i = 0; i < ASYNC_URING_FILE_MAX_OPERATIONS; i++) {
+				m_operations[i].instance = this;
+				m_operations[i].offset = 0;
+				m_operations[i].sizeDone = 0;
+				m_operations[i].flagRead = sl_false;
+				m_operations[i].flagDone = sl_false;
+				m_operations[i].result = 0;
+			}
+		}
+
+		~_AsyncIoUringFileStreamInstance()
+		{
+			close();
+		}
+
+	public:
+		static Ref<_AsyncIoUringFileStreamInstance> open(_AsyncIoUring* ring, const String& path, FileMode mode)
+		{
+			Ref<_AsyncIoUringFileStreamInstance> ret;
+			Ref<File> file = File::open(path, mode);
+			if (file.isNotNull()) {
+				ret = new _AsyncIoUringFileStreamInstance();
+				if (ret.isNotNull()) {
+					ret->m_ring = ring;
+					ret->m_file = file;
+					ret->setHandle(file->getHandle());
+					if (mode == FileMode::Append) {
+						ret->m_offset = file->getSize();
+					}
+				}
+			}
+			return ret;
+		}
+
+		void close() override
+		{
+			setHandle(SLIB_FILE_INVALID_HANDLE);
+			m_file.setNull();
+		}
+
+		void onOrder() override
+		{
+			sl_file handle = getHandle();
+			if (handle == SLIB_FILE_INVALID_HANDLE) {
+				return;
+			}
+			// reads and writes are not mixed in flight, so the stream offset stays sequential
+			while (m_nOperations < ASYNC_URING_FILE_MAX_OPERATIONS) {
+				sl_bool flagRead;
+				if (m_nOperations) {
+					flagRead = m_flagReadOperations;
+				} else {
+					if (getReadRequestsCount()) {
+						flagRead = sl_true;
+					} else if (getWriteRequestsCount()) {
+						flagRead = sl_false;
+					} else {
+						break;
+					}
+				}
+				if (!((flagRead ? getReadRequestsCount() : getWriteRequestsCount()))) {
+					break;
+				}
+				io_uring_sqe* sqe = m_ring->getSubmissionEntry();
+				if (!sqe) {
+					// retried on the next completion
+					break;
+				}
+				Ref<AsyncStreamRequest> req;
+				if (flagRead) {
+					popReadRequest(req);
+				} else {
+					popWriteRequest(req);
+				}
+				if (req.isNull()) {
+					continue;
+				}
+				Operation& op = m_operations[(m_indexFirstOperation + m_nOperations) % ASYNC_URING_FILE_MAX_OPERATIONS];
+				op.request = req;
+				op.offset = m_offset;
+				op.sizeDone = 0;
+				op.flagRead = flagRead;
+				op.flagDone = sl_false;
+				op.result = 0;
+				_prepareEntry(op, sqe);
+				// a short read only happens at the end of the regular file, and a short write is resubmitted until it is complete, so the next offset can be assumed
+				m_offset += req->size;
+				m_flagReadOperations = flagRead;
+				m_nOperations++;
+				// released when the completion arrives
+				increaseReference();
+			}
+		}
+
+		void _prepareEntry(Operation& op, io_uring_sqe* sqe)
+		{
+			op.iov.iov_base = (sl_uint8*)(op.request->data) + op.sizeDone;
+			op.iov.iov_len = op.request->size - op.sizeDone;
+			sqe->opcode = op.flagRead ? IORING_OP_READV : IORING_OP_WRITEV;
+			sqe->fd = (int)(getHandle());
+			sqe->off = op.offset + op.sizeDone;
+			sqe->addr = (sl_uint64)(sl_size)(&(op.iov));
+			sqe->len = 1;
+			sqe->user_data = (sl_uint64)(sl_size)(static_cast<_AsyncIoUringCompletion*>(&op));
+			m_ring->pushSubmissionEntry();
+		}
+
+		void onEvent(EventDesc* pev) override
+		{
+			Ref<AsyncIoInstance> self = this;
+			decreaseReference();
+
+			Operation* op = (Operation*)(static_cast<_AsyncIoUringCompletion*>(pev->pCompletion));
+			sl_int32 res = pev->result;
+			if (!(op->flagRead) && res > 0 && op->request.isNotNull()) {
+				op->sizeDone += (sl_uint32)res;
+				if (op->sizeDone < op->request->size && isOpened()) {
+					// short write: the remaining bytes are written in place, before the following writes are reported
+					io_uring_sqe* sqe = m_ring->getSubmissionEntry();
+					if (sqe) {
+						_prepareEntry(*op, sqe);
+						increaseReference();
+						return;
+					}
+					// the ring is full: writes the rest synchronously rather than leaving a hole
+					while (op->sizeDone < op->request->size) {
+						ssize_t n = ::pwrite((int)(getHandle()), (sl_uint8*)(op->request->data) + op->sizeDone, op->request->size - op->sizeDone, (off_t)(op->offset + op->sizeDone));
+						if (n <= 0) {
+							if (n < 0 && errno == EINTR) {
+								continue;
+							}
+							break;
+						}
+						op->sizeDone += (sl_uint32)n;
+					}
+					if (op->sizeDone < op->request->size) {
+						res = -EIO;
+					}
+				}
+				if (res > 0) {
+					res = (sl_int32)(op->sizeDone);
+				}
+			}
+			op->flagDone = sl_true;
+			op->result = res;
+
+			while (m_nOperations) {
+				Operation& front = m_operations[m_indexFirstOperation];
+				if (!(front.flagDone)) {
+					break;
+				}
+				Ref<AsyncStreamRequest> req = front.request;
+				sl_int32 result = front.result;
+				front.request.setNull();
+				front.flagDone = sl_false;
+				m_indexFirstOperation = (m_indexFirstOperation + 1) % ASYNC_URING_FILE_MAX_OPERATIONS;
+				m_nOperations--;
+				if (req.isNotNull() && isOpened()) {
+					Ref<AsyncIoObject> object = getObject();
+					if (object.isNotNull()) {
+						if (result > 0) {
+							req->runCallback(static_cast<AsyncStream*>(object.get()), (sl_uint32)result, sl_false);
+						} else {
+							req->runCallback(static_cast<AsyncStream*>(object.get()), 0, sl_true);
+						}
+					}
+				}
+			}
+
+			if (isOpened() && (getReadRequestsCount() || getWriteRequestsCount())) {
+				requestOrder();
+			}
+		}
+
+		sl_bool isSeekable() override
+		{
+			return sl_true;
+		}
+
+		sl_bool seek(sl_uint64 pos) override
+		{
+			m_offset = pos;
+			return sl_true;
+		}
+
+		sl_uint64 getSize() override
+		{
+			return File::getSize(getHandle());
+		}
+
+	};
+
+	Ref<AsyncStream> AsyncFile::openIoUring(const String& path, FileMode mode, const Ref<AsyncIoLoop>& loop)
+	{
+		if (loop.isNull()) {
+			return sl_null;
+		}
+		_AsyncIoUring* ring = (_AsyncIoUring*)(loop->_native_getIoUring());
+		if (!ring) {
+			return sl_null;
+		}
+		Ref<_AsyncIoUringFileStreamInstance> ret = _AsyncIoUringFileStreamInstance::open(ring, path, mode);
+		if (ret.isNotNull()) {
+			// regular files are not registered to epoll
+			return AsyncStream::create(ret.get(), AsyncIoMode::None, loop);
+		}
+		return sl_null;
+	}
+
+}
+
+#endif
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_ASYNC_URING
+#define CHECKHEADER_SLIB_CORE_ASYNC_URING
+
+#include "async_config.h"
+
+#if defined(ASYNC_USE_URING)
+
+#include "slib/core/async.h"
+
+#include <linux/io_uring.h>
+
+namespace slib
+{
+
+	// `user_data` of the submitted entries points to this structure
+	struct _AsyncIoUringCompletion
+	{
+		AsyncIoInstance* instance;
+	};
+
+	class _AsyncIoUring
+	{
+	public:
+		_AsyncIoUring();
+
+		~_AsyncIoUring();
+
+	public:
+		// returns null when io_uring is not supported (or not permitted) on the running kernel
+		static _AsyncIoUring* create(sl_uint32 nEntries);
+
+	public:
+		// eventfd signaled on every completion
+		int getEventHandle();
+
+		// returns the free entry to be filled, or null when the submission queue is full
+		io_uring_sqe* getSubmissionEntry();
+
+		// queues the entry returned by `getSubmissionEntry()`
+		void pushSubmissionEntry();
+
+		// submits all queued entries by one system call
+		void submit();
+
+		struct Completion
+		{
+			_AsyncIoUringCompletion* completion;
+			sl_int32 result;
+		};
+
+		sl_uint32 popCompletions(Completion* completions, sl_uint32 nMax);
+
+		void clearEvent();
+
+	protected:
+		int m_fd;
+		int m_fdEvent;
+
+		void* m_ringSq;
+		sl_size m_sizeRingSq;
+		void* m_ringCq;
+		sl_size m_sizeRingCq;
+		io_uring_sqe* m_sqes;
+		sl_size m_sizeSqes;
+
+		unsigned* m_sqHead;
+		unsigned* m_sqTail;
+		unsigned m_sqMask;
+		unsigned* m_sqArray;
+		unsigned m_sqEntries;
+		unsigned m_sqTailLocal;
+		unsigned m_nPending;
+
+		unsigned* m_cqHead;
+		unsigned* m_cqTail;
+		unsigned m_cqMask;
+		io_uring_cqe* m_cqes;
+
+	};
+
+}
+
+#endif
+
+#endif
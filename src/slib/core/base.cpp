@@ -10,6 +10,8 @@
 
 #include "slib/core/base.h"
 
+#include "slib/core/memory_allocator.h"
+#include "slib/core/memory_arena.h"
 #include "slib/core/system.h"
 #include "slib/core/math.h"
 
@@ -47,18 +49,52 @@ namespace slib
 	typedef char32_t _base_char32;
 #endif
 
+	extern MemoryAllocator* _g_memory_allocator_current;
+	extern sl_bool _g_memory_arena_enabled;
+
 	void* Base::createMemory(sl_size size) noexcept
 	{
+		if (_g_memory_arena_enabled) {
+			MemoryArena* arena = ArenaScope::getCurrent();
+			if (arena) {
+				return arena->allocate(size);
+			}
+		}
+		MemoryAllocator* allocator = _g_memory_allocator_current;
+		if (allocator) {
+			return allocator->createMemory(size);
+		}
 		return ::malloc(size);
 	}
 
 	void Base::freeMemory(void* ptr) noexcept
 	{
+		if (_g_memory_arena_enabled) {
+			// the blocks of the arenas are freed with their arenas
+			if (MemoryArena::isArenaMemory(ptr)) {
+				return;
+			}
+		}
+		MemoryAllocator* allocator = _g_memory_allocator_current;
+		if (allocator) {
+			allocator->freeMemory(ptr);
+			return;
+		}
 		::free(ptr);
 	}
 
 	void* Base::reallocMemory(void* ptr, sl_size sizeNew) noexcept
 	{
+		if (_g_memory_arena_enabled) {
+			MemoryArena* arena = ptr ? MemoryArena::getArena(ptr) : ArenaScope::getCurrent();
+			if (arena) {
+				return arena->reallocate(ptr, sizeNew);
+			}
+		}
+		MemoryAllocator* allocator = _g_memory_allocator_current;
+		if (allocator) {
+			return allocator->reallocMemory(ptr, sizeNew);
+		}
 		if (sizeNew == 0) {
 			::free(ptr);
 			return ::malloc(1);
@@ -69,7 +105,7 @@ namespace slib
 
 	void* Base::createZeroMemory(sl_size size) noexcept
 	{
-		void* ptr = ::malloc(size);
+		void* ptr = createMemory(size);
 		if (ptr) {
 			::memset(ptr, 0, size);
 		}
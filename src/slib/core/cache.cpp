@@ -0,0 +1,183 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "slib/core/cache.h"
+
+#include "slib/core/base.h"
+
+// a word holds 16 counters of 4 bits: 4 counters for each of the 4 rows
+#define _PRIV_CACHE_SKETCH_MAX_WORDS ((sl_size)1 << 24)
+
+namespace slib
+{
+
+	CacheParam::CacheParam()
+	{
+		policy = CachePolicy::TinyLFU;
+		maximumWeight = 10000;
+		timeToLive = 0;
+		shardsCount = SLIB_CACHE_DEFAULT_SHARDS;
+	}
+
+	CacheParam::~CacheParam()
+	{
+	}
+
+
+	CacheStatistics::CacheStatistics()
+	{
+		hitCount = 0;
+		missCount = 0;
+		loadSuccessCount = 0;
+		loadFailureCount = 0;
+		evictionCount = 0;
+		expirationCount = 0;
+		count = 0;
+		weight = 0;
+	}
+
+	CacheStatistics::~CacheStatistics()
+	{
+	}
+
+	double CacheStatistics::getHitRate() const
+	{
+		sl_uint64 total = hitCount + missCount;
+		if (total) {
+			return (double)hitCount / (double)total;
+		}
+		return 0;
+	}
+
+
+	SLIB_INLINE static sl_uint64 _priv_CacheFrequencySketch_mix(sl_uint64 h)
+	{
+		h *= 0xBF58476D1CE4E5B9ULL;
+		h ^= h >> 31;
+		h *= 0x94D049BB133111EBULL;
+		h ^= h >> 29;
+		return h;
+	}
+
+	// row `i` of the sketch: the word is chosen by double hashing, and one of the 4 counters of the row in the word by 2 bits of the top byte
+	SLIB_INLINE static sl_size _priv_CacheFrequencySketch_getSlot(sl_uint64 h1, sl_uint64 h2, sl_uint32 i, sl_size mask, sl_uint32& shift)
+	{
+		shift = (sl_uint32)(((i << 2) + ((h1 >> (56 + (i << 1))) & 3)) << 2);
+		return (sl_size)(h1 + i * h2) & mask;
+	}
+
+	CacheFrequencySketch::CacheFrequencySketch()
+	{
+		m_table = sl_null;
+		m_capacity = 0;
+		m_mask = 0;
+		m_size = 0;
+		m_sampleSize = 0;
+	}
+
+	CacheFrequencySketch::~CacheFrequencySketch()
+	{
+		if (m_table) {
+			Base::freeMemory(m_table);
+		}
+	}
+
+	sl_size CacheFrequencySketch::getCapacity() const
+	{
+		return m_capacity;
+	}
+
+	void CacheFrequencySketch::ensureCapacity(sl_size capacity)
+	{
+		if (capacity <= m_capacity) {
+			return;
+		}
+		sl_size n = 8;
+		while (n < capacity && n < _PRIV_CACHE_SKETCH_MAX_WORDS) {
+			n <<= 1;
+		}
+		if (n <= m_mask + 1 && m_table) {
+			m_capacity = capacity;
+			return;
+		}
+		sl_uint64* table = (sl_uint64*)(Base::createMemory(n * sizeof(sl_uint64)));
+		if (!table) {
+			return;
+		}
+		Base::zeroMemory(table, n * sizeof(sl_uint64));
+		if (m_table) {
+			Base::freeMemory(m_table);
+		}
+		m_table = table;
+		m_capacity = capacity;
+		m_mask = n - 1;
+		m_size = 0;
+		m_sampleSize = n * 10;
+	}
+
+	void CacheFrequencySketch::increment(sl_size hash)
+	{
+		sl_uint64* table = m_table;
+		if (!table) {
+			return;
+		}
+		sl_uint64 h1 = _priv_CacheFrequencySketch_mix(hash);
+		sl_uint64 h2 = (h1 >> 32) | 1;
+		sl_bool flagAdded = sl_false;
+		for (sl_uint32 i = 0; i < 4; i++) {
+			sl_uint32 shift;
+			sl_uint64& word = table[_priv_CacheFrequencySketch_getSlot(h1, h2, i, m_mask, shift)];
+			if (((word >> shift) & 15) != 15) {
+				word += (sl_uint64)1 << shift;
+				flagAdded = sl_true;
+			}
+		}
+		if (flagAdded) {
+			m_size++;
+			if (m_size >= m_sampleSize) {
+				// aging: halves all counters
+				sl_size n = m_mask + 1;
+				for (sl_size i = 0; i < n; i++) {
+					table[i] = (table[i] >> 1) & 0x7777777777777777ULL;
+				}
+				m_size >>= 1;
+			}
+		}
+	}
+
+	sl_uint32 CacheFrequencySketch::getFrequency(sl_size hash) const
+	{
+		sl_uint64* table = m_table;
+		if (!table) {
+			return 0;
+		}
+		sl_uint64 h1 = _priv_CacheFrequencySketch_mix(hash);
+		sl_uint64 h2 = (h1 >> 32) | 1;
+		sl_uint32 freq = 15;
+		for (sl_uint32 i = 0; i < 4; i++) {
+			sl_uint32 shift;
+			sl_uint64 word = table[_priv_CacheFrequencySketch_getSlot(h1, h2, i, m_mask, shift)];
+			sl_uint32 count = (sl_uint32)((word >> shift) & 15);
+			if (count < freq) {
+				freq = count;
+			}
+		}
+		return freq;
+	}
+
+	void CacheFrequencySketch::clear()
+	{
+		if (m_table) {
+			Base::zeroMemory(m_table, (m_mask + 1) * sizeof(sl_uint64));
+		}
+		m_size = 0;
+	}
+
+}
@@ -0,0 +1,136 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "slib/core/cpu.h"
+
+#if defined(SLIB_ARCH_IS_X64) || defined(SLIB_ARCH_IS_X86)
+#	define _PRIV_CPU_X86
+#	if defined(SLIB_COMPILER_IS_VC)
+#		include <intrin.h>
+#	else
+#		include <cpuid.h>
+#	endif
+#endif
+
+#define _PRIV_CPU_DETECTED 1
+#define _PRIV_CPU_SSE2 2
+#define _PRIV_CPU_SSSE3 4
+#define _PRIV_CPU_SSE41 8
+#define _PRIV_CPU_AVX2 16
+#define _PRIV_CPU_NEON 32
+
+namespace slib
+{
+
+	// written once by any thread, always with the same value
+	static sl_uint32 _g_cpu_features = 0;
+
+#if defined(_PRIV_CPU_X86)
+	static void _priv_Cpu_cpuid(sl_uint32 leaf, sl_uint32 subleaf, sl_uint32 regs[4]) noexcept
+	{
+#	if defined(SLIB_COMPILER_IS_VC)
+		int r[4];
+		__cpuidex(r, (int)leaf, (int)subleaf);
+		regs[0] = (sl_uint32)(r[0]);
+		regs[1] = (sl_uint32)(r[1]);
+		regs[2] = (sl_uint32)(r[2]);
+		regs[3] = (sl_uint32)(r[3]);
+#	else
+		unsigned int a, b, c, d;
+		__cpuid_count(leaf, subleaf, a, b, c, d);
+		regs[0] = a;
+		regs[1] = b;
+		regs[2] = c;
+		regs[3] = d;
+#	endif
+	}
+
+	static sl_uint64 _priv_Cpu_xgetbv() noexcept
+	{
+#	if defined(SLIB_COMPILER_IS_VC)
+		return _xgetbv(0);
+#	else
+		sl_uint32 lo, hi;
+		__asm__ __volatile__ ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+		return ((sl_uint64)hi << 32) | lo;
+#	endif
+	}
+#endif
+
+	static sl_uint32 _priv_Cpu_detect() noexcept
+	{
+		sl_uint32 features = _PRIV_CPU_DETECTED;
+#if defined(_PRIV_CPU_X86)
+		sl_uint32 regs[4];
+		_priv_Cpu_cpuid(0, 0, regs);
+		sl_uint32 nMaxLeaf = regs[0];
+		if (nMaxLeaf >= 1) {
+			_priv_Cpu_cpuid(1, 0, regs);
+			if (regs[3] & (1 << 26)) {
+				features |= _PRIV_CPU_SSE2;
+			}
+			if (regs[2] & (1 << 9)) {
+				features |= _PRIV_CPU_SSSE3;
+			}
+			if (regs[2] & (1 << 19)) {
+				features |= _PRIV_CPU_SSE41;
+			}
+			// AVX and OSXSAVE, and the OS saves the XMM and YMM states
+			sl_bool flagAVX = (regs[2] & (1 << 27)) && (regs[2] & (1 << 28)) && ((_priv_Cpu_xgetbv() & 6) == 6);
+			if (flagAVX && nMaxLeaf >= 7) {
+				_priv_Cpu_cpuid(7, 0, regs);
+				if (regs[1] & (1 << 5)) {
+					features |= _PRIV_CPU_AVX2;
+				}
+			}
+		}
+#elif defined(SLIB_ARCH_IS_ARM64) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+		features |= _PRIV_CPU_NEON;
+#endif
+		return features;
+	}
+
+	static sl_uint32 _priv_Cpu_getFeatures() noexcept
+	{
+		sl_uint32 features = _g_cpu_features;
+		if (features) {
+			return features;
+		}
+		features = _priv_Cpu_detect();
+		_g_cpu_features = features;
+		return features;
+	}
+
+	sl_bool Cpu::isSupportingSSE2() noexcept
+	{
+		return (_priv_Cpu_getFeatures() & _PRIV_CPU_SSE2) != 0;
+	}
+
+	sl_bool Cpu::isSupportingSSSE3() noexcept
+	{
+		return (_priv_Cpu_getFeatures() & _PRIV_CPU_SSSE3) != 0;
+	}
+
+	sl_bool Cpu::isSupportingSSE41() noexcept
+	{
+		return (_priv_Cpu_getFeatures() & _PRIV_CPU_SSE41) != 0;
+	}
+
+	sl_bool Cpu::isSupportingAVX2() noexcept
+	{
+		return (_priv_Cpu_getFeatures() & _PRIV_CPU_AVX2) != 0;
+	}
+
+	sl_bool Cpu::isSupportingNEON() noexcept
+	{
+		return (_priv_Cpu_getFeatures() & _PRIV_CPU_NEON) != 0;
+	}
+
+}
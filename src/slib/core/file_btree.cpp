@@ -0,0 +1,581 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "slib/core/file_btree.h"
+
+#include "slib/core/mio.h"
+#include "slib/crypto/zlib.h"
+
+#if defined(SLIB_PLATFORM_IS_UNIX)
+#include <sys/mman.h>
+#endif
+
+#define STORAGE_MAGIC 0x53504C53 // SLPS
+#define STORAGE_VERSION 1
+#define STORAGE_HEADER_SIZE 56
+#define STORAGE_MIN_PAGE_SIZE 64
+#define STORAGE_DEFAULT_CACHE_PAGES 1024
+
+#define LOG_MAGIC 0x4C504C53 // SLPL
+// magic, page size, number of the records
+#define LOG_HEADER_SIZE 16
+#define LOG_TRAILER_SIZE 20
+
+namespace slib
+{
+
+	FilePageStorageParam::FilePageStorageParam()
+	{
+		cachePagesCount = STORAGE_DEFAULT_CACHE_PAGES;
+		flagUseMemoryMap = sl_true;
+		flagSynchronous = sl_true;
+	}
+
+	FilePageStorageParam::~FilePageStorageParam()
+	{
+	}
+
+
+	SLIB_DEFINE_OBJECT(FilePageStorage, Object)
+
+	FilePageStorage::FilePageStorage()
+	{
+		m_sizePage = 0;
+		m_signature = 0;
+
+		m_countPages = 0;
+		m_rootPage = 0;
+		m_freePageHead = 0;
+		m_countFreePages = 0;
+		m_flagHeaderDirty = sl_false;
+		m_countPagesInFile = 0;
+
+		m_slots = sl_null;
+		m_countSlots = 0;
+		m_capacitySlots = 0;
+		m_countDirtySlots = 0;
+		m_indexClock = 0;
+
+		m_mapData = sl_null;
+		m_sizeMap = 0;
+	}
+
+	FilePageStorage::~FilePageStorage()
+	{
+		_unmapFile();
+		_freeSlots();
+		if (m_file.isNotNull()) {
+			m_file->unlock();
+		}
+	}
+
+	Ref<FilePageStorage> FilePageStorage::open(const String& filePath, sl_uint32 pageSize, sl_uint64 signature, const FilePageStorageParam& param)
+	{
+		if (pageSize < STORAGE_MIN_PAGE_SIZE) {
+			return sl_null;
+		}
+		Ref<File> file = File::openForRandomAccess(filePath);
+		if (file.isNull()) {
+			return sl_null;
+		}
+		if (!(file->lock())) {
+			return sl_null;
+		}
+		Ref<File> fileLog = File::openForRandomAccess(filePath + "-wal");
+		if (fileLog.isNull()) {
+			file->unlock();
+			return sl_null;
+		}
+		Ref<FilePageStorage> ret = new FilePageStorage;
+		if (ret.isNull()) {
+			file->unlock();
+			return sl_null;
+		}
+		ret->m_path = filePath;
+		ret->m_file = file;
+		ret->m_fileLog = fileLog;
+		ret->m_sizePage = pageSize;
+		ret->m_signature = signature;
+		ret->m_param = param;
+		if (ret->_initialize()) {
+			return ret;
+		}
+		return sl_null;
+	}
+
+	Ref<FilePageStorage> FilePageStorage::open(const String& filePath, sl_uint32 pageSize, sl_uint64 signature)
+	{
+		FilePageStorageParam param;
+		return open(filePath, pageSize, signature, param);
+	}
+
+	String FilePageStorage::getFilePath()
+	{
+		return m_path;
+	}
+
+	sl_uint32 FilePageStorage::getPageSize()
+	{
+		return m_sizePage;
+	}
+
+	sl_uint64 FilePageStorage::getPagesCount()
+	{
+		return m_countPages;
+	}
+
+	sl_uint64 FilePageStorage::getFreePagesCount()
+	{
+		return m_countFreePages;
+	}
+
+	sl_uint64 FilePageStorage::getRootPage()
+	{
+		return m_rootPage;
+	}
+
+	void FilePageStorage::setRootPage(sl_uint64 index)
+	{
+		if (m_rootPage != index) {
+			m_rootPage = index;
+			m_flagHeaderDirty = sl_true;
+		}
+	}
+
+	sl_uint64 FilePageStorage::allocatePage()
+	{
+		sl_uint64 index = m_freePageHead;
+		if (index) {
+			const sl_uint8* page = readPage(index);
+			if (!page) {
+				return 0;
+			}
+			m_freePageHead = (sl_uint64)(MIO::readInt64LE(page));
+			m_countFreePages--;
+		} else {
+			index = m_countPages;
+			m_countPages++;
+		}
+		m_flagHeaderDirty = sl_true;
+		return index;
+	}
+
+	sl_bool FilePageStorage::freePage(sl_uint64 index)
+	{
+		sl_uint8* page = writePage(index);
+		if (!page) {
+			return sl_false;
+		}
+		Base::zeroMemory(page, m_sizePage);
+		MIO::writeInt64LE(page, (sl_int64)m_freePageHead);
+		m_freePageHead = index;
+		m_countFreePages++;
+		m_flagHeaderDirty = sl_true;
+		return sl_true;
+	}
+
+	const sl_uint8* FilePageStorage::readPage(sl_uint64 index)
+	{
+		if (!index || index >= m_countPages) {
+			return sl_null;
+		}
+		PageSlot* slot = _getSlot(index);
+		if (slot) {
+			return slot->data;
+		}
+		if (m_mapData && index < m_countPagesInFile) {
+			return m_mapData + (sl_size)(index * m_sizePage);
+		}
+		slot = _loadSlot(index);
+		if (slot) {
+			return slot->data;
+		}
+		return sl_null;
+	}
+
+	sl_uint8* FilePageStorage::writePage(sl_uint64 index)
+	{
+		if (!index || index >= m_countPages) {
+			return sl_null;
+		}
+		PageSlot* slot = _getSlot(index);
+		if (!slot) {
+			slot = _loadSlot(index);
+			if (!slot) {
+				return sl_null;
+			}
+		}
+		if (!(slot->flagDirty)) {
+			slot->flagDirty = sl_true;
+			m_countDirtySlots++;
+		}
+		return slot->data;
+	}
+
+	sl_bool FilePageStorage::commit()
+	{
+		if (!m_countDirtySlots && !m_flagHeaderDirty) {
+			return sl_true;
+		}
+		sl_size nPages = m_countDirtySlots + 1;
+		sl_size i;
+
+		sl_size sizeRecord = 8 + m_sizePage;
+		sl_size sizeLog = LOG_HEADER_SIZE + nPages * sizeRecord + LOG_TRAILER_SIZE;
+		Memory memLog = Memory::create(sizeLog);
+		if (memLog.isNull()) {
+			return sl_false;
+		}
+		sl_uint8* log = (sl_uint8*)(memLog.getData());
+		MIO::writeUint32LE(log, LOG_MAGIC);
+		MIO::writeUint32LE(log + 4, m_sizePage);
+		MIO::writeInt64LE(log + 8, (sl_int64)nPages);
+		sl_uint8* p = log + LOG_HEADER_SIZE;
+		MIO::writeInt64LE(p, 0);
+		_writeHeader(p + 8);
+		p += sizeRecord;
+		for (i = 0; i < m_countSlots; i++) {
+			PageSlot& slot = m_slots[i];
+			if (slot.flagDirty) {
+				MIO::writeInt64LE(p, (sl_int64)(slot.index));
+				Base::copyMemory(p + 8, slot.data, m_sizePage);
+				p += sizeRecord;
+			}
+		}
+		MIO::writeInt64LE(p, -1);
+		MIO::writeInt64LE(p + 8, (sl_int64)nPages);
+		MIO::writeUint32LE(p + 16, Zlib::crc32(log, (sl_size)(p + 16 - log)));
+
+		if (!(m_fileLog->seek(0, SeekPosition::Begin))) {
+			return sl_false;
+		}
+		if (m_fileLog->writeFully(log, sizeLog) != (sl_reg)sizeLog) {
+			return sl_false;
+		}
+		if (m_param.flagSynchronous) {
+			if (!(m_fileLog->flush())) {
+				return sl_false;
+			}
+		}
+		// from here, the transaction is durable: a failure below is recovered by replaying the log on next open
+		if (!(_applyLog(log, nPages))) {
+			return sl_false;
+		}
+		// the pages stay dirty on failure, so the next commit writes them again with a new log
+		if (!(m_fileLog->setSize(0))) {
+			return sl_false;
+		}
+
+		for (i = 0; i < m_countSlots; i++) {
+			m_slots[i].flagDirty = sl_false;
+		}
+		m_countDirtySlots = 0;
+		m_flagHeaderDirty = sl_false;
+		if (m_countPages > m_countPagesInFile) {
+			// allocated pages are written only when they are modified: extends the file with zeros, so that the mapping does not pass the end of file
+			sl_uint64 size = m_countPages * m_sizePage;
+			if (m_file->getSize() < size) {
+				m_file->setSize(size);
+			}
+			m_countPagesInFile = m_file->getSize() / m_sizePage;
+			if (m_countPagesInFile > m_countPages) {
+				m_countPagesInFile = m_countPages;
+			}
+			_mapFile();
+		}
+		return sl_true;
+	}
+
+	void FilePageStorage::rollback()
+	{
+		for (sl_size i = 0; i < m_countSlots; i++) {
+			PageSlot& slot = m_slots[i];
+			if (slot.flagDirty) {
+				m_mapSlots.remove_NoLock(slot.index);
+				slot.index = 0;
+				slot.flagDirty = sl_false;
+				slot.flagReferenced = sl_false;
+			}
+		}
+		m_countDirtySlots = 0;
+		_readHeader();
+		m_flagHeaderDirty = sl_false;
+	}
+
+	sl_bool FilePageStorage::_initialize()
+	{
+		if (!(_replayLog())) {
+			return sl_false;
+		}
+		sl_uint64 size = m_file->getSize();
+		m_countPagesInFile = size / m_sizePage;
+		if (size) {
+			if (!(_readHeader())) {
+				return sl_false;
+			}
+			_mapFile();
+		} else {
+			m_countPages = 1;
+			m_rootPage = 0;
+			m_freePageHead = 0;
+			m_countFreePages = 0;
+			m_flagHeaderDirty = sl_true;
+			if (!(commit())) {
+				return sl_false;
+			}
+		}
+		return sl_true;
+	}
+
+	sl_bool FilePageStorage::_readHeader()
+	{
+		sl_uint8 header[STORAGE_HEADER_SIZE];
+		if (!(m_file->seek(0, SeekPosition::Begin))) {
+			return sl_false;
+		}
+		if (m_file->readFully(header, STORAGE_HEADER_SIZE) != STORAGE_HEADER_SIZE) {
+			return sl_false;
+		}
+		if (MIO::readUint32LE(header) != STORAGE_MAGIC) {
+			return sl_false;
+		}
+		if (MIO::readUint32LE(header + 4) != STORAGE_VERSION) {
+			return sl_false;
+		}
+		if (MIO::readUint32LE(header + 8) != m_sizePage) {
+			return sl_false;
+		}
+		if ((sl_uint64)(MIO::readInt64LE(header + 16)) != m_signature) {
+			return sl_false;
+		}
+		m_countPages = (sl_uint64)(MIO::readInt64LE(header + 24));
+		m_rootPage = (sl_uint64)(MIO::readInt64LE(header + 32));
+		m_freePageHead = (sl_uint64)(MIO::readInt64LE(header + 40));
+		m_countFreePages = (sl_uint64)(MIO::readInt64LE(header + 48));
+		if (!m_countPages || m_rootPage >= m_countPages || m_freePageHead >= m_countPages) {
+			return sl_false;
+		}
+		return sl_true;
+	}
+
+	void FilePageStorage::_writeHeader(sl_uint8* page)
+	{
+		Base::zeroMemory(page, m_sizePage);
+		MIO::writeUint32LE(page, STORAGE_MAGIC);
+		MIO::writeUint32LE(page + 4, STORAGE_VERSION);
+		MIO::writeUint32LE(page + 8, m_sizePage);
+		MIO::writeInt64LE(page + 16, (sl_int64)m_signature);
+		MIO::writeInt64LE(page + 24, (sl_int64)m_countPages);
+		MIO::writeInt64LE(page + 32, (sl_int64)m_rootPage);
+		MIO::writeInt64LE(page + 40, (sl_int64)m_freePageHead);
+		MIO::writeInt64LE(page + 48, (sl_int64)m_countFreePages);
+	}
+
+	sl_bool FilePageStorage::_replayLog()
+	{
+		sl_uint64 size = m_fileLog->getSize();
+		if (!size) {
+			return sl_true;
+		}
+		sl_size sizeRecord = 8 + m_sizePage;
+		if (size >= LOG_HEADER_SIZE + sizeRecord + LOG_TRAILER_SIZE && size <= SLIB_SIZE_MAX) {
+			if (m_fileLog->seek(0, SeekPosition::Begin)) {
+				Memory mem = m_fileLog->readAllBytes();
+				if (mem.getSize() == size) {
+					sl_uint8* log = (sl_uint8*)(mem.getData());
+					// the length is taken from the header, so bytes left behind by an older, longer log are ignored
+					sl_uint64 nPages = (sl_uint64)(MIO::readInt64LE(log + 8));
+					if (MIO::readUint32LE(log) == LOG_MAGIC && MIO::readUint32LE(log + 4) == m_sizePage && nPages && nPages <= (size - LOG_HEADER_SIZE - LOG_TRAILER_SIZE) / sizeRecord) {
+						sl_size sizeLog = LOG_HEADER_SIZE + (sl_size)nPages * sizeRecord + LOG_TRAILER_SIZE;
+						sl_uint8* trailer = log + sizeLog - LOG_TRAILER_SIZE;
+						if (MIO::readInt64LE(trailer) == -1 && (sl_uint64)(MIO::readInt64LE(trailer + 8)) == nPages && MIO::readUint32LE(trailer + 16) == Zlib::crc32(log, sizeLog - 4)) {
+							if (!(_applyLog(log, (sl_size)nPages))) {
+								return sl_false;
+							}
+						}
+					}
+				}
+			}
+		}
+		// an incomplete log belongs to a transaction which was never committed
+		m_fileLog->setSize(0);
+		if (m_param.flagSynchronous) {
+			m_fileLog->flush();
+		}
+		return sl_true;
+	}
+
+	sl_bool FilePageStorage::_applyLog(const sl_uint8* log, sl_size nPages)
+	{
+		sl_size sizeRecord = 8 + m_sizePage;
+		const sl_uint8* p = log + LOG_HEADER_SIZE;
+		for (sl_size i = 0; i < nPages; i++) {
+			sl_uint64 index = (sl_uint64)(MIO::readInt64LE(p));
+			if (!(m_file->seek(index * m_sizePage, SeekPosition::Begin))) {
+				return sl_false;
+			}
+			if (m_file->writeFully(p + 8, m_sizePage) != (sl_reg)(m_sizePage)) {
+				return sl_false;
+			}
+			p += sizeRecord;
+		}
+		if (m_param.flagSynchronous) {
+			if (!(m_file->flush())) {
+				return sl_false;
+			}
+		}
+		return sl_true;
+	}
+
+	FilePageStorage::PageSlot* FilePageStorage::_getSlot(sl_uint64 index)
+	{
+		sl_size* p = m_mapSlots.getItemPointer(index);
+		if (p) {
+			PageSlot* slot = m_slots + *p;
+			slot->flagReferenced = sl_true;
+			return slot;
+		}
+		return sl_null;
+	}
+
+	FilePageStorage::PageSlot* FilePageStorage::_loadSlot(sl_uint64 index)
+	{
+		PageSlot* slot = _allocateSlot();
+		if (!slot) {
+			return sl_null;
+		}
+		if (index < m_countPagesInFile) {
+			if (m_mapData) {
+				Base::copyMemory(slot->data, m_mapData + (sl_size)(index * m_sizePage), m_sizePage);
+			} else {
+				if (!(_readPageFromFile(index, slot->data))) {
+					return sl_null;
+				}
+			}
+		} else {
+			Base::zeroMemory(slot->data, m_sizePage);
+		}
+		if (!(m_mapSlots.put_NoLock(index, (sl_size)(slot - m_slots)))) {
+			return sl_null;
+		}
+		slot->index = index;
+		slot->flagDirty = sl_false;
+		slot->flagReferenced = sl_true;
+		return slot;
+	}
+
+	FilePageStorage::PageSlot* FilePageStorage::_allocateSlot()
+	{
+		sl_size n = m_countSlots;
+		if (n - m_countDirtySlots >= m_param.cachePagesCount && n) {
+			// clock replacement over the clean pages: dirty pages are pinned until commit
+			for (sl_size i = 0; i < 2 * n; i++) {
+				PageSlot* slot = m_slots + m_indexClock;
+				m_indexClock++;
+				if (m_indexClock >= n) {
+					m_indexClock = 0;
+				}
+				if (!(slot->index)) {
+					return slot;
+				}
+				if (slot->flagDirty) {
+					continue;
+				}
+				if (slot->flagReferenced) {
+					slot->flagReferenced = sl_false;
+					continue;
+				}
+				m_mapSlots.remove_NoLock(slot->index);
+				slot->index = 0;
+				return slot;
+			}
+		}
+		if (n >= m_capacitySlots) {
+			sl_size capacity = m_capacitySlots ? m_capacitySlots * 2 : 16;
+			PageSlot* slots = (PageSlot*)(Base::reallocMemory(m_slots, capacity * sizeof(PageSlot)));
+			if (!slots) {
+				return sl_null;
+			}
+			m_slots = slots;
+			m_capacitySlots = capacity;
+		}
+		sl_uint8* data = (sl_uint8*)(Base::createMemory(m_sizePage));
+		if (!data) {
+			return sl_null;
+		}
+		PageSlot* slot = m_slots + n;
+		slot->index = 0;
+		slot->data = data;
+		slot->flagDirty = sl_false;
+		slot->flagReferenced = sl_false;
+		m_countSlots = n + 1;
+		return slot;
+	}
+
+	void FilePageStorage::_freeSlots()
+	{
+		for (sl_size i = 0; i < m_countSlots; i++) {
+			Base::freeMemory(m_slots[i].data);
+		}
+		if (m_slots) {
+			Base::freeMemory(m_slots);
+		}
+		m_slots = sl_null;
+		m_countSlots = 0;
+		m_capacitySlots = 0;
+		m_mapSlots.removeAll_NoLock();
+	}
+
+	sl_bool FilePageStorage::_readPageFromFile(sl_uint64 index, sl_uint8* data)
+	{
+		if (!(m_file->seek(index * m_sizePage, SeekPosition::Begin))) {
+			return sl_false;
+		}
+		sl_reg n = m_file->readFully(data, m_sizePage);
+		if (n < 0) {
+			return sl_false;
+		}
+		if ((sl_uint32)n < m_sizePage) {
+			Base::zeroMemory(data + n, m_sizePage - (sl_uint32)n);
+		}
+		return sl_true;
+	}
+
+	void FilePageStorage::_mapFile()
+	{
+		_unmapFile();
+#if defined(SLIB_PLATFORM_IS_UNIX)
+		if (!(m_param.flagUseMemoryMap)) {
+			return;
+		}
+		sl_uint64 size = m_countPagesInFile * m_sizePage;
+		if (!size || size > SLIB_SIZE_MAX) {
+			return;
+		}
+		void* p = ::mmap(sl_null, (size_t)size, PROT_READ, MAP_SHARED, (int)(m_file->getHandle()), 0);
+		if (p != MAP_FAILED) {
+			m_mapData = (sl_uint8*)p;
+			m_sizeMap = (sl_size)size;
+		}
+#endif
+	}
+
+	void FilePageStorage::_unmapFile()
+	{
+#if defined(SLIB_PLATFORM_IS_UNIX)
+		if (m_mapData) {
+			::munmap(m_mapData, m_sizeMap);
+		}
+#endif
+		m_mapData = sl_null;
+		m_sizeMap = 0;
+	}
+
+}
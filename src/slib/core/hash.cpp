@@ -12,52 +12,584 @@
 #include "slib/core/hash_table.h"
 
 #include "slib/core/math.h"
+#include "slib/core/cpu.h"
+#include "slib/core/spin_lock.h"
+#include "slib/core/time.h"
+#include "slib/core/system.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(SLIB_ARCH_IS_X64) || (defined(SLIB_ARCH_IS_X86) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#	define _PRIV_HASH_USE_SSE2
+#	include <immintrin.h>
+#elif defined(SLIB_ARCH_IS_ARM64) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+#	define _PRIV_HASH_USE_NEON
+#	include <arm_neon.h>
+#endif
+
+#if defined(SLIB_COMPILER_IS_VC)
+#	include <intrin.h>
+#endif
 
 namespace slib
 {
 
 	/****************************************************
-	 
-		Fowler–Noll–Vo hash function / FNV-1a hash
-	 
-	 https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
-	 http://www.isthe.com/chongo/tech/comp/fnv/index.html
-	 
+
+		The short and medium inputs are hashed with the
+		wyhash construction (public domain)
+
+	 https://github.com/wangyi-fudan/wyhash
+
+		The inputs longer than 1KB are read in 64-byte
+		stripes into eight 64-bit lanes, like XXH3, so
+		that SSE2, AVX2 and NEON can process them.
+
 	****************************************************/
-	sl_uint32 HashBytes32(const void* _buf, sl_size n) noexcept
+
+	static const sl_uint64 _g_hash_wy_secret[4] = {
+		SLIB_UINT64(0x2d358dccaa6c78a5),
+		SLIB_UINT64(0x8bb84b93962eacc9),
+		SLIB_UINT64(0x4b33a62ed433d4a3),
+		SLIB_UINT64(0x4d5a2da51de1aa47)
+	};
+
+	static const sl_uint64 _g_hash_lanes_init[8] = {
+		SLIB_UINT64(0x00000000C2B2AE3D),
+		SLIB_UINT64(0x9E3779B185EBCA87),
+		SLIB_UINT64(0xC2B2AE3D27D4EB4F),
+		SLIB_UINT64(0x165667B19E3779F9),
+		SLIB_UINT64(0x85EBCA77C2B2AE63),
+		SLIB_UINT64(0x0000000085EBCA77),
+		SLIB_UINT64(0x27D4EB2F165667C5),
+		SLIB_UINT64(0x000000009E3779B1)
+	};
+
+	SLIB_INLINE static sl_uint64 _priv_Hash_read64(const sl_uint8* p) noexcept
+	{
+		sl_uint64 v;
+		memcpy(&v, p, 8);
+		return v;
+	}
+
+	SLIB_INLINE static sl_uint64 _priv_Hash_read32(const sl_uint8* p) noexcept
+	{
+		sl_uint32 v;
+		memcpy(&v, p, 4);
+		return v;
+	}
+
+	SLIB_INLINE static sl_uint64 _priv_Hash_read3(const sl_uint8* p, sl_size k) noexcept
+	{
+		return (((sl_uint64)(p[0])) << 16) | (((sl_uint64)(p[k >> 1])) << 8) | p[k - 1];
+	}
+
+	// 64x64 -> 128 bit multiplication, returning the low half in `a` and the high half in `b`
+	SLIB_INLINE static void _priv_Hash_mum(sl_uint64* a, sl_uint64* b) noexcept
 	{
-		sl_uint8* buf = (sl_uint8*)_buf;
-		sl_uint32 hash = 0x811c9dc5;
-		sl_uint32 prime = 16777619;
-		for (sl_size i = 0; i < n; i++) {
-			hash ^= buf[i];
-			hash *= prime;
+#if defined(__SIZEOF_INT128__)
+		unsigned __int128 r = *a;
+		r *= *b;
+		*a = (sl_uint64)r;
+		*b = (sl_uint64)(r >> 64);
+#elif defined(SLIB_COMPILER_IS_VC) && defined(SLIB_ARCH_IS_X64)
+		*a = _umul128(*a, *b, b);
+#else
+		sl_uint64 ha = *a >> 32, hb = *b >> 32, la = (sl_uint32)*a, lb = (sl_uint32)*b;
+		sl_uint64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+		sl_uint64 t = rl + (rm0 << 32);
+		sl_uint64 c = t < rl;
+		sl_uint64 lo = t + (rm1 << 32);
+		c += lo < t;
+		*a = lo;
+		*b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+	}
+
+	SLIB_INLINE static sl_uint64 _priv_Hash_mix(sl_uint64 a, sl_uint64 b) noexcept
+	{
+		_priv_Hash_mum(&a, &b);
+		return a ^ b;
+	}
+
+	SLIB_INLINE static sl_uint64 _priv_Hash_prepareSeed(sl_uint64 seed) noexcept
+	{
+		return seed ^ _priv_Hash_mix(seed ^ _g_hash_wy_secret[0], _g_hash_wy_secret[1]);
+	}
+
+	// `seed` is prepared by _priv_Hash_prepareSeed()
+	static sl_uint64 _priv_Hash_short(const sl_uint8* p, sl_size len, sl_uint64 seed) noexcept
+	{
+		const sl_uint64* secret = _g_hash_wy_secret;
+		sl_uint64 a, b;
+		if (len <= 16) {
+			if (len >= 4) {
+				a = (_priv_Hash_read32(p) << 32) | _priv_Hash_read32(p + ((len >> 3) << 2));
+				b = (_priv_Hash_read32(p + len - 4) << 32) | _priv_Hash_read32(p + len - 4 - ((len >> 3) << 2));
+			} else if (len > 0) {
+				a = _priv_Hash_read3(p, len);
+				b = 0;
+			} else {
+				a = b = 0;
+			}
+		} else {
+			sl_size i = len;
+			if (i > 48) {
+				sl_uint64 see1 = seed, see2 = seed;
+				do {
+					seed = _priv_Hash_mix(_priv_Hash_read64(p) ^ secret[1], _priv_Hash_read64(p + 8) ^ seed);
+					see1 = _priv_Hash_mix(_priv_Hash_read64(p + 16) ^ secret[2], _priv_Hash_read64(p + 24) ^ see1);
+					see2 = _priv_Hash_mix(_priv_Hash_read64(p + 32) ^ secret[3], _priv_Hash_read64(p + 40) ^ see2);
+					p += 48;
+					i -= 48;
+				} while (i > 48);
+				seed ^= see1 ^ see2;
+			}
+			while (i > 16) {
+				seed = _priv_Hash_mix(_priv_Hash_read64(p) ^ secret[1], _priv_Hash_read64(p + 8) ^ seed);
+				i -= 16;
+				p += 16;
+			}
+			a = _priv_Hash_read64(p + i - 16);
+			b = _priv_Hash_read64(p + i - 8);
 		}
-		return hash;
+		a ^= secret[1];
+		b ^= seed;
+		_priv_Hash_mum(&a, &b);
+		return _priv_Hash_mix(a ^ secret[0] ^ len, b ^ secret[1]);
 	}
-	
-	sl_uint64 HashBytes64(const void* _buf, sl_size n) noexcept
+
+#define _PRIV_HASH_STRIPE_SIZE 64
+#define _PRIV_HASH_STRIPES_PER_BLOCK 16
+#define _PRIV_HASH_BLOCK_SIZE (_PRIV_HASH_STRIPE_SIZE * _PRIV_HASH_STRIPES_PER_BLOCK)
+#define _PRIV_HASH_SECRET_SIZE 192
+#define _PRIV_HASH_SCRAMBLE_SECRET_OFFSET (_PRIV_HASH_SECRET_SIZE - _PRIV_HASH_STRIPE_SIZE)
+#define _PRIV_HASH_LAST_STRIPE_SECRET_OFFSET (_PRIV_HASH_SECRET_SIZE - _PRIV_HASH_STRIPE_SIZE - 7)
+#define _PRIV_HASH_PRIME32 0x9E3779B1
+
+	// each stripe `s` is combined with the secret at `secret + 8 * s`
+	typedef void (*_priv_Hash_AccumulateFunc)(sl_uint64* acc, const sl_uint8* data, const sl_uint8* secret, sl_size nStripes);
+
+	typedef void (*_priv_Hash_ScrambleFunc)(sl_uint64* acc, const sl_uint8* secret);
+
+	static void _priv_Hash_accumulate_scalar(sl_uint64* acc, const sl_uint8* data, const sl_uint8* secret, sl_size nStripes) noexcept
 	{
-		sl_uint8* buf = (sl_uint8*)_buf;
-		sl_uint64 hash = SLIB_UINT64(0xcbf29ce484222325);
-		sl_uint64 prime = SLIB_UINT64(1099511628211);
-		for (sl_size i = 0; i < n; i++) {
-			hash ^= buf[i];
-			hash *= prime;
+		for (sl_size s = 0; s < nStripes; s++) {
+			for (sl_uint32 i = 0; i < 8; i++) {
+				sl_uint64 d = _priv_Hash_read64(data + (i << 3));
+				sl_uint64 k = d ^ _priv_Hash_read64(secret + (i << 3));
+				acc[i ^ 1] += d;
+				acc[i] += (k & 0xFFFFFFFF) * (k >> 32);
+			}
+			data += _PRIV_HASH_STRIPE_SIZE;
+			secret += 8;
 		}
-		return hash;
 	}
-	
+
+	static void _priv_Hash_scramble_scalar(sl_uint64* acc, const sl_uint8* secret) noexcept
+	{
+		for (sl_uint32 i = 0; i < 8; i++) {
+			sl_uint64 a = acc[i];
+			a ^= a >> 47;
+			a ^= _priv_Hash_read64(secret + (i << 3));
+			acc[i] = a * _PRIV_HASH_PRIME32;
+		}
+	}
+
+#if defined(_PRIV_HASH_USE_SSE2)
+	static void _priv_Hash_accumulate_sse2(sl_uint64* _acc, const sl_uint8* data, const sl_uint8* secret, sl_size nStripes) noexcept
+	{
+		__m128i* acc = (__m128i*)_acc;
+		__m128i a0 = _mm_loadu_si128(acc);
+		__m128i a1 = _mm_loadu_si128(acc + 1);
+		__m128i a2 = _mm_loadu_si128(acc + 2);
+		__m128i a3 = _mm_loadu_si128(acc + 3);
+#define _PRIV_HASH_SSE2_LANE(A, OFFSET) \
+		{ \
+			__m128i d = _mm_loadu_si128((const __m128i*)(data + OFFSET)); \
+			__m128i k = _mm_xor_si128(d, _mm_loadu_si128((const __m128i*)(secret + OFFSET))); \
+			__m128i p = _mm_mul_epu32(k, _mm_shuffle_epi32(k, _MM_SHUFFLE(0, 3, 0, 1))); \
+			A = _mm_add_epi64(A, _mm_add_epi64(p, _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2)))); \
+		}
+		for (sl_size s = 0; s < nStripes; s++) {
+			_PRIV_HASH_SSE2_LANE(a0, 0)
+			_PRIV_HASH_SSE2_LANE(a1, 16)
+			_PRIV_HASH_SSE2_LANE(a2, 32)
+			_PRIV_HASH_SSE2_LANE(a3, 48)
+			data += _PRIV_HASH_STRIPE_SIZE;
+			secret += 8;
+		}
+#undef _PRIV_HASH_SSE2_LANE
+		_mm_storeu_si128(acc, a0);
+		_mm_storeu_si128(acc + 1, a1);
+		_mm_storeu_si128(acc + 2, a2);
+		_mm_storeu_si128(acc + 3, a3);
+	}
+
+	static void _priv_Hash_scramble_sse2(sl_uint64* _acc, const sl_uint8* secret) noexcept
+	{
+		__m128i* acc = (__m128i*)_acc;
+		__m128i prime = _mm_set1_epi32((int)_PRIV_HASH_PRIME32);
+		for (sl_uint32 i = 0; i < 4; i++) {
+			__m128i a = _mm_loadu_si128(acc + i);
+			a = _mm_xor_si128(a, _mm_srli_epi64(a, 47));
+			a = _mm_xor_si128(a, _mm_loadu_si128((const __m128i*)(secret + (i << 4))));
+			__m128i lo = _mm_mul_epu32(a, prime);
+			__m128i hi = _mm_mul_epu32(_mm_shuffle_epi32(a, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+			_mm_storeu_si128(acc + i, _mm_add_epi64(lo, _mm_slli_epi64(hi, 32)));
+		}
+	}
+
+	SLIB_TARGET_AVX2 static void _priv_Hash_accumulate_avx2(sl_uint64* _acc, const sl_uint8* data, const sl_uint8* secret, sl_size nStripes) noexcept
+	{
+		__m256i* acc = (__m256i*)_acc;
+		__m256i a0 = _mm256_loadu_si256(acc);
+		__m256i a1 = _mm256_loadu_si256(acc + 1);
+		for (sl_size s = 0; s < nStripes; s++) {
+			__m256i d0 = _mm256_loadu_si256((const __m256i*)data);
+			__m256i d1 = _mm256_loadu_si256((const __m256i*)(data + 32));
+			__m256i k0 = _mm256_xor_si256(d0, _mm256_loadu_si256((const __m256i*)secret));
+			__m256i k1 = _mm256_xor_si256(d1, _mm256_loadu_si256((const __m256i*)(secret + 32)));
+			__m256i p0 = _mm256_mul_epu32(k0, _mm256_shuffle_epi32(k0, _MM_SHUFFLE(0, 3, 0, 1)));
+			__m256i p1 = _mm256_mul_epu32(k1, _mm256_shuffle_epi32(k1, _MM_SHUFFLE(0, 3, 0, 1)));
+			a0 = _mm256_add_epi64(a0, _mm256_add_epi64(p0, _mm256_shuffle_epi32(d0, _MM_SHUFFLE(1, 0, 3, 2))));
+			a1 = _mm256_add_epi64(a1, _mm256_add_epi64(p1, _mm256_shuffle_epi32(d1, _MM_SHUFFLE(1, 0, 3, 2))));
+			data += _PRIV_HASH_STRIPE_SIZE;
+			secret += 8;
+		}
+		_mm256_storeu_si256(acc, a0);
+		_mm256_storeu_si256(acc + 1, a1);
+	}
+
+	SLIB_TARGET_AVX2 static void _priv_Hash_scramble_avx2(sl_uint64* _acc, const sl_uint8* secret) noexcept
+	{
+		__m256i* acc = (__m256i*)_acc;
+		__m256i prime = _mm256_set1_epi32((int)_PRIV_HASH_PRIME32);
+		for (sl_uint32 i = 0; i < 2; i++) {
+			__m256i a = _mm256_loadu_si256(acc + i);
+			a = _mm256_xor_si256(a, _mm256_srli_epi64(a, 47));
+			a = _mm256_xor_si256(a, _mm256_loadu_si256((const __m256i*)(secret + (i << 5))));
+			__m256i lo = _mm256_mul_epu32(a, prime);
+			__m256i hi = _mm256_mul_epu32(_mm256_shuffle_epi32(a, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+			_mm256_storeu_si256(acc + i, _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32)));
+		}
+	}
+#endif
+
+#if defined(_PRIV_HASH_USE_NEON)
+	static void _priv_Hash_accumulate_neon(sl_uint64* acc, const sl_uint8* data, const sl_uint8* secret, sl_size nStripes) noexcept
+	{
+		uint64x2_t a[4];
+		for (sl_uint32 i = 0; i < 4; i++) {
+			a[i] = vld1q_u64(acc + (i << 1));
+		}
+		for (sl_size s = 0; s < nStripes; s++) {
+			for (sl_uint32 i = 0; i < 4; i++) {
+				uint64x2_t d = vreinterpretq_u64_u8(vld1q_u8(data + (i << 4)));
+				uint64x2_t k = veorq_u64(d, vreinterpretq_u64_u8(vld1q_u8(secret + (i << 4))));
+				uint64x2_t p = vmull_u32(vmovn_u64(k), vshrn_n_u64(k, 32));
+				a[i] = vaddq_u64(a[i], vaddq_u64(p, vextq_u64(d, d, 1)));
+			}
+			data += _PRIV_HASH_STRIPE_SIZE;
+			secret += 8;
+		}
+		for (sl_uint32 i = 0; i < 4; i++) {
+			vst1q_u64(acc + (i << 1), a[i]);
+		}
+	}
+
+	static void _priv_Hash_scramble_neon(sl_uint64* acc, const sl_uint8* secret) noexcept
+	{
+		uint32x2_t prime = vdup_n_u32(_PRIV_HASH_PRIME32);
+		for (sl_uint32 i = 0; i < 4; i++) {
+			uint64x2_t a = vld1q_u64(acc + (i << 1));
+			a = veorq_u64(a, vshrq_n_u64(a, 47));
+			a = veorq_u64(a, vreinterpretq_u64_u8(vld1q_u8(secret + (i << 4))));
+			uint64x2_t lo = vmull_u32(vmovn_u64(a), prime);
+			uint64x2_t hi = vmull_u32(vshrn_n_u64(a, 32), prime);
+			vst1q_u64(acc + (i << 1), vaddq_u64(lo, vshlq_n_u64(hi, 32)));
+		}
+	}
+#endif
+
+	static _priv_Hash_AccumulateFunc _g_hash_accumulate = sl_null;
+	static _priv_Hash_ScrambleFunc _g_hash_scramble = sl_null;
+
+	static void _priv_Hash_selectFunctions() noexcept
+	{
+		_priv_Hash_ScrambleFunc scramble = _priv_Hash_scramble_scalar;
+		_priv_Hash_AccumulateFunc accumulate = _priv_Hash_accumulate_scalar;
+#if defined(_PRIV_HASH_USE_SSE2)
+		if (Cpu::isSupportingAVX2()) {
+			scramble = _priv_Hash_scramble_avx2;
+			accumulate = _priv_Hash_accumulate_avx2;
+		} else {
+			scramble = _priv_Hash_scramble_sse2;
+			accumulate = _priv_Hash_accumulate_sse2;
+		}
+#elif defined(_PRIV_HASH_USE_NEON)
+		scramble = _priv_Hash_scramble_neon;
+		accumulate = _priv_Hash_accumulate_neon;
+#endif
+		// the results of all implementations are same, so the threads may race here
+		_g_hash_scramble = scramble;
+		_g_hash_accumulate = accumulate;
+	}
+
+	SLIB_INLINE static _priv_Hash_AccumulateFunc _priv_Hash_getAccumulate() noexcept
+	{
+		_priv_Hash_AccumulateFunc f = _g_hash_accumulate;
+		if (f) {
+			return f;
+		}
+		_priv_Hash_selectFunctions();
+		return _g_hash_accumulate;
+	}
+
+	SLIB_INLINE static _priv_Hash_ScrambleFunc _priv_Hash_getScramble() noexcept
+	{
+		_priv_Hash_ScrambleFunc f = _g_hash_scramble;
+		if (f) {
+			return f;
+		}
+		_priv_Hash_selectFunctions();
+		return _g_hash_scramble;
+	}
+
+	static void _priv_Hash_deriveSecret(sl_uint64 seed, sl_uint8* secret) noexcept
+	{
+		sl_uint64 state = seed;
+		for (sl_uint32 i = 0; i < _PRIV_HASH_SECRET_SIZE; i += 8) {
+			// wyrand
+			state += _g_hash_wy_secret[0];
+			sl_uint64 v = _priv_Hash_mix(state, state ^ _g_hash_wy_secret[1]);
+			memcpy(secret + i, &v, 8);
+		}
+	}
+
+	static sl_uint64 _priv_Hash_mergeLanes(const sl_uint64* acc, sl_uint64 len, sl_uint64 seed, const sl_uint8* secret) noexcept
+	{
+		sl_uint64 h = len * SLIB_UINT64(0x9E3779B185EBCA87);
+		for (sl_uint32 i = 0; i < 4; i++) {
+			const sl_uint8* s = secret + 11 + (i << 4);
+			h += _priv_Hash_mix(acc[i << 1] ^ _priv_Hash_read64(s), acc[(i << 1) | 1] ^ _priv_Hash_read64(s + 8));
+		}
+		return _priv_Hash_mix(h ^ _g_hash_wy_secret[0], seed ^ _g_hash_wy_secret[3]);
+	}
+
+	static sl_uint64 _priv_Hash_long(const sl_uint8* p, sl_size len, sl_uint64 seed, const sl_uint8* secret) noexcept
+	{
+		_priv_Hash_AccumulateFunc accumulate = _priv_Hash_getAccumulate();
+		_priv_Hash_ScrambleFunc scramble = _priv_Hash_getScramble();
+		sl_uint64 acc[8];
+		memcpy(acc, _g_hash_lanes_init, sizeof(acc));
+		// the last byte is always left for the last stripe
+		sl_size nBlocks = (len - 1) / _PRIV_HASH_BLOCK_SIZE;
+		for (sl_size i = 0; i < nBlocks; i++) {
+			accumulate(acc, p + i * _PRIV_HASH_BLOCK_SIZE, secret, _PRIV_HASH_STRIPES_PER_BLOCK);
+			scramble(acc, secret + _PRIV_HASH_SCRAMBLE_SECRET_OFFSET);
+		}
+		sl_size nStripes = ((len - 1) - nBlocks * _PRIV_HASH_BLOCK_SIZE) / _PRIV_HASH_STRIPE_SIZE;
+		accumulate(acc, p + nBlocks * _PRIV_HASH_BLOCK_SIZE, secret, nStripes);
+		accumulate(acc, p + len - _PRIV_HASH_STRIPE_SIZE, secret + _PRIV_HASH_LAST_STRIPE_SECRET_OFFSET, 1);
+		return _priv_Hash_mergeLanes(acc, len, seed, secret);
+	}
+
+	struct _priv_Hash_DefaultKey
+	{
+		sl_uint64 seed;
+		sl_uint64 seedPrepared;
+		sl_uint8 secret[_PRIV_HASH_SECRET_SIZE];
+	};
+
+	static _priv_Hash_DefaultKey _g_hash_default_key_storage;
+	static _priv_Hash_DefaultKey* _g_hash_default_key = sl_null;
+	static SpinLock _g_hash_default_key_lock;
+
+	static const _priv_Hash_DefaultKey* _priv_Hash_getDefaultKey() noexcept
+	{
+		_priv_Hash_DefaultKey* key = _g_hash_default_key;
+		if (key) {
+			return key;
+		}
+		SpinLocker lock(&_g_hash_default_key_lock);
+		key = _g_hash_default_key;
+		if (key) {
+			return key;
+		}
+		key = &_g_hash_default_key_storage;
+		// no system source of random numbers is used here: the timers and the addresses (ASLR) are enough against flooding
+		void* heap = ::malloc(1);
+		sl_uint64 entropy[5];
+		entropy[0] = (sl_uint64)(Time::now().toInt());
+		entropy[1] = (sl_uint64)(System::getTickCount());
+		entropy[2] = (sl_uint64)((sl_size)key);
+		entropy[3] = (sl_uint64)((sl_size)&entropy);
+		entropy[4] = (sl_uint64)((sl_size)heap);
+		::free(heap);
+		sl_uint64 seed = _priv_Hash_short((sl_uint8*)entropy, sizeof(entropy), _priv_Hash_prepareSeed(_g_hash_wy_secret[2]));
+		key->seed = seed;
+		key->seedPrepared = _priv_Hash_prepareSeed(seed);
+		_priv_Hash_deriveSecret(seed, key->secret);
+		// publishes the key with a full barrier
+		Base::interlockedCompareExchangePtr((void**)&_g_hash_default_key, key, sl_null);
+		return key;
+	}
+
+	sl_uint64 GetHashSeed() noexcept
+	{
+		return _priv_Hash_getDefaultKey()->seed;
+	}
+
+	sl_uint64 HashBytes64(const void* buf, sl_size n, sl_uint64 seed) noexcept
+	{
+		const sl_uint8* p = (const sl_uint8*)buf;
+		if (n <= _PRIV_HASH_BLOCK_SIZE) {
+			return _priv_Hash_short(p, n, _priv_Hash_prepareSeed(seed));
+		}
+		sl_uint8 secret[_PRIV_HASH_SECRET_SIZE];
+		_priv_Hash_deriveSecret(seed, secret);
+		return _priv_Hash_long(p, n, seed, secret);
+	}
+
+	sl_uint32 HashBytes32(const void* buf, sl_size n, sl_uint64 seed) noexcept
+	{
+		sl_uint64 h = HashBytes64(buf, n, seed);
+		return (sl_uint32)(h ^ (h >> 32));
+	}
+
+	sl_uint64 HashBytes64(const void* buf, sl_size n) noexcept
+	{
+		const _priv_Hash_DefaultKey* key = _priv_Hash_getDefaultKey();
+		const sl_uint8* p = (const sl_uint8*)buf;
+		if (n <= _PRIV_HASH_BLOCK_SIZE) {
+			return _priv_Hash_short(p, n, key->seedPrepared);
+		}
+		return _priv_Hash_long(p, n, key->seed, key->secret);
+	}
+
+	sl_uint32 HashBytes32(const void* buf, sl_size n) noexcept
+	{
+		sl_uint64 h = HashBytes64(buf, n);
+		return (sl_uint32)(h ^ (h >> 32));
+	}
+
 	sl_size HashBytes(const void* buf, sl_size n) noexcept
 	{
+		const _priv_Hash_DefaultKey* key = _priv_Hash_getDefaultKey();
+		const sl_uint8* p = (const sl_uint8*)buf;
+		sl_uint64 h;
+		if (n <= _PRIV_HASH_BLOCK_SIZE) {
+			h = _priv_Hash_short(p, n, key->seedPrepared);
+		} else {
+			h = _priv_Hash_long(p, n, key->seed, key->secret);
+		}
 #ifdef SLIB_ARCH_IS_64BIT
-		return HashBytes64(buf, n);
+		return (sl_size)h;
 #else
-		return HashBytes32(buf, n);
+		return (sl_uint32)(h ^ (h >> 32));
 #endif
 	}
 
-	
+
+	BytesHasher::BytesHasher() noexcept
+	{
+		start();
+	}
+
+	BytesHasher::BytesHasher(sl_uint64 seed) noexcept
+	{
+		start(seed);
+	}
+
+	void BytesHasher::start() noexcept
+	{
+		start(GetHashSeed());
+	}
+
+	void BytesHasher::start(sl_uint64 seed) noexcept
+	{
+		m_seed = seed;
+		m_sizeTotal = 0;
+		m_sizeBuffer = 0;
+		m_posConsumed = 0;
+		m_flagLong = sl_false;
+		m_nStripesInBlock = 0;
+	}
+
+	void BytesHasher::update(const void* _buf, sl_size n) noexcept
+	{
+		const sl_uint8* buf = (const sl_uint8*)_buf;
+		m_sizeTotal += n;
+		while (n) {
+			sl_size m = SLIB_BYTES_HASHER_BUFFER_SIZE - m_sizeBuffer;
+			if (m > n) {
+				m = n;
+			}
+			memcpy(m_buffer + m_sizeBuffer, buf, m);
+			m_sizeBuffer += m;
+			buf += m;
+			n -= m;
+			if (!m_flagLong) {
+				if (m_sizeBuffer <= _PRIV_HASH_BLOCK_SIZE) {
+					continue;
+				}
+				m_flagLong = sl_true;
+				memcpy(m_acc, _g_hash_lanes_init, sizeof(m_acc));
+				if (m_seed == GetHashSeed()) {
+					memcpy(m_secret, _priv_Hash_getDefaultKey()->secret, _PRIV_HASH_SECRET_SIZE);
+				} else {
+					_priv_Hash_deriveSecret(m_seed, m_secret);
+				}
+			}
+			_consumeStripes();
+		}
+	}
+
+	sl_uint64 BytesHasher::finish() noexcept
+	{
+		if (!m_flagLong) {
+			return _priv_Hash_short(m_buffer, (sl_size)m_sizeTotal, _priv_Hash_prepareSeed(m_seed));
+		}
+		sl_uint64 acc[8];
+		memcpy(acc, m_acc, sizeof(acc));
+		// the buffer keeps at least one stripe of the consumed data
+		_priv_Hash_getAccumulate()(acc, m_buffer + m_sizeBuffer - _PRIV_HASH_STRIPE_SIZE, m_secret + _PRIV_HASH_LAST_STRIPE_SECRET_OFFSET, 1);
+		return _priv_Hash_mergeLanes(acc, m_sizeTotal, m_seed, m_secret);
+	}
+
+	void BytesHasher::_consumeStripes() noexcept
+	{
+		_priv_Hash_AccumulateFunc accumulate = _priv_Hash_getAccumulate();
+		_priv_Hash_ScrambleFunc scramble = _priv_Hash_getScramble();
+		sl_size pos = m_posConsumed;
+		// a stripe is consumed only when more data follows it, so the last stripe is left for `finish()`
+		while (m_sizeBuffer - pos > _PRIV_HASH_STRIPE_SIZE) {
+			sl_size nStripes = (m_sizeBuffer - pos - 1) / _PRIV_HASH_STRIPE_SIZE;
+			sl_size nLeftInBlock = _PRIV_HASH_STRIPES_PER_BLOCK - m_nStripesInBlock;
+			if (nStripes > nLeftInBlock) {
+				nStripes = nLeftInBlock;
+			}
+			accumulate(m_acc, m_buffer + pos, m_secret + (m_nStripesInBlock << 3), nStripes);
+			pos += nStripes * _PRIV_HASH_STRIPE_SIZE;
+			m_nStripesInBlock += (sl_uint32)nStripes;
+			if (m_nStripesInBlock == _PRIV_HASH_STRIPES_PER_BLOCK) {
+				scramble(m_acc, m_secret + _PRIV_HASH_SCRAMBLE_SECRET_OFFSET);
+				m_nStripesInBlock = 0;
+			}
+		}
+		// keeps one consumed stripe before the remaining data, for the last stripe
+		if (pos > _PRIV_HASH_STRIPE_SIZE) {
+			sl_size start = pos - _PRIV_HASH_STRIPE_SIZE;
+			memmove(m_buffer, m_buffer + start, m_sizeBuffer - start);
+			m_sizeBuffer -= start;
+			pos = _PRIV_HASH_STRIPE_SIZE;
+		}
+		m_posConsumed = pos;
+	}
+
+
 	#define PRIV_SLIB_HASHTABLE_MIN_CAPACITY 16
 	#define PRIV_SLIB_HASHTABLE_LOAD_FACTOR_UP 0.75f
 	#define PRIV_SLIB_HASHTABLE_LOAD_FACTOR_DOWN 0.25f
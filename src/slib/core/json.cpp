@@ -14,6 +14,7 @@
 
 #include "slib/core/list.h"
 #include "slib/core/map.h"
+#include "slib/core/string_interner.h"
 
 #include "slib/core/file.h"
 #include "slib/core/log.h"
@@ -310,6 +311,8 @@ namespace slib
 		ST strTrue;
 		ST strFalse;
 		
+		StringInterner keys{sl_false};
+		
 	public:
 		_Json_Parser();
 		
@@ -344,6 +347,33 @@ namespace slib
 		strFalse = _false;
 	}
 
+	// keys without escapes are interned, so the same key in the objects of a list shares one string
+	static sl_bool _Json_parseSimpleKey(StringInterner& interner, const sl_char8* buf, sl_size len, sl_size& pos, String& key)
+	{
+		sl_char8 chQuote = buf[pos];
+		sl_size start = pos + 1;
+		for (sl_size end = start; end < len; end++) {
+			sl_char8 ch = buf[end];
+			if (ch == chQuote) {
+				key = interner.intern(buf + start, end - start);
+				if (key.isNull()) {
+					return sl_false;
+				}
+				pos = end + 1;
+				return sl_true;
+			}
+			if (ch == '\\') {
+				return sl_false;
+			}
+		}
+		return sl_false;
+	}
+
+	static sl_bool _Json_parseSimpleKey(StringInterner& interner, const sl_char16* buf, sl_size len, sl_size& pos, String16& key)
+	{
+		return sl_false;
+	}
+
 	template <class ST, class CT>
 	void _Json_Parser<ST, CT>::escapeSpaceAndComments()
 	{
@@ -507,14 +537,16 @@ namespace slib
 					pos++;
 					return map;
 				} else if (ch == '"' || ch == '\'') {
-					sl_size m = 0;
-					sl_bool f = sl_false;
-					key = ParseUtil::parseBackslashEscapes(buf + pos, len - pos, &m, &f);
-					pos += m;
-					if (f) {
-						flagError = sl_true;
-						errorMessage = "Object Item Name: Missing terminating character \" or ' ";
-						return sl_null;
+					if (!(_Json_parseSimpleKey(keys, buf, len, pos, key))) {
+						sl_size m = 0;
+						sl_bool f = sl_false;
+						key = ParseUtil::parseBackslashEscapes(buf + pos, len - pos, &m, &f);
+						pos += m;
+						if (f) {
+							flagError = sl_true;
+							errorMessage = "Object Item Name: Missing terminating character \" or ' ";
+							return sl_null;
+						}
 					}
 				} else {
 					sl_size s = pos;
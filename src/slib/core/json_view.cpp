@@ -0,0 +1,1076 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "slib/core/json_view.h"
+
+#include "slib/core/list.h"
+#include "slib/core/map.h"
+#include "slib/core/string_interner.h"
+#include "slib/core/parse.h"
+#include "slib/core/log.h"
+
+#if defined(SLIB_ARCH_IS_X64) || (defined(SLIB_ARCH_IS_X86) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#	define _PRIV_JSON_VIEW_USE_SSE2
+#	include <emmintrin.h>
+#elif defined(SLIB_ARCH_IS_ARM64)
+#	define _PRIV_JSON_VIEW_USE_NEON
+#	include <arm_neon.h>
+#endif
+
+#if defined(SLIB_COMPILER_IS_VC)
+#	include <intrin.h>
+#endif
+
+#define _PRIV_JSON_VIEW_MAX_DEPTH 1024
+
+namespace slib
+{
+
+	// bit masks of the characters in a 64 byte block
+	struct _priv_JsonView_BlockMasks
+	{
+		sl_uint64 quote;
+		sl_uint64 backslash;
+		sl_uint64 op;
+		sl_uint64 space;
+	};
+
+#if defined(_PRIV_JSON_VIEW_USE_SSE2)
+	SLIB_INLINE static sl_uint64 _priv_JsonView_moveMask(__m128i v0, __m128i v1, __m128i v2, __m128i v3) noexcept
+	{
+		return (sl_uint64)(sl_uint32)(_mm_movemask_epi8(v0)) | ((sl_uint64)(sl_uint32)(_mm_movemask_epi8(v1)) << 16) | ((sl_uint64)(sl_uint32)(_mm_movemask_epi8(v2)) << 32) | ((sl_uint64)(sl_uint32)(_mm_movemask_epi8(v3)) << 48);
+	}
+
+	static void _priv_JsonView_classify(const sl_uint8* p, _priv_JsonView_BlockMasks& masks) noexcept
+	{
+		__m128i v[4];
+		__m128i quote[4], backslash[4], op[4], space[4];
+		const __m128i cQuote = _mm_set1_epi8('"');
+		const __m128i cBackslash = _mm_set1_epi8('\\');
+		// '[' | 0x20 = '{', ']' | 0x20 = '}'
+		const __m128i cLower = _mm_set1_epi8(0x20);
+		const __m128i cBraceOpen = _mm_set1_epi8('{');
+		const __m128i cBraceClose = _mm_set1_epi8('}');
+		const __m128i cColon = _mm_set1_epi8(':');
+		const __m128i cComma = _mm_set1_epi8(',');
+		const __m128i cSpace = _mm_set1_epi8(' ');
+		const __m128i cTab = _mm_set1_epi8('\t');
+		const __m128i cLF = _mm_set1_epi8('\n');
+		const __m128i cCR = _mm_set1_epi8('\r');
+		for (int i = 0; i < 4; i++) {
+			v[i] = _mm_loadu_si128((const __m128i*)(p + (i << 4)));
+			quote[i] = _mm_cmpeq_epi8(v[i], cQuote);
+			backslash[i] = _mm_cmpeq_epi8(v[i], cBackslash);
+			__m128i l = _mm_or_si128(v[i], cLower);
+			op[i] = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(l, cBraceOpen), _mm_cmpeq_epi8(l, cBraceClose)), _mm_or_si128(_mm_cmpeq_epi8(v[i], cColon), _mm_cmpeq_epi8(v[i], cComma)));
+			space[i] = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v[i], cSpace), _mm_cmpeq_epi8(v[i], cTab)), _mm_or_si128(_mm_cmpeq_epi8(v[i], cLF), _mm_cmpeq_epi8(v[i], cCR)));
+		}
+		masks.quote = _priv_JsonView_moveMask(quote[0], quote[1], quote[2], quote[3]);
+		masks.backslash = _priv_JsonView_moveMask(backslash[0], backslash[1], backslash[2], backslash[3]);
+		masks.op = _priv_JsonView_moveMask(op[0], op[1], op[2], op[3]);
+		masks.space = _priv_JsonView_moveMask(space[0], space[1], space[2], space[3]);
+	}
+#elif defined(_PRIV_JSON_VIEW_USE_NEON)
+	SLIB_INLINE static sl_uint64 _priv_JsonView_moveMask(uint8x16_t v0, uint8x16_t v1, uint8x16_t v2, uint8x16_t v3) noexcept
+	{
+		static const sl_uint8 _bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+		const uint8x16_t bits = vld1q_u8(_bits);
+		uint8x16_t s0 = vpaddq_u8(vandq_u8(v0, bits), vandq_u8(v1, bits));
+		uint8x16_t s1 = vpaddq_u8(vandq_u8(v2, bits), vandq_u8(v3, bits));
+		s0 = vpaddq_u8(s0, s1);
+		s0 = vpaddq_u8(s0, s0);
+		return vgetq_lane_u64(vreinterpretq_u64_u8(s0), 0);
+	}
+
+	static void _priv_JsonView_classify(const sl_uint8* p, _priv_JsonView_BlockMasks& masks) noexcept
+	{
+		uint8x16_t v[4];
+		uint8x16_t quote[4], backslash[4], op[4], space[4];
+		const uint8x16_t cQuote = vdupq_n_u8('"');
+		const uint8x16_t cBackslash = vdupq_n_u8('\\');
+		const uint8x16_t cLower = vdupq_n_u8(0x20);
+		const uint8x16_t cBraceOpen = vdupq_n_u8('{');
+		const uint8x16_t cBraceClose = vdupq_n_u8('}');
+		const uint8x16_t cColon = vdupq_n_u8(':');
+		const uint8x16_t cComma = vdupq_n_u8(',');
+		const uint8x16_t cSpace = vdupq_n_u8(' ');
+		const uint8x16_t cTab = vdupq_n_u8('\t');
+		const uint8x16_t cLF = vdupq_n_u8('\n');
+		const uint8x16_t cCR = vdupq_n_u8('\r');
+		for (int i = 0; i < 4; i++) {
+			v[i] = vld1q_u8(p + (i << 4));
+			quote[i] = vceqq_u8(v[i], cQuote);
+			backslash[i] = vceqq_u8(v[i], cBackslash);
+			uint8x16_t l = vorrq_u8(v[i], cLower);
+			op[i] = vorrq_u8(vorrq_u8(vceqq_u8(l, cBraceOpen), vceqq_u8(l, cBraceClose)), vorrq_u8(vceqq_u8(v[i], cColon), vceqq_u8(v[i], cComma)));
+			space[i] = vorrq_u8(vorrq_u8(vceqq_u8(v[i], cSpace), vceqq_u8(v[i], cTab)), vorrq_u8(vceqq_u8(v[i], cLF), vceqq_u8(v[i], cCR)));
+		}
+		masks.quote = _priv_JsonView_moveMask(quote[0], quote[1], quote[2], quote[3]);
+		masks.backslash = _priv_JsonView_moveMask(backslash[0], backslash[1], backslash[2], backslash[3]);
+		masks.op = _priv_JsonView_moveMask(op[0], op[1], op[2], op[3]);
+		masks.space = _priv_JsonView_moveMask(space[0], space[1], space[2], space[3]);
+	}
+#else
+	static void _priv_JsonView_classify(const sl_uint8* p, _priv_JsonView_BlockMasks& masks) noexcept
+	{
+		sl_uint64 quote = 0, backslash = 0, op = 0, space = 0;
+		for (sl_uint32 i = 0; i < 64; i++) {
+			sl_uint64 bit = (sl_uint64)1 << i;
+			switch (p[i]) {
+				case '"':
+					quote |= bit;
+					break;
+				case '\\':
+					backslash |= bit;
+					break;
+				case '{':
+				case '}':
+				case '[':
+				case ']':
+				case ':':
+				case ',':
+					op |= bit;
+					break;
+				case ' ':
+				case '\t':
+				case '\r':
+				case '\n':
+					space |= bit;
+					break;
+			}
+		}
+		masks.quote = quote;
+		masks.backslash = backslash;
+		masks.op = op;
+		masks.space = space;
+	}
+#endif
+
+	SLIB_INLINE static sl_uint32 _priv_JsonView_getTrailingZeros(sl_uint64 bits) noexcept
+	{
+#if defined(SLIB_COMPILER_IS_VC)
+#	if defined(SLIB_ARCH_IS_64BIT)
+		unsigned long index;
+		_BitScanForward64(&index, bits);
+		return (sl_uint32)index;
+#	else
+		unsigned long index;
+		if ((sl_uint32)bits) {
+			_BitScanForward(&index, (sl_uint32)bits);
+			return (sl_uint32)index;
+		}
+		_BitScanForward(&index, (sl_uint32)(bits >> 32));
+		return (sl_uint32)index + 32;
+#	endif
+#else
+		return (sl_uint32)(__builtin_ctzll(bits));
+#endif
+	}
+
+	// bit i is set when the count of the set bits in [0, i] is odd
+	SLIB_INLINE static sl_uint64 _priv_JsonView_prefixXor(sl_uint64 x) noexcept
+	{
+		x ^= x << 1;
+		x ^= x << 2;
+		x ^= x << 4;
+		x ^= x << 8;
+		x ^= x << 16;
+		x ^= x << 32;
+		return x;
+	}
+
+	SLIB_INLINE static sl_bool _priv_JsonView_isLiteralEnd(sl_char8 ch) noexcept
+	{
+		switch (ch) {
+			case ' ':
+			case '\t':
+			case '\r':
+			case '\n':
+			case '{':
+			case '}':
+			case '[':
+			case ']':
+			case ':':
+			case ',':
+			case '"':
+				return sl_true;
+		}
+		return sl_false;
+	}
+
+	static sl_bool _priv_JsonView_isValidLiteral(const sl_char8* s, sl_size n) noexcept
+	{
+		switch (s[0]) {
+			case 't':
+				return n == 4 && s[1] == 'r' && s[2] == 'u' && s[3] == 'e';
+			case 'f':
+				return n == 5 && s[1] == 'a' && s[2] == 'l' && s[3] == 's' && s[4] == 'e';
+			case 'n':
+				return n == 4 && s[1] == 'u' && s[2] == 'l' && s[3] == 'l';
+		}
+		// -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+		sl_size i = 0;
+		if (s[i] == '-') {
+			i++;
+		}
+		if (i >= n) {
+			return sl_false;
+		}
+		if (s[i] == '0') {
+			i++;
+		} else if (s[i] >= '1' && s[i] <= '9') {
+			do {
+				i++;
+			} while (i < n && s[i] >= '0' && s[i] <= '9');
+		} else {
+			return sl_false;
+		}
+		if (i < n && s[i] == '.') {
+			i++;
+			if (i >= n || s[i] < '0' || s[i] > '9') {
+				return sl_false;
+			}
+			do {
+				i++;
+			} while (i < n && s[i] >= '0' && s[i] <= '9');
+		}
+		if (i < n && (s[i] == 'e' || s[i] == 'E')) {
+			i++;
+			if (i < n && (s[i] == '+' || s[i] == '-')) {
+				i++;
+			}
+			if (i >= n || s[i] < '0' || s[i] > '9') {
+				return sl_false;
+			}
+			do {
+				i++;
+			} while (i < n && s[i] >= '0' && s[i] <= '9');
+		}
+		return i == n;
+	}
+
+	enum class _priv_JsonView_State
+	{
+		Value,
+		FirstElement,
+		FirstKey,
+		Key,
+		Colon,
+		Next,
+		End
+	};
+
+	JsonView::JsonView() noexcept
+	 : m_document(sl_null), m_index(0)
+	{
+	}
+
+	JsonView::JsonView(const JsonDocument* document, sl_uint32 index) noexcept
+	 : m_document(document), m_index(index)
+	{
+	}
+
+	JsonView JsonView::operator[](const String& key) const noexcept
+	{
+		return getItem(key);
+	}
+
+	JsonView JsonView::operator[](sl_size index) const noexcept
+	{
+		return getElement(index);
+	}
+
+	sl_bool JsonView::isValid() const noexcept
+	{
+		return m_document != sl_null;
+	}
+
+	sl_bool JsonView::isNull() const noexcept
+	{
+		sl_char8 ch = _getFirstChar();
+		return !ch || ch == 'n';
+	}
+
+	sl_bool JsonView::isNotNull() const noexcept
+	{
+		return !(isNull());
+	}
+
+	sl_bool JsonView::isObject() const noexcept
+	{
+		return _getFirstChar() == '{';
+	}
+
+	sl_bool JsonView::isArray() const noexcept
+	{
+		return _getFirstChar() == '[';
+	}
+
+	sl_bool JsonView::isString() const noexcept
+	{
+		return _getFirstChar() == '"';
+	}
+
+	sl_bool JsonView::isNumber() const noexcept
+	{
+		sl_char8 ch = _getFirstChar();
+		return ch == '-' || (ch >= '0' && ch <= '9');
+	}
+
+	sl_bool JsonView::isBoolean() const noexcept
+	{
+		sl_char8 ch = _getFirstChar();
+		return ch == 't' || ch == 'f';
+	}
+
+	String JsonView::getString(const String& def) const noexcept
+	{
+		sl_char8 ch = _getFirstChar();
+		if (ch == '"') {
+			String str = m_document->_getString(m_document->m_structurals[m_index]);
+			if (str.isNotNull()) {
+				return str;
+			}
+			return def;
+		}
+		if (ch == '-' || (ch >= '0' && ch <= '9') || ch == 't' || ch == 'f') {
+			return getRawText();
+		}
+		return def;
+	}
+
+	String JsonView::getString() const noexcept
+	{
+		return getString(String::null());
+	}
+
+#define _PRIV_JSON_VIEW_DEFINE_GET_NUMBER(TYPE, NAME, PARSE, PARSE_TYPE) \
+	TYPE JsonView::NAME(TYPE def) const noexcept \
+	{ \
+		const sl_char8* start; \
+		const sl_char8* end; \
+		if (_getNumberText(start, end)) { \
+			PARSE_TYPE v; \
+			sl_size n = end - start; \
+			if (String::PARSE(10, &v, start, 0, n) == (sl_reg)n) { \
+				return (TYPE)v; \
+			} \
+			double f; \
+			if (String::parseDouble(&f, start, 0, n) == (sl_reg)n) { \
+				return (TYPE)f; \
+			} \
+			return def; \
+		} \
+		sl_char8 ch = _getFirstChar(); \
+		if (ch == 't') { \
+			return 1; \
+		} else if (ch == 'f') { \
+			return 0; \
+		} else if (ch == '"') { \
+			String str = m_document->_getString(m_document->m_structurals[m_index]); \
+			PARSE_TYPE v; \
+			if (str.PARSE(10, &v)) { \
+				return (TYPE)v; \
+			} \
+		} \
+		return def; \
+	}
+
+	_PRIV_JSON_VIEW_DEFINE_GET_NUMBER(sl_int32, getInt32, parseInt64, sl_int64)
+	_PRIV_JSON_VIEW_DEFINE_GET_NUMBER(sl_uint32, getUint32, parseUint64, sl_uint64)
+	_PRIV_JSON_VIEW_DEFINE_GET_NUMBER(sl_int64, getInt64, parseInt64, sl_int64)
+	_PRIV_JSON_VIEW_DEFINE_GET_NUMBER(sl_uint64, getUint64, parseUint64, sl_uint64)
+
+	float JsonView::getFloat(float def) const noexcept
+	{
+		return (float)(getDouble(def));
+	}
+
+	double JsonView::getDouble(double def) const noexcept
+	{
+		const sl_char8* start;
+		const sl_char8* end;
+		if (_getNumberText(start, end)) {
+			double v;
+			sl_size n = end - start;
+			if (String::parseDouble(&v, start, 0, n) == (sl_reg)n) {
+				return v;
+			}
+			return def;
+		}
+		sl_char8 ch = _getFirstChar();
+		if (ch == 't') {
+			return 1;
+		} else if (ch == 'f') {
+			return 0;
+		} else if (ch == '"') {
+			String str = m_document->_getString(m_document->m_structurals[m_index]);
+			double v;
+			if (str.parseDouble(&v)) {
+				return v;
+			}
+		}
+		return def;
+	}
+
+	sl_bool JsonView::getBoolean(sl_bool def) const noexcept
+	{
+		sl_char8 ch = _getFirstChar();
+		if (ch == 't') {
+			return sl_true;
+		} else if (ch == 'f') {
+			return sl_false;
+		} else if (ch == '-' || (ch >= '0' && ch <= '9')) {
+			return getDouble() != 0;
+		} else if (ch == '"') {
+			String str = m_document->_getString(m_document->m_structurals[m_index]);
+			str = str.toLower();
+			if (str == "true" || str == "yes" || str == "1") {
+				return sl_true;
+			} else if (str == "false" || str == "no" || str == "0") {
+				return sl_false;
+			}
+		}
+		return def;
+	}
+
+	String JsonView::getRawText() const noexcept
+	{
+		if (!m_document) {
+			return sl_null;
+		}
+		const JsonDocument* doc = m_document;
+		sl_size start = doc->m_structurals[m_index];
+		sl_size end;
+		sl_char8 ch = doc->m_data[start];
+		if (ch == '{' || ch == '[') {
+			end = doc->m_structurals[doc->m_pairs[m_index]] + 1;
+		} else if (ch == '"') {
+			end = doc->_getEndOfString(start) + 1;
+		} else {
+			end = doc->_getEndOfLiteral(start);
+		}
+		return String(doc->m_data + start, end - start);
+	}
+
+	JsonView JsonView::getItem(const String& key) const noexcept
+	{
+		if (_getFirstChar() != '{') {
+			return JsonView();
+		}
+		const JsonDocument* doc = m_document;
+		const sl_char8* data = doc->m_data;
+		const sl_uint32* structurals = doc->m_structurals;
+		sl_uint32 k = m_index + 1;
+		while (data[structurals[k]] == '"') {
+			if (doc->_equalsKey(structurals[k], key)) {
+				return JsonView(doc, k + 2);
+			}
+			// `,` or `}`
+			k = doc->_getEndOfValue(k + 2) + 1;
+			if (data[structurals[k]] != ',') {
+				break;
+			}
+			k++;
+		}
+		return JsonView();
+	}
+
+	JsonView JsonView::getElement(sl_size index) const noexcept
+	{
+		if (_getFirstChar() != '[') {
+			return JsonView();
+		}
+		const JsonDocument* doc = m_document;
+		const sl_char8* data = doc->m_data;
+		const sl_uint32* structurals = doc->m_structurals;
+		sl_uint32 k = m_index + 1;
+		if (data[structurals[k]] == ']') {
+			return JsonView();
+		}
+		for (;;) {
+			if (!index) {
+				return JsonView(doc, k);
+			}
+			index--;
+			k = doc->_getEndOfValue(k) + 1;
+			if (data[structurals[k]] != ',') {
+				break;
+			}
+			k++;
+		}
+		return JsonView();
+	}
+
+	sl_size JsonView::getElementsCount() const noexcept
+	{
+		sl_char8 ch = _getFirstChar();
+		if (ch != '{' && ch != '[') {
+			return 0;
+		}
+		const JsonDocument* doc = m_document;
+		sl_uint32 k = m_index + 1;
+		sl_uint32 kEnd = doc->m_pairs[m_index];
+		if (k == kEnd) {
+			return 0;
+		}
+		if (ch == '{') {
+			k += 2;
+		}
+		sl_size count = 0;
+		for (;;) {
+			count++;
+			k = doc->_getEndOfValue(k) + 1;
+			if (k >= kEnd) {
+				break;
+			}
+			// skips `,` and the key with `:`
+			k += ch == '{' ? 3 : 1;
+		}
+		return count;
+	}
+
+	JsonView JsonView::getFirstChild() const noexcept
+	{
+		sl_char8 ch = _getFirstChar();
+		if (ch != '{' && ch != '[') {
+			return JsonView();
+		}
+		const JsonDocument* doc = m_document;
+		if (doc->m_pairs[m_index] == m_index + 1) {
+			return JsonView();
+		}
+		if (ch == '{') {
+			return JsonView(doc, m_index + 3);
+		} else {
+			return JsonView(doc, m_index + 1);
+		}
+	}
+
+	JsonView JsonView::getNextSibling() const noexcept
+	{
+		if (!m_document || !m_index) {
+			return JsonView();
+		}
+		const JsonDocument* doc = m_document;
+		const sl_char8* data = doc->m_data;
+		const sl_uint32* structurals = doc->m_structurals;
+		sl_uint32 k = doc->_getEndOfValue(m_index) + 1;
+		if (data[structurals[k]] != ',') {
+			return JsonView();
+		}
+		if (data[structurals[m_index - 1]] == ':') {
+			return JsonView(doc, k + 3);
+		} else {
+			return JsonView(doc, k + 1);
+		}
+	}
+
+	String JsonView::getKey() const noexcept
+	{
+		if (!m_document || m_index < 2) {
+			return sl_null;
+		}
+		const JsonDocument* doc = m_document;
+		if (doc->m_data[doc->m_structurals[m_index - 1]] != ':') {
+			return sl_null;
+		}
+		return doc->_getString(doc->m_structurals[m_index - 2]);
+	}
+
+	Json JsonView::toJson() const noexcept
+	{
+		if (m_document) {
+			StringInterner keys(sl_false);
+			return m_document->_toJson(m_index, keys);
+		}
+		return sl_null;
+	}
+
+	sl_char8 JsonView::_getFirstChar() const noexcept
+	{
+		if (m_document) {
+			return m_document->m_data[m_document->m_structurals[m_index]];
+		}
+		return 0;
+	}
+
+	sl_bool JsonView::_getNumberText(const sl_char8*& start, const sl_char8*& end) const noexcept
+	{
+		sl_char8 ch = _getFirstChar();
+		if (ch == '-' || (ch >= '0' && ch <= '9')) {
+			const JsonDocument* doc = m_document;
+			sl_size pos = doc->m_structurals[m_index];
+			start = doc->m_data + pos;
+			end = doc->m_data + doc->_getEndOfLiteral(pos);
+			return sl_true;
+		}
+		return sl_false;
+	}
+
+
+	SLIB_DEFINE_OBJECT(JsonDocument, Referable)
+
+	JsonDocument::JsonDocument()
+	{
+		m_data = sl_null;
+		m_length = 0;
+		m_structurals = sl_null;
+		m_countStructurals = 0;
+		m_pairs = sl_null;
+	}
+
+	JsonDocument::~JsonDocument()
+	{
+		if (m_structurals) {
+			Base::freeMemory(m_structurals);
+		}
+		if (m_pairs) {
+			Base::freeMemory(m_pairs);
+		}
+	}
+
+	Ref<JsonDocument> JsonDocument::parse(const String& json, JsonParseParam& param)
+	{
+		return _parse(json, sl_null, json.getData(), json.getLength(), param);
+	}
+
+	Ref<JsonDocument> JsonDocument::parse(const String& json)
+	{
+		JsonParseParam param;
+		return parse(json, param);
+	}
+
+	Ref<JsonDocument> JsonDocument::parse(const Memory& mem, JsonParseParam& param)
+	{
+		return _parse(sl_null, mem, (const sl_char8*)(mem.getData()), mem.getSize(), param);
+	}
+
+	Ref<JsonDocument> JsonDocument::parse(const Memory& mem)
+	{
+		JsonParseParam param;
+		return parse(mem, param);
+	}
+
+	Ref<JsonDocument> JsonDocument::parse(const sl_char8* sz, sl_size len, JsonParseParam& param)
+	{
+		return _parse(String(sz, len), sl_null, sl_null, 0, param);
+	}
+
+	Ref<JsonDocument> JsonDocument::parse(const sl_char8* sz, sl_size len)
+	{
+		JsonParseParam param;
+		return parse(sz, len, param);
+	}
+
+	JsonView JsonDocument::getRoot() const noexcept
+	{
+		return JsonView(this, 0);
+	}
+
+	const sl_char8* JsonDocument::getData() const noexcept
+	{
+		return m_data;
+	}
+
+	sl_size JsonDocument::getLength() const noexcept
+	{
+		return m_length;
+	}
+
+	sl_uint32 JsonDocument::getStructuralsCount() const noexcept
+	{
+		return m_countStructurals;
+	}
+
+	Ref<JsonDocument> JsonDocument::_parse(const String& str, const Memory& mem, const sl_char8* sz, sl_size len, JsonParseParam& param)
+	{
+		param.flagError = sl_false;
+		Ref<JsonDocument> doc = new JsonDocument;
+		if (doc.isNull()) {
+			return sl_null;
+		}
+		if (str.isNotNull()) {
+			doc->m_str = str;
+			sz = str.getData();
+			len = str.getLength();
+		} else {
+			doc->m_mem = mem;
+		}
+		doc->m_data = sz;
+		doc->m_length = len;
+		String errorMessage;
+		sl_size errorPosition = 0;
+		if (doc->_buildIndex(errorMessage, errorPosition)) {
+			if (doc->_validate(errorMessage, errorPosition)) {
+				return doc;
+			}
+		}
+		param.flagError = sl_true;
+		param.errorPosition = errorPosition;
+		param.errorMessage = errorMessage;
+		param.errorLine = ParseUtil::countLineNumber(sz, errorPosition, &(param.errorColumn));
+		if (param.flagLogError) {
+			LogError("Json", param.getErrorText());
+		}
+		return sl_null;
+	}
+
+	sl_bool JsonDocument::_buildIndex(String& errorMessage, sl_size& errorPosition)
+	{
+		const sl_uint8* data = (const sl_uint8*)m_data;
+		sl_size len = m_length;
+		if (len >= 0xFFFFFFF0) {
+			errorMessage = "Document is too large";
+			return sl_false;
+		}
+		// at least one token per 8 bytes is typical for real documents
+		sl_size capacity = (len >> 3) + 64;
+		sl_uint32* structurals = (sl_uint32*)(Base::createMemory(capacity * sizeof(sl_uint32)));
+		if (!structurals) {
+			errorMessage = "Lack of memory";
+			return sl_false;
+		}
+		sl_size count = 0;
+
+		const sl_uint64 EVEN_BITS = SLIB_UINT64(0x5555555555555555);
+		sl_uint64 prevEscaped = 0;
+		sl_uint64 prevInString = 0;
+		sl_uint64 prevScalar = 0;
+
+		sl_uint8 tail[64];
+		for (sl_size base = 0; base < len; base += 64) {
+			const sl_uint8* p = data + base;
+			if (len - base < 64) {
+				// pads the last block with white spaces
+				sl_size n = len - base;
+				Base::copyMemory(tail, p, n);
+				Base::resetMemory(tail + n, ' ', 64 - n);
+				p = tail;
+			}
+			_priv_JsonView_BlockMasks masks;
+			_priv_JsonView_classify(p, masks);
+
+			// finds the escaped characters: the character after an odd-length run of backslashes
+			sl_uint64 escaped;
+			{
+				sl_uint64 backslash = masks.backslash & ~prevEscaped;
+				sl_uint64 followsEscape = (backslash << 1) | prevEscaped;
+				sl_uint64 oddStarts = backslash & ~EVEN_BITS & ~followsEscape;
+				sl_uint64 sequencesStartingOnEvenBits = oddStarts + backslash;
+				prevEscaped = sequencesStartingOnEvenBits < oddStarts ? 1 : 0;
+				sl_uint64 invertMask = sequencesStartingOnEvenBits << 1;
+				escaped = (EVEN_BITS ^ invertMask) & followsEscape;
+			}
+			sl_uint64 quote = masks.quote & ~escaped;
+			// from the opening quote to the character before the closing quote
+			sl_uint64 inString = _priv_JsonView_prefixXor(quote) ^ prevInString;
+			prevInString = (sl_uint64)((sl_int64)inString >> 63);
+
+			sl_uint64 scalar = ~(masks.op | masks.space | quote) & ~inString;
+			sl_uint64 scalarStarts = scalar & ~((scalar << 1) | prevScalar);
+			prevScalar = scalar >> 63;
+
+			sl_uint64 bits = (masks.op & ~inString) | (quote & inString) | scalarStarts;
+			if (!bits) {
+				continue;
+			}
+			if (count + 64 > capacity) {
+				sl_size n = capacity + (capacity >> 1) + 64;
+				sl_uint32* t = (sl_uint32*)(Base::reallocMemory(structurals, n * sizeof(sl_uint32)));
+				if (!t) {
+					Base::freeMemory(structurals);
+					errorMessage = "Lack of memory";
+					return sl_false;
+				}
+				structurals = t;
+				capacity = n;
+			}
+			sl_uint32* out = structurals + count;
+			sl_uint32 b = (sl_uint32)base;
+			do {
+				*(out++) = b + _priv_JsonView_getTrailingZeros(bits);
+				bits &= bits - 1;
+			} while (bits);
+			count = out - structurals;
+		}
+		m_structurals = structurals;
+		m_countStructurals = (sl_uint32)count;
+		if (prevInString) {
+			errorMessage = "Missing string terminator";
+			errorPosition = len;
+			return sl_false;
+		}
+		if (!count) {
+			errorMessage = "Empty document";
+			errorPosition = len;
+			return sl_false;
+		}
+		return sl_true;
+	}
+
+	sl_bool JsonDocument::_validate(String& errorMessage, sl_size& errorPosition)
+	{
+		sl_uint32 count = m_countStructurals;
+		sl_uint32* pairs = (sl_uint32*)(Base::createMemory(count * sizeof(sl_uint32)));
+		if (!pairs) {
+			errorMessage = "Lack of memory";
+			return sl_false;
+		}
+		m_pairs = pairs;
+		const sl_char8* data = m_data;
+		const sl_uint32* structurals = m_structurals;
+		sl_uint32 stack[_PRIV_JSON_VIEW_MAX_DEPTH];
+		sl_uint32 depth = 0;
+		_priv_JsonView_State state = _priv_JsonView_State::Value;
+		for (sl_uint32 i = 0; i < count; i++) {
+			sl_size pos = structurals[i];
+			sl_char8 ch = data[pos];
+			pairs[i] = i;
+			switch (state) {
+				case _priv_JsonView_State::FirstElement:
+					if (ch == ']') {
+						depth--;
+						pairs[stack[depth]] = i;
+						state = depth ? _priv_JsonView_State::Next : _priv_JsonView_State::End;
+						continue;
+					}
+					// fall through
+				case _priv_JsonView_State::Value:
+					if (ch == '{' || ch == '[') {
+						if (depth >= _PRIV_JSON_VIEW_MAX_DEPTH) {
+							errorMessage = "Too deep nesting";
+							errorPosition = pos;
+							return sl_false;
+						}
+						stack[depth++] = i;
+						state = ch == '{' ? _priv_JsonView_State::FirstKey : _priv_JsonView_State::FirstElement;
+					} else if (ch == '"') {
+						state = depth ? _priv_JsonView_State::Next : _priv_JsonView_State::End;
+					} else if (ch == '}' || ch == ']' || ch == ':' || ch == ',') {
+						errorMessage = "Missing value";
+						errorPosition = pos;
+						return sl_false;
+					} else {
+						sl_size end = _getEndOfLiteral(pos);
+						if (!(_priv_JsonView_isValidLiteral(data + pos, end - pos))) {
+							errorMessage = "Invalid token";
+							errorPosition = pos;
+							return sl_false;
+						}
+						state = depth ? _priv_JsonView_State::Next : _priv_JsonView_State::End;
+					}
+					break;
+				case _priv_JsonView_State::FirstKey:
+					if (ch == '}') {
+						depth--;
+						pairs[stack[depth]] = i;
+						state = depth ? _priv_JsonView_State::Next : _priv_JsonView_State::End;
+						continue;
+					}
+					// fall through
+				case _priv_JsonView_State::Key:
+					if (ch != '"') {
+						errorMessage = "Object key must be a string";
+						errorPosition = pos;
+						return sl_false;
+					}
+					state = _priv_JsonView_State::Colon;
+					break;
+				case _priv_JsonView_State::Colon:
+					if (ch != ':') {
+						errorMessage = "Missing colon";
+						errorPosition = pos;
+						return sl_false;
+					}
+					state = _priv_JsonView_State::Value;
+					break;
+				case _priv_JsonView_State::Next:
+					{
+						sl_uint32 open = stack[depth - 1];
+						sl_char8 chOpen = data[structurals[open]];
+						if (ch == ',') {
+							state = chOpen == '{' ? _priv_JsonView_State::Key : _priv_JsonView_State::Value;
+						} else if ((ch == '}' && chOpen == '{') || (ch == ']' && chOpen == '[')) {
+							depth--;
+							pairs[open] = i;
+							state = depth ? _priv_JsonView_State::Next : _priv_JsonView_State::End;
+						} else {
+							errorMessage = chOpen == '{' ? "Missing '}' or ','" : "Missing ']' or ','";
+							errorPosition = pos;
+							return sl_false;
+						}
+					}
+					break;
+				case _priv_JsonView_State::End:
+					errorMessage = "Invalid token";
+					errorPosition = pos;
+					return sl_false;
+			}
+		}
+		if (state != _priv_JsonView_State::End) {
+			errorMessage = "Unexpected end of document";
+			errorPosition = m_length;
+			return sl_false;
+		}
+		return sl_true;
+	}
+
+	sl_uint32 JsonDocument::_getEndOfValue(sl_uint32 index) const noexcept
+	{
+		sl_char8 ch = m_data[m_structurals[index]];
+		if (ch == '{' || ch == '[') {
+			return m_pairs[index];
+		}
+		return index;
+	}
+
+	sl_size JsonDocument::_getEndOfString(sl_size pos) const noexcept
+	{
+		const sl_char8* data = m_data;
+		sl_size len = m_length;
+		sl_size start = pos + 1;
+		for (;;) {
+			const sl_char8* q = (const sl_char8*)(Base::findMemory(data + start, (sl_uint8)'"', len - start));
+			if (!q) {
+				return len;
+			}
+			sl_size e = q - data;
+			// the quote is escaped when an odd number of backslashes precedes it
+			sl_size n = 0;
+			while (e - n > pos + 1 && data[e - n - 1] == '\\') {
+				n++;
+			}
+			if (!(n & 1)) {
+				return e;
+			}
+			start = e + 1;
+		}
+	}
+
+	sl_size JsonDocument::_getEndOfLiteral(sl_size pos) const noexcept
+	{
+		const sl_char8* data = m_data;
+		sl_size len = m_length;
+		while (pos < len && !(_priv_JsonView_isLiteralEnd(data[pos]))) {
+			pos++;
+		}
+		return pos;
+	}
+
+	String JsonDocument::_getString(sl_size pos) const noexcept
+	{
+		const sl_char8* data = m_data;
+		sl_size end = _getEndOfString(pos);
+		const sl_char8* s = data + pos + 1;
+		sl_size n = end - pos - 1;
+		if (!(Base::findMemory(s, (sl_uint8)'\\', n))) {
+			return String(s, n);
+		}
+		sl_size m = 0;
+		sl_bool flagError = sl_false;
+		String str = ParseUtil::parseBackslashEscapes(data + pos, end - pos + 1, &m, &flagError);
+		if (flagError) {
+			return sl_null;
+		}
+		return str;
+	}
+
+	sl_bool JsonDocument::_equalsKey(sl_size pos, const String& key) const noexcept
+	{
+		const sl_char8* data = m_data;
+		sl_size end = _getEndOfString(pos);
+		const sl_char8* s = data + pos + 1;
+		sl_size n = end - pos - 1;
+		if (!(Base::findMemory(s, (sl_uint8)'\\', n))) {
+			return n == key.getLength() && Base::equalsMemory(s, key.getData(), n);
+		}
+		return _getString(pos) == key;
+	}
+
+	Json JsonDocument::_toJson(sl_uint32 index, StringInterner& keys) const noexcept
+	{
+		const sl_char8* data = m_data;
+		const sl_uint32* structurals = m_structurals;
+		sl_size pos = structurals[index];
+		sl_char8 ch = data[pos];
+		switch (ch) {
+			case '{':
+				{
+					JsonMap map = JsonMap::create();
+					if (map.isNull()) {
+						return sl_null;
+					}
+					sl_uint32 k = index + 1;
+					while (data[structurals[k]] == '"') {
+						// the keys are shared by the objects having the same members
+						sl_size posKey = structurals[k];
+						sl_size lenKey = _getEndOfString(posKey) - posKey - 1;
+						String key;
+						if (Base::findMemory(data + posKey + 1, (sl_uint8)'\\', lenKey)) {
+							key = _getString(posKey);
+						} else {
+							key = keys.intern(data + posKey + 1, lenKey);
+						}
+						map.put_NoLock(key, _toJson(k + 2, keys));
+						k = _getEndOfValue(k + 2) + 1;
+						if (data[structurals[k]] != ',') {
+							break;
+						}
+						k++;
+					}
+					return map;
+				}
+			case '[':
+				{
+					JsonList list = JsonList::create();
+					if (list.isNull()) {
+						return sl_null;
+					}
+					sl_uint32 k = index + 1;
+					if (data[structurals[k]] != ']') {
+						for (;;) {
+							list.add_NoLock(_toJson(k, keys));
+							k = _getEndOfValue(k) + 1;
+							if (data[structurals[k]] != ',') {
+								break;
+							}
+							k++;
+						}
+					}
+					return list;
+				}
+			case '"':
+				return _getString(pos);
+			case 't':
+				return Json::fromBoolean(sl_true);
+			case 'f':
+				return Json::fromBoolean(sl_false);
+			case 'n':
+				return sl_null;
+		}
+		sl_size end = _getEndOfLiteral(pos);
+		sl_size n = end - pos;
+		sl_int64 vi64;
+		if (String::parseInt64(10, &vi64, data + pos, 0, n) == (sl_reg)n) {
+			if (vi64 >= SLIB_INT64(-0x80000000) && vi64 < SLIB_INT64(0x7fffffff)) {
+				return (sl_int32)vi64;
+			} else {
+				return vi64;
+			}
+		}
+		double vf;
+		if (String::parseDouble(&vf, data + pos, 0, n) == (sl_reg)n) {
+			return vf;
+		}
+		return sl_null;
+	}
+
+}
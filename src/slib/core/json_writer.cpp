@@ -0,0 +1,917 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "slib/core/json_writer.h"
+
+#include "slib/core/io.h"
+
+#if defined(SLIB_ARCH_IS_X64) || (defined(SLIB_ARCH_IS_X86) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#	define _PRIV_JSON_WRITER_USE_SSE2
+#	include <emmintrin.h>
+#elif defined(SLIB_ARCH_IS_ARM64)
+#	define _PRIV_JSON_WRITER_USE_NEON
+#	include <arm_neon.h>
+#endif
+
+#if defined(SLIB_COMPILER_IS_VC)
+#	include <intrin.h>
+#endif
+
+#define _PRIV_JSON_WRITER_MIN_CHUNK_SIZE 256
+
+namespace slib
+{
+
+	/*
+		Grisu2 (Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers", 2010)
+	*/
+
+	struct _priv_JsonWriter_DiyFp
+	{
+		sl_uint64 f;
+		sl_int32 e;
+	};
+
+	SLIB_INLINE static _priv_JsonWriter_DiyFp _priv_JsonWriter_DiyFp_make(sl_uint64 f, sl_int32 e) noexcept
+	{
+		_priv_JsonWriter_DiyFp ret;
+		ret.f = f;
+		ret.e = e;
+		return ret;
+	}
+
+	// `n` should not be zero
+	SLIB_INLINE static sl_uint32 _priv_JsonWriter_countLeadingZeros(sl_uint64 n) noexcept
+	{
+#if defined(SLIB_COMPILER_IS_VC)
+#	if defined(SLIB_ARCH_IS_64BIT)
+		unsigned long index;
+		_BitScanReverse64(&index, n);
+		return 63 - (sl_uint32)index;
+#	else
+		unsigned long index;
+		if ((sl_uint32)(n >> 32)) {
+			_BitScanReverse(&index, (sl_uint32)(n >> 32));
+			return 31 - (sl_uint32)index;
+		}
+		_BitScanReverse(&index, (sl_uint32)n);
+		return 63 - (sl_uint32)index;
+#	endif
+#else
+		return (sl_uint32)(__builtin_clzll(n));
+#endif
+	}
+
+	// `n` should not be zero
+	SLIB_INLINE static sl_uint32 _priv_JsonWriter_countTrailingZeros(sl_uint32 n) noexcept
+	{
+#if defined(SLIB_COMPILER_IS_VC)
+		unsigned long index;
+		_BitScanForward(&index, n);
+		return (sl_uint32)index;
+#else
+		return (sl_uint32)(__builtin_ctz(n));
+#endif
+	}
+
+	SLIB_INLINE static _priv_JsonWriter_DiyFp _priv_JsonWriter_DiyFp_normalize(const _priv_JsonWriter_DiyFp& x) noexcept
+	{
+		sl_uint32 s = _priv_JsonWriter_countLeadingZeros(x.f);
+		return _priv_JsonWriter_DiyFp_make(x.f << s, x.e - (sl_int32)s);
+	}
+
+	// rounded upper 64 bits of the 128 bits product
+	SLIB_INLINE static _priv_JsonWriter_DiyFp _priv_JsonWriter_DiyFp_multiply(const _priv_JsonWriter_DiyFp& x, const _priv_JsonWriter_DiyFp& y) noexcept
+	{
+		const sl_uint64 M32 = 0xFFFFFFFF;
+		sl_uint64 a = x.f >> 32;
+		sl_uint64 b = x.f & M32;
+		sl_uint64 c = y.f >> 32;
+		sl_uint64 d = y.f & M32;
+		sl_uint64 ac = a * c;
+		sl_uint64 bc = b * c;
+		sl_uint64 ad = a * d;
+		sl_uint64 bd = b * d;
+		sl_uint64 t = (bd >> 32) + (ad & M32) + (bc & M32);
+		t += SLIB_UINT64(1) << 31;
+		return _priv_JsonWriter_DiyFp_make(ac + (ad >> 32) + (bc >> 32) + (t >> 32), x.e + y.e + 64);
+	}
+
+	// normalized 10^k for k = -348, -340, ..., 340
+	static const sl_uint64 _priv_JsonWriter_cachedPowers_F[] = {
+		SLIB_UINT64(0xfa8fd5a0081c0288), SLIB_UINT64(0xbaaee17fa23ebf76), SLIB_UINT64(0x8b16fb203055ac76), SLIB_UINT64(0xcf42894a5dce35ea),
+		SLIB_UINT64(0x9a6bb0aa55653b2d), SLIB_UINT64(0xe61acf033d1a45df), SLIB_UINT64(0xab70fe17c79ac6ca), SLIB_UINT64(0xff77b1fcbebcdc4f),
+		SLIB_UINT64(0xbe5691ef416bd60c), SLIB_UINT64(0x8dd01fad907ffc3c), SLIB_UINT64(0xd3515c2831559a83), SLIB_UINT64(0x9d71ac8fada6c9b5),
+		SLIB_UINT64(0xea9c227723ee8bcb), SLIB_UINT64(0xaecc49914078536d), SLIB_UINT64(0x823c12795db6ce57), SLIB_UINT64(0xc21094364dfb5637),
+		SLIB_UINT64(0x9096ea6f3848984f), SLIB_UINT64(0xd77485cb25823ac7), SLIB_UINT64(0xa086cfcd97bf97f4), SLIB_UINT64(0xef340a98172aace5),
+		SLIB_UINT64(0xb23867fb2a35b28e), SLIB_UINT64(0x84c8d4dfd2c63f3b), SLIB_UINT64(0xc5dd44271ad3cdba), SLIB_UINT64(0x936b9fcebb25c996),
+		SLIB_UINT64(0xdbac6c247d62a584), SLIB_UINT64(0xa3ab66580d5fdaf6), SLIB_UINT64(0xf3e2f893dec3f126), SLIB_UINT64(0xb5b5ada8aaff80b8),
+		SLIB_UINT64(0x87625f056c7c4a8b), SLIB_UINT64(0xc9bcff6034c13053), SLIB_UINT64(0x964e858c91ba2655), SLIB_UINT64(0xdff9772470297ebd),
+		SLIB_UINT64(0xa6dfbd9fb8e5b88f), SLIB_UINT64(0xf8a95fcf88747d94), SLIB_UINT64(0xb94470938fa89bcf), SLIB_UINT64(0x8a08f0f8bf0f156b),
+		SLIB_UINT64(0xcdb02555653131b6), SLIB_UINT64(0x993fe2c6d07b7fac), SLIB_UINT64(0xe45c10c42a2b3b06), SLIB_UINT64(0xaa242499697392d3),
+		SLIB_UINT64(0xfd87b5f28300ca0e), SLIB_UINT64(0xbce5086492111aeb), SLIB_UINT64(0x8cbccc096f5088cc), SLIB_UINT64(0xd1b71758e219652c),
+		SLIB_UINT64(0x9c40000000000000), SLIB_UINT64(0xe8d4a51000000000), SLIB_UINT64(0xad78ebc5ac620000), SLIB_UINT64(0x813f3978f8940984),
+		SLIB_UINT64(0xc097ce7bc90715b3), SLIB_UINT64(0x8f7e32ce7bea5c70), SLIB_UINT64(0xd5d238a4abe98068), SLIB_UINT64(0x9f4f2726179a2245),
+		SLIB_UINT64(0xed63a231d4c4fb27), SLIB_UINT64(0xb0de65388cc8ada8), SLIB_UINT64(0x83c7088e1aab65db), SLIB_UINT64(0xc45d1df942711d9a),
+		SLIB_UINT64(0x924d692ca61be758), SLIB_UINT64(0xda01ee641a708dea), SLIB_UINT64(0xa26da3999aef774a), SLIB_UINT64(0xf209787bb47d6b85),
+		SLIB_UINT64(0xb454e4a179dd1877), SLIB_UINT64(0x865b86925b9bc5c2), SLIB_UINT64(0xc83553c5c8965d3d), SLIB_UINT64(0x952ab45cfa97a0b3),
+		SLIB_UINT64(0xde469fbd99a05fe3), SLIB_UINT64(0xa59bc234db398c25), SLIB_UINT64(0xf6c69a72a3989f5c), SLIB_UINT64(0xb7dcbf5354e9bece),
+		SLIB_UINT64(0x88fcf317f22241e2), SLIB_UINT64(0xcc20ce9bd35c78a5), SLIB_UINT64(0x98165af37b2153df), SLIB_UINT64(0xe2a0b5dc971f303a),
+		SLIB_UINT64(0xa8d9d1535ce3b396), SLIB_UINT64(0xfb9b7cd9a4a7443c), SLIB_UINT64(0xbb764c4ca7a44410), SLIB_UINT64(0x8bab8eefb6409c1a),
+		SLIB_UINT64(0xd01fef10a657842c), SLIB_UINT64(0x9b10a4e5e9913129), SLIB_UINT64(0xe7109bfba19c0c9d), SLIB_UINT64(0xac2820d9623bf429),
+		SLIB_UINT64(0x80444b5e7aa7cf85), SLIB_UINT64(0xbf21e44003acdd2d), SLIB_UINT64(0x8e679c2f5e44ff8f), SLIB_UINT64(0xd433179d9c8cb841),
+		SLIB_UINT64(0x9e19db92b4e31ba9), SLIB_UINT64(0xeb96bf6ebadf77d9), SLIB_UINT64(0xaf87023b9bf0ee6b)
+	};
+
+	static const sl_int16 _priv_JsonWriter_cachedPowers_E[] = {
+		-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927, -901, -874, -847, -821,
+		-794, -768, -741, -715, -688, -661, -635, -608, -582, -555, -529, -502, -475, -449, -422, -396,
+		-369, -343, -316, -289, -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+		56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348, 375, 402, 428, 455,
+		481, 508, 534, 561, 588, 614, 641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+		907, 933, 960, 986, 1013, 1039, 1066
+	};
+
+	static const sl_uint64 _priv_JsonWriter_pow10[] = {
+		SLIB_UINT64(1), SLIB_UINT64(10), SLIB_UINT64(100), SLIB_UINT64(1000), SLIB_UINT64(10000),
+		SLIB_UINT64(100000), SLIB_UINT64(1000000), SLIB_UINT64(10000000), SLIB_UINT64(100000000), SLIB_UINT64(1000000000),
+		SLIB_UINT64(10000000000), SLIB_UINT64(100000000000), SLIB_UINT64(1000000000000), SLIB_UINT64(10000000000000), SLIB_UINT64(100000000000000),
+		SLIB_UINT64(1000000000000000), SLIB_UINT64(10000000000000000), SLIB_UINT64(100000000000000000), SLIB_UINT64(1000000000000000000), SLIB_UINT64(10000000000000000000)
+	};
+
+	// returns the cached power c = 10^(-K) such that the exponent of (w * c) is in [-60, -32]
+	SLIB_INLINE static _priv_JsonWriter_DiyFp _priv_JsonWriter_getCachedPower(sl_int32 e, sl_int32* K) noexcept
+	{
+		double dk = (-61 - e) * 0.30102999566398114 + 347;
+		sl_int32 k = (sl_int32)dk;
+		if (dk - k > 0.0) {
+			k++;
+		}
+		sl_uint32 index = (sl_uint32)((k >> 3) + 1);
+		*K = -(-348 + (sl_int32)(index << 3));
+		return _priv_JsonWriter_DiyFp_make(_priv_JsonWriter_cachedPowers_F[index], _priv_JsonWriter_cachedPowers_E[index]);
+	}
+
+	SLIB_INLINE static sl_uint32 _priv_JsonWriter_countDecimalDigits(sl_uint32 n) noexcept
+	{
+		if (n < 10) return 1;
+		if (n < 100) return 2;
+		if (n < 1000) return 3;
+		if (n < 10000) return 4;
+		if (n < 100000) return 5;
+		if (n < 1000000) return 6;
+		if (n < 10000000) return 7;
+		if (n < 100000000) return 8;
+		if (n < 1000000000) return 9;
+		return 10;
+	}
+
+	SLIB_INLINE static void _priv_JsonWriter_grisuRound(sl_char8* buf, sl_int32 len, sl_uint64 delta, sl_uint64 rest, sl_uint64 tenKappa, sl_uint64 distance) noexcept
+	{
+		while (rest < distance && delta - rest >= tenKappa && (rest + tenKappa < distance || distance - rest > rest + tenKappa - distance)) {
+			buf[len - 1]--;
+			rest += tenKappa;
+		}
+	}
+
+	static void _priv_JsonWriter_generateDigits(const _priv_JsonWriter_DiyFp& W, const _priv_JsonWriter_DiyFp& Mp, sl_uint64 delta, sl_char8* buf, sl_int32* len, sl_int32* K) noexcept
+	{
+		sl_uint32 shift = (sl_uint32)(-Mp.e);
+		sl_uint64 one = SLIB_UINT64(1) << shift;
+		sl_uint64 distance = Mp.f - W.f;
+		sl_uint32 p1 = (sl_uint32)(Mp.f >> shift);
+		sl_uint64 p2 = Mp.f & (one - 1);
+		sl_int32 kappa = (sl_int32)(_priv_JsonWriter_countDecimalDigits(p1));
+		sl_int32 n = 0;
+		while (kappa > 0) {
+			sl_uint32 p = (sl_uint32)(_priv_JsonWriter_pow10[kappa - 1]);
+			sl_uint32 d = p1 / p;
+			p1 %= p;
+			if (d || n) {
+				buf[n++] = (sl_char8)('0' + d);
+			}
+			kappa--;
+			sl_uint64 rest = ((sl_uint64)p1 << shift) + p2;
+			if (rest <= delta) {
+				*len = n;
+				*K += kappa;
+				_priv_JsonWriter_grisuRound(buf, n, delta, rest, _priv_JsonWriter_pow10[kappa] << shift, distance);
+				return;
+			}
+		}
+		for (;;) {
+			p2 *= 10;
+			delta *= 10;
+			sl_char8 d = (sl_char8)(p2 >> shift);
+			if (d || n) {
+				buf[n++] = (sl_char8)('0' + d);
+			}
+			p2 &= one - 1;
+			kappa--;
+			if (p2 < delta) {
+				*len = n;
+				*K += kappa;
+				sl_int32 index = -kappa;
+				_priv_JsonWriter_grisuRound(buf, n, delta, p2, one, index < 20 ? distance * _priv_JsonWriter_pow10[index] : 0);
+				return;
+			}
+		}
+	}
+
+	// `f * 2^e` is the value, `flagLowerCloser` is set when the lower neighbor is closer (the significand is a power of two)
+	static void _priv_JsonWriter_grisu2(sl_uint64 f, sl_int32 e, sl_bool flagLowerCloser, sl_char8* buf, sl_int32* len, sl_int32* K) noexcept
+	{
+		_priv_JsonWriter_DiyFp plus = _priv_JsonWriter_DiyFp_normalize(_priv_JsonWriter_DiyFp_make((f << 1) + 1, e - 1));
+		_priv_JsonWriter_DiyFp minus;
+		if (flagLowerCloser) {
+			minus = _priv_JsonWriter_DiyFp_make((f << 2) - 1, e - 2);
+		} else {
+			minus = _priv_JsonWriter_DiyFp_make((f << 1) - 1, e - 1);
+		}
+		minus.f <<= minus.e - plus.e;
+		minus.e = plus.e;
+		_priv_JsonWriter_DiyFp c = _priv_JsonWriter_getCachedPower(plus.e, K);
+		_priv_JsonWriter_DiyFp W = _priv_JsonWriter_DiyFp_multiply(_priv_JsonWriter_DiyFp_normalize(_priv_JsonWriter_DiyFp_make(f, e)), c);
+		_priv_JsonWriter_DiyFp Wp = _priv_JsonWriter_DiyFp_multiply(plus, c);
+		_priv_JsonWriter_DiyFp Wm = _priv_JsonWriter_DiyFp_multiply(minus, c);
+		Wm.f++;
+		Wp.f--;
+		_priv_JsonWriter_generateDigits(W, Wp, Wp.f - Wm.f, buf, len, K);
+	}
+
+	static sl_char8* _priv_JsonWriter_writeExponent(sl_char8* buf, sl_int32 k) noexcept
+	{
+		if (k < 0) {
+			*(buf++) = '-';
+			k = -k;
+		}
+		if (k >= 100) {
+			*(buf++) = (sl_char8)('0' + k / 100);
+			k %= 100;
+			*(buf++) = (sl_char8)('0' + k / 10);
+			*(buf++) = (sl_char8)('0' + k % 10);
+		} else if (k >= 10) {
+			*(buf++) = (sl_char8)('0' + k / 10);
+			*(buf++) = (sl_char8)('0' + k % 10);
+		} else {
+			*(buf++) = (sl_char8)('0' + k);
+		}
+		return buf;
+	}
+
+	// formats the digits `buf[0, len) * 10^k` like the ECMAScript Number::toString
+	static sl_char8* _priv_JsonWriter_prettify(sl_char8* buf, sl_int32 len, sl_int32 k) noexcept
+	{
+		// 10^(kk-1) <= v < 10^kk
+		sl_int32 kk = len + k;
+		if (k >= 0 && kk <= 21) {
+			// 1234e7 -> 12340000000
+			for (sl_int32 i = len; i < kk; i++) {
+				buf[i] = '0';
+			}
+			return buf + kk;
+		} else if (kk > 0 && kk <= 21) {
+			// 1234e-2 -> 12.34
+			Base::moveMemory(buf + kk + 1, buf + kk, len - kk);
+			buf[kk] = '.';
+			return buf + len + 1;
+		} else if (kk > -6 && kk <= 0) {
+			// 1234e-6 -> 0.001234
+			sl_int32 offset = 2 - kk;
+			Base::moveMemory(buf + offset, buf, len);
+			buf[0] = '0';
+			buf[1] = '.';
+			for (sl_int32 i = 2; i < offset; i++) {
+				buf[i] = '0';
+			}
+			return buf + len + offset;
+		} else if (len == 1) {
+			// 1e30
+			buf[1] = 'e';
+			return _priv_JsonWriter_writeExponent(buf + 2, kk - 1);
+		} else {
+			// 1234e30 -> 1.234e33
+			Base::moveMemory(buf + 2, buf + 1, len - 1);
+			buf[1] = '.';
+			buf[len + 1] = 'e';
+			return _priv_JsonWriter_writeExponent(buf + len + 2, kk - 1);
+		}
+	}
+
+	static const sl_char8 _priv_JsonWriter_digitPairs[] =
+		"00010203040506070809"
+		"10111213141516171819"
+		"20212223242526272829"
+		"30313233343536373839"
+		"40414243444546474849"
+		"50515253545556575859"
+		"60616263646566676869"
+		"70717273747576777879"
+		"80818283848586878889"
+		"90919293949596979899";
+
+	static const sl_char8 _priv_JsonWriter_null[] = "null";
+
+	static const sl_char8 _priv_JsonWriter_hex[] = "0123456789abcdef";
+
+	/*
+		Escape character for each byte: 0 for the bytes copied as is, 'u' for \u00XX
+	*/
+	static const sl_char8 _priv_JsonWriter_escapes[256] = {
+		'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+		'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+		0, 0, '"', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '\\', 0, 0, 0
+	};
+
+	// returns the index of the first character which should be escaped, or `length`
+	static sl_size _priv_JsonWriter_findEscape(const sl_char8* str, sl_size length) noexcept
+	{
+		sl_size i = 0;
+#if defined(_PRIV_JSON_WRITER_USE_SSE2)
+		const __m128i vQuote = _mm_set1_epi8('"');
+		const __m128i vBackslash = _mm_set1_epi8('\\');
+		const __m128i vControl = _mm_set1_epi8(0x1F);
+		for (; i + 16 <= length; i += 16) {
+			__m128i v = _mm_loadu_si128((const __m128i*)(str + i));
+			__m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, vQuote), _mm_cmpeq_epi8(v, vBackslash)), _mm_cmpeq_epi8(_mm_max_epu8(v, vControl), vControl));
+			sl_uint32 mask = (sl_uint32)(_mm_movemask_epi8(m));
+			if (mask) {
+				return i + _priv_JsonWriter_countTrailingZeros(mask);
+			}
+		}
+#elif defined(_PRIV_JSON_WRITER_USE_NEON)
+		const uint8x16_t vQuote = vdupq_n_u8('"');
+		const uint8x16_t vBackslash = vdupq_n_u8('\\');
+		const uint8x16_t vControl = vdupq_n_u8(0x20);
+		for (; i + 16 <= length; i += 16) {
+			uint8x16_t v = vld1q_u8((const sl_uint8*)(str + i));
+			uint8x16_t m = vorrq_u8(vorrq_u8(vceqq_u8(v, vQuote), vceqq_u8(v, vBackslash)), vcltq_u8(v, vControl));
+			if (vmaxvq_u8(m)) {
+				break;
+			}
+		}
+#endif
+		for (; i < length; i++) {
+			if (_priv_JsonWriter_escapes[(sl_uint8)(str[i])]) {
+				return i;
+			}
+		}
+		return length;
+	}
+
+
+	JsonWriter::JsonWriter(IWriter* writer, sl_size chunkSize) noexcept
+	{
+		m_writer = writer;
+		m_queue = sl_null;
+		_init(chunkSize);
+	}
+
+	JsonWriter::JsonWriter(MemoryQueue* queue, sl_size chunkSize) noexcept
+	{
+		m_writer = sl_null;
+		m_queue = queue;
+		_init(chunkSize);
+	}
+
+	JsonWriter::JsonWriter(const Function<void(const Memory&)>& onChunk, sl_size chunkSize) noexcept
+	{
+		m_writer = sl_null;
+		m_queue = sl_null;
+		m_onChunk = onChunk;
+		_init(chunkSize);
+	}
+
+	JsonWriter::~JsonWriter() noexcept
+	{
+		flush();
+	}
+
+	void JsonWriter::_init(sl_size chunkSize) noexcept
+	{
+		if (chunkSize < _PRIV_JSON_WRITER_MIN_CHUNK_SIZE) {
+			chunkSize = _PRIV_JSON_WRITER_MIN_CHUNK_SIZE;
+		}
+		m_buf = sl_null;
+		m_sizeChunk = chunkSize;
+		m_pos = 0;
+		m_sizeFlushed = 0;
+		m_flagNeedComma = sl_false;
+		m_flagError = sl_false;
+	}
+
+	sl_bool JsonWriter::write(const Variant& value) noexcept
+	{
+		return _writeVariant(value);
+	}
+
+	sl_bool JsonWriter::beginObject() noexcept
+	{
+		if (!(_prepareValue())) {
+			return sl_false;
+		}
+		m_buf[m_pos++] = '{';
+		m_flagNeedComma = sl_false;
+		return sl_true;
+	}
+
+	sl_bool JsonWriter::endObject() noexcept
+	{
+		if (!(_reserve(1))) {
+			return sl_false;
+		}
+		m_buf[m_pos++] = '}';
+		m_flagNeedComma = sl_true;
+		return sl_true;
+	}
+
+	sl_bool JsonWriter::beginArray() noexcept
+	{
+		if (!(_prepareValue())) {
+			return sl_false;
+		}
+		m_buf[m_pos++] = '[';
+		m_flagNeedComma = sl_false;
+		return sl_true;
+	}
+
+	sl_bool JsonWriter::endArray() noexcept
+	{
+		if (!(_reserve(1))) {
+			return sl_false;
+		}
+		m_buf[m_pos++] = ']';
+		m_flagNeedComma = sl_true;
+		return sl_true;
+	}
+
+	sl_bool JsonWriter::writeKey(const String& key) noexcept
+	{
+		return writeKey(key.getData(), key.getLength());
+	}
+
+	sl_bool JsonWriter::writeKey(const sl_char8* key, sl_size length) noexcept
+	{
+		if (!(_prepareValue())) {
+			return sl_false;
+		}
+		if (!(_writeEscapedString(key, length))) {
+			return sl_false;
+		}
+		if (!(_reserve(1))) {
+			return sl_false;
+		}
+		m_buf[m_pos++] = ':';
+		m_flagNeedComma = sl_false;
+		return sl_true;
+	}
+
+	sl_bool JsonWriter::writeNull() noexcept
+	{
+		return writeRaw(_priv_JsonWriter_null, 4);
+	}
+
+	sl_bool JsonWriter::writeBoolean(sl_bool value) noexcept
+	{
+		if (value) {
+			return writeRaw("true", 4);
+		} else {
+			return writeRaw("false", 5);
+		}
+	}
+
+	sl_bool JsonWriter::writeInt32(sl_int32 value) noexcept
+	{
+		return writeInt64(value);
+	}
+
+	sl_bool JsonWriter::writeUint32(sl_uint32 value) noexcept
+	{
+		return writeUint64(value);
+	}
+
+	sl_bool JsonWriter::writeInt64(sl_int64 value) noexcept
+	{
+		if (!(_prepareValue())) {
+			return sl_false;
+		}
+		m_pos = formatInt64(m_buf + m_pos, value) - m_buf;
+		m_flagNeedComma = sl_true;
+		return sl_true;
+	}
+
+	sl_bool JsonWriter::writeUint64(sl_uint64 value) noexcept
+	{
+		if (!(_prepareValue())) {
+			return sl_false;
+		}
+		m_pos = formatUint64(m_buf + m_pos, value) - m_buf;
+		m_flagNeedComma = sl_true;
+		return sl_true;
+	}
+
+	sl_bool JsonWriter::writeFloat(float value) noexcept
+	{
+		if (!(_prepareValue())) {
+			return sl_false;
+		}
+		m_pos = formatFloat(m_buf + m_pos, value) - m_buf;
+		m_flagNeedComma = sl_true;
+		return sl_true;
+	}
+
+	sl_bool JsonWriter::writeDouble(double value) noexcept
+	{
+		if (!(_prepareValue())) {
+			return sl_false;
+		}
+		m_pos = formatDouble(m_buf + m_pos, value) - m_buf;
+		m_flagNeedComma = sl_true;
+		return sl_true;
+	}
+
+	sl_bool JsonWriter::writeString(const String& value) noexcept
+	{
+		return writeString(value.getData(), value.getLength());
+	}
+
+	sl_bool JsonWriter::writeString(const sl_char8* value, sl_size length) noexcept
+	{
+		if (!(_prepareValue())) {
+			return sl_false;
+		}
+		if (!(_writeEscapedString(value, length))) {
+			return sl_false;
+		}
+		m_flagNeedComma = sl_true;
+		return sl_true;
+	}
+
+	sl_bool JsonWriter::writeRaw(const sl_char8* json, sl_size length) noexcept
+	{
+		if (!(_prepareValue())) {
+			return sl_false;
+		}
+		if (!(_writeBytes(json, length))) {
+			return sl_false;
+		}
+		m_flagNeedComma = sl_true;
+		return sl_true;
+	}
+
+	sl_bool JsonWriter::flush() noexcept
+	{
+		if (m_flagError) {
+			return sl_false;
+		}
+		return _flushChunk();
+	}
+
+	sl_bool JsonWriter::isError() const noexcept
+	{
+		return m_flagError;
+	}
+
+	sl_uint64 JsonWriter::getOutputSize() const noexcept
+	{
+		return m_sizeFlushed + m_pos;
+	}
+
+	sl_char8* JsonWriter::formatUint64(sl_char8* buf, sl_uint64 value) noexcept
+	{
+		sl_char8 t[24];
+		sl_char8* p = t + 24;
+		while (value >= 100) {
+			sl_uint32 r = (sl_uint32)(value % 100);
+			value /= 100;
+			p -= 2;
+			p[0] = _priv_JsonWriter_digitPairs[r << 1];
+			p[1] = _priv_JsonWriter_digitPairs[(r << 1) + 1];
+		}
+		if (value >= 10) {
+			sl_uint32 r = (sl_uint32)value;
+			p -= 2;
+			p[0] = _priv_JsonWriter_digitPairs[r << 1];
+			p[1] = _priv_JsonWriter_digitPairs[(r << 1) + 1];
+		} else {
+			*(--p) = (sl_char8)('0' + (sl_uint32)value);
+		}
+		sl_size n = t + 24 - p;
+		Base::copyMemory(buf, p, n);
+		return buf + n;
+	}
+
+	sl_char8* JsonWriter::formatInt64(sl_char8* buf, sl_int64 value) noexcept
+	{
+		if (value < 0) {
+			*(buf++) = '-';
+			return formatUint64(buf, (sl_uint64)0 - (sl_uint64)value);
+		}
+		return formatUint64(buf, (sl_uint64)value);
+	}
+
+	sl_char8* JsonWriter::formatDouble(sl_char8* buf, double value) noexcept
+	{
+		sl_uint64 u;
+		Base::copyMemory(&u, &value, 8);
+		sl_uint32 biased = (sl_uint32)((u >> 52) & 0x7FF);
+		sl_uint64 significand = u & ((SLIB_UINT64(1) << 52) - 1);
+		if (biased == 0x7FF) {
+			Base::copyMemory(buf, _priv_JsonWriter_null, 4);
+			return buf + 4;
+		}
+		if (u >> 63) {
+			*(buf++) = '-';
+		}
+		if (!biased && !significand) {
+			*(buf++) = '0';
+			return buf;
+		}
+		sl_int32 len, K;
+		if (biased) {
+			_priv_JsonWriter_grisu2(significand | (SLIB_UINT64(1) << 52), (sl_int32)biased - 1075, !significand && biased > 1, buf, &len, &K);
+		} else {
+			_priv_JsonWriter_grisu2(significand, -1074, sl_false, buf, &len, &K);
+		}
+		return _priv_JsonWriter_prettify(buf, len, K);
+	}
+
+	sl_char8* JsonWriter::formatFloat(sl_char8* buf, float value) noexcept
+	{
+		sl_uint32 u;
+		Base::copyMemory(&u, &value, 4);
+		sl_uint32 biased = (u >> 23) & 0xFF;
+		sl_uint32 significand = u & ((1 << 23) - 1);
+		if (biased == 0xFF) {
+			Base::copyMemory(buf, _priv_JsonWriter_null, 4);
+			return buf + 4;
+		}
+		if (u >> 31) {
+			*(buf++) = '-';
+		}
+		if (!biased && !significand) {
+			*(buf++) = '0';
+			return buf;
+		}
+		sl_int32 len, K;
+		if (biased) {
+			_priv_JsonWriter_grisu2(significand | (1 << 23), (sl_int32)biased - 150, !significand && biased > 1, buf, &len, &K);
+		} else {
+			_priv_JsonWriter_grisu2(significand, -149, sl_false, buf, &len, &K);
+		}
+		return _priv_JsonWriter_prettify(buf, len, K);
+	}
+
+	sl_bool JsonWriter::_prepareValue() noexcept
+	{
+		if (!(_reserve(SLIB_JSON_WRITER_NUMBER_BUFFER_SIZE))) {
+			return sl_false;
+		}
+		if (m_flagNeedComma) {
+			m_buf[m_pos++] = ',';
+		}
+		return sl_true;
+	}
+
+	sl_bool JsonWriter::_reserve(sl_size size) noexcept
+	{
+		if (m_flagError) {
+			return sl_false;
+		}
+		if (m_buf) {
+			if (m_pos + size <= m_sizeChunk) {
+				return sl_true;
+			}
+			if (!(_flushChunk())) {
+				return sl_false;
+			}
+			if (m_buf) {
+				return sl_true;
+			}
+		}
+		m_chunk = Memory::create(m_sizeChunk);
+		if (m_chunk.isNull()) {
+			m_flagError = sl_true;
+			return sl_false;
+		}
+		m_buf = (sl_char8*)(m_chunk.getData());
+		m_pos = 0;
+		return sl_true;
+	}
+
+	sl_bool JsonWriter::_flushChunk() noexcept
+	{
+		sl_size n = m_pos;
+		if (!n) {
+			return sl_true;
+		}
+		m_sizeFlushed += n;
+		m_pos = 0;
+		if (m_writer) {
+			if (m_writer->writeFully(m_buf, n) != (sl_reg)n) {
+				m_flagError = sl_true;
+				return sl_false;
+			}
+			return sl_true;
+		}
+		Memory mem;
+		if (n < (m_sizeChunk >> 2)) {
+			// copies the small tail, and keeps the chunk for the next output
+			mem = Memory::create(m_buf, n);
+			if (mem.isNull()) {
+				m_flagError = sl_true;
+				return sl_false;
+			}
+		} else {
+			// passes the chunk without copy
+			if (n < m_sizeChunk) {
+				mem = m_chunk.sub(0, n);
+			} else {
+				mem = m_chunk;
+			}
+			m_chunk.setNull();
+			m_buf = sl_null;
+		}
+		if (m_queue) {
+			if (!(m_queue->add(mem))) {
+				m_flagError = sl_true;
+				return sl_false;
+			}
+		} else {
+			m_onChunk(mem);
+		}
+		return sl_true;
+	}
+
+	sl_bool JsonWriter::_writeBytes(const void* _data, sl_size size) noexcept
+	{
+		const sl_char8* data = (const sl_char8*)_data;
+		while (size) {
+			if (!(_reserve(1))) {
+				return sl_false;
+			}
+			sl_size n = m_sizeChunk - m_pos;
+			if (n > size) {
+				n = size;
+			}
+			Base::copyMemory(m_buf + m_pos, data, n);
+			m_pos += n;
+			data += n;
+			size -= n;
+		}
+		return sl_true;
+	}
+
+	sl_bool JsonWriter::_writeEscapedString(const sl_char8* str, sl_size length) noexcept
+	{
+		if (!(_reserve(1))) {
+			return sl_false;
+		}
+		m_buf[m_pos++] = '"';
+		while (length) {
+			sl_size n = _priv_JsonWriter_findEscape(str, length);
+			if (n) {
+				if (!(_writeBytes(str, n))) {
+					return sl_false;
+				}
+				if (n == length) {
+					break;
+				}
+			}
+			if (!(_reserve(6))) {
+				return sl_false;
+			}
+			sl_uint8 ch = (sl_uint8)(str[n]);
+			sl_char8 e = _priv_JsonWriter_escapes[ch];
+			sl_char8* p = m_buf + m_pos;
+			p[0] = '\\';
+			if (e == 'u') {
+				p[1] = 'u';
+				p[2] = '0';
+				p[3] = '0';
+				p[4] = _priv_JsonWriter_hex[ch >> 4];
+				p[5] = _priv_JsonWriter_hex[ch & 15];
+				m_pos += 6;
+			} else {
+				p[1] = e;
+				m_pos += 2;
+			}
+			str += n + 1;
+			length -= n + 1;
+		}
+		if (!(_reserve(1))) {
+			return sl_false;
+		}
+		m_buf[m_pos++] = '"';
+		return sl_true;
+	}
+
+	sl_bool JsonWriter::_writeVariant(const Variant& v) noexcept
+	{
+		switch (v.getType()) {
+			case VariantType::Int32:
+				return writeInt32(v.getInt32());
+			case VariantType::Uint32:
+				return writeUint32(v.getUint32());
+			case VariantType::Int64:
+				return writeInt64(v.getInt64());
+			case VariantType::Uint64:
+				return writeUint64(v.getUint64());
+			case VariantType::Float:
+				return writeFloat(v.getFloat());
+			case VariantType::Double:
+				return writeDouble(v.getDouble());
+			case VariantType::Boolean:
+				return writeBoolean(v.getBoolean());
+			case VariantType::Time:
+			case VariantType::String8:
+			case VariantType::Sz8:
+			case VariantType::String16:
+			case VariantType::Sz16:
+				return writeString(v.getString());
+			case VariantType::Object:
+			case VariantType::Weak:
+				break;
+			default:
+				return writeNull();
+		}
+		Ref<Referable> obj(v.getObject());
+		if (obj.isNull()) {
+			return writeNull();
+		}
+		if (CList<Variant>* p1 = CastInstance< CList<Variant> >(obj._ptr)) {
+			ListLocker<Variant> list(*p1);
+			if (!(beginArray())) {
+				return sl_false;
+			}
+			for (sl_size i = 0; i < list.count; i++) {
+				if (!(_writeVariant(list[i]))) {
+					return sl_false;
+				}
+			}
+			return endArray();
+		} else if (CMap<String, Variant>* p2 = CastInstance< CMap<String, Variant> >(obj._ptr)) {
+			MutexLocker lock(p2->getLocker());
+			if (!(beginObject())) {
+				return sl_false;
+			}
+			for (auto& pair : *p2) {
+				if (!(writeKey(pair.key))) {
+					return sl_false;
+				}
+				if (!(_writeVariant(pair.value))) {
+					return sl_false;
+				}
+			}
+			return endObject();
+		} else if (CHashMap<String, Variant>* p3 = CastInstance< CHashMap<String, Variant> >(obj._ptr)) {
+			MutexLocker lock(p3->getLocker());
+			if (!(beginObject())) {
+				return sl_false;
+			}
+			for (auto& pair : *p3) {
+				if (!(writeKey(pair.key))) {
+					return sl_false;
+				}
+				if (!(_writeVariant(pair.value))) {
+					return sl_false;
+				}
+			}
+			return endObject();
+		} else if (CList< Map<String, Variant> >* p4 = CastInstance< CList< Map<String, Variant> > >(obj._ptr)) {
+			ListLocker< Map<String, Variant> > list(*p4);
+			if (!(beginArray())) {
+				return sl_false;
+			}
+			for (sl_size i = 0; i < list.count; i++) {
+				if (!(_writeVariant(list[i]))) {
+					return sl_false;
+				}
+			}
+			return endArray();
+		} else if (CList< HashMap<String, Variant> >* p5 = CastInstance< CList< HashMap<String, Variant> > >(obj._ptr)) {
+			ListLocker< HashMap<String, Variant> > list(*p5);
+			if (!(beginArray())) {
+				return sl_false;
+			}
+			for (sl_size i = 0; i < list.count; i++) {
+				if (!(_writeVariant(list[i]))) {
+					return sl_false;
+				}
+			}
+			return endArray();
+		}
+		return writeNull();
+	}
+
+}
@@ -0,0 +1,544 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "slib/core/memory_allocator.h"
+
+#include "slib/core/base.h"
+#include "slib/core/spin_lock.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define _PRIV_POOLED_SLAB_SHIFT 16
+#define _PRIV_POOLED_SLAB_SIZE (1 << _PRIV_POOLED_SLAB_SHIFT)
+#define _PRIV_POOLED_SLAB_HEADER_SIZE 64
+#define _PRIV_POOLED_SLABS_PER_CHUNK 16
+#define _PRIV_POOLED_CLASSES_COUNT SLIB_MEMORY_ALLOCATOR_SIZE_CLASSES_COUNT
+#define _PRIV_POOLED_MAX_SIZE SLIB_MEMORY_ALLOCATOR_MAX_POOLED_SIZE
+
+#if defined(SLIB_ARCH_IS_64BIT)
+#	define _PRIV_POOLED_SLAB_MAP_SIZE 0x10000
+#else
+#	define _PRIV_POOLED_SLAB_MAP_SIZE 1
+#endif
+
+namespace slib
+{
+
+	MemoryAllocator* _g_memory_allocator_current = sl_null;
+
+	MemoryAllocatorStatistics::MemoryAllocatorStatistics() noexcept
+	{
+		Base::zeroMemory(this, sizeof(MemoryAllocatorStatistics));
+	}
+
+	sl_uint64 MemoryAllocatorStatistics::getLiveBlocksCount() const noexcept
+	{
+		sl_uint64 n = 0;
+		for (sl_uint32 i = 0; i < countSizeClasses; i++) {
+			n += sizeClasses[i].countLive;
+		}
+		return n;
+	}
+
+	sl_uint64 MemoryAllocatorStatistics::getLiveBlocksSize() const noexcept
+	{
+		sl_uint64 n = 0;
+		for (sl_uint32 i = 0; i < countSizeClasses; i++) {
+			n += sizeClasses[i].countLive * sizeClasses[i].blockSize;
+		}
+		return n;
+	}
+
+
+	MemoryAllocator::~MemoryAllocator() noexcept
+	{
+	}
+
+	sl_bool MemoryAllocator::getStatistics(MemoryAllocatorStatistics& statistics) noexcept
+	{
+		return sl_false;
+	}
+
+
+	class _priv_SystemMemoryAllocator : public MemoryAllocator
+	{
+	public:
+		constexpr _priv_SystemMemoryAllocator() noexcept {}
+
+	public:
+		void* createMemory(sl_size size) noexcept override
+		{
+			return ::malloc(size);
+		}
+
+		void* reallocMemory(void* ptr, sl_size sizeNew) noexcept override
+		{
+			if (sizeNew == 0) {
+				::free(ptr);
+				return ::malloc(1);
+			} else {
+				return ::realloc(ptr, sizeNew);
+			}
+		}
+
+		void freeMemory(void* ptr) noexcept override
+		{
+			::free(ptr);
+		}
+
+	};
+
+	static _priv_SystemMemoryAllocator _g_memory_allocator_system;
+
+
+	static const sl_uint32 _g_pooled_block_sizes[_PRIV_POOLED_CLASSES_COUNT] = { 16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512, 640, 768, 896, 1024 };
+
+	// count of the blocks moved between a thread cache and the shared list at once
+	static const sl_uint32 _g_pooled_batch_counts[_PRIV_POOLED_CLASSES_COUNT] = { 64, 64, 64, 64, 51, 42, 36, 32, 25, 21, 18, 16, 12, 10, 9, 8, 8, 8, 8, 8 };
+
+	// size class indexed by (size + 15) / 16
+	static const sl_uint8 _g_pooled_size_classes[(_PRIV_POOLED_MAX_SIZE >> 4) + 1] = {
+		0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 12, 12, 13, 13, 13, 13, 14, 14, 14, 14, 15, 15, 15, 15,
+		16, 16, 16, 16, 16, 16, 16, 16, 17, 17, 17, 17, 17, 17, 17, 17, 18, 18, 18, 18, 18, 18, 18, 18, 19, 19, 19, 19, 19, 19, 19, 19
+	};
+
+	struct _priv_PooledMemory_FreeBlock
+	{
+		_priv_PooledMemory_FreeBlock* next;
+	};
+
+	struct _priv_PooledMemory_SlabHeader
+	{
+		sl_uint32 sizeClass;
+	};
+
+	struct _priv_PooledMemory_CentralBin
+	{
+		SpinLock lock;
+		_priv_PooledMemory_FreeBlock* head = sl_null;
+		// the part of the current slab not split into blocks yet
+		sl_uint8* cursor = sl_null;
+		sl_uint8* end = sl_null;
+		// keeps the locks of the neighboring bins out of this cache line
+		sl_uint8 _padding[64] = {0};
+	};
+
+	struct _priv_PooledMemory_ThreadBin
+	{
+		_priv_PooledMemory_FreeBlock* head;
+		sl_uint32 count;
+		sl_uint64 countAllocated;
+		sl_uint64 countFreed;
+	};
+
+	struct _priv_PooledMemory_ThreadCache
+	{
+		_priv_PooledMemory_ThreadBin bins[_PRIV_POOLED_CLASSES_COUNT];
+		sl_uint64 countLargeAllocated;
+		sl_uint64 sizeLargeAllocated;
+		_priv_PooledMemory_ThreadCache* prev;
+		_priv_PooledMemory_ThreadCache* next;
+	};
+
+	static _priv_PooledMemory_CentralBin _g_pooled_bins[_PRIV_POOLED_CLASSES_COUNT];
+
+	// guards the slab chunks, the list of the thread caches and the counters of the exited threads
+	static SpinLock _g_pooled_lock;
+	static sl_uint8* _g_pooled_chunk_cursor = sl_null;
+	static sl_uint8* _g_pooled_chunk_end = sl_null;
+	static sl_uint64 _g_pooled_size_reserved = 0;
+	static _priv_PooledMemory_ThreadCache* _g_pooled_caches = sl_null;
+	static sl_uint32 _g_pooled_caches_count = 0;
+	static sl_uint64 _g_pooled_retired_allocated[_PRIV_POOLED_CLASSES_COUNT] = {0};
+	static sl_uint64 _g_pooled_retired_freed[_PRIV_POOLED_CLASSES_COUNT] = {0};
+	static sl_uint64 _g_pooled_retired_large_count = 0;
+	static sl_uint64 _g_pooled_retired_large_size = 0;
+
+	// one bit for each 64KB of the address space, set for the slabs
+	static sl_uint32* _g_pooled_slab_map[_PRIV_POOLED_SLAB_MAP_SIZE] = {0};
+
+	SLIB_THREAD _priv_PooledMemory_ThreadCache* _gt_pooled_cache = sl_null;
+	SLIB_THREAD sl_bool _gt_pooled_cache_released = sl_false;
+
+	static sl_bool _priv_PooledMemory_isSlabBlock(const void* ptr) noexcept
+	{
+		sl_size addr = (sl_size)ptr;
+#if defined(SLIB_ARCH_IS_64BIT)
+		if (addr >> 48) {
+			return sl_false;
+		}
+		sl_uint32* leaf = _g_pooled_slab_map[addr >> 32];
+#else
+		sl_uint32* leaf = _g_pooled_slab_map[0];
+#endif
+		if (!leaf) {
+			return sl_false;
+		}
+		sl_uint32 slab = (sl_uint32)(addr >> _PRIV_POOLED_SLAB_SHIFT) & 0xFFFF;
+		return (leaf[slab >> 5] >> (slab & 31)) & 1;
+	}
+
+	// called in `_g_pooled_lock`
+	static sl_bool _priv_PooledMemory_registerSlab(sl_uint8* slab) noexcept
+	{
+		sl_size addr = (sl_size)slab;
+#if defined(SLIB_ARCH_IS_64BIT)
+		if (addr >> 48) {
+			return sl_false;
+		}
+		sl_uint32** pLeaf = _g_pooled_slab_map + (addr >> 32);
+#else
+		sl_uint32** pLeaf = _g_pooled_slab_map;
+#endif
+		sl_uint32* leaf = *pLeaf;
+		if (!leaf) {
+			leaf = (sl_uint32*)(::calloc(1, 0x10000 >> 3));
+			if (!leaf) {
+				return sl_false;
+			}
+			// publishes the zero-filled leaf with a full barrier
+			Base::interlockedCompareExchangePtr((void**)pLeaf, leaf, sl_null);
+		}
+		sl_uint32 index = (sl_uint32)(addr >> _PRIV_POOLED_SLAB_SHIFT) & 0xFFFF;
+		leaf[index >> 5] |= (sl_uint32)1 << (index & 31);
+		return sl_true;
+	}
+
+	static sl_uint8* _priv_PooledMemory_createSlab() noexcept
+	{
+		SpinLocker lock(&_g_pooled_lock);
+		if (_g_pooled_chunk_cursor == _g_pooled_chunk_end) {
+			// slabs are aligned to their size, so the slab of a block is found by masking its address
+			sl_size size = _PRIV_POOLED_SLAB_SIZE * (_PRIV_POOLED_SLABS_PER_CHUNK + 1);
+			sl_uint8* chunk = (sl_uint8*)(::malloc(size));
+			if (!chunk) {
+				return sl_null;
+			}
+			sl_uint8* start = (sl_uint8*)(((sl_size)chunk + _PRIV_POOLED_SLAB_SIZE - 1) & ~((sl_size)_PRIV_POOLED_SLAB_SIZE - 1));
+			_g_pooled_chunk_cursor = start;
+			_g_pooled_chunk_end = start + _PRIV_POOLED_SLAB_SIZE * _PRIV_POOLED_SLABS_PER_CHUNK;
+			_g_pooled_size_reserved += size;
+		}
+		sl_uint8* slab = _g_pooled_chunk_cursor;
+		if (!(_priv_PooledMemory_registerSlab(slab))) {
+			return sl_null;
+		}
+		_g_pooled_chunk_cursor += _PRIV_POOLED_SLAB_SIZE;
+		return slab;
+	}
+
+	// pops up to `count` blocks from the shared list of the size class, or splits new blocks
+	static sl_uint32 _priv_PooledMemory_fetchBlocks(sl_uint32 sizeClass, sl_uint32 count, _priv_PooledMemory_FreeBlock*& outHead) noexcept
+	{
+		_priv_PooledMemory_CentralBin& bin = _g_pooled_bins[sizeClass];
+		sl_size sizeBlock = _g_pooled_block_sizes[sizeClass];
+		_priv_PooledMemory_FreeBlock* head = sl_null;
+		sl_uint32 n = 0;
+		SpinLocker lock(&(bin.lock));
+		while (n < count && bin.head) {
+			_priv_PooledMemory_FreeBlock* block = bin.head;
+			bin.head = block->next;
+			block->next = head;
+			head = block;
+			n++;
+		}
+		while (n < count) {
+			if (bin.cursor + sizeBlock > bin.end) {
+				sl_uint8* slab = _priv_PooledMemory_createSlab();
+				if (!slab) {
+					break;
+				}
+				((_priv_PooledMemory_SlabHeader*)slab)->sizeClass = sizeClass;
+				bin.cursor = slab + _PRIV_POOLED_SLAB_HEADER_SIZE;
+				bin.end = slab + _PRIV_POOLED_SLAB_SIZE;
+			}
+			_priv_PooledMemory_FreeBlock* block = (_priv_PooledMemory_FreeBlock*)(bin.cursor);
+			bin.cursor += sizeBlock;
+			block->next = head;
+			head = block;
+			n++;
+		}
+		outHead = head;
+		return n;
+	}
+
+	static void _priv_PooledMemory_returnBlocks(sl_uint32 sizeClass, _priv_PooledMemory_FreeBlock* head, _priv_PooledMemory_FreeBlock* tail) noexcept
+	{
+		_priv_PooledMemory_CentralBin& bin = _g_pooled_bins[sizeClass];
+		SpinLocker lock(&(bin.lock));
+		tail->next = bin.head;
+		bin.head = head;
+	}
+
+	static void _priv_PooledMemory_releaseThreadCache() noexcept
+	{
+		_priv_PooledMemory_ThreadCache* cache = _gt_pooled_cache;
+		_gt_pooled_cache_released = sl_true;
+		if (!cache) {
+			return;
+		}
+		_gt_pooled_cache = sl_null;
+		for (sl_uint32 i = 0; i < _PRIV_POOLED_CLASSES_COUNT; i++) {
+			_priv_PooledMemory_FreeBlock* head = cache->bins[i].head;
+			if (head) {
+				_priv_PooledMemory_FreeBlock* tail = head;
+				while (tail->next) {
+					tail = tail->next;
+				}
+				_priv_PooledMemory_returnBlocks(i, head, tail);
+			}
+		}
+		{
+			SpinLocker lock(&_g_pooled_lock);
+			for (sl_uint32 i = 0; i < _PRIV_POOLED_CLASSES_COUNT; i++) {
+				_g_pooled_retired_allocated[i] += cache->bins[i].countAllocated;
+				_g_pooled_retired_freed[i] += cache->bins[i].countFreed;
+			}
+			_g_pooled_retired_large_count += cache->countLargeAllocated;
+			_g_pooled_retired_large_size += cache->sizeLargeAllocated;
+			if (cache->prev) {
+				cache->prev->next = cache->next;
+			} else {
+				_g_pooled_caches = cache->next;
+			}
+			if (cache->next) {
+				cache->next->prev = cache->prev;
+			}
+			_g_pooled_caches_count--;
+		}
+		::free(cache);
+	}
+
+	class _priv_PooledMemory_ThreadCacheReleaser
+	{
+	public:
+		void activate() noexcept
+		{
+			m_flagActive = sl_true;
+		}
+
+		~_priv_PooledMemory_ThreadCacheReleaser() noexcept
+		{
+			_priv_PooledMemory_releaseThreadCache();
+		}
+
+	private:
+		sl_bool m_flagActive = sl_false;
+
+	};
+
+	SLIB_THREAD _priv_PooledMemory_ThreadCacheReleaser _gt_pooled_cache_releaser;
+
+	SLIB_INLINE static _priv_PooledMemory_ThreadCache* _priv_PooledMemory_getThreadCache() noexcept
+	{
+		_priv_PooledMemory_ThreadCache* cache = _gt_pooled_cache;
+		if (cache) {
+			return cache;
+		}
+		// no cache is created again while the thread is exiting
+		if (_gt_pooled_cache_released) {
+			return sl_null;
+		}
+		cache = (_priv_PooledMemory_ThreadCache*)(::calloc(1, sizeof(_priv_PooledMemory_ThreadCache)));
+		if (!cache) {
+			return sl_null;
+		}
+		_gt_pooled_cache = cache;
+		// registers the destructor releasing the cache on thread exit
+		_gt_pooled_cache_releaser.activate();
+		SpinLocker lock(&_g_pooled_lock);
+		cache->next = _g_pooled_caches;
+		if (_g_pooled_caches) {
+			_g_pooled_caches->prev = cache;
+		}
+		_g_pooled_caches = cache;
+		_g_pooled_caches_count++;
+		return cache;
+	}
+
+	class _priv_PooledMemoryAllocator : public MemoryAllocator
+	{
+	public:
+		constexpr _priv_PooledMemoryAllocator() noexcept {}
+
+	public:
+		void* createMemory(sl_size size) noexcept override
+		{
+			_priv_PooledMemory_ThreadCache* cache = _priv_PooledMemory_getThreadCache();
+			if (size > _PRIV_POOLED_MAX_SIZE) {
+				if (cache) {
+					cache->countLargeAllocated++;
+					cache->sizeLargeAllocated += size;
+				} else {
+					SpinLocker lock(&_g_pooled_lock);
+					_g_pooled_retired_large_count++;
+					_g_pooled_retired_large_size += size;
+				}
+				return ::malloc(size);
+			}
+			sl_uint32 sizeClass = _g_pooled_size_classes[(size + 15) >> 4];
+			if (cache) {
+				_priv_PooledMemory_ThreadBin& bin = cache->bins[sizeClass];
+				_priv_PooledMemory_FreeBlock* block = bin.head;
+				if (!block) {
+					bin.count = _priv_PooledMemory_fetchBlocks(sizeClass, _g_pooled_batch_counts[sizeClass], block);
+					if (!block) {
+						return sl_null;
+					}
+				}
+				bin.head = block->next;
+				bin.count--;
+				bin.countAllocated++;
+				return block;
+			}
+			_priv_PooledMemory_FreeBlock* block;
+			if (_priv_PooledMemory_fetchBlocks(sizeClass, 1, block)) {
+				SpinLocker lock(&_g_pooled_lock);
+				_g_pooled_retired_allocated[sizeClass]++;
+				return block;
+			}
+			return sl_null;
+		}
+
+		void* reallocMemory(void* ptr, sl_size sizeNew) noexcept override
+		{
+			if (!ptr) {
+				return createMemory(sizeNew ? sizeNew : 1);
+			}
+			if (!sizeNew) {
+				freeMemory(ptr);
+				return createMemory(1);
+			}
+			if (!(_priv_PooledMemory_isSlabBlock(ptr))) {
+				// the size of a foreign block is unknown, so it stays in the system allocator
+				return ::realloc(ptr, sizeNew);
+			}
+			_priv_PooledMemory_SlabHeader* slab = (_priv_PooledMemory_SlabHeader*)((sl_size)ptr & ~((sl_size)_PRIV_POOLED_SLAB_SIZE - 1));
+			sl_size sizeOld = _g_pooled_block_sizes[slab->sizeClass];
+			if (sizeNew <= sizeOld) {
+				return ptr;
+			}
+			void* ptrNew = createMemory(sizeNew);
+			if (ptrNew) {
+				::memcpy(ptrNew, ptr, sizeOld);
+				freeMemory(ptr);
+			}
+			return ptrNew;
+		}
+
+		void freeMemory(void* ptr) noexcept override
+		{
+			if (!ptr) {
+				return;
+			}
+			if (!(_priv_PooledMemory_isSlabBlock(ptr))) {
+				::free(ptr);
+				return;
+			}
+			_priv_PooledMemory_SlabHeader* slab = (_priv_PooledMemory_SlabHeader*)((sl_size)ptr & ~((sl_size)_PRIV_POOLED_SLAB_SIZE - 1));
+			sl_uint32 sizeClass = slab->sizeClass;
+			_priv_PooledMemory_FreeBlock* block = (_priv_PooledMemory_FreeBlock*)ptr;
+			_priv_PooledMemory_ThreadCache* cache = _priv_PooledMemory_getThreadCache();
+			if (cache) {
+				_priv_PooledMemory_ThreadBin& bin = cache->bins[sizeClass];
+				block->next = bin.head;
+				bin.head = block;
+				bin.count++;
+				bin.countFreed++;
+				sl_uint32 nBatch = _g_pooled_batch_counts[sizeClass];
+				if (bin.count > (nBatch << 1)) {
+					// returns a batch, so that the blocks freed by a consumer thread flow back to the producers
+					_priv_PooledMemory_FreeBlock* head = bin.head;
+					_priv_PooledMemory_FreeBlock* tail = head;
+					for (sl_uint32 i = 1; i < nBatch; i++) {
+						tail = tail->next;
+					}
+					bin.head = tail->next;
+					bin.count -= nBatch;
+					_priv_PooledMemory_returnBlocks(sizeClass, head, tail);
+				}
+			} else {
+				block->next = sl_null;
+				_priv_PooledMemory_returnBlocks(sizeClass, block, block);
+				SpinLocker lock(&_g_pooled_lock);
+				_g_pooled_retired_freed[sizeClass]++;
+			}
+		}
+
+		sl_bool getStatistics(MemoryAllocatorStatistics& statistics) noexcept override
+		{
+			statistics.countSizeClasses = _PRIV_POOLED_CLASSES_COUNT;
+			sl_uint64 countAllocated[_PRIV_POOLED_CLASSES_COUNT];
+			sl_uint64 countFreed[_PRIV_POOLED_CLASSES_COUNT];
+			SpinLocker lock(&_g_pooled_lock);
+			for (sl_uint32 i = 0; i < _PRIV_POOLED_CLASSES_COUNT; i++) {
+				countAllocated[i] = _g_pooled_retired_allocated[i];
+				countFreed[i] = _g_pooled_retired_freed[i];
+			}
+			sl_uint64 countLarge = _g_pooled_retired_large_count;
+			sl_uint64 sizeLarge = _g_pooled_retired_large_size;
+			_priv_PooledMemory_ThreadCache* cache = _g_pooled_caches;
+			while (cache) {
+				for (sl_uint32 i = 0; i < _PRIV_POOLED_CLASSES_COUNT; i++) {
+					countAllocated[i] += cache->bins[i].countAllocated;
+					countFreed[i] += cache->bins[i].countFreed;
+				}
+				countLarge += cache->countLargeAllocated;
+				sizeLarge += cache->sizeLargeAllocated;
+				cache = cache->next;
+			}
+			for (sl_uint32 i = 0; i < _PRIV_POOLED_CLASSES_COUNT; i++) {
+				MemorySizeClassStatistics& s = statistics.sizeClasses[i];
+				s.blockSize = _g_pooled_block_sizes[i];
+				s.countAllocated = countAllocated[i];
+				// a block may be counted as freed by one thread before its allocation is read from another
+				s.countLive = countAllocated[i] > countFreed[i] ? countAllocated[i] - countFreed[i] : 0;
+			}
+			statistics.countLargeAllocated = countLarge;
+			statistics.sizeLargeAllocated = sizeLarge;
+			statistics.sizeReserved = _g_pooled_size_reserved;
+			statistics.countThreadCaches = _g_pooled_caches_count;
+			return sl_true;
+		}
+
+	};
+
+	static _priv_PooledMemoryAllocator _g_memory_allocator_pooled;
+
+
+	MemoryAllocator* MemoryAllocator::getDefault() noexcept
+	{
+		MemoryAllocator* allocator = _g_memory_allocator_current;
+		if (allocator) {
+			return allocator;
+		}
+		return &_g_memory_allocator_system;
+	}
+
+	void MemoryAllocator::setDefault(MemoryAllocator* allocator) noexcept
+	{
+		if (allocator == &_g_memory_allocator_system) {
+			allocator = sl_null;
+		}
+		_g_memory_allocator_current = allocator;
+	}
+
+	MemoryAllocator* MemoryAllocator::getSystem() noexcept
+	{
+		return &_g_memory_allocator_system;
+	}
+
+	MemoryAllocator* MemoryAllocator::getPooled() noexcept
+	{
+		return &_g_memory_allocator_pooled;
+	}
+
+}
@@ -0,0 +1,323 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "slib/core/memory_arena.h"
+
+#include "slib/core/base.h"
+#include "slib/core/spin_lock.h"
+
+#include <stdlib.h>
+
+#define _PRIV_MEMORY_ARENA_PAGE_SHIFT 12
+#define _PRIV_MEMORY_ARENA_PAGE_SIZE (1 << _PRIV_MEMORY_ARENA_PAGE_SHIFT)
+#define _PRIV_MEMORY_ARENA_PAGES_PER_LEAF 0x100000
+#define _PRIV_MEMORY_ARENA_CHUNK_HEADER_SIZE 32
+#define _PRIV_MEMORY_ARENA_BLOCK_HEADER_SIZE 16
+// larger blocks are given their own chunks
+#define _PRIV_MEMORY_ARENA_MAX_SHARED_BLOCK_RATIO 4
+
+#if defined(SLIB_ARCH_IS_64BIT)
+#	define _PRIV_MEMORY_ARENA_PAGE_MAP_SIZE 0x10000
+#else
+#	define _PRIV_MEMORY_ARENA_PAGE_MAP_SIZE 1
+#endif
+
+namespace slib
+{
+
+	// set when an arena is used for the first time, so that Base skips the checks before
+	sl_bool _g_memory_arena_enabled = sl_false;
+
+	SLIB_THREAD MemoryArena* _gt_memory_arena_current = sl_null;
+
+	struct _priv_MemoryArena_Chunk
+	{
+		_priv_MemoryArena_Chunk* next;
+		// pointer returned by `malloc()`
+		void* base;
+		// size from the start of the chunk, multiple of the page size
+		sl_size size;
+	};
+
+	struct _priv_MemoryArena_BlockHeader
+	{
+		MemoryArena* arena;
+		sl_size size;
+	};
+
+	// guards the updates of the page map
+	static SpinLock _g_memory_arena_lock;
+
+	// one bit for each 4KB of the address space, set for the pages of the chunks
+	static sl_uint32* _g_memory_arena_page_map[_PRIV_MEMORY_ARENA_PAGE_MAP_SIZE] = {0};
+
+	static sl_size _priv_MemoryArena_alignBlock(sl_size size) noexcept
+	{
+		return (size + 15) & ~((sl_size)15);
+	}
+
+	static sl_size _priv_MemoryArena_alignPage(sl_size size) noexcept
+	{
+		return (size + _PRIV_MEMORY_ARENA_PAGE_SIZE - 1) & ~((sl_size)_PRIV_MEMORY_ARENA_PAGE_SIZE - 1);
+	}
+
+	static sl_bool _priv_MemoryArena_markPages(sl_uint8* start, sl_size size, sl_bool flagSet) noexcept
+	{
+		SpinLocker lock(&_g_memory_arena_lock);
+		for (sl_size offset = 0; offset < size; offset += _PRIV_MEMORY_ARENA_PAGE_SIZE) {
+			sl_size addr = (sl_size)(start + offset);
+#if defined(SLIB_ARCH_IS_64BIT)
+			if (addr >> 48) {
+				return sl_false;
+			}
+			sl_uint32** pLeaf = _g_memory_arena_page_map + (addr >> 32);
+#else
+			sl_uint32** pLeaf = _g_memory_arena_page_map;
+#endif
+			sl_uint32* leaf = *pLeaf;
+			if (!leaf) {
+				if (!flagSet) {
+					continue;
+				}
+				leaf = (sl_uint32*)(::calloc(1, _PRIV_MEMORY_ARENA_PAGES_PER_LEAF >> 3));
+				if (!leaf) {
+					return sl_false;
+				}
+				// publishes the zero-filled leaf with a full barrier
+				Base::interlockedCompareExchangePtr((void**)pLeaf, leaf, sl_null);
+			}
+			sl_uint32 page = (sl_uint32)(addr >> _PRIV_MEMORY_ARENA_PAGE_SHIFT) & (_PRIV_MEMORY_ARENA_PAGES_PER_LEAF - 1);
+			if (flagSet) {
+				leaf[page >> 5] |= (sl_uint32)1 << (page & 31);
+			} else {
+				leaf[page >> 5] &= ~((sl_uint32)1 << (page & 31));
+			}
+		}
+		return sl_true;
+	}
+
+	static void _priv_MemoryArena_freeChunk(_priv_MemoryArena_Chunk* chunk) noexcept
+	{
+		// the pages must be unmarked before the memory is reused by the system allocator
+		_priv_MemoryArena_markPages((sl_uint8*)chunk, chunk->size, sl_false);
+		::free(chunk->base);
+	}
+
+	MemoryArena::MemoryArena(sl_size sizeChunk) noexcept
+	{
+		m_chunks = sl_null;
+		m_cursor = sl_null;
+		m_end = sl_null;
+		m_lastBlock = sl_null;
+		if (sizeChunk < _PRIV_MEMORY_ARENA_PAGE_SIZE) {
+			sizeChunk = _PRIV_MEMORY_ARENA_PAGE_SIZE;
+		}
+		m_sizeChunk = _priv_MemoryArena_alignPage(sizeChunk);
+		m_sizeAllocated = 0;
+		m_sizeReserved = 0;
+	}
+
+	MemoryArena::~MemoryArena() noexcept
+	{
+		_freeChunks(sl_false);
+	}
+
+	void* MemoryArena::allocate(sl_size size) noexcept
+	{
+		if (!size) {
+			size = 1;
+		}
+		sl_size sizeBlock = _PRIV_MEMORY_ARENA_BLOCK_HEADER_SIZE + _priv_MemoryArena_alignBlock(size);
+		if (sizeBlock < size) {
+			return sl_null;
+		}
+		sl_uint8* block;
+		if (sizeBlock > m_sizeChunk / _PRIV_MEMORY_ARENA_MAX_SHARED_BLOCK_RATIO) {
+			// keeps the current chunk for the following small blocks
+			_priv_MemoryArena_Chunk* current = (_priv_MemoryArena_Chunk*)m_chunks;
+			if (!(_createChunk(sizeBlock))) {
+				return sl_null;
+			}
+			_priv_MemoryArena_Chunk* chunk = (_priv_MemoryArena_Chunk*)m_chunks;
+			if (current) {
+				m_chunks = current;
+				chunk->next = current->next;
+				current->next = chunk;
+			}
+			block = (sl_uint8*)chunk + _PRIV_MEMORY_ARENA_CHUNK_HEADER_SIZE;
+		} else {
+			if ((sl_size)(m_end - m_cursor) < sizeBlock) {
+				if (!(_createChunk(m_sizeChunk - _PRIV_MEMORY_ARENA_CHUNK_HEADER_SIZE))) {
+					return sl_null;
+				}
+				_priv_MemoryArena_Chunk* chunk = (_priv_MemoryArena_Chunk*)m_chunks;
+				m_cursor = (sl_uint8*)chunk + _PRIV_MEMORY_ARENA_CHUNK_HEADER_SIZE;
+				m_end = (sl_uint8*)chunk + chunk->size;
+			}
+			block = m_cursor;
+			m_cursor += sizeBlock;
+			m_lastBlock = block + _PRIV_MEMORY_ARENA_BLOCK_HEADER_SIZE;
+		}
+		_priv_MemoryArena_BlockHeader* header = (_priv_MemoryArena_BlockHeader*)block;
+		header->arena = this;
+		header->size = size;
+		m_sizeAllocated += size;
+		return block + _PRIV_MEMORY_ARENA_BLOCK_HEADER_SIZE;
+	}
+
+	void* MemoryArena::reallocate(void* _ptr, sl_size sizeNew) noexcept
+	{
+		if (!_ptr) {
+			return allocate(sizeNew);
+		}
+		if (!sizeNew) {
+			sizeNew = 1;
+		}
+		sl_uint8* ptr = (sl_uint8*)_ptr;
+		_priv_MemoryArena_BlockHeader* header = (_priv_MemoryArena_BlockHeader*)(ptr - _PRIV_MEMORY_ARENA_BLOCK_HEADER_SIZE);
+		sl_size sizeOld = header->size;
+		if (ptr == m_lastBlock) {
+			sl_size sizeAligned = _priv_MemoryArena_alignBlock(sizeNew);
+			if (sizeAligned >= sizeNew && sizeAligned <= (sl_size)(m_end - ptr)) {
+				m_cursor = ptr + sizeAligned;
+				m_sizeAllocated = m_sizeAllocated - sizeOld + sizeNew;
+				header->size = sizeNew;
+				return ptr;
+			}
+		}
+		if (sizeNew <= sizeOld) {
+			return ptr;
+		}
+		void* ret = allocate(sizeNew);
+		if (ret) {
+			Base::copyMemory(ret, ptr, sizeOld);
+		}
+		return ret;
+	}
+
+	void MemoryArena::reset() noexcept
+	{
+		_freeChunks(sl_true);
+		_priv_MemoryArena_Chunk* chunk = (_priv_MemoryArena_Chunk*)m_chunks;
+		if (chunk) {
+			m_cursor = (sl_uint8*)chunk + _PRIV_MEMORY_ARENA_CHUNK_HEADER_SIZE;
+			m_end = (sl_uint8*)chunk + chunk->size;
+		} else {
+			m_cursor = sl_null;
+			m_end = sl_null;
+		}
+		m_lastBlock = sl_null;
+		m_sizeAllocated = 0;
+	}
+
+	sl_size MemoryArena::getAllocatedSize() const noexcept
+	{
+		return m_sizeAllocated;
+	}
+
+	sl_size MemoryArena::getReservedSize() const noexcept
+	{
+		return m_sizeReserved;
+	}
+
+	sl_bool MemoryArena::isArenaMemory(const void* ptr) noexcept
+	{
+		sl_size addr = (sl_size)ptr;
+#if defined(SLIB_ARCH_IS_64BIT)
+		if (addr >> 48) {
+			return sl_false;
+		}
+		sl_uint32* leaf = _g_memory_arena_page_map[addr >> 32];
+#else
+		sl_uint32* leaf = _g_memory_arena_page_map[0];
+#endif
+		if (!leaf) {
+			return sl_false;
+		}
+		sl_uint32 page = (sl_uint32)(addr >> _PRIV_MEMORY_ARENA_PAGE_SHIFT) & (_PRIV_MEMORY_ARENA_PAGES_PER_LEAF - 1);
+		return (leaf[page >> 5] >> (page & 31)) & 1;
+	}
+
+	MemoryArena* MemoryArena::getArena(const void* ptr) noexcept
+	{
+		if (!(isArenaMemory(ptr))) {
+			return sl_null;
+		}
+		return ((_priv_MemoryArena_BlockHeader*)((sl_uint8*)ptr - _PRIV_MEMORY_ARENA_BLOCK_HEADER_SIZE))->arena;
+	}
+
+	sl_bool MemoryArena::_createChunk(sl_size sizeMinimum) noexcept
+	{
+		sl_size size = _priv_MemoryArena_alignPage(_PRIV_MEMORY_ARENA_CHUNK_HEADER_SIZE + sizeMinimum);
+		if (size < sizeMinimum) {
+			return sl_false;
+		}
+		if (size < m_sizeChunk) {
+			size = m_sizeChunk;
+		}
+		// chunks are aligned to the pages, so that no page of the map is shared with other memory
+		void* base = ::malloc(size + _PRIV_MEMORY_ARENA_PAGE_SIZE - 1);
+		if (!base) {
+			return sl_false;
+		}
+		_priv_MemoryArena_Chunk* chunk = (_priv_MemoryArena_Chunk*)(_priv_MemoryArena_alignPage((sl_size)base));
+		if (!(_priv_MemoryArena_markPages((sl_uint8*)chunk, size, sl_true))) {
+			_priv_MemoryArena_markPages((sl_uint8*)chunk, size, sl_false);
+			::free(base);
+			return sl_false;
+		}
+		_g_memory_arena_enabled = sl_true;
+		chunk->next = (_priv_MemoryArena_Chunk*)m_chunks;
+		chunk->base = base;
+		chunk->size = size;
+		m_chunks = chunk;
+		m_sizeReserved += size + _PRIV_MEMORY_ARENA_PAGE_SIZE - 1;
+		return sl_true;
+	}
+
+	void MemoryArena::_freeChunks(sl_bool flagKeepFirst) noexcept
+	{
+		_priv_MemoryArena_Chunk* kept = sl_null;
+		_priv_MemoryArena_Chunk* chunk = (_priv_MemoryArena_Chunk*)m_chunks;
+		while (chunk) {
+			_priv_MemoryArena_Chunk* next = chunk->next;
+			if (flagKeepFirst && !kept && chunk->size == m_sizeChunk) {
+				kept = chunk;
+				kept->next = sl_null;
+			} else {
+				m_sizeReserved -= chunk->size + _PRIV_MEMORY_ARENA_PAGE_SIZE - 1;
+				_priv_MemoryArena_freeChunk(chunk);
+			}
+			chunk = next;
+		}
+		m_chunks = kept;
+	}
+
+
+	ArenaScope::ArenaScope(MemoryArena* arena) noexcept
+	{
+		if (arena) {
+			_g_memory_arena_enabled = sl_true;
+		}
+		m_arenaPrevious = _gt_memory_arena_current;
+		_gt_memory_arena_current = arena;
+	}
+
+	ArenaScope::~ArenaScope() noexcept
+	{
+		_gt_memory_arena_current = m_arenaPrevious;
+	}
+
+	MemoryArena* ArenaScope::getCurrent() noexcept
+	{
+		return _gt_memory_arena_current;
+	}
+
+}
@@ -11,6 +11,7 @@
 #include "slib/core/mutex.h"
 
 #include "slib/core/base.h"
+#include "slib/core/memory_arena.h"
 
 #if defined(SLIB_PLATFORM_IS_WINDOWS)
 #include <windows.h>
@@ -25,88 +26,119 @@ namespace slib
 
 	Mutex::Mutex() noexcept
 	{
-		_init();
+		m_pObject = sl_null;
 	}
 
 	Mutex::Mutex(const Mutex& other) noexcept
 	{
-		_init();
+		m_pObject = sl_null;
 	}
 	
 	Mutex::Mutex(Mutex&& other) noexcept
 	{
-		_init();
+		m_pObject = sl_null;
 	}
 
 	Mutex::~Mutex() noexcept
 	{
-		_free();
+		if (m_pObject) {
+			_freeObject(m_pObject);
+		}
 	}
 
-	void Mutex::_init() noexcept
+	void* Mutex::_getObject() const noexcept
 	{
+		void* object = m_pObject;
+		if (object) {
+			return object;
+		}
+		object = _createObject();
+		if (!object) {
+			return sl_null;
+		}
+		if (Base::interlockedCompareExchangePtr(&m_pObject, object, sl_null)) {
+			return object;
+		}
+		// another thread has created the object first
+		_freeObject(object);
+		return m_pObject;
+	}
+
+	void* Mutex::_createObject() noexcept
+	{
+		// the owner of the mutex may outlive the current arena
+		ArenaScope scope(sl_null);
 #if defined(SLIB_PLATFORM_IS_WINDOWS)
-		m_pObject = Base::createMemory(sizeof(CRITICAL_SECTION));
+		void* object = Base::createMemory(sizeof(CRITICAL_SECTION));
+		if (!object) {
+			return sl_null;
+		}
 #	if defined(SLIB_PLATFORM_IS_DESKTOP)
-		InitializeCriticalSection((PCRITICAL_SECTION)m_pObject);
+		InitializeCriticalSection((PCRITICAL_SECTION)object);
 #	elif defined(SLIB_PLATFORM_IS_MOBILE)
-		InitializeCriticalSectionEx((PCRITICAL_SECTION)m_pObject, NULL, NULL);
+		InitializeCriticalSectionEx((PCRITICAL_SECTION)object, NULL, NULL);
 #	endif
+		return object;
 #elif defined(SLIB_PLATFORM_IS_UNIX)
-		m_pObject = Base::createMemory(sizeof(pthread_mutex_t));
+		void* object = Base::createMemory(sizeof(pthread_mutex_t));
+		if (!object) {
+			return sl_null;
+		}
 		pthread_mutexattr_t attr;
 		pthread_mutexattr_init(&attr);
 		pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
-		pthread_mutex_init((pthread_mutex_t*)(m_pObject), &attr);
+		pthread_mutex_init((pthread_mutex_t*)object, &attr);
 		pthread_mutexattr_destroy(&attr);
+		return object;
 #endif
 	}
 
-	void Mutex::_free() noexcept
+	void Mutex::_freeObject(void* object) noexcept
 	{
 #if defined(SLIB_PLATFORM_IS_WINDOWS)
-		DeleteCriticalSection((PCRITICAL_SECTION)m_pObject);
-		Base::freeMemory(m_pObject);
-		m_pObject = sl_null;
+		DeleteCriticalSection((PCRITICAL_SECTION)object);
 #elif defined(SLIB_PLATFORM_IS_UNIX)
-		pthread_mutex_destroy((pthread_mutex_t*)(m_pObject));
-		Base::freeMemory(m_pObject);
+		pthread_mutex_destroy((pthread_mutex_t*)object);
 #endif
+		Base::freeMemory(object);
 	}
 
 	void Mutex::lock() const noexcept
 	{
-		if (!m_pObject) {
+		void* object = _getObject();
+		if (!object) {
 			return;
 		}
 #if defined(SLIB_PLATFORM_IS_WINDOWS)
-		EnterCriticalSection((PCRITICAL_SECTION)m_pObject);
+		EnterCriticalSection((PCRITICAL_SECTION)object);
 #elif defined(SLIB_PLATFORM_IS_UNIX)
-		pthread_mutex_lock((pthread_mutex_t*)(m_pObject));
+		pthread_mutex_lock((pthread_mutex_t*)object);
 #endif
 	}
 
 	sl_bool Mutex::tryLock() const noexcept
 	{
-		if (!m_pObject) {
+		void* object = _getObject();
+		if (!object) {
 			return sl_false;
 		}
 #if defined(SLIB_PLATFORM_IS_WINDOWS)
-		return TryEnterCriticalSection((PCRITICAL_SECTION)m_pObject) != 0;
+		return TryEnterCriticalSection((PCRITICAL_SECTION)object) != 0;
 #elif defined(SLIB_PLATFORM_IS_UNIX)
-		return pthread_mutex_trylock((pthread_mutex_t*)(m_pObject)) == 0;
+		return pthread_mutex_trylock((pthread_mutex_t*)object) == 0;
 #endif
 	}
 
 	void Mutex::unlock() const noexcept
 	{
-		if (!m_pObject) {
+		void* object = m_pObject;
+		if (!object) {
 			return;
 		}
 #if defined(SLIB_PLATFORM_IS_WINDOWS)
-		LeaveCriticalSection((PCRITICAL_SECTION)m_pObject);
+		LeaveCriticalSection((PCRITICAL_SECTION)object);
 #elif defined(SLIB_PLATFORM_IS_UNIX)
-		pthread_mutex_unlock((pthread_mutex_t*)(m_pObject));
+		pthread_mutex_unlock((pthread_mutex_t*)object);
 #endif
 	}
 
@@ -83,6 +83,37 @@ namespace slib
 		}
 	}
 
+
+	SLIB_DEFINE_ROOT_OBJECT(LightObject)
+
+	LightObject::LightObject() noexcept
+	{
+	}
+
+	LightObject::~LightObject() noexcept
+	{
+	}
+
+	Mutex* LightObject::getLocker() const noexcept
+	{
+		return (Mutex*)(&m_locker);
+	}
+
+	void LightObject::lock() const noexcept
+	{
+		m_locker.lock();
+	}
+
+	void LightObject::unlock() const noexcept
+	{
+		m_locker.unlock();
+	}
+
+	sl_bool LightObject::tryLock() const noexcept
+	{
+		return m_locker.tryLock();
+	}
+
 	ObjectLocker::ObjectLocker() noexcept
 	{
 	}
@@ -97,6 +128,16 @@ namespace slib
 	{
 	}
 
+	ObjectLocker::ObjectLocker(const LightObject* object) noexcept
+	 : MutexLocker(object ? object->getLocker(): sl_null)
+	{
+	}
+
+	ObjectLocker::ObjectLocker(const LightObject* object1, const LightObject* object2) noexcept
+	 : MutexLocker(object1 ? object1->getLocker() : sl_null, object2 ? object2->getLocker() : sl_null)
+	{
+	}
+
 	ObjectLocker::~ObjectLocker() noexcept
 	{
 	}
@@ -123,4 +164,26 @@ namespace slib
 		}
 	}
 
+	void ObjectLocker::lock(const LightObject* object) noexcept
+	{
+		if (object) {
+			MutexLocker::lock(object->getLocker());
+		}
+	}
+
+	void ObjectLocker::lock(const LightObject* object1, const LightObject* object2) noexcept
+	{
+		if (object1) {
+			if (object2) {
+				MutexLocker::lock(object1->getLocker(), object2->getLocker());
+			} else {
+				MutexLocker::lock(object1->getLocker());
+			}
+		} else {
+			if (object2) {
+				MutexLocker::lock(object2->getLocker());
+			}
+		}
+	}
+
 }
@@ -10,6 +10,8 @@
 
 #include "slib/core/ref.h"
 
+#include "slib/core/memory_arena.h"
+
 #define _SIGNATURE 0x15181289
 
 namespace slib
@@ -129,10 +131,24 @@ namespace slib
 
 	CWeakRef* Referable::_getWeakObject() noexcept
 	{
-		SpinLocker lock(&m_lockWeak);
-		if (! m_weak) {
-			m_weak = CWeakRef::create(this);
+		CWeakRef* weak = m_weak;
+		if (weak) {
+			return weak;
+		}
+		{
+			// the referable object may outlive the current arena
+			ArenaScope scope(sl_null);
+			weak = CWeakRef::create(this);
+		}
+		if (!weak) {
+			return sl_null;
+		}
+		if (Base::interlockedCompareExchangePtr((void**)(&m_weak), weak, sl_null)) {
+			return weak;
 		}
+		// another thread has created the weak object first
+		weak->m_object = sl_null;
+		weak->decreaseReference();
 		return m_weak;
 	}
 
@@ -10,6 +10,7 @@
 
 #include "slib/core/spin_lock.h"
 
+#include "slib/core/base.h"
 #include "slib/core/system.h"
 
 #if defined(SLIB_PLATFORM_IS_WINDOWS)
@@ -60,7 +61,7 @@ namespace slib
 #endif
 	}
 
-	SpinLock& SpinLock::operator=(const SpinLock& other) noexcept
+	SpinLock& SpinLock::operator=(const SpinLock&) noexcept
 	{
 		return *this;
 	}
@@ -133,6 +134,128 @@ namespace slib
 		}
 	}
 
+// bit 30: writer, bits 20~29: number of waiting writers, bits 0~19: number of readers
+#define RW_SPINLOCK_WRITER 0x40000000
+#define RW_SPINLOCK_WRITER_WAITING 0x00100000
+#define RW_SPINLOCK_WRITERS_WAITING_MASK 0x3FF00000
+#define RW_SPINLOCK_READERS_MASK 0x000FFFFF
+
+	SLIB_INLINE static sl_int32 _ReadWriteSpinLock_getState(const sl_int32* state)
+	{
+		return *((volatile sl_int32*)state);
+	}
+
+	void ReadWriteSpinLock::lockRead() const noexcept
+	{
+		sl_uint32 count = 0;
+		while (!(tryLockRead())) {
+			System::yield(count);
+			count++;
+		}
+	}
+
+	sl_bool ReadWriteSpinLock::tryLockRead() const noexcept
+	{
+		sl_int32* p = (sl_int32*)(&m_state);
+		sl_int32 state = _ReadWriteSpinLock_getState(p);
+		if (state & (RW_SPINLOCK_WRITER | RW_SPINLOCK_WRITERS_WAITING_MASK)) {
+			return sl_false;
+		}
+		return Base::interlockedCompareExchange32(p, state + 1, state);
+	}
+
+	void ReadWriteSpinLock::unlockRead() const noexcept
+	{
+		Base::interlockedDecrement32((sl_int32*)(&m_state));
+	}
+
+	void ReadWriteSpinLock::lockWrite() const noexcept
+	{
+		if (tryLockWrite()) {
+			return;
+		}
+		sl_int32* p = (sl_int32*)(&m_state);
+		// stops new readers from entering until this writer has acquired the lock
+		Base::interlockedAdd32(p, RW_SPINLOCK_WRITER_WAITING);
+		sl_uint32 count = 0;
+		for (;;) {
+			sl_int32 state = _ReadWriteSpinLock_getState(p);
+			if (!(state & (RW_SPINLOCK_WRITER | RW_SPINLOCK_READERS_MASK))) {
+				// removes only its own waiting count, so the other waiting writers still keep the readers out
+				if (Base::interlockedCompareExchange32(p, state - RW_SPINLOCK_WRITER_WAITING + RW_SPINLOCK_WRITER, state)) {
+					return;
+				}
+			}
+			System::yield(count);
+			count++;
+		}
+	}
+
+	sl_bool ReadWriteSpinLock::tryLockWrite() const noexcept
+	{
+		sl_int32* p = (sl_int32*)(&m_state);
+		sl_int32 state = _ReadWriteSpinLock_getState(p);
+		if (state & (RW_SPINLOCK_WRITER | RW_SPINLOCK_READERS_MASK)) {
+			return sl_false;
+		}
+		return Base::interlockedCompareExchange32(p, state | RW_SPINLOCK_WRITER, state);
+	}
+
+	void ReadWriteSpinLock::unlockWrite() const noexcept
+	{
+		// keeps the waiting counts of the other writers
+		Base::interlockedAdd32((sl_int32*)(&m_state), -RW_SPINLOCK_WRITER);
+	}
+
+	ReadWriteSpinLock& ReadWriteSpinLock::operator=(const ReadWriteSpinLock&) noexcept
+	{
+		return *this;
+	}
+
+
+	ReadSpinLocker::ReadSpinLocker(const ReadWriteSpinLock* lock) noexcept
+	{
+		m_lock = lock;
+		if (lock) {
+			lock->lockRead();
+		}
+	}
+
+	ReadSpinLocker::~ReadSpinLocker() noexcept
+	{
+		unlock();
+	}
+
+	void ReadSpinLocker::unlock() noexcept
+	{
+		if (m_lock) {
+			m_lock->unlockRead();
+			m_lock = sl_null;
+		}
+	}
+
+
+	WriteSpinLocker::WriteSpinLocker(const ReadWriteSpinLock* lock) noexcept
+	{
+		m_lock = lock;
+		if (lock) {
+			lock->lockWrite();
+		}
+	}
+
+	WriteSpinLocker::~WriteSpinLocker() noexcept
+	{
+		unlock();
+	}
+
+	void WriteSpinLocker::unlock() noexcept
+	{
+		if (m_lock) {
+			m_lock->unlockWrite();
+			m_lock = sl_null;
+		}
+	}
+
 	template class SpinLockPool<-10>;
 
 	template class SpinLockPool<-20>;
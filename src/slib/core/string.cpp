@@ -12,11 +12,14 @@
 
 #include "slib/core/string.h"
 #include "slib/core/string_buffer.h"
+#include "slib/core/string_interner.h"
 
 #include "slib/core/base.h"
 #include "slib/core/mio.h"
 #include "slib/core/endian.h"
 #include "slib/core/scoped.h"
+#include "slib/core/safe_static.h"
+#include "slib/core/memory_arena.h"
 #include "slib/core/variant.h"
 #include "slib/core/cast.h"
 #include "slib/core/math.h"
@@ -1836,13 +1839,7 @@ namespace slib
 	template <class CT>
 	SLIB_INLINE static sl_size _priv_String_calcHash(const CT* buf, sl_size len) noexcept
 	{
-		sl_size hash = 0;
-		for (sl_size i = 0; i < len; i++) {
-			sl_uint32 ch = buf[i];
-			hash = hash * 31 + ch;
-		}
-		hash = Rehash(hash);
-		return hash;
+		return HashBytes(buf, len * sizeof(CT));
 	}
 	
 	sl_size String::getHashCode() const noexcept
@@ -8586,5 +8583,236 @@ https://docs.oracle.com/javase/7/docs/api/java/util/Formatter.html
 		}
 		return ret;
 	}
+
+
+	StringInterner::StringInterner(sl_bool flagThreadSafe) noexcept
+	{
+		m_table = sl_null;
+		m_capacity = 0;
+		m_count = 0;
+		m_flagThreadSafe = flagThreadSafe;
+		m_flagImmortal = sl_false;
+	}
+
+	StringInterner::StringInterner(sl_bool flagThreadSafe, sl_bool flagImmortal) noexcept
+	{
+		m_table = sl_null;
+		m_capacity = 0;
+		m_count = 0;
+		m_flagThreadSafe = flagThreadSafe;
+		m_flagImmortal = flagImmortal;
+	}
+
+	StringInterner::~StringInterner() noexcept
+	{
+		StringContainer** table = m_table;
+		if (table) {
+			if (!m_flagImmortal) {
+				sl_size n = m_capacity;
+				for (sl_size i = 0; i < n; i++) {
+					if (table[i]) {
+						table[i]->decreaseReference();
+					}
+				}
+			}
+			Base::freeMemory(table);
+		}
+	}
+
+	StringInterner* StringInterner::getGlobal() noexcept
+	{
+		SLIB_SAFE_STATIC(StringInterner, ret, sl_true, sl_true)
+		if (SLIB_SAFE_STATIC_CHECK_FREED(ret)) {
+			return sl_null;
+		}
+		return &ret;
+	}
+
+	String StringInterner::intern(const sl_char8* sz, sl_size len) noexcept
+	{
+		if (!sz) {
+			return sl_null;
+		}
+		if (!len) {
+			return String::getEmpty();
+		}
+		sl_size hash = _priv_String_calcHash(sz, len);
+		if (m_flagThreadSafe) {
+			ReadSpinLocker lock(&m_lock);
+			StringContainer* container = _find(sz, len, hash);
+			if (container) {
+				container->increaseReference();
+				return container;
+			}
+		} else {
+			StringContainer* container = _find(sz, len, hash);
+			if (container) {
+				container->increaseReference();
+				return container;
+			}
+		}
+		// the atoms of the global interner outlive any arena
+		ArenaScope scope(m_flagImmortal ? sl_null : ArenaScope::getCurrent());
+		StringContainer* container = _priv_String_alloc(len);
+		if (!container) {
+			return sl_null;
+		}
+		Base::copyMemory(container->sz, sz, len);
+		container->hash = hash;
+		if (m_flagImmortal) {
+			container->ref = -1;
+		}
+		if (m_flagThreadSafe) {
+			m_lock.lockWrite();
+		}
+		// another thread may have added the same text after the read lock was released
+		StringContainer* old = _find(sz, len, hash);
+		if (old) {
+			old->increaseReference();
+		} else if (!(_insert(container))) {
+			if (m_flagThreadSafe) {
+				m_lock.unlockWrite();
+			}
+			Base::freeMemory(container);
+			return sl_null;
+		} else {
+			container->increaseReference();
+		}
+		if (m_flagThreadSafe) {
+			m_lock.unlockWrite();
+		}
+		if (old) {
+			Base::freeMemory(container);
+			return old;
+		}
+		return container;
+	}
+
+	String StringInterner::intern(const String& str) noexcept
+	{
+		StringContainer* source = str.m_container;
+		if (!source) {
+			return sl_null;
+		}
+		sl_size len = source->len;
+		if (!len) {
+			return String::getEmpty();
+		}
+		// the static strings are shared as they are. the others are copied, because their owners may modify them
+		if (source->ref >= 0) {
+			return intern(source->sz, len);
+		}
+		sl_size hash = str.getHashCode();
+		if (m_flagThreadSafe) {
+			m_lock.lockWrite();
+		}
+		StringContainer* container = _find(source->sz, len, hash);
+		if (!container) {
+			if (_insert(source)) {
+				container = source;
+			}
+		}
+		if (container) {
+			// the returned string holds its own reference, as in the other overload
+			container->increaseReference();
+		}
+		if (m_flagThreadSafe) {
+			m_lock.unlockWrite();
+		}
+		return container;
+	}
+
+	String StringInterner::find(const sl_char8* sz, sl_size len) const noexcept
+	{
+		if (!sz) {
+			return sl_null;
+		}
+		if (!len) {
+			return String::getEmpty();
+		}
+		sl_size hash = _priv_String_calcHash(sz, len);
+		if (m_flagThreadSafe) {
+			ReadSpinLocker lock(&m_lock);
+			StringContainer* container = _find(sz, len, hash);
+			if (container) {
+				container->increaseReference();
+			}
+			return container;
+		} else {
+			StringContainer* container = _find(sz, len, hash);
+			if (container) {
+				container->increaseReference();
+			}
+			return container;
+		}
+	}
+
+	String StringInterner::find(const String& str) const noexcept
+	{
+		return find(str.getData(), str.getLength());
+	}
+
+	sl_size StringInterner::getCount() const noexcept
+	{
+		return m_count;
+	}
+
+	StringContainer* StringInterner::_find(const sl_char8* sz, sl_size len, sl_size hash) const noexcept
+	{
+		StringContainer** table = m_table;
+		if (!table) {
+			return sl_null;
+		}
+		sl_size mask = m_capacity - 1;
+		sl_size index = hash & mask;
+		for (;;) {
+			StringContainer* container = table[index];
+			if (!container) {
+				return sl_null;
+			}
+			if (container->hash == hash && container->len == len && Base::equalsMemory(container->sz, sz, len)) {
+				return container;
+			}
+			index = (index + 1) & mask;
+		}
+	}
+
+	sl_bool StringInterner::_insert(StringContainer* container) noexcept
+	{
+		if ((m_count + 1) << 1 > m_capacity) {
+			sl_size capacity = m_capacity ? m_capacity << 1 : 64;
+			StringContainer** table = (StringContainer**)(Base::createMemory(capacity * sizeof(StringContainer*)));
+			if (!table) {
+				return sl_false;
+			}
+			Base::zeroMemory(table, capacity * sizeof(StringContainer*));
+			sl_size mask = capacity - 1;
+			StringContainer** old = m_table;
+			sl_size n = m_capacity;
+			for (sl_size i = 0; i < n; i++) {
+				StringContainer* item = old[i];
+				if (item) {
+					sl_size index = item->hash & mask;
+					while (table[index]) {
+						index = (index + 1) & mask;
+					}
+					table[index] = item;
+				}
+			}
+			if (old) {
+				Base::freeMemory(old);
+			}
+			m_table = table;
+			m_capacity = capacity;
+		}
+		sl_size mask = m_capacity - 1;
+		sl_size index = container->hash & mask;
+		while (m_table[index]) {
+			index = (index + 1) & mask;
+		}
+		m_table[index] = container;
+		m_count++;
+		return sl_true;
+	}
 	
 }
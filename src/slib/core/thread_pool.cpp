@@ -10,20 +10,156 @@
 
 #include "slib/core/thread_pool.h"
 
+#include <atomic>
+
 namespace slib
 {
 
+	SLIB_THREAD ThreadPool* _gt_threadPoolCurrent = sl_null;
+	SLIB_THREAD void* _gt_threadPoolWorkerCurrent = sl_null;
+
+/*************************************
+		ThreadPool::TaskQueue
+*************************************/
+
+	ThreadPool::TaskQueue::TaskQueue()
+	{
+		m_tasks = sl_null;
+		m_capacity = 0;
+		m_first = 0;
+		m_count = 0;
+	}
+
+	ThreadPool::TaskQueue::~TaskQueue()
+	{
+		if (m_tasks) {
+			delete[] m_tasks;
+		}
+	}
+
+	sl_size ThreadPool::TaskQueue::getCount()
+	{
+		return m_count;
+	}
+
+	sl_bool ThreadPool::TaskQueue::pushBack(const Function<void()>& task)
+	{
+		SpinLocker lock(&m_lock);
+		if (m_count >= m_capacity) {
+			sl_size capacity = m_capacity ? (m_capacity << 1) : 16;
+			Function<void()>* tasks = new Function<void()>[capacity];
+			if (!tasks) {
+				return sl_false;
+			}
+			sl_size mask = m_capacity - 1;
+			for (sl_size i = 0; i < m_count; i++) {
+				tasks[i] = m_tasks[(m_first + i) & mask];
+			}
+			if (m_tasks) {
+				delete[] m_tasks;
+			}
+			m_tasks = tasks;
+			m_capacity = capacity;
+			m_first = 0;
+		}
+		m_tasks[(m_first + m_count) & (m_capacity - 1)] = task;
+		m_count++;
+		return sl_true;
+	}
+
+	sl_bool ThreadPool::TaskQueue::popBack(Function<void()>* _out)
+	{
+		SpinLocker lock(&m_lock);
+		if (!m_count) {
+			return sl_false;
+		}
+		m_count--;
+		Function<void()>& task = m_tasks[(m_first + m_count) & (m_capacity - 1)];
+		*_out = task;
+		task.setNull();
+		return sl_true;
+	}
+
+	sl_bool ThreadPool::TaskQueue::popFront(Function<void()>* _out)
+	{
+		SpinLocker lock(&m_lock);
+		if (!m_count) {
+			return sl_false;
+		}
+		Function<void()>& task = m_tasks[m_first];
+		*_out = task;
+		task.setNull();
+		m_first = (m_first + 1) & (m_capacity - 1);
+		m_count--;
+		return sl_true;
+	}
+
+	void ThreadPool::TaskQueue::removeAll()
+	{
+		Function<void()>* tasks;
+		{
+			SpinLocker lock(&m_lock);
+			tasks = m_tasks;
+			m_tasks = sl_null;
+			m_capacity = 0;
+			m_first = 0;
+			m_count = 0;
+		}
+		if (tasks) {
+			delete[] tasks;
+		}
+	}
+
+/*************************************
+		ThreadPool::Worker
+*************************************/
+
+	ThreadPool::Worker::Worker()
+	{
+		index = 0;
+		flagParked = 0;
+		seed = 0;
+	}
+
+/*************************************
+			ThreadPool
+*************************************/
+
 	SLIB_DEFINE_OBJECT(ThreadPool, Dispatcher)
 
 	ThreadPool::ThreadPool()
 	{
 		setThreadStackSize(SLIB_THREAD_DEFAULT_STACK_SIZE);
+		setIdleTimeout(5000);
+		
+		m_workers = sl_null;
+		m_nWorkers = 0;
+		m_nThreads = 0;
+		
+		m_parkedWorkers = sl_null;
+		m_nParkedWorkers = 0;
+		
+		Base::zeroMemory(m_timerSlots, sizeof(m_timerSlots));
+		m_tickTimer = 0;
+		m_tickTimerNext = (sl_uint64)-1;
+		m_nDelayedTasks = 0;
+		
+		m_nStolenTasks = 0;
+		m_nParkedMilliseconds = 0;
+		
 		m_flagRunning = sl_true;
 	}
 
 	ThreadPool::~ThreadPool()
 	{
 		release();
+		_clearDelayedTasks();
+		if (m_workers) {
+			delete[] m_workers;
+		}
+		if (m_parkedWorkers) {
+			delete[] m_parkedWorkers;
+		}
 	}
 
 	Ref<ThreadPool> ThreadPool::create(sl_uint32 minThreads, sl_uint32 maxThreads)
@@ -44,14 +180,32 @@ namespace slib
 		}
 		m_flagRunning = sl_false;
 		
-		ListElements< Ref<Thread> > threads(m_threadWorkers);
+		List< Ref<Thread> > threads;
+		for (sl_uint32 i = 0; i < m_nWorkers; i++) {
+			Ref<Thread> thread = m_workers[i].thread;
+			if (thread.isNotNull()) {
+				threads.add_NoLock(thread);
+			}
+		}
+		lock.unlock();
+		
+		{
+			MutexLocker lockTimer(&m_lockTimer);
+			if (m_threadTimer.isNotNull()) {
+				threads.add_NoLock(m_threadTimer);
+			}
+		}
+		
+		ListElements< Ref<Thread> > list(threads);
 		sl_size i;
-		for (i = 0; i < threads.count; i++) {
-			threads[i]->finish();
+		for (i = 0; i < list.count; i++) {
+			list[i]->finish();
 		}
-		for (i = 0; i < threads.count; i++) {
-			threads[i]->finishAndWait();
+		for (i = 0; i < list.count; i++) {
+			list[i]->finishAndWait();
 		}
+		
+		_clearDelayedTasks();
 	}
 
 	sl_bool ThreadPool::isRunning()
@@ -61,7 +215,7 @@ namespace slib
 
 	sl_uint32 ThreadPool::getThreadsCount()
 	{
-		return (sl_uint32)(m_threadWorkers.getCount());
+		return m_nThreads;
 	}
 
 	sl_bool ThreadPool::addTask(const Function<void()>& task)
@@ -69,62 +223,408 @@ namespace slib
 		if (task.isNull()) {
 			return sl_false;
 		}
-		ObjectLocker lock(this);
 		if (!m_flagRunning) {
 			return sl_false;
 		}
-		// add task
-		if (!(m_tasks.push(task))) {
+		if (!m_workers) {
+			ObjectLocker lock(this);
+			if (!m_flagRunning) {
+				return sl_false;
+			}
+			if (!(_initWorkers())) {
+				return sl_false;
+			}
+		}
+		
+		// tasks added by a worker go to its own queue, others to the injection queue
+		if (_gt_threadPoolCurrent == this) {
+			Worker* worker = (Worker*)_gt_threadPoolWorkerCurrent;
+			if (!(worker->tasks.pushBack(task))) {
+				return sl_false;
+			}
+		} else {
+			if (!(m_tasks.pushBack(task))) {
+				return sl_false;
+			}
+		}
+
+		if (_unparkWorker()) {
+			return sl_true;
+		}
+		
+		// increase workers
+		sl_uint32 nThreads = m_nThreads;
+		if (nThreads == 0 || nThreads < getMaximumThreadsCount()) {
+			ObjectLocker lock(this);
+			_startWorker();
+		}
+		return sl_true;
+	}
+
+	sl_bool ThreadPool::dispatch(const Function<void()>& callback, sl_uint64 delay_ms)
+	{
+		if (delay_ms == 0) {
+			return addTask(callback);
+		}
+		return _addDelayedTask(callback, delay_ms);
+	}
+
+	sl_size ThreadPool::getQueuedTasksCount()
+	{
+		sl_size n = m_tasks.getCount();
+		Worker* workers = m_workers;
+		if (workers) {
+			for (sl_uint32 i = 0; i < m_nWorkers; i++) {
+				n += workers[i].tasks.getCount();
+			}
+		}
+		return n;
+	}
+
+	sl_size ThreadPool::getDelayedTasksCount()
+	{
+		return m_nDelayedTasks;
+	}
+
+	sl_uint32 ThreadPool::getParkedThreadsCount()
+	{
+		return (sl_uint32)(m_nParkedWorkers);
+	}
+
+	sl_uint64 ThreadPool::getStolenTasksCount()
+	{
+		return (sl_uint64)(m_nStolenTasks);
+	}
+
+	sl_uint64 ThreadPool::getParkedMilliseconds()
+	{
+		return (sl_uint64)(m_nParkedMilliseconds);
+	}
+
+	void ThreadPool::onRunWorker(Worker* worker)
+	{
+		_gt_threadPoolCurrent = this;
+		_gt_threadPoolWorkerCurrent = worker;
+		
+		while (m_flagRunning && Thread::isNotStoppingCurrent()) {
+			Function<void()> task;
+			if (_findTask(worker, &task)) {
+				task();
+			} else {
+				sl_int32 timeout = -1;
+				if (m_nThreads > getMinimumThreadsCount()) {
+					timeout = (sl_int32)(getIdleTimeout());
+				}
+				if (!(_park(worker, timeout))) {
+					ObjectLocker lock(this);
+					// a task may have been pushed after the wait timed out, while no worker was parked to take it
+					if (m_nThreads > getMinimumThreadsCount() && !(_hasTasks())) {
+						m_nThreads--;
+						// pairs with `addTask`: either the task pushed concurrently is seen here, or `addTask` sees the decreased count and starts a worker
+						std::atomic_thread_fence(std::memory_order_seq_cst);
+						if (!(_hasTasks())) {
+							worker->thread.setNull();
+							break;
+						}
+						m_nThreads++;
+					}
+				}
+			}
+		}
+		
+		_gt_threadPoolCurrent = sl_null;
+		_gt_threadPoolWorkerCurrent = sl_null;
+	}
+
+	void ThreadPool::onRunTimer()
+	{
+		Ref<Event> ev = m_eventTimer;
+		while (m_flagRunning && Thread::isNotStoppingCurrent()) {
+			_processTimerWheel(m_timeCounter.getElapsedMilliseconds() / SLIB_THREAD_POOL_TIMER_TICK);
+			ev->wait(_getTimerTimeout());
+		}
+	}
+
+	sl_bool ThreadPool::_initWorkers()
+	{
+		if (m_workers) {
+			return sl_true;
+		}
+		sl_uint32 n = getMaximumThreadsCount();
+		if (n < getMinimumThreadsCount()) {
+			n = getMinimumThreadsCount();
+		}
+		if (!n) {
+			n = 1;
+		}
+		Worker* workers = new Worker[n];
+		if (!workers) {
 			return sl_false;
 		}
+		sl_uint32* parked = new sl_uint32[n];
+		if (parked) {
+			sl_uint32 i;
+			for (i = 0; i < n; i++) {
+				Worker& worker = workers[i];
+				worker.index = i;
+				worker.seed = i + 1;
+				worker.eventWake = Event::create(sl_true);
+				if (worker.eventWake.isNull()) {
+					break;
+				}
+			}
+			if (i == n) {
+				m_parkedWorkers = parked;
+				m_nWorkers = n;
+				Base::interlockedCompareExchangePtr((void**)(&m_workers), workers, sl_null);
+				return sl_true;
+			}
+			delete[] parked;
+		}
+		delete[] workers;
+		return sl_false;
+	}
 
-		// wake a sleeping worker
-		{
-			ListElements< Ref<Thread> > threads(m_threadWorkers);
-			for (sl_size i = 0; i < threads.count; i++) {
-				if (threads[i]->isWaiting()) {
-					threads[i]->wake();
+	sl_bool ThreadPool::_findTask(Worker* worker, Function<void()>* _out)
+	{
+		if (worker->tasks.popBack(_out)) {
+			return sl_true;
+		}
+		if (m_tasks.popFront(_out)) {
+			return sl_true;
+		}
+		sl_uint32 n = m_nWorkers;
+		if (n < 2) {
+			return sl_false;
+		}
+		// xorshift, to spread the victims of the workers
+		sl_uint32 seed = worker->seed;
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		worker->seed = seed;
+		sl_uint32 start = seed % n;
+		for (sl_uint32 i = 0; i < n; i++) {
+			Worker& victim = m_workers[(start + i) % n];
+			if (&victim != worker && victim.tasks.getCount()) {
+				if (victim.tasks.popFront(_out)) {
+					Base::interlockedIncrement64(&m_nStolenTasks);
 					return sl_true;
 				}
 			}
 		}
+		return sl_false;
+	}
 
-		// increase workers
+	sl_bool ThreadPool::_hasTasks()
+	{
+		return getQueuedTasksCount() > 0;
+	}
+
+	sl_bool ThreadPool::_park(Worker* worker, sl_int32 timeout)
+	{
 		{
-			sl_size nThreads = m_threadWorkers.getCount();
-			if (nThreads == 0 || (nThreads < getMaximumThreadsCount())) {
-				Ref<Thread> worker = Thread::start(SLIB_FUNCTION_CLASS(ThreadPool, onRunWorker, this), getThreadStackSize());
-				if (worker.isNotNull()) {
-					m_threadWorkers.add_NoLock(worker);
+			SpinLocker lock(&m_lockParkedWorkers);
+			m_parkedWorkers[m_nParkedWorkers] = worker->index;
+			worker->flagParked = 1;
+			Base::interlockedIncrement32(&m_nParkedWorkers);
+		}
+		// re-check after publishing, so that a task added concurrently is not missed
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (!m_flagRunning || _hasTasks()) {
+			_removeParked(worker);
+			return sl_true;
+		}
+		sl_uint64 timeStart = m_timeCounter.getElapsedMilliseconds();
+		sl_bool flagWoken = worker->eventWake->wait(timeout);
+		Base::interlockedAdd64(&m_nParkedMilliseconds, (sl_int64)(m_timeCounter.getElapsedMilliseconds() - timeStart));
+		// an unparker that already cleared `flagParked` counts on this worker, even if the wait has timed out
+		if (!(_removeParked(worker))) {
+			flagWoken = sl_true;
+		}
+		return flagWoken;
+	}
+
+	sl_bool ThreadPool::_removeParked(Worker* worker)
+	{
+		SpinLocker lock(&m_lockParkedWorkers);
+		if (!(worker->flagParked)) {
+			return sl_false;
+		}
+		worker->flagParked = 0;
+		sl_int32 n = m_nParkedWorkers;
+		for (sl_int32 i = 0; i < n; i++) {
+			if (m_parkedWorkers[i] == worker->index) {
+				for (sl_int32 k = i + 1; k < n; k++) {
+					m_parkedWorkers[k - 1] = m_parkedWorkers[k];
 				}
+				Base::interlockedDecrement32(&m_nParkedWorkers);
+				return sl_true;
 			}
 		}
 		return sl_true;
 	}
 
-	sl_bool ThreadPool::dispatch(const Function<void()>& callback, sl_uint64 delay_ms)
+	sl_bool ThreadPool::_unparkWorker()
 	{
-		return addTask(callback);
+		// orders the preceding push against reading the parking state (pairs with `_park`)
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (m_nParkedWorkers <= 0) {
+			return sl_false;
+		}
+		SpinLocker lock(&m_lockParkedWorkers);
+		sl_int32 n = m_nParkedWorkers;
+		if (n <= 0) {
+			return sl_false;
+		}
+		// the most recently parked worker is the warmest one
+		Worker& worker = m_workers[m_parkedWorkers[n - 1]];
+		worker.flagParked = 0;
+		Base::interlockedDecrement32(&m_nParkedWorkers);
+		lock.unlock();
+		worker.eventWake->set();
+		return sl_true;
 	}
 
-	void ThreadPool::onRunWorker()
+	sl_bool ThreadPool::_startWorker()
 	{
-		while (m_flagRunning && Thread::isNotStoppingCurrent()) {
-			Function<void()> task;
-			if (m_tasks.pop(&task)) {
-				task();
-			} else {
-				ObjectLocker lock(this);
-				sl_size nThreads = m_threadWorkers.getCount();
-				if (nThreads > getMinimumThreadsCount()) {
-					m_threadWorkers.remove_NoLock(Thread::getCurrent());
-					return;
-				} else {
-					lock.unlock();
-					Thread::sleep(5000);
+		if (!m_flagRunning) {
+			return sl_false;
+		}
+		if (m_nThreads > 0 && m_nThreads >= getMaximumThreadsCount()) {
+			return sl_false;
+		}
+		for (sl_uint32 i = 0; i < m_nWorkers; i++) {
+			Worker& worker = m_workers[i];
+			if (worker.thread.isNull()) {
+				Ref<Thread> thread = Thread::start(SLIB_BIND_CLASS(void(), ThreadPool, onRunWorker, this, &worker), getThreadStackSize());
+				if (thread.isNotNull()) {
+					worker.thread = thread;
+					m_nThreads++;
+					return sl_true;
 				}
+				return sl_false;
+			}
+		}
+		return sl_false;
+	}
+
+	sl_bool ThreadPool::_addDelayedTask(const Function<void()>& task, sl_uint64 delay_ms)
+	{
+		if (task.isNull()) {
+			return sl_false;
+		}
+		MutexLocker lock(&m_lockTimer);
+		if (!m_flagRunning) {
+			return sl_false;
+		}
+		if (m_threadTimer.isNull()) {
+			m_eventTimer = Event::create(sl_true);
+			if (m_eventTimer.isNull()) {
+				return sl_false;
+			}
+			m_tickTimer = m_timeCounter.getElapsedMilliseconds() / SLIB_THREAD_POOL_TIMER_TICK;
+			m_threadTimer = Thread::start(SLIB_FUNCTION_CLASS(ThreadPool, onRunTimer, this));
+			if (m_threadTimer.isNull()) {
+				return sl_false;
+			}
+		}
+		DelayedTask* item = new DelayedTask;
+		if (!item) {
+			return sl_false;
+		}
+		sl_uint64 tick = (m_timeCounter.getElapsedMilliseconds() + delay_ms + SLIB_THREAD_POOL_TIMER_TICK - 1) / SLIB_THREAD_POOL_TIMER_TICK;
+		if (tick <= m_tickTimer) {
+			tick = m_tickTimer + 1;
+		}
+		item->tick = tick;
+		item->task = task;
+		DelayedTask*& slot = m_timerSlots[tick % SLIB_THREAD_POOL_TIMER_SLOTS];
+		item->next = slot;
+		slot = item;
+		m_nDelayedTasks++;
+		if (tick < m_tickTimerNext) {
+			m_tickTimerNext = tick;
+			m_eventTimer->set();
+		}
+		return sl_true;
+	}
+
+	void ThreadPool::_processTimerWheel(sl_uint64 tickNow)
+	{
+		DelayedTask* expired = sl_null;
+		DelayedTask** last = &expired;
+		{
+			MutexLocker lock(&m_lockTimer);
+			sl_uint64 tick = m_tickTimer;
+			if (tickNow > tick + SLIB_THREAD_POOL_TIMER_SLOTS) {
+				// every slot is visited only once
+				tick = tickNow - SLIB_THREAD_POOL_TIMER_SLOTS;
+			}
+			while (tick < tickNow) {
+				tick++;
+				DelayedTask** link = &(m_timerSlots[tick % SLIB_THREAD_POOL_TIMER_SLOTS]);
+				while (DelayedTask* item = *link) {
+					if (item->tick <= tickNow) {
+						*link = item->next;
+						item->next = sl_null;
+						*last = item;
+						last = &(item->next);
+						m_nDelayedTasks--;
+					} else {
+						link = &(item->next);
+					}
+				}
+			}
+			if (tickNow > m_tickTimer) {
+				m_tickTimer = tickNow;
+			}
+		}
+		while (expired) {
+			DelayedTask* item = expired;
+			expired = item->next;
+			addTask(item->task);
+			delete item;
+		}
+	}
+
+	sl_int32 ThreadPool::_getTimerTimeout()
+	{
+		MutexLocker lock(&m_lockTimer);
+		if (!m_nDelayedTasks) {
+			m_tickTimerNext = (sl_uint64)-1;
+			return -1;
+		}
+		// sleep until the next occupied slot; it may only hold the tasks of later rounds
+		sl_uint64 tick = m_tickTimer + SLIB_THREAD_POOL_TIMER_SLOTS;
+		for (sl_uint32 i = 1; i <= SLIB_THREAD_POOL_TIMER_SLOTS; i++) {
+			if (m_timerSlots[(m_tickTimer + i) % SLIB_THREAD_POOL_TIMER_SLOTS]) {
+				tick = m_tickTimer + i;
+				break;
+			}
+		}
+		m_tickTimerNext = tick;
+		sl_uint64 t = tick * SLIB_THREAD_POOL_TIMER_TICK;
+		sl_uint64 now = m_timeCounter.getElapsedMilliseconds();
+		if (t > now) {
+			return (sl_int32)(t - now);
+		}
+		return 0;
+	}
+
+	void ThreadPool::_clearDelayedTasks()
+	{
+		MutexLocker lock(&m_lockTimer);
+		for (sl_uint32 i = 0; i < SLIB_THREAD_POOL_TIMER_SLOTS; i++) {
+			DelayedTask* item = m_timerSlots[i];
+			while (item) {
+				DelayedTask* next = item->next;
+				delete item;
+				item = next;
 			}
+			m_timerSlots[i] = sl_null;
 		}
+		m_nDelayedTasks = 0;
 	}
 
 }
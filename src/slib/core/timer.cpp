@@ -16,7 +16,7 @@
 namespace slib
 {
 
-	SLIB_DEFINE_OBJECT(Timer, Object)
+	SLIB_DEFINE_OBJECT(Timer, LightObject)
 
 	Timer::Timer()
 	{
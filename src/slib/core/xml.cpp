@@ -11,6 +11,9 @@
 #include "slib/core/xml.h"
 
 #include "slib/core/file.h"
+#include "slib/core/io.h"
+#include "slib/core/async.h"
+#include "slib/core/thread.h"
 #include "slib/core/log.h"
 #include "slib/core/string_buffer.h"
 
@@ -2364,6 +2367,879 @@ namespace slib
 		return _priv_Xml_Parser<String16, sl_char16, StringBuffer16>::parseXml(filePath, xml.getData(), xml.getLength(), param);
 	}
 
+
+#define SLIB_XML_STREAM_DEFAULT_CHUNK_SIZE 65536
+
+#define STREAM_CALL_LISTENER(NAME, POS, NODE, ...) \
+	{ \
+		PtrLocker<IXmlParseListener> _listener(m_listener); \
+		if (_listener.isNotNull()) { \
+			m_control.parsingPosition = (sl_size)(m_offsetBuf + (POS)); \
+			m_control.currentNode = NODE; \
+			_listener->NAME(&m_control, __VA_ARGS__); \
+			if (m_control.flagStopParsing) { \
+				_setError(_g_xml_error_msg_user_stop, POS); \
+				return sl_false; \
+			} \
+		} \
+	}
+
+
+	SLIB_DEFINE_OBJECT(XmlStreamParser, Object)
+
+	XmlStreamParser::XmlStreamParser()
+	{
+	}
+
+	XmlStreamParser::~XmlStreamParser()
+	{
+	}
+
+	String XmlStreamParser::getErrorText()
+	{
+		return getParam().getErrorText();
+	}
+
+	sl_bool XmlStreamParser::parseFromReader(const Ptr<IReader>& _reader, sl_uint32 sizeChunk)
+	{
+		PtrLocker<IReader> reader(_reader);
+		if (reader.isNull()) {
+			return sl_false;
+		}
+		if (!sizeChunk) {
+			sizeChunk = SLIB_XML_STREAM_DEFAULT_CHUNK_SIZE;
+		}
+		Memory mem = Memory::create(sizeChunk);
+		if (mem.isNull()) {
+			return sl_false;
+		}
+		void* buf = mem.getData();
+		for (;;) {
+			sl_reg n = reader->read(buf, sizeChunk);
+			if (n < 0) {
+				break;
+			}
+			if (n > 0) {
+				if (!(parse(buf, n))) {
+					return sl_false;
+				}
+			} else {
+				if (Thread::isStoppingCurrent()) {
+					return sl_false;
+				}
+				Thread::sleep(1);
+			}
+		}
+		return end();
+	}
+
+	class _priv_XmlStreamParser : public XmlStreamParser
+	{
+	public:
+		struct ElementFrame
+		{
+			Ref<XmlElement> element;
+			String name;
+			String defNamespace;
+			HashMap<String, String> namespaces;
+			List<String> prefixMappings;
+		};
+
+	public:
+		XmlParseParam m_param;
+		Ptr<IXmlParseListener> m_listener;
+		XmlParseControl m_control;
+		_priv_Xml_Parser<String, sl_char8, StringBuffer> m_parser;
+
+		// unprocessed bytes. `m_buf` points to the caller's chunk or to `m_storage`
+		const sl_char8* m_buf;
+		sl_size m_len;
+		sl_size m_pos;
+		sl_char8* m_storage;
+		sl_size m_sizeStorage;
+		// stream offset of `m_buf[0]`
+		sl_uint64 m_offsetBuf;
+
+		// search position and quotation state of the current unfinished markup
+		sl_size m_posScan;
+		sl_char8 m_chQuote;
+
+		// line and column of `m_buf[m_pos]`
+		sl_size m_line;
+		sl_size m_column;
+		sl_bool m_flagLastCR;
+
+		List<ElementFrame> m_stack;
+
+		sl_bool m_flagStarted;
+		sl_bool m_flagEnded;
+		sl_bool m_flagError;
+		sl_bool m_flagFoundRoot;
+
+		Ref<AsyncStream> m_stream;
+		Memory m_memRead;
+		Function<void(XmlStreamParser*)> m_onEnd;
+
+	public:
+		_priv_XmlStreamParser()
+		{
+			m_buf = sl_null;
+			m_len = 0;
+			m_pos = 0;
+			m_storage = sl_null;
+			m_sizeStorage = 0;
+			m_offsetBuf = 0;
+			m_posScan = 0;
+			m_chQuote = 0;
+			m_line = 1;
+			m_column = 1;
+			m_flagLastCR = sl_false;
+			m_flagStarted = sl_false;
+			m_flagEnded = sl_false;
+			m_flagError = sl_false;
+			m_flagFoundRoot = sl_false;
+		}
+
+		~_priv_XmlStreamParser()
+		{
+			if (m_storage) {
+				Base::freeMemory(m_storage);
+			}
+		}
+
+	public:
+		sl_bool parse(const void* data, sl_size size) override
+		{
+			if (m_flagError || m_flagEnded) {
+				return sl_false;
+			}
+			if (!m_flagStarted) {
+				if (!(_start())) {
+					return sl_false;
+				}
+			}
+			if (!size) {
+				return sl_true;
+			}
+			if (m_pos >= m_len) {
+				// nothing is pending: the chunk is parsed in place
+				m_offsetBuf += m_len;
+				m_posScan = 0;
+				m_buf = (const sl_char8*)data;
+				m_len = size;
+				m_pos = 0;
+			} else {
+				sl_size n = m_len + size;
+				if (n > m_sizeStorage) {
+					sl_size sizeNew = m_sizeStorage ? m_sizeStorage : 1024;
+					while (sizeNew < n) {
+						sizeNew <<= 1;
+					}
+					sl_char8* storage = (sl_char8*)(Base::reallocMemory(m_storage, sizeNew));
+					if (!storage) {
+						_setError(_g_xml_error_msg_memory_lack, m_pos);
+						return sl_false;
+					}
+					m_storage = storage;
+					m_sizeStorage = sizeNew;
+					m_buf = storage;
+				}
+				Base::copyMemory(m_storage + m_len, data, size);
+				m_len = n;
+			}
+			if (!(_process(sl_false))) {
+				return sl_false;
+			}
+			return _keepRemaining();
+		}
+
+		sl_bool end() override
+		{
+			if (m_flagError) {
+				return sl_false;
+			}
+			if (m_flagEnded) {
+				return sl_true;
+			}
+			if (!m_flagStarted) {
+				if (!(_start())) {
+					return sl_false;
+				}
+			}
+			if (!(_process(sl_true))) {
+				return sl_false;
+			}
+			if (m_stack.getCount()) {
+				_setError(_g_xml_error_msg_element_tag_not_matching_end_tag, m_len);
+				return sl_false;
+			}
+			if (m_param.flagCheckWellFormed && !m_flagFoundRoot) {
+				_setError(_g_xml_error_msg_document_not_wellformed, m_len);
+				return sl_false;
+			}
+			m_flagEnded = sl_true;
+			STREAM_CALL_LISTENER(onEndDocument, m_len, sl_null, (XmlDocument*)sl_null)
+			return sl_true;
+		}
+
+		sl_bool isError() override
+		{
+			return m_flagError;
+		}
+
+		sl_bool isEnded() override
+		{
+			return m_flagEnded;
+		}
+
+		XmlParseParam& getParam() override
+		{
+			return m_param;
+		}
+
+		sl_bool parseFromAsyncStream(const Ref<AsyncStream>& stream, const Function<void(XmlStreamParser*)>& onEnd, sl_uint32 sizeChunk) override
+		{
+			if (stream.isNull() || m_stream.isNotNull()) {
+				return sl_false;
+			}
+			if (!sizeChunk) {
+				sizeChunk = SLIB_XML_STREAM_DEFAULT_CHUNK_SIZE;
+			}
+			m_memRead = Memory::create(sizeChunk);
+			if (m_memRead.isNull()) {
+				return sl_false;
+			}
+			m_stream = stream;
+			m_onEnd = onEnd;
+			if (stream->readToMemory(m_memRead, SLIB_FUNCTION_REF(_priv_XmlStreamParser, _onReadStream, this))) {
+				return sl_true;
+			}
+			m_stream.setNull();
+			m_onEnd.setNull();
+			return sl_false;
+		}
+
+		void _onReadStream(AsyncStreamResult* result)
+		{
+			if (!(result->flagError)) {
+				if (parse(result->data, result->size)) {
+					if (m_stream->readToMemory(m_memRead, SLIB_FUNCTION_REF(_priv_XmlStreamParser, _onReadStream, this))) {
+						return;
+					}
+				}
+			}
+			if (!m_flagError) {
+				end();
+			}
+			m_stream.setNull();
+			Function<void(XmlStreamParser*)> onEnd = m_onEnd;
+			m_onEnd.setNull();
+			onEnd(this);
+		}
+
+		sl_bool _start()
+		{
+			m_flagStarted = sl_true;
+			STREAM_CALL_LISTENER(onStartDocument, 0, sl_null, (XmlDocument*)sl_null)
+			return sl_true;
+		}
+
+		// moves the unfinished markup into the storage
+		sl_bool _keepRemaining()
+		{
+			sl_size n = m_len - m_pos;
+			if (n) {
+				if (n > m_sizeStorage) {
+					sl_size sizeNew = m_sizeStorage ? m_sizeStorage : 1024;
+					while (sizeNew < n) {
+						sizeNew <<= 1;
+					}
+					sl_char8* storage = (sl_char8*)(Base::createMemory(sizeNew));
+					if (!storage) {
+						_setError(_g_xml_error_msg_memory_lack, m_pos);
+						return sl_false;
+					}
+					Base::copyMemory(storage, m_buf + m_pos, n);
+					if (m_storage) {
+						Base::freeMemory(m_storage);
+					}
+					m_storage = storage;
+					m_sizeStorage = sizeNew;
+				} else if (m_buf != m_storage || m_pos) {
+					Base::moveMemory(m_storage, m_buf + m_pos, n);
+				}
+			}
+			m_offsetBuf += m_pos;
+			if (m_posScan > m_pos) {
+				m_posScan -= m_pos;
+			} else {
+				m_posScan = 0;
+			}
+			m_buf = m_storage;
+			m_len = n;
+			m_pos = 0;
+			return sl_true;
+		}
+
+		void _countLines(const sl_char8* buf, sl_size start, sl_size end, sl_size& line, sl_size& column, sl_bool& flagLastCR)
+		{
+			for (sl_size i = start; i < end; i++) {
+				sl_char8 ch = buf[i];
+				if (ch == '\r') {
+					line++;
+					column = 1;
+					flagLastCR = sl_true;
+				} else {
+					if (ch == '\n') {
+						if (!flagLastCR) {
+							line++;
+							column = 1;
+						}
+					} else {
+						column++;
+					}
+					flagLastCR = sl_false;
+				}
+			}
+		}
+
+		void _consume(sl_size end)
+		{
+			_countLines(m_buf, m_pos, end, m_line, m_column, m_flagLastCR);
+			m_pos = end;
+			m_posScan = end;
+			m_chQuote = 0;
+		}
+
+		void _setError(const String& message, sl_size pos)
+		{
+			m_flagError = sl_true;
+			sl_size line = m_line;
+			sl_size column = m_column;
+			sl_bool flagLastCR = m_flagLastCR;
+			if (pos > m_len) {
+				pos = m_len;
+			}
+			if (pos > m_pos) {
+				_countLines(m_buf, m_pos, pos, line, column, flagLastCR);
+			}
+			m_param.flagError = sl_true;
+			m_param.errorPosition = (sl_size)(m_offsetBuf + pos);
+			m_param.errorLine = line;
+			m_param.errorColumn = column;
+			m_param.errorMessage = message;
+			if (m_param.flagLogError) {
+				LogError("Xml", m_param.getErrorText());
+			}
+		}
+
+		void _setParserError(sl_size start)
+		{
+			_setError(m_parser.errorMessage, start + m_parser.pos);
+		}
+
+		void _prepareParser(sl_size start, sl_size end)
+		{
+			m_parser.buf = m_buf + start;
+			m_parser.len = end - start;
+			m_parser.pos = 0;
+			m_parser.flagError = sl_false;
+		}
+
+		// 1: matched, 0: not matched, -1: more data is required
+		sl_int32 _matchPrefix(sl_size start, const char* prefix, sl_size len)
+		{
+			sl_size n = m_len - start;
+			sl_bool flagShort = n < len;
+			if (flagShort) {
+				len = n;
+			}
+			if (!(Base::equalsMemory(m_buf + start, prefix, len))) {
+				return 0;
+			}
+			return flagShort ? -1 : 1;
+		}
+
+		// returns the position of `term`, or `m_len` when it is not found yet
+		sl_size _findTerminator(sl_size start, const char* term, sl_size lenTerm)
+		{
+			sl_size pos = m_posScan > start ? m_posScan : start;
+			while (pos + lenTerm <= m_len) {
+				const sl_uint8* p = Base::findMemory(m_buf + pos, term[0], m_len - pos);
+				if (!p) {
+					break;
+				}
+				pos = (const sl_char8*)p - m_buf;
+				if (pos + lenTerm > m_len) {
+					break;
+				}
+				if (Base::equalsMemory(m_buf + pos, term, lenTerm)) {
+					return pos;
+				}
+				pos++;
+			}
+			if (m_len >= lenTerm && m_len - lenTerm + 1 > start) {
+				m_posScan = m_len - lenTerm + 1;
+			}
+			return m_len;
+		}
+
+		// finds the end of a start-tag, skipping the quoted attribute values
+		sl_size _findEndOfTag(sl_size start)
+		{
+			sl_size pos = m_posScan > start ? m_posScan : start;
+			sl_char8 chQuote = m_chQuote;
+			for (; pos < m_len; pos++) {
+				sl_char8 ch = m_buf[pos];
+				if (chQuote) {
+					if (ch == chQuote) {
+						chQuote = 0;
+					}
+				} else if (ch == '>') {
+					return pos;
+				} else if (ch == '\"' || ch == '\'') {
+					chQuote = ch;
+				}
+			}
+			m_posScan = m_len;
+			m_chQuote = chQuote;
+			return m_len;
+		}
+
+		sl_bool _process(sl_bool flagEnd)
+		{
+			if (!m_offsetBuf && !m_pos && m_line == 1 && m_column == 1) {
+				// UTF-8 byte order mark
+				sl_int32 r = _matchPrefix(0, "\xEF\xBB\xBF", 3);
+				if (r > 0) {
+					m_pos = 3;
+					m_posScan = 3;
+				} else if (r < 0 && !flagEnd) {
+					return sl_true;
+				}
+			}
+			while (m_pos < m_len) {
+				sl_size start = m_pos;
+				if (m_buf[start] != '<') {
+					sl_size end = m_len;
+					sl_size pos = m_posScan > start ? m_posScan : start;
+					const sl_uint8* p = Base::findMemory(m_buf + pos, '<', m_len - pos);
+					if (p) {
+						end = (const sl_char8*)p - m_buf;
+					} else if (!flagEnd) {
+						m_posScan = m_len;
+						return sl_true;
+					}
+					if (!(_processText(start, end))) {
+						return sl_false;
+					}
+					_consume(end);
+					continue;
+				}
+				if (start + 1 >= m_len) {
+					if (flagEnd) {
+						_setError(_g_xml_error_msg_element_tag_not_end, m_len);
+						return sl_false;
+					}
+					return sl_true;
+				}
+				sl_char8 ch = m_buf[start + 1];
+				if (ch == '!') {
+					sl_int32 r = _matchPrefix(start, "<!--", 4);
+					if (r > 0) {
+						sl_size end = _findTerminator(start + 4, "-->", 3);
+						if (end >= m_len) {
+							if (flagEnd) {
+								_setError(_g_xml_error_msg_comment_not_end, m_len);
+								return sl_false;
+							}
+							return sl_true;
+						}
+						if (!(_processComment(start + 4, end))) {
+							return sl_false;
+						}
+						_consume(end + 3);
+						continue;
+					}
+					if (r == 0) {
+						r = _matchPrefix(start, "<![CDATA[", 9);
+						if (r > 0) {
+							sl_size end = _findTerminator(start + 9, "]]>", 3);
+							if (end >= m_len) {
+								if (flagEnd) {
+									_setError(_g_xml_error_msg_CDATA_not_end, m_len);
+									return sl_false;
+								}
+								return sl_true;
+							}
+							if (!(_processCDATA(start + 9, end))) {
+								return sl_false;
+							}
+							_consume(end + 3);
+							continue;
+						}
+						if (r == 0) {
+							_setError(_g_xml_error_msg_invalid_markup, start + 2);
+							return sl_false;
+						}
+					}
+					if (flagEnd) {
+						_setError(_g_xml_error_msg_invalid_markup, start + 2);
+						return sl_false;
+					}
+					return sl_true;
+				} else if (ch == '?') {
+					sl_size end = _findTerminator(start + 2, "?>", 2);
+					if (end >= m_len) {
+						if (flagEnd) {
+							_setError(_g_xml_error_msg_PI_not_end, m_len);
+							return sl_false;
+						}
+						return sl_true;
+					}
+					if (!(_processPI(start + 2, end))) {
+						return sl_false;
+					}
+					_consume(end + 2);
+				} else if (ch == '/') {
+					sl_size end = _findTerminator(start + 2, ">", 1);
+					if (end >= m_len) {
+						if (flagEnd) {
+							_setError(_g_xml_error_msg_element_tag_not_end, m_len);
+							return sl_false;
+						}
+						return sl_true;
+					}
+					if (!(_processEndTag(start + 2, end))) {
+						return sl_false;
+					}
+					_consume(end + 1);
+				} else {
+					sl_size end = _findEndOfTag(start + 1);
+					if (end >= m_len) {
+						if (flagEnd) {
+							_setError(m_chQuote ? _g_xml_error_msg_element_attr_not_end : _g_xml_error_msg_element_tag_not_end, m_len);
+							return sl_false;
+						}
+						return sl_true;
+					}
+					if (!(_processStartTag(start + 1, end))) {
+						return sl_false;
+					}
+					_consume(end + 1);
+				}
+			}
+			return sl_true;
+		}
+
+		sl_bool _processText(sl_size start, sl_size end)
+		{
+			const sl_char8* buf = m_buf;
+			while (start < end && SLIB_CHAR_IS_WHITE_SPACE(buf[start])) {
+				start++;
+			}
+			while (end > start && SLIB_CHAR_IS_WHITE_SPACE(buf[end - 1])) {
+				end--;
+			}
+			if (start >= end) {
+				return sl_true;
+			}
+			if (m_param.flagCheckWellFormed && m_stack.isEmpty()) {
+				_setError(_g_xml_error_msg_document_not_wellformed, start);
+				return sl_false;
+			}
+			StringBuffer _sb;
+			StringBuffer* sb = m_param.flagCreateTextNodes ? &_sb : sl_null;
+			_prepareParser(start, end);
+			sl_size len = end - start;
+			sl_size startText = 0;
+			const sl_char8* p = buf + start;
+			while (m_parser.pos < len) {
+				const sl_uint8* q = Base::findMemory(p + m_parser.pos, '&', len - m_parser.pos);
+				if (!q) {
+					break;
+				}
+				m_parser.pos = (const sl_char8*)q - p;
+				if (sb && m_parser.pos > startText) {
+					if (!(sb->addStatic(p + startText, m_parser.pos - startText))) {
+						_setError(_g_xml_error_msg_memory_lack, start + m_parser.pos);
+						return sl_false;
+					}
+				}
+				m_parser.pos++;
+				m_parser.unescapeEntity(sb);
+				if (m_parser.flagError) {
+					_setParserError(start);
+					return sl_false;
+				}
+				startText = m_parser.pos;
+			}
+			if (!sb) {
+				return sl_true;
+			}
+			String text;
+			if (startText) {
+				if (len > startText) {
+					if (!(sb->addStatic(p + startText, len - startText))) {
+						_setError(_g_xml_error_msg_memory_lack, start);
+						return sl_false;
+					}
+				}
+				text = sb->merge();
+			} else {
+				text = String(p, len);
+			}
+			if (text.isNull()) {
+				_setError(_g_xml_error_msg_memory_lack, start);
+				return sl_false;
+			}
+			STREAM_CALL_LISTENER(onText, start, sl_null, text)
+			return sl_true;
+		}
+
+		sl_bool _processComment(sl_size start, sl_size end)
+		{
+			for (sl_size i = start; i + 1 < end; i++) {
+				if (m_buf[i] == '-' && m_buf[i + 1] == '-') {
+					_setError(_g_xml_error_msg_comment_double_hyphen, i);
+					return sl_false;
+				}
+			}
+			if (m_param.flagCreateCommentNodes) {
+				String str(m_buf + start, end - start);
+				if (str.isNull()) {
+					_setError(_g_xml_error_msg_memory_lack, start);
+					return sl_false;
+				}
+				STREAM_CALL_LISTENER(onComment, start, sl_null, str)
+			}
+			return sl_true;
+		}
+
+		sl_bool _processCDATA(sl_size start, sl_size end)
+		{
+			if (m_param.flagCheckWellFormed && m_stack.isEmpty()) {
+				_setError(_g_xml_error_msg_document_not_wellformed, start);
+				return sl_false;
+			}
+			if (m_param.flagCreateTextNodes) {
+				String str(m_buf + start, end - start);
+				if (str.isNull()) {
+					_setError(_g_xml_error_msg_memory_lack, start);
+					return sl_false;
+				}
+				STREAM_CALL_LISTENER(onCDATA, start, sl_null, str)
+			}
+			return sl_true;
+		}
+
+		sl_bool _processPI(sl_size start, sl_size end)
+		{
+			_prepareParser(start, end);
+			String target;
+			m_parser.parseName(target);
+			if (m_parser.flagError) {
+				_setParserError(start);
+				return sl_false;
+			}
+			if (m_parser.pos < m_parser.len) {
+				if (SLIB_CHAR_IS_WHITE_SPACE(m_parser.buf[m_parser.pos])) {
+					m_parser.escapeWhiteSpaces();
+				} else {
+					_setError(_g_xml_error_msg_name_invalid_char, start + m_parser.pos);
+					return sl_false;
+				}
+			}
+			if (m_param.flagCreateProcessingInstructionNodes) {
+				String str(m_parser.buf + m_parser.pos, m_parser.len - m_parser.pos);
+				if (str.isNull()) {
+					_setError(_g_xml_error_msg_memory_lack, start);
+					return sl_false;
+				}
+				STREAM_CALL_LISTENER(onProcessingInstruction, start, sl_null, target, str)
+			}
+			return sl_true;
+		}
+
+		sl_bool _processStartTag(sl_size start, sl_size end)
+		{
+			sl_bool flagEmptyTag = sl_false;
+			if (end > start && m_buf[end - 1] == '/') {
+				flagEmptyTag = sl_true;
+				end--;
+			}
+			if (m_param.flagCheckWellFormed && m_stack.isEmpty() && m_flagFoundRoot) {
+				_setError(_g_xml_error_msg_document_not_wellformed, start);
+				return sl_false;
+			}
+
+			ElementFrame frame;
+			sl_size nStack = m_stack.getCount();
+			ElementFrame* parent = nStack ? m_stack.getPointerAt(nStack - 1) : sl_null;
+			if (parent) {
+				frame.defNamespace = parent->defNamespace;
+				frame.namespaces = parent->namespaces;
+			}
+			HashMap<String, String> namespacesParent = frame.namespaces;
+
+			_prepareParser(start, end);
+			m_parser.parseName(frame.name);
+			if (m_parser.flagError) {
+				_setParserError(start);
+				return sl_false;
+			}
+
+			Ref<XmlElement> element = new XmlElement;
+			if (element.isNull()) {
+				_setError(_g_xml_error_msg_memory_lack, start);
+				return sl_false;
+			}
+
+			sl_size indexAttr = 0;
+			while (m_parser.pos < m_parser.len) {
+				sl_size startWhiteSpace = m_parser.pos;
+				if (!(SLIB_CHAR_IS_WHITE_SPACE(m_parser.buf[m_parser.pos]))) {
+					_setError(indexAttr ? _g_xml_error_msg_element_attr_end_with_invalid_char : _g_xml_error_msg_name_invalid_char, start + m_parser.pos);
+					return sl_false;
+				}
+				m_parser.escapeWhiteSpaces();
+				sl_size endWhiteSpace = m_parser.pos;
+				if (m_parser.pos >= m_parser.len) {
+					break;
+				}
+				XmlAttribute attr;
+				m_parser.parseAttribute(attr.name, attr.value);
+				if (m_parser.flagError) {
+					_setParserError(start);
+					return sl_false;
+				}
+				if (element->containsAttribute(attr.name)) {
+					_setError(_g_xml_error_msg_element_attr_duplicate, start + m_parser.pos);
+					return sl_false;
+				}
+				String prefix;
+				m_parser.processPrefix(attr.name, frame.defNamespace, frame.namespaces, prefix, attr.uri, attr.localName);
+				if (m_param.flagCreateWhiteSpaces) {
+					attr.whiteSpacesBeforeName = String(m_parser.buf + startWhiteSpace, endWhiteSpace - startWhiteSpace);
+				}
+				if (!(element->setAttribute(attr))) {
+					_setError(_g_xml_error_msg_memory_lack, start);
+					return sl_false;
+				}
+				if (m_param.flagProcessNamespaces) {
+					if (attr.name == "xmlns") {
+						frame.defNamespace = attr.value;
+						if (!(frame.prefixMappings.add_NoLock(String::null()))) {
+							_setError(_g_xml_error_msg_memory_lack, start);
+							return sl_false;
+						}
+						STREAM_CALL_LISTENER(onStartPrefixMapping, start, element.get(), String::null(), frame.defNamespace)
+					} else if (prefix == "xmlns" && attr.localName.isNotEmpty() && attr.value.isNotEmpty()) {
+						if (frame.namespaces == namespacesParent) {
+							frame.namespaces = namespacesParent.duplicate();
+						}
+						if (!(frame.namespaces.put(attr.localName, attr.value))) {
+							_setError(_g_xml_error_msg_memory_lack, start);
+							return sl_false;
+						}
+						if (!(frame.prefixMappings.add_NoLock(attr.localName))) {
+							_setError(_g_xml_error_msg_memory_lack, start);
+							return sl_false;
+						}
+						STREAM_CALL_LISTENER(onStartPrefixMapping, start, element.get(), attr.localName, attr.value)
+					}
+				}
+				indexAttr++;
+			}
+
+			sl_size line = m_line;
+			sl_size column = m_column;
+			sl_bool flagLastCR = m_flagLastCR;
+			_countLines(m_buf, m_pos, start, line, column, flagLastCR);
+			element->setStartPositionInSource((sl_size)(m_offsetBuf + start));
+			element->setEndPositionInSource((sl_size)(m_offsetBuf + end + (flagEmptyTag ? 2 : 1)));
+			element->setLineNumberInSource(line);
+			element->setColumnNumberInSource(column);
+
+			String prefix, uri, localName;
+			m_parser.processPrefix(frame.name, frame.defNamespace, frame.namespaces, prefix, uri, localName);
+			if (!(element->setName(frame.name, uri, localName))) {
+				_setError(_g_xml_error_msg_unknown, start);
+				return sl_false;
+			}
+			if (m_stack.isEmpty()) {
+				m_flagFoundRoot = sl_true;
+			}
+			STREAM_CALL_LISTENER(onStartElement, start, element.get(), element.get())
+			if (flagEmptyTag) {
+				return _endElement(frame, element.get(), start);
+			}
+			frame.element = Move(element);
+			if (!(m_stack.add_NoLock(Move(frame)))) {
+				_setError(_g_xml_error_msg_memory_lack, start);
+				return sl_false;
+			}
+			return sl_true;
+		}
+
+		sl_bool _processEndTag(sl_size start, sl_size end)
+		{
+			sl_size nStack = m_stack.getCount();
+			ElementFrame* frame = nStack ? m_stack.getPointerAt(nStack - 1) : sl_null;
+			if (!frame) {
+				_setError(_g_xml_error_msg_element_tag_not_matching_end_tag, start);
+				return sl_false;
+			}
+			sl_size lenName = frame->name.getLength();
+			if (end - start < lenName || !(Base::equalsMemory(m_buf + start, frame->name.getData(), lenName))) {
+				_setError(_g_xml_error_msg_element_tag_not_matching_end_tag, start);
+				return sl_false;
+			}
+			for (sl_size i = start + lenName; i < end; i++) {
+				if (!(SLIB_CHAR_IS_WHITE_SPACE(m_buf[i]))) {
+					_setError(i == start + lenName ? _g_xml_error_msg_element_tag_not_matching_end_tag : _g_xml_error_msg_element_tag_not_end, i);
+					return sl_false;
+				}
+			}
+			ElementFrame f;
+			m_stack.popBack_NoLock(&f);
+			f.element->setEndPositionInSource((sl_size)(m_offsetBuf + end + 1));
+			return _endElement(f, f.element.get(), start);
+		}
+
+		sl_bool _endElement(ElementFrame& frame, XmlElement* element, sl_size pos)
+		{
+			STREAM_CALL_LISTENER(onEndElement, pos, element, element)
+			if (m_param.flagProcessNamespaces) {
+				ListLocker<String> prefixes(frame.prefixMappings);
+				for (sl_size i = 0; i < prefixes.count; i++) {
+					STREAM_CALL_LISTENER(onEndPrefixMapping, pos, element, prefixes[i])
+				}
+			}
+			return sl_true;
+		}
+
+	};
+
+	Ref<XmlStreamParser> XmlStreamParser::create(const XmlParseParam& param)
+	{
+		Ref<_priv_XmlStreamParser> ret = new _priv_XmlStreamParser;
+		if (ret.isNotNull()) {
+			ret->m_param = param;
+			ret->m_param.flagError = sl_false;
+			ret->m_param.errorPosition = 0;
+			ret->m_param.errorLine = 0;
+			ret->m_param.errorColumn = 0;
+			ret->m_param.errorMessage.setNull();
+			ret->m_listener = param.listener;
+			ret->m_parser.param = param;
+			ret->m_control.characterSize = 1;
+			return ret;
+		}
+		return sl_null;
+	}
+
+
 	
 	String Xml::encodeTextToEntities(const String& text)
 	{
@@ -19,6 +19,7 @@
 #include "slib/core/scoped.h"
 #include "slib/core/log.h"
 #include "slib/core/safe_static.h"
+#include "slib/core/flat_hash_map.h"
 
 #define TAG "MySQL"
 
@@ -192,7 +193,7 @@ namespace slib
 			CList<String> m_listColumnNames;
 			sl_uint32 m_nColumnNames;
 			String* m_columnNames;
-			CHashMap<String, sl_int32> m_mapColumnIndexes;
+			FlatHashMap<String, sl_int32> m_mapColumnIndexes;
 
 			_DatabaseCursor(MySQL_Database* db, MYSQL_RES* result)
 			{
@@ -203,7 +204,7 @@ namespace slib
 				m_fields = ::mysql_fetch_fields(result);
 				for (sl_uint32 i = 0; i < cols; i++) {
 					m_listColumnNames.add_NoLock(m_fields[i].name);
-					m_mapColumnIndexes.put_NoLock(m_fields[i].name, i);
+					m_mapColumnIndexes.put(m_fields[i].name, i);
 				}
 				m_nColumnNames = (sl_uint32)(m_listColumnNames.getCount());
 				m_columnNames = m_listColumnNames.getData();
@@ -235,7 +236,7 @@ namespace slib
 
 			sl_int32 getColumnIndex(const String& name) override
 			{
-				return m_mapColumnIndexes.getValue_NoLock(name, -1);
+				return m_mapColumnIndexes.getValue(name, -1);
 			}
 
 			HashMap<String, Variant> getRow() override
@@ -381,7 +382,7 @@ namespace slib
 			CList<String> m_listColumnNames;
 			sl_uint32 m_nColumnNames;
 			String* m_columnNames;
-			CHashMap<String, sl_int32> m_mapColumnIndexes;
+			FlatHashMap<String, sl_int32> m_mapColumnIndexes;
 
 			_DatabaseStatementCursor(Database* db, DatabaseStatement* statementObj, MYSQL_STMT* statement, MYSQL_RES* resultMetadata, MYSQL_BIND* bind, _FieldDesc* fds)
 			{
@@ -397,7 +398,7 @@ namespace slib
 
 				for (sl_uint32 i = 0; i < cols; i++) {
 					m_listColumnNames.add_NoLock(m_fields[i].name);
-					m_mapColumnIndexes.put_NoLock(m_fields[i].name, i);
+					m_mapColumnIndexes.put(m_fields[i].name, i);
 				}
 				m_nColumnNames = (sl_uint32)(m_listColumnNames.getCount());
 				m_columnNames = m_listColumnNames.getData();
@@ -429,7 +430,7 @@ namespace slib
 
 			sl_int32 getColumnIndex(const String& name) override
 			{
-				return m_mapColumnIndexes.getValue_NoLock(name, -1);
+				return m_mapColumnIndexes.getValue(name, -1);
 			}
 
 			HashMap<String, Variant> getRow() override
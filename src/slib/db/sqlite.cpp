@@ -13,6 +13,7 @@
 #include "slib/db/sqlite.h"
 
 #include "slib/core/file.h"
+#include "slib/core/flat_hash_map.h"
 
 namespace slib
 {	
@@ -91,7 +92,7 @@ namespace slib
 			CList<String> m_listColumnNames;
 			sl_uint32 m_nColumnNames;
 			String* m_columnNames;
-			CHashMap<String, sl_int32> m_mapColumnIndexes;
+			FlatHashMap<String, sl_int32> m_mapColumnIndexes;
 
 			_DatabaseCursor(Database* db, DatabaseStatement* statementObj, sqlite3_stmt* statement)
 			{
@@ -104,7 +105,7 @@ namespace slib
 					const char* buf = ::sqlite3_column_name(statement, (int)i);
 					String name(buf);
 					m_listColumnNames.add_NoLock(name);
-					m_mapColumnIndexes.put_NoLock(name, i);
+					m_mapColumnIndexes.put(name, i);
 				}
 				m_nColumnNames = (sl_uint32)(m_listColumnNames.getCount());
 				m_columnNames = m_listColumnNames.getData();
@@ -134,7 +135,7 @@ namespace slib
 
 			sl_int32 getColumnIndex(const String& name) override
 			{
-				return m_mapColumnIndexes.getValue_NoLock(name, -1);
+				return m_mapColumnIndexes.getValue(name, -1);
 			}
 
 			HashMap<String, Variant> getRow() override
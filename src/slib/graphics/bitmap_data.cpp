@@ -12,6 +12,8 @@
 
 #include "slib/graphics/yuv.h"
 
+#include "slib/core/base.h"
+
 namespace slib
 {
 
@@ -1260,8 +1262,70 @@ namespace slib
 		}
 	}
 
+	sl_bool _BitmapData_getRGBAOrder(BitmapFormat format, sl_bool& flagBGRA, sl_bool& flagPA)
+	{
+		switch (format) {
+			case BitmapFormat::RGBA:
+				flagBGRA = sl_false;
+				flagPA = sl_false;
+				return sl_true;
+			case BitmapFormat::RGBA_PA:
+				flagBGRA = sl_false;
+				flagPA = sl_true;
+				return sl_true;
+			case BitmapFormat::BGRA:
+				flagBGRA = sl_true;
+				flagPA = sl_false;
+				return sl_true;
+			case BitmapFormat::BGRA_PA:
+				flagBGRA = sl_true;
+				flagPA = sl_true;
+				return sl_true;
+			default:
+				break;
+		}
+		return sl_false;
+	}
+
+	// converts between RGBA, BGRA and their premultiplied formats by the row functions of Color
+	sl_bool _BitmapData_copyPixels_RGBA(sl_uint32 width, sl_uint32 height, BitmapFormat src_format, sl_uint8** src_planes, sl_int32* src_pitches, BitmapFormat dst_format, sl_uint8** dst_planes, sl_int32* dst_pitches)
+	{
+		sl_bool flagSrcBGRA, flagSrcPA, flagDstBGRA, flagDstPA;
+		if (!(_BitmapData_getRGBAOrder(src_format, flagSrcBGRA, flagSrcPA))) {
+			return sl_false;
+		}
+		if (!(_BitmapData_getRGBAOrder(dst_format, flagDstBGRA, flagDstPA))) {
+			return sl_false;
+		}
+		sl_uint8* sr = src_planes[0];
+		sl_uint8* dr = dst_planes[0];
+		for (sl_uint32 i = 0; i < height; i++) {
+			const Color* ss = (const Color*)sr;
+			Color* ds = (Color*)dr;
+			if (flagSrcPA != flagDstPA) {
+				if (flagDstPA) {
+					Color::convertNPAtoPA(ds, ss, width);
+				} else {
+					Color::convertPAtoNPA(ds, ss, width);
+				}
+				ss = ds;
+			}
+			if (flagSrcBGRA != flagDstBGRA) {
+				Color::swapRedBlue(ds, ss, width);
+			} else if (ss != ds) {
+				Base::copyMemory(ds, ss, width << 2);
+			}
+			sr += src_pitches[0];
+			dr += dst_pitches[0];
+		}
+		return sl_true;
+	}
+
 	void _BitmapData_copyPixels_Normal(sl_uint32 width, sl_uint32 height, BitmapFormat src_format, sl_uint8** src_planes, sl_int32* src_pitches, BitmapFormat dst_format, sl_uint8** dst_planes, sl_int32* dst_pitches)
 	{
+		if (_BitmapData_copyPixels_RGBA(width, height, src_format, src_planes, src_pitches, dst_format, dst_planes, dst_pitches)) {
+			return;
+		}
 		switch (src_format) {
 			case BitmapFormat::RGBA:
 				_BitmapData_copyPixels_Normal_Step1<RGBA_PROC>(width, height, src_planes, src_pitches, dst_format, dst_planes, dst_pitches);
@@ -1475,8 +1539,42 @@ namespace slib
 		}
 	}
 
+	sl_bool _BitmapData_copyPixels_YUV420ToRGBA(sl_uint32 width, sl_uint32 height, BitmapData& src, BitmapFormat dst_format, sl_uint8** dst_planes, sl_int32* dst_pitches)
+	{
+		// the colors are opaque, so the premultiplied formats have the same values
+		sl_bool flagBGRA, flagPA;
+		if (!(_BitmapData_getRGBAOrder(dst_format, flagBGRA, flagPA))) {
+			return sl_false;
+		}
+		ColorComponentBuffer src_cb[3];
+		if (src.getColorComponentBuffers(src_cb) != 3) {
+			return sl_false;
+		}
+		sl_int32 strideUV = src_cb[1].sample_stride;
+		if (src_cb[0].sample_stride != 1 || src_cb[2].sample_stride != strideUV) {
+			return sl_false;
+		}
+		sl_uint8* sry = (sl_uint8*)(src_cb[0].data);
+		sl_uint8* sru = (sl_uint8*)(src_cb[1].data);
+		sl_uint8* srv = (sl_uint8*)(src_cb[2].data);
+		sl_uint8* dr = dst_planes[0];
+		for (sl_uint32 i = 0; i < height; i++) {
+			YUV::convertYUV420ToRGBA(sry, sru, srv, strideUV, dr, width, flagBGRA);
+			sry += src_cb[0].pitch;
+			if (i & 1) {
+				sru += src_cb[1].pitch;
+				srv += src_cb[2].pitch;
+			}
+			dr += dst_pitches[0];
+		}
+		return sl_true;
+	}
+
 	void _BitmapData_copyPixels_YUV420ToOther(sl_uint32 width, sl_uint32 height, BitmapData& src, BitmapFormat dst_format, sl_uint8** dst_planes, sl_int32* dst_pitches)
 	{
+		if (_BitmapData_copyPixels_YUV420ToRGBA(width, height, src, dst_format, dst_planes, dst_pitches)) {
+			return;
+		}
 		switch (dst_format) {
 			case BitmapFormat::RGBA:
 				_BitmapData_copyPixels_YUV420ToOther_Step1<RGBA_PROC>(width, height, src, dst_planes, dst_pitches);
@@ -1697,8 +1795,40 @@ namespace slib
 		}
 	}
 
+	sl_bool _BitmapData_copyPixels_RGBAToYUV420(sl_uint32 width, sl_uint32 height, BitmapFormat src_format, sl_uint8** src_planes, sl_int32* src_pitches, BitmapData& dst)
+	{
+		sl_bool flagBGRA, flagPA;
+		if (!(_BitmapData_getRGBAOrder(src_format, flagBGRA, flagPA)) || flagPA) {
+			return sl_false;
+		}
+		ColorComponentBuffer dst_cb[3];
+		if (dst.getColorComponentBuffers(dst_cb) != 3) {
+			return sl_false;
+		}
+		sl_int32 strideUV = dst_cb[1].sample_stride;
+		if (dst_cb[0].sample_stride != 1 || dst_cb[2].sample_stride != strideUV) {
+			return sl_false;
+		}
+		sl_uint32 H2 = height >> 1;
+		sl_uint8* sr = src_planes[0];
+		sl_uint8* dry = (sl_uint8*)(dst_cb[0].data);
+		sl_uint8* dru = (sl_uint8*)(dst_cb[1].data);
+		sl_uint8* drv = (sl_uint8*)(dst_cb[2].data);
+		for (sl_uint32 i = 0; i < H2; i++) {
+			YUV::convertRGBAToYUV420(sr, sr + src_pitches[0], dry, dry + dst_cb[0].pitch, dru, drv, strideUV, width, flagBGRA);
+			sr += src_pitches[0] + src_pitches[0];
+			dry += dst_cb[0].pitch + dst_cb[0].pitch;
+			dru += dst_cb[1].pitch;
+			drv += dst_cb[2].pitch;
+		}
+		return sl_true;
+	}
+
 	void _BitmapData_copyPixels_OtherToYUV420(sl_uint32 width, sl_uint32 height, BitmapFormat src_format, sl_uint8** src_planes, sl_int32* src_pitches, BitmapData& dst)
 	{
+		if (_BitmapData_copyPixels_RGBAToYUV420(width, height, src_format, src_planes, src_pitches, dst)) {
+			return;
+		}
 		switch (src_format) {
 			case BitmapFormat::RGBA:
 				_BitmapData_copyPixels_OtherToYUV420_Step1<RGBA_PROC>(width, height, src_planes, src_pitches, dst);
@@ -1843,12 +1973,16 @@ namespace slib
 					sl_uint8* sr = (sl_uint8*)(src_cb[iPlane].data);
 					sl_uint8* dr = (sl_uint8*)(dst_cb[iPlane].data);
 					for (sl_uint32 i = 0; i < h; i++) {
-						sl_uint8* ss = sr;
-						sl_uint8* ds = dr;
-						for (sl_uint32 j = 0; j < w; j++) {
-							*ds = *ss;
-							ss+=src_stride;
-							ds+=dst_stride;
+						if (src_stride == 1 && dst_stride == 1) {
+							Base::copyMemory(dr, sr, w);
+						} else {
+							sl_uint8* ss = sr;
+							sl_uint8* ds = dr;
+							for (sl_uint32 j = 0; j < w; j++) {
+								*ds = *ss;
+								ss+=src_stride;
+								ds+=dst_stride;
+							}
 						}
 						sr += src_cb[iPlane].pitch;
 						dr += dst_cb[iPlane].pitch;
@@ -1890,13 +2024,7 @@ namespace slib
 						sl_uint8* sr = (sl_uint8*)(src_planes[iPlane]);
 						sl_uint8* dr = (sl_uint8*)(dst_planes[iPlane]);
 						for (sl_uint32 i = 0; i < height; i++) {
-							sl_uint8* ss = sr;
-							sl_uint8* ds = dr;
-							for (sl_uint32 j = 0; j < row_size; j++) {
-								*ds = *ss;
-								ss++;
-								ds++;
-							}
+							Base::copyMemory(dr, sr, row_size);
 							sr += src_pitches[iPlane];
 							dr += dst_pitches[iPlane];
 						}
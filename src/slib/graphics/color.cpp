@@ -13,6 +13,15 @@
 #include "slib/core/math.h"
 #include "slib/core/variant.h"
 #include "slib/core/safe_static.h"
+#include "slib/core/cpu.h"
+
+#if defined(SLIB_ARCH_IS_X64) || (defined(SLIB_ARCH_IS_X86) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#	define _PRIV_COLOR_USE_SSE2
+#	include <immintrin.h>
+#elif defined(SLIB_ARCH_IS_ARM64) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+#	define _PRIV_COLOR_USE_NEON
+#	include <arm_neon.h>
+#endif
 
 namespace slib
 {
@@ -163,6 +172,460 @@ namespace slib
 		b = (sl_uint8)(_ob);
 	}
 
+	typedef void (*_priv_Color_RowFunc)(Color* dst, const Color* src, sl_size count);
+
+	struct _priv_Color_RowFunctions
+	{
+		_priv_Color_RowFunc convertNPAtoPA;
+		_priv_Color_RowFunc convertPAtoNPA;
+		_priv_Color_RowFunc swapRedBlue;
+		_priv_Color_RowFunc blend_PA_NPA;
+		_priv_Color_RowFunc blend_PA_PA;
+	};
+
+	static void _priv_Color_convertNPAtoPA_scalar(Color* dst, const Color* src, sl_size count)
+	{
+		for (sl_size i = 0; i < count; i++) {
+			Color c = src[i];
+			c.convertNPAtoPA();
+			dst[i] = c;
+		}
+	}
+
+	static void _priv_Color_convertPAtoNPA_scalar(Color* dst, const Color* src, sl_size count)
+	{
+		for (sl_size i = 0; i < count; i++) {
+			Color c = src[i];
+			c.convertPAtoNPA();
+			dst[i] = c;
+		}
+	}
+
+	static void _priv_Color_swapRedBlue_scalar(Color* dst, const Color* src, sl_size count)
+	{
+		for (sl_size i = 0; i < count; i++) {
+			Color c = src[i];
+			sl_uint8 t = c.r;
+			c.r = c.b;
+			c.b = t;
+			dst[i] = c;
+		}
+	}
+
+	static void _priv_Color_blend_PA_NPA_scalar(Color* dst, const Color* src, sl_size count)
+	{
+		for (sl_size i = 0; i < count; i++) {
+			const Color& c = src[i];
+			dst[i].blend_PA_NPA(c.r, c.g, c.b, c.a);
+		}
+	}
+
+	static void _priv_Color_blend_PA_PA_scalar(Color* dst, const Color* src, sl_size count)
+	{
+		for (sl_size i = 0; i < count; i++) {
+			const Color& c = src[i];
+			dst[i].blend_PA_PA(c.r, c.g, c.b, c.a);
+		}
+	}
+
+/*
+	The SIMD kernels keep the integer formulas of the scalar functions.
+
+	- x / 255 is computed as (x + 1 + (x >> 8)) >> 8, which is exact for x <= 255 * 255.
+	- The blending of premultiplied alpha is o * (255 - a) / 255 + s on all the channels,
+	  because (oa * (255 - a) + 255 * a) / 255 is same as oa * (255 - a) / 255 + a.
+	- (c << 8) / (a + 1) is computed in single precision, which never rounds to the next integer
+	  because the quotients are smaller than 2^15 and they are at least 1 / 256 away from the next integer.
+*/
+
+#if defined(_PRIV_COLOR_USE_SSE2)
+	SLIB_INLINE static __m128i _priv_Color_div255_sse2(__m128i x)
+	{
+		return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+	}
+
+	// broadcasts the alpha of the pixels in 16-bit lanes
+	SLIB_INLINE static __m128i _priv_Color_alpha16_sse2(__m128i x)
+	{
+		return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	}
+
+	static void _priv_Color_convertNPAtoPA_sse2(Color* dst, const Color* src, sl_size count)
+	{
+		__m128i zero = _mm_setzero_si128();
+		__m128i one = _mm_set1_epi16(1);
+		__m128i maskAlpha = _mm_set1_epi32((int)0xFF000000);
+		sl_size i = 0;
+		for (; i + 4 <= count; i += 4) {
+			__m128i p = _mm_loadu_si128((const __m128i*)(src + i));
+			__m128i lo = _mm_unpacklo_epi8(p, zero);
+			__m128i hi = _mm_unpackhi_epi8(p, zero);
+			lo = _mm_srli_epi16(_mm_mullo_epi16(lo, _mm_add_epi16(_priv_Color_alpha16_sse2(lo), one)), 8);
+			hi = _mm_srli_epi16(_mm_mullo_epi16(hi, _mm_add_epi16(_priv_Color_alpha16_sse2(hi), one)), 8);
+			__m128i r = _mm_packus_epi16(lo, hi);
+			r = _mm_or_si128(_mm_andnot_si128(maskAlpha, r), _mm_and_si128(maskAlpha, p));
+			_mm_storeu_si128((__m128i*)(dst + i), r);
+		}
+		_priv_Color_convertNPAtoPA_scalar(dst + i, src + i, count - i);
+	}
+
+	// divides a pixel in 32-bit lanes
+	SLIB_INLINE static __m128i _priv_Color_unpremultiply_sse2(__m128i x)
+	{
+		__m128 c = _mm_mul_ps(_mm_cvtepi32_ps(x), _mm_set1_ps(256.0f));
+		__m128 a = _mm_cvtepi32_ps(_mm_add_epi32(_mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3)), _mm_set1_epi32(1)));
+		return _mm_cvttps_epi32(_mm_div_ps(c, a));
+	}
+
+	static void _priv_Color_convertPAtoNPA_sse2(Color* dst, const Color* src, sl_size count)
+	{
+		__m128i zero = _mm_setzero_si128();
+		__m128i maskAlpha = _mm_set1_epi32((int)0xFF000000);
+		sl_size i = 0;
+		for (; i + 4 <= count; i += 4) {
+			__m128i p = _mm_loadu_si128((const __m128i*)(src + i));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(p, maskAlpha), maskAlpha)) != 0xFFFF) {
+				__m128i lo = _mm_unpacklo_epi8(p, zero);
+				__m128i hi = _mm_unpackhi_epi8(p, zero);
+				__m128i q0 = _priv_Color_unpremultiply_sse2(_mm_unpacklo_epi16(lo, zero));
+				__m128i q1 = _priv_Color_unpremultiply_sse2(_mm_unpackhi_epi16(lo, zero));
+				__m128i q2 = _priv_Color_unpremultiply_sse2(_mm_unpacklo_epi16(hi, zero));
+				__m128i q3 = _priv_Color_unpremultiply_sse2(_mm_unpackhi_epi16(hi, zero));
+				__m128i r = _mm_packus_epi16(_mm_packs_epi32(q0, q1), _mm_packs_epi32(q2, q3));
+				p = _mm_or_si128(_mm_andnot_si128(maskAlpha, r), _mm_and_si128(maskAlpha, p));
+			}
+			_mm_storeu_si128((__m128i*)(dst + i), p);
+		}
+		_priv_Color_convertPAtoNPA_scalar(dst + i, src + i, count - i);
+	}
+
+	static void _priv_Color_swapRedBlue_sse2(Color* dst, const Color* src, sl_size count)
+	{
+		__m128i maskAG = _mm_set1_epi32((int)0xFF00FF00);
+		sl_size i = 0;
+		for (; i + 4 <= count; i += 4) {
+			__m128i p = _mm_loadu_si128((const __m128i*)(src + i));
+			__m128i rb = _mm_andnot_si128(maskAG, p);
+			rb = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+			_mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(_mm_and_si128(p, maskAG), rb));
+		}
+		_priv_Color_swapRedBlue_scalar(dst + i, src + i, count - i);
+	}
+
+	static void _priv_Color_blend_PA_NPA_sse2(Color* dst, const Color* src, sl_size count)
+	{
+		__m128i zero = _mm_setzero_si128();
+		__m128i c255 = _mm_set1_epi16(255);
+		__m128i maskAlpha = _mm_set1_epi32((int)0xFF000000);
+		sl_size i = 0;
+		for (; i + 4 <= count; i += 4) {
+			__m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+			__m128i alpha = _mm_and_si128(s, maskAlpha);
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, zero)) == 0xFFFF) {
+				continue;
+			}
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, maskAlpha)) == 0xFFFF) {
+				_mm_storeu_si128((__m128i*)(dst + i), s);
+				continue;
+			}
+			__m128i o = _mm_loadu_si128((const __m128i*)(dst + i));
+			__m128i slo = _mm_unpacklo_epi8(s, zero);
+			__m128i shi = _mm_unpackhi_epi8(s, zero);
+			__m128i alo = _priv_Color_alpha16_sse2(slo);
+			__m128i ahi = _priv_Color_alpha16_sse2(shi);
+			// the source alpha is blended as 255
+			__m128i s1 = _mm_or_si128(s, maskAlpha);
+			slo = _mm_unpacklo_epi8(s1, zero);
+			shi = _mm_unpackhi_epi8(s1, zero);
+			__m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(o, zero), _mm_sub_epi16(c255, alo)), _mm_mullo_epi16(slo, alo));
+			__m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(o, zero), _mm_sub_epi16(c255, ahi)), _mm_mullo_epi16(shi, ahi));
+			_mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(_priv_Color_div255_sse2(lo), _priv_Color_div255_sse2(hi)));
+		}
+		_priv_Color_blend_PA_NPA_scalar(dst + i, src + i, count - i);
+	}
+
+	static void _priv_Color_blend_PA_PA_sse2(Color* dst, const Color* src, sl_size count)
+	{
+		__m128i zero = _mm_setzero_si128();
+		__m128i c255 = _mm_set1_epi16(255);
+		sl_size i = 0;
+		for (; i + 4 <= count; i += 4) {
+			__m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+			__m128i o = _mm_loadu_si128((const __m128i*)(dst + i));
+			__m128i alo = _mm_sub_epi16(c255, _priv_Color_alpha16_sse2(_mm_unpacklo_epi8(s, zero)));
+			__m128i ahi = _mm_sub_epi16(c255, _priv_Color_alpha16_sse2(_mm_unpackhi_epi8(s, zero)));
+			__m128i lo = _priv_Color_div255_sse2(_mm_mullo_epi16(_mm_unpacklo_epi8(o, zero), alo));
+			__m128i hi = _priv_Color_div255_sse2(_mm_mullo_epi16(_mm_unpackhi_epi8(o, zero), ahi));
+			_mm_storeu_si128((__m128i*)(dst + i), _mm_adds_epu8(_mm_packus_epi16(lo, hi), s));
+		}
+		_priv_Color_blend_PA_PA_scalar(dst + i, src + i, count - i);
+	}
+
+	static const _priv_Color_RowFunctions _g_color_row_functions_sse2 = {
+		_priv_Color_convertNPAtoPA_sse2,
+		_priv_Color_convertPAtoNPA_sse2,
+		_priv_Color_swapRedBlue_sse2,
+		_priv_Color_blend_PA_NPA_sse2,
+		_priv_Color_blend_PA_PA_sse2
+	};
+
+	SLIB_TARGET_AVX2 SLIB_INLINE static __m256i _priv_Color_div255_avx2(__m256i x)
+	{
+		return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(x, _mm256_set1_epi16(1)), _mm256_srli_epi16(x, 8)), 8);
+	}
+
+	SLIB_TARGET_AVX2 SLIB_INLINE static __m256i _priv_Color_alpha16_avx2(__m256i x)
+	{
+		return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(x, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	}
+
+	SLIB_TARGET_AVX2 static void _priv_Color_convertNPAtoPA_avx2(Color* dst, const Color* src, sl_size count)
+	{
+		__m256i zero = _mm256_setzero_si256();
+		__m256i one = _mm256_set1_epi16(1);
+		__m256i maskAlpha = _mm256_set1_epi32((int)0xFF000000);
+		sl_size i = 0;
+		for (; i + 8 <= count; i += 8) {
+			__m256i p = _mm256_loadu_si256((const __m256i*)(src + i));
+			__m256i lo = _mm256_unpacklo_epi8(p, zero);
+			__m256i hi = _mm256_unpackhi_epi8(p, zero);
+			lo = _mm256_srli_epi16(_mm256_mullo_epi16(lo, _mm256_add_epi16(_priv_Color_alpha16_avx2(lo), one)), 8);
+			hi = _mm256_srli_epi16(_mm256_mullo_epi16(hi, _mm256_add_epi16(_priv_Color_alpha16_avx2(hi), one)), 8);
+			__m256i r = _mm256_packus_epi16(lo, hi);
+			r = _mm256_blendv_epi8(r, p, maskAlpha);
+			_mm256_storeu_si256((__m256i*)(dst + i), r);
+		}
+		_priv_Color_convertNPAtoPA_sse2(dst + i, src + i, count - i);
+	}
+
+	SLIB_TARGET_AVX2 SLIB_INLINE static __m256i _priv_Color_unpremultiply_avx2(__m256i x)
+	{
+		__m256 c = _mm256_mul_ps(_mm256_cvtepi32_ps(x), _mm256_set1_ps(256.0f));
+		__m256 a = _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3)), _mm256_set1_epi32(1)));
+		return _mm256_cvttps_epi32(_mm256_div_ps(c, a));
+	}
+
+	SLIB_TARGET_AVX2 static void _priv_Color_convertPAtoNPA_avx2(Color* dst, const Color* src, sl_size count)
+	{
+		__m256i zero = _mm256_setzero_si256();
+		__m256i maskAlpha = _mm256_set1_epi32((int)0xFF000000);
+		sl_size i = 0;
+		for (; i + 8 <= count; i += 8) {
+			__m256i p = _mm256_loadu_si256((const __m256i*)(src + i));
+			if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_and_si256(p, maskAlpha), maskAlpha)) != -1) {
+				__m256i lo = _mm256_unpacklo_epi8(p, zero);
+				__m256i hi = _mm256_unpackhi_epi8(p, zero);
+				__m256i q0 = _priv_Color_unpremultiply_avx2(_mm256_unpacklo_epi16(lo, zero));
+				__m256i q1 = _priv_Color_unpremultiply_avx2(_mm256_unpackhi_epi16(lo, zero));
+				__m256i q2 = _priv_Color_unpremultiply_avx2(_mm256_unpacklo_epi16(hi, zero));
+				__m256i q3 = _priv_Color_unpremultiply_avx2(_mm256_unpackhi_epi16(hi, zero));
+				__m256i r = _mm256_packus_epi16(_mm256_packs_epi32(q0, q1), _mm256_packs_epi32(q2, q3));
+				p = _mm256_blendv_epi8(r, p, maskAlpha);
+			}
+			_mm256_storeu_si256((__m256i*)(dst + i), p);
+		}
+		_priv_Color_convertPAtoNPA_sse2(dst + i, src + i, count - i);
+	}
+
+	SLIB_TARGET_AVX2 static void _priv_Color_swapRedBlue_avx2(Color* dst, const Color* src, sl_size count)
+	{
+		__m256i order = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15, 2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+		sl_size i = 0;
+		for (; i + 8 <= count; i += 8) {
+			__m256i p = _mm256_loadu_si256((const __m256i*)(src + i));
+			_mm256_storeu_si256((__m256i*)(dst + i), _mm256_shuffle_epi8(p, order));
+		}
+		_priv_Color_swapRedBlue_sse2(dst + i, src + i, count - i);
+	}
+
+	SLIB_TARGET_AVX2 static void _priv_Color_blend_PA_NPA_avx2(Color* dst, const Color* src, sl_size count)
+	{
+		__m256i zero = _mm256_setzero_si256();
+		__m256i c255 = _mm256_set1_epi16(255);
+		__m256i maskAlpha = _mm256_set1_epi32((int)0xFF000000);
+		sl_size i = 0;
+		for (; i + 8 <= count; i += 8) {
+			__m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+			__m256i alpha = _mm256_and_si256(s, maskAlpha);
+			if (_mm256_testz_si256(alpha, alpha)) {
+				continue;
+			}
+			if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(alpha, maskAlpha)) == -1) {
+				_mm256_storeu_si256((__m256i*)(dst + i), s);
+				continue;
+			}
+			__m256i o = _mm256_loadu_si256((const __m256i*)(dst + i));
+			__m256i alo = _priv_Color_alpha16_avx2(_mm256_unpacklo_epi8(s, zero));
+			__m256i ahi = _priv_Color_alpha16_avx2(_mm256_unpackhi_epi8(s, zero));
+			__m256i s1 = _mm256_or_si256(s, maskAlpha);
+			__m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(o, zero), _mm256_sub_epi16(c255, alo)), _mm256_mullo_epi16(_mm256_unpacklo_epi8(s1, zero), alo));
+			__m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(o, zero), _mm256_sub_epi16(c255, ahi)), _mm256_mullo_epi16(_mm256_unpackhi_epi8(s1, zero), ahi));
+			_mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(_priv_Color_div255_avx2(lo), _priv_Color_div255_avx2(hi)));
+		}
+		_priv_Color_blend_PA_NPA_sse2(dst + i, src + i, count - i);
+	}
+
+	SLIB_TARGET_AVX2 static void _priv_Color_blend_PA_PA_avx2(Color* dst, const Color* src, sl_size count)
+	{
+		__m256i zero = _mm256_setzero_si256();
+		__m256i c255 = _mm256_set1_epi16(255);
+		sl_size i = 0;
+		for (; i + 8 <= count; i += 8) {
+			__m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+			__m256i o = _mm256_loadu_si256((const __m256i*)(dst + i));
+			__m256i alo = _mm256_sub_epi16(c255, _priv_Color_alpha16_avx2(_mm256_unpacklo_epi8(s, zero)));
+			__m256i ahi = _mm256_sub_epi16(c255, _priv_Color_alpha16_avx2(_mm256_unpackhi_epi8(s, zero)));
+			__m256i lo = _priv_Color_div255_avx2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(o, zero), alo));
+			__m256i hi = _priv_Color_div255_avx2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(o, zero), ahi));
+			_mm256_storeu_si256((__m256i*)(dst + i), _mm256_adds_epu8(_mm256_packus_epi16(lo, hi), s));
+		}
+		_priv_Color_blend_PA_PA_sse2(dst + i, src + i, count - i);
+	}
+
+	static const _priv_Color_RowFunctions _g_color_row_functions_avx2 = {
+		_priv_Color_convertNPAtoPA_avx2,
+		_priv_Color_convertPAtoNPA_avx2,
+		_priv_Color_swapRedBlue_avx2,
+		_priv_Color_blend_PA_NPA_avx2,
+		_priv_Color_blend_PA_PA_avx2
+	};
+#endif
+
+#if defined(_PRIV_COLOR_USE_NEON)
+	SLIB_INLINE static uint8x8_t _priv_Color_div255_neon(uint16x8_t x)
+	{
+		return vshrn_n_u16(vaddq_u16(vaddq_u16(x, vdupq_n_u16(1)), vshrq_n_u16(x, 8)), 8);
+	}
+
+	SLIB_INLINE static uint8x16_t _priv_Color_premultiply_neon(uint8x16_t c, uint8x16_t a)
+	{
+		uint16x8_t lo = vmlal_u8(vmovl_u8(vget_low_u8(c)), vget_low_u8(c), vget_low_u8(a));
+		uint16x8_t hi = vmlal_u8(vmovl_u8(vget_high_u8(c)), vget_high_u8(c), vget_high_u8(a));
+		return vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+	}
+
+	static void _priv_Color_convertNPAtoPA_neon(Color* dst, const Color* src, sl_size count)
+	{
+		sl_size i = 0;
+		for (; i + 16 <= count; i += 16) {
+			uint8x16x4_t p = vld4q_u8((const sl_uint8*)(src + i));
+			p.val[0] = _priv_Color_premultiply_neon(p.val[0], p.val[3]);
+			p.val[1] = _priv_Color_premultiply_neon(p.val[1], p.val[3]);
+			p.val[2] = _priv_Color_premultiply_neon(p.val[2], p.val[3]);
+			vst4q_u8((sl_uint8*)(dst + i), p);
+		}
+		_priv_Color_convertNPAtoPA_scalar(dst + i, src + i, count - i);
+	}
+
+	static void _priv_Color_swapRedBlue_neon(Color* dst, const Color* src, sl_size count)
+	{
+		sl_size i = 0;
+		for (; i + 16 <= count; i += 16) {
+			uint8x16x4_t p = vld4q_u8((const sl_uint8*)(src + i));
+			uint8x16_t t = p.val[0];
+			p.val[0] = p.val[2];
+			p.val[2] = t;
+			vst4q_u8((sl_uint8*)(dst + i), p);
+		}
+		_priv_Color_swapRedBlue_scalar(dst + i, src + i, count - i);
+	}
+
+	static void _priv_Color_blend_PA_NPA_neon(Color* dst, const Color* src, sl_size count)
+	{
+		sl_size i = 0;
+		for (; i + 8 <= count; i += 8) {
+			uint8x8x4_t s = vld4_u8((const sl_uint8*)(src + i));
+			uint8x8x4_t o = vld4_u8((const sl_uint8*)(dst + i));
+			uint8x8_t a = s.val[3];
+			uint8x8_t ia = vmvn_u8(a);
+			s.val[3] = vdup_n_u8(255);
+			for (sl_uint32 k = 0; k < 4; k++) {
+				o.val[k] = _priv_Color_div255_neon(vmlal_u8(vmull_u8(o.val[k], ia), s.val[k], a));
+			}
+			vst4_u8((sl_uint8*)(dst + i), o);
+		}
+		_priv_Color_blend_PA_NPA_scalar(dst + i, src + i, count - i);
+	}
+
+	static void _priv_Color_blend_PA_PA_neon(Color* dst, const Color* src, sl_size count)
+	{
+		sl_size i = 0;
+		for (; i + 8 <= count; i += 8) {
+			uint8x8x4_t s = vld4_u8((const sl_uint8*)(src + i));
+			uint8x8x4_t o = vld4_u8((const sl_uint8*)(dst + i));
+			uint8x8_t ia = vmvn_u8(s.val[3]);
+			for (sl_uint32 k = 0; k < 4; k++) {
+				o.val[k] = vqadd_u8(_priv_Color_div255_neon(vmull_u8(o.val[k], ia)), s.val[k]);
+			}
+			vst4_u8((sl_uint8*)(dst + i), o);
+		}
+		_priv_Color_blend_PA_PA_scalar(dst + i, src + i, count - i);
+	}
+
+	static const _priv_Color_RowFunctions _g_color_row_functions_neon = {
+		_priv_Color_convertNPAtoPA_neon,
+		_priv_Color_convertPAtoNPA_scalar,
+		_priv_Color_swapRedBlue_neon,
+		_priv_Color_blend_PA_NPA_neon,
+		_priv_Color_blend_PA_PA_neon
+	};
+#endif
+
+	static const _priv_Color_RowFunctions* _g_color_row_functions = sl_null;
+
+	static const _priv_Color_RowFunctions* _priv_Color_getRowFunctions() noexcept
+	{
+		const _priv_Color_RowFunctions* functions = _g_color_row_functions;
+		if (functions) {
+			return functions;
+		}
+#if defined(_PRIV_COLOR_USE_SSE2)
+		if (Cpu::isSupportingAVX2()) {
+			functions = &_g_color_row_functions_avx2;
+		} else {
+			functions = &_g_color_row_functions_sse2;
+		}
+#elif defined(_PRIV_COLOR_USE_NEON)
+		functions = &_g_color_row_functions_neon;
+#else
+		static const _priv_Color_RowFunctions functionsScalar = {
+			_priv_Color_convertNPAtoPA_scalar,
+			_priv_Color_convertPAtoNPA_scalar,
+			_priv_Color_swapRedBlue_scalar,
+			_priv_Color_blend_PA_NPA_scalar,
+			_priv_Color_blend_PA_PA_scalar
+		};
+		functions = &functionsScalar;
+#endif
+		_g_color_row_functions = functions;
+		return functions;
+	}
+
+	void Color::convertNPAtoPA(Color* dst, const Color* src, sl_size count) noexcept
+	{
+		_priv_Color_getRowFunctions()->convertNPAtoPA(dst, src, count);
+	}
+
+	void Color::convertPAtoNPA(Color* dst, const Color* src, sl_size count) noexcept
+	{
+		_priv_Color_getRowFunctions()->convertPAtoNPA(dst, src, count);
+	}
+
+	void Color::swapRedBlue(Color* dst, const Color* src, sl_size count) noexcept
+	{
+		_priv_Color_getRowFunctions()->swapRedBlue(dst, src, count);
+	}
+
+	void Color::blend_PA_NPA(Color* dst, const Color* src, sl_size count) noexcept
+	{
+		_priv_Color_getRowFunctions()->blend_PA_NPA(dst, src, count);
+	}
+
+	void Color::blend_PA_PA(Color* dst, const Color* src, sl_size count) noexcept
+	{
+		_priv_Color_getRowFunctions()->blend_PA_PA(dst, src, count);
+	}
+
 
 	String Color::toString() const noexcept
 	{
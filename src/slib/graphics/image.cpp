@@ -15,6 +15,7 @@
 #include "slib/core/scoped.h"
 
 #include "image_stb.h"
+#include "image_decode.h"
 
 namespace slib
 {
@@ -29,6 +30,16 @@ namespace slib
 	}
 
 
+	ImageDecodeParam::ImageDecodeParam()
+	: minimumWidth(0), minimumHeight(0), tileWidth(0), tileHeight(0)
+	{
+	}
+
+	ImageDecodeParam::~ImageDecodeParam()
+	{
+	}
+
+
 	SLIB_DEFINE_OBJECT(Image, Bitmap)
 
 	Image::Image()
@@ -357,9 +368,7 @@ namespace slib
 			Color* colorsDst = dst.colors;
 			const Color* colorsSrc = src.colors;
 			for (sl_uint32 y = 0; y < dst.height; y++) {
-				for (sl_uint32 x = 0; x < dst.width; x++) {
-					BLEND_OP::blend(colorsDst[x], colorsSrc[x]);
-				}
+				BLEND_OP::blendRow(colorsDst, colorsSrc, dst.width);
 				colorsDst += dst.stride;
 				colorsSrc += src.stride;
 			}
@@ -395,14 +404,12 @@ namespace slib
 		template <class BLEND_OP>
 		static void stretchY(ImageDesc& dst, const ImageDesc& src)
 		{
-			sl_uint32 dx, dy;
+			sl_uint32 dy;
 			
 			Color* colorsDst = dst.colors;
 			for (dy = 0; dy < dst.height; dy++) {
 				const Color* colorsSrc = src.colors + ((dy * src.height) / dst.height) * src.stride;
-				for (dx = 0; dx < dst.width; dx++) {
-					BLEND_OP::blend(colorsDst[dx], colorsSrc[dx]);
-				}
+				BLEND_OP::blendRow(colorsDst, colorsSrc, dst.width);
 				colorsDst += dst.stride;
 			}
 		}
@@ -1050,6 +1057,11 @@ namespace slib
 		{
 			dst = src;
 		}
+
+		SLIB_INLINE static void blendRow(Color* dst, const Color* src, sl_uint32 count)
+		{
+			Base::copyMemory(dst, src, count << 2);
+		}
 	};
 
 	class _ImageBlend_SrcAlpha
@@ -1059,6 +1071,11 @@ namespace slib
 		{
 			dst.blend_PA_NPA(src);
 		}
+
+		SLIB_INLINE static void blendRow(Color* dst, const Color* src, sl_uint32 count)
+		{
+			Color::blend_PA_NPA(dst, src, count);
+		}
 	};
 
 	class _ImageStretch
@@ -1094,7 +1111,9 @@ namespace slib
 			_ImageStretch::template stretch<_ImageStretch_FillColor>(dst, src, blend);
 			return;
 		}
-		if (stretch == StretchMode::Nearest) {
+		if (stretch == StretchMode::Bicubic || stretch == StretchMode::Mitchell || stretch == StretchMode::Lanczos) {
+			resample(dst, src, stretch, blend);
+		} else if (stretch == StretchMode::Nearest) {
 			_ImageStretch::template stretch<_ImageStretch_Nearest>(dst, src, blend);
 		} else if (stretch == StretchMode::Linear) {
 			_ImageStretch::template stretch< _ImageStretch_Smooth<_ImageStretch_Smooth_LinearFilter> >(dst, src, blend);
@@ -1242,6 +1261,18 @@ namespace slib
 		return sl_null;
 	}
 
+	Ref<Image> Image::scale(sl_uint32 width, sl_uint32 height, StretchMode stretch, const Ref<ThreadPool>& threadPool) const
+	{
+		if (width > 0 && height > 0) {
+			Ref<Image> ret = Image::create(width, height);
+			if (ret.isNotNull()) {
+				resample(ret->m_desc, m_desc, stretch, BlendMode::Copy, threadPool);
+			}
+			return ret;
+		}
+		return sl_null;
+	}
+
 	Ref<Image> Image::scaleToSmall(sl_uint32 requiredWidth, sl_uint32 requiredHeight, StretchMode stretch) const
 	{
 		sl_uint32 width = SLIB_MIN(requiredWidth, m_desc.width);
@@ -1279,8 +1310,193 @@ namespace slib
 		return getFileType(mem.getData(), mem.getSize());
 	}
 
+	sl_uint32 Image_Decoder::getBandHeight(const ImageDecodeParam& param)
+	{
+		if (param.tileHeight) {
+			return param.tileHeight;
+		}
+		return 16;
+	}
+
+	sl_bool Image_Decoder::emitBand(const ImageDecodeParam& param, sl_uint32 y, const ImageDesc& band)
+	{
+		if (param.onTile.isNull()) {
+			return sl_true;
+		}
+		sl_uint32 tileWidth = param.tileWidth;
+		if (tileWidth == 0 || tileWidth >= band.width) {
+			return param.onTile(0, y, band);
+		}
+		ImageDesc tile;
+		tile.height = band.height;
+		tile.stride = band.stride;
+		for (sl_uint32 x = 0; x < band.width; x += tileWidth) {
+			tile.colors = band.colors + x;
+			tile.width = SLIB_MIN(tileWidth, band.width - x);
+			if (!(param.onTile(x, y, tile))) {
+				return sl_false;
+			}
+		}
+		return sl_true;
+	}
+
+	void Image_Decoder::expandRGB(Color* row, sl_uint32 width)
+	{
+		// backward, so that the RGB pixels are read before they are overwritten
+		sl_uint8* src = (sl_uint8*)row + width * 3;
+		Color* dst = row + width;
+		while (dst != row) {
+			src -= 3;
+			dst--;
+			sl_uint8 r = src[0];
+			sl_uint8 g = src[1];
+			sl_uint8 b = src[2];
+			dst->r = r;
+			dst->g = g;
+			dst->b = b;
+			dst->a = 255;
+		}
+	}
+
+	sl_bool Image::decode(const void* content, sl_size size, const ImageDecodeParam& param)
+	{
+		switch (getFileType(content, size)) {
+			case ImageFileType::JPEG:
+				return decodeJPEG(content, size, param);
+			case ImageFileType::PNG:
+				return decodePNG(content, size, param);
+			default:
+				break;
+		}
+		return sl_false;
+	}
+
+	// averages the decoded bands into the smaller image, so that the full-size image is never stored
+	class _ImageDecode_Reducer
+	{
+	public:
+		Ref<Image> image;
+		sl_uint32 srcWidth;
+		sl_uint32 srcHeight;
+		sl_uint32 width;
+		sl_uint32 height;
+		sl_uint32* mapX;
+		sl_uint32* countX;
+		sl_uint32* sum;
+		sl_uint32 yCurrent;
+		sl_uint32 nRows;
+		Memory memory;
+
+	public:
+		sl_bool start(sl_uint32 _srcWidth, sl_uint32 _srcHeight, sl_uint32 _width, sl_uint32 _height)
+		{
+			if (_srcWidth < _width || _srcHeight < _height) {
+				return sl_false;
+			}
+			srcWidth = _srcWidth;
+			srcHeight = _srcHeight;
+			width = _width;
+			height = _height;
+			image = Image::create(width, height);
+			if (image.isNull()) {
+				return sl_false;
+			}
+			memory = Memory::create(((sl_size)srcWidth + (sl_size)width * 5) * sizeof(sl_uint32));
+			if (memory.isNull()) {
+				return sl_false;
+			}
+			mapX = (sl_uint32*)(memory.getData());
+			countX = mapX + srcWidth;
+			sum = countX + width;
+			Base::zeroMemory(countX, (sl_size)width * 5 * sizeof(sl_uint32));
+			for (sl_uint32 x = 0; x < srcWidth; x++) {
+				sl_uint32 k = (sl_uint32)((sl_uint64)x * width / srcWidth);
+				mapX[x] = k << 2;
+				countX[k]++;
+			}
+			yCurrent = 0;
+			nRows = 0;
+			return sl_true;
+		}
+
+		void addBand(sl_uint32 y, const ImageDesc& band)
+		{
+			const Color* row = band.colors;
+			for (sl_uint32 i = 0; i < band.height; i++) {
+				sl_uint32 k = (sl_uint32)((sl_uint64)(y + i) * height / srcHeight);
+				if (k != yCurrent) {
+					flush();
+					yCurrent = k;
+				}
+				for (sl_uint32 x = 0; x < srcWidth; x++) {
+					sl_uint32* s = sum + mapX[x];
+					const Color& c = row[x];
+					s[0] += c.r;
+					s[1] += c.g;
+					s[2] += c.b;
+					s[3] += c.a;
+				}
+				nRows++;
+				row += band.stride;
+			}
+			if (y + band.height >= srcHeight) {
+				flush();
+			}
+		}
+
+		void flush()
+		{
+			if (!nRows) {
+				return;
+			}
+			Color* dst = image->getColorsAt(0, yCurrent);
+			sl_uint32* s = sum;
+			for (sl_uint32 x = 0; x < width; x++) {
+				sl_uint32 n = countX[x] * nRows;
+				sl_uint32 h = n >> 1;
+				dst[x].r = (sl_uint8)((s[0] + h) / n);
+				dst[x].g = (sl_uint8)((s[1] + h) / n);
+				dst[x].b = (sl_uint8)((s[2] + h) / n);
+				dst[x].a = (sl_uint8)((s[3] + h) / n);
+				s[0] = 0;
+				s[1] = 0;
+				s[2] = 0;
+				s[3] = 0;
+				s += 4;
+			}
+			nRows = 0;
+		}
+
+	};
+
+	static Ref<Image> _ImageDecode_loadReduced(const void* mem, sl_size size, sl_uint32 width, sl_uint32 height)
+	{
+		_ImageDecode_Reducer reducer;
+		ImageDecodeParam param;
+		param.minimumWidth = width;
+		param.minimumHeight = height;
+		param.onStart = [&reducer, width, height](sl_uint32 srcWidth, sl_uint32 srcHeight) {
+			return reducer.start(srcWidth, srcHeight, width, height);
+		};
+		param.onTile = [&reducer](sl_uint32, sl_uint32 y, const ImageDesc& band) {
+			reducer.addBand(y, band);
+			return sl_true;
+		};
+		if (Image::decode(mem, size, param)) {
+			return reducer.image;
+		}
+		return sl_null;
+	}
+
 	Ref<Image> Image::loadFromMemory(const void* mem, sl_size size, sl_uint32 width, sl_uint32 height)
 	{
+		if (width && height) {
+			// shrinks while decoding, when the image is not smaller than the requested size
+			Ref<Image> ret = _ImageDecode_loadReduced(mem, size, width, height);
+			if (ret.isNotNull()) {
+				return ret;
+			}
+		}
 		Ref<Image> ret = Image_STB::loadImage(mem, size);
 		if (ret.isNotNull()) {
 			if (width == 0 || height == 0) {
@@ -0,0 +1,33 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_GRAPHICS_IMAGE_DECODE
+#define CHECKHEADER_SLIB_GRAPHICS_IMAGE_DECODE
+
+#include "slib/graphics/image.h"
+
+namespace slib
+{
+
+	class Image_Decoder
+	{
+	public:
+		static sl_uint32 getBandHeight(const ImageDecodeParam& param);
+
+		// splits the band into the tiles of `param`
+		static sl_bool emitBand(const ImageDecodeParam& param, sl_uint32 y, const ImageDesc& band);
+
+		// expands the RGB pixels stored at the beginning of the row, in place
+		static void expandRGB(Color* row, sl_uint32 width);
+	};
+
+}
+
+#endif
@@ -23,6 +23,8 @@
 
 #include "thirdparty/libjpeg/jpeglib.h"
 
+#include "image_decode.h"
+
 namespace slib
 {
 
@@ -93,6 +95,117 @@ namespace slib
 		return ret;
 	}
 
+	class _slib_image_jpeg_decoder
+	{
+	public:
+		jpeg_decompress_struct cinfo;
+		_slib_image_ext_jpeg_error_mgr jerr;
+		Memory band;
+		Memory rows;
+		ImageDesc desc;
+
+	public:
+		// the objects having destructors are kept in the members, because the errors are thrown by `longjmp`
+		sl_bool run(const void* content, sl_size size, const ImageDecodeParam& param)
+		{
+			cinfo.err = jpeg_std_error(&(jerr.pub));
+			jerr.pub.error_exit = _slib_image_jpeg_error_exit;
+
+			if (setjmp(jerr.setjmp_buffer)) {
+				jpeg_destroy_decompress(&cinfo);
+				return sl_false;
+			}
+
+			jpeg_create_decompress(&cinfo);
+
+			jpeg_mem_src(&cinfo, (unsigned char*)content, (sl_uint32)size);
+
+			jpeg_read_header(&cinfo, 1);
+
+			cinfo.out_color_space = JCS_RGB;
+
+			if (param.minimumWidth || param.minimumHeight) {
+				// scaled IDCT: the blocks are decoded at n/8 of the size, instead of being resized after decoding
+				cinfo.scale_denom = 8;
+				for (unsigned int n = 1; n <= 8; n++) {
+					cinfo.scale_num = n;
+					jpeg_calc_output_dimensions(&cinfo);
+					if (cinfo.output_width >= param.minimumWidth && cinfo.output_height >= param.minimumHeight) {
+						break;
+					}
+				}
+			}
+
+			jpeg_start_decompress(&cinfo);
+
+			sl_uint32 width = cinfo.output_width;
+			sl_uint32 height = cinfo.output_height;
+			if (param.onStart.isNotNull() && !(param.onStart(width, height))) {
+				jpeg_destroy_decompress(&cinfo);
+				return sl_false;
+			}
+			sl_uint32 bandHeight = Image_Decoder::getBandHeight(param);
+			if (bandHeight > height) {
+				bandHeight = height;
+			}
+			band = Memory::create((sl_size)width * bandHeight * sizeof(Color));
+			rows = Memory::create(bandHeight * sizeof(JSAMPROW));
+			if (band.isNull() || rows.isNull()) {
+				jpeg_destroy_decompress(&cinfo);
+				return sl_false;
+			}
+			Color* colors = (Color*)(band.getData());
+			JSAMPROW* pRows = (JSAMPROW*)(rows.getData());
+			for (sl_uint32 i = 0; i < bandHeight; i++) {
+				// RGB samples are decoded at the beginning of each row, and expanded later
+				pRows[i] = (JSAMPROW)(colors + (sl_size)i * width);
+			}
+
+			desc.width = width;
+			desc.stride = width;
+			desc.colors = colors;
+			while (cinfo.output_scanline < height) {
+				sl_uint32 y = cinfo.output_scanline;
+				sl_uint32 n = SLIB_MIN(bandHeight, height - y);
+				sl_uint32 k = 0;
+				while (k < n) {
+					sl_uint32 m = (sl_uint32)(jpeg_read_scanlines(&cinfo, pRows + k, n - k));
+					if (!m) {
+						break;
+					}
+					k += m;
+				}
+				if (k < n) {
+					break;
+				}
+				for (sl_uint32 i = 0; i < n; i++) {
+					Image_Decoder::expandRGB(colors + (sl_size)i * width, width);
+				}
+				desc.height = n;
+				if (!(Image_Decoder::emitBand(param, y, desc))) {
+					jpeg_destroy_decompress(&cinfo);
+					return sl_false;
+				}
+			}
+			if (cinfo.output_scanline < height) {
+				jpeg_destroy_decompress(&cinfo);
+				return sl_false;
+			}
+
+			jpeg_finish_decompress(&cinfo);
+			jpeg_destroy_decompress(&cinfo);
+
+			return sl_true;
+		}
+
+	};
+
+	sl_bool Image::decodeJPEG(const void* content, sl_size size, const ImageDecodeParam& param)
+	{
+		_slib_image_jpeg_decoder decoder;
+		return decoder.run(content, size, param);
+	}
+
 	Memory Image::saveToJPEG(const Ref<Image>& image, float quality)
 	{
 		if (image.isNull()) {
@@ -15,6 +15,8 @@
 #include "thirdparty/libpng/png.h"
 #include "thirdparty/libpng/pngstruct.h"
 
+#include "image_decode.h"
+
 namespace slib
 {
 
@@ -47,6 +49,166 @@ namespace slib
 		return ret;
 	}
 
+	struct _slib_image_png_mem_reader
+	{
+		const sl_uint8* data;
+		sl_size size;
+		sl_size pos;
+	};
+
+	static void _slib_image_png_mem_read_callback(png_structp png_ptr, png_bytep data, png_size_t length)
+	{
+		_slib_image_png_mem_reader* reader = (_slib_image_png_mem_reader*)(png_get_io_ptr(png_ptr));
+		if (reader->size - reader->pos < length) {
+			png_error(png_ptr, "unexpected end of data");
+		}
+		Base::copyMemory(data, reader->data + reader->pos, length);
+		reader->pos += length;
+	}
+
+	static void _slib_image_png_decode_error(png_structp png_ptr, png_const_charp)
+	{
+		png_longjmp(png_ptr, 1);
+	}
+
+	static void _slib_image_png_decode_warning(png_structp, png_const_charp)
+	{
+	}
+
+	class _slib_image_png_decoder
+	{
+	public:
+		png_structp png_ptr;
+		png_infop info_ptr;
+		_slib_image_png_mem_reader reader;
+		Memory band;
+		ImageDesc desc;
+
+	public:
+		_slib_image_png_decoder()
+		{
+			png_ptr = sl_null;
+			info_ptr = sl_null;
+		}
+
+		~_slib_image_png_decoder()
+		{
+			if (png_ptr) {
+				png_destroy_read_struct(&png_ptr, info_ptr ? &info_ptr : NULL, NULL);
+			}
+		}
+
+	public:
+		// the objects having destructors are kept in the members, because the errors are thrown by `longjmp`
+		sl_bool run(const void* content, sl_size size, const ImageDecodeParam& param)
+		{
+			png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, _slib_image_png_decode_error, _slib_image_png_decode_warning);
+			if (!png_ptr) {
+				return sl_false;
+			}
+			info_ptr = png_create_info_struct(png_ptr);
+			if (!info_ptr) {
+				return sl_false;
+			}
+			if (setjmp(png_jmpbuf(png_ptr))) {
+				return sl_false;
+			}
+
+			reader.data = (const sl_uint8*)content;
+			reader.size = size;
+			reader.pos = 0;
+			png_set_read_fn(png_ptr, &reader, _slib_image_png_mem_read_callback);
+
+			png_read_info(png_ptr, info_ptr);
+
+			png_uint_32 width = 0;
+			png_uint_32 height = 0;
+			int bitDepth = 0;
+			int colorType = 0;
+			int interlaceType = 0;
+			png_get_IHDR(png_ptr, info_ptr, &width, &height, &bitDepth, &colorType, &interlaceType, NULL, NULL);
+
+			// converts all the formats into 8-bit RGBA
+			if (colorType == PNG_COLOR_TYPE_PALETTE) {
+				png_set_palette_to_rgb(png_ptr);
+			}
+			if (!(colorType & PNG_COLOR_MASK_COLOR)) {
+				if (bitDepth < 8) {
+					png_set_expand_gray_1_2_4_to_8(png_ptr);
+				}
+				png_set_gray_to_rgb(png_ptr);
+			}
+			sl_bool flagAlpha = (colorType & PNG_COLOR_MASK_ALPHA) != 0;
+			if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS)) {
+				png_set_tRNS_to_alpha(png_ptr);
+				flagAlpha = sl_true;
+			}
+			if (bitDepth == 16) {
+				png_set_scale_16(png_ptr);
+			}
+			if (!flagAlpha) {
+				png_set_filler(png_ptr, 0xff, PNG_FILLER_AFTER);
+			}
+			int nPasses = png_set_interlace_handling(png_ptr);
+			png_read_update_info(png_ptr, info_ptr);
+
+			if (param.onStart.isNotNull() && !(param.onStart(width, height))) {
+				return sl_false;
+			}
+
+			// the interlaced images are completed only after the last pass, so they are stored as a whole
+			sl_uint32 bandHeight = nPasses > 1 ? height : Image_Decoder::getBandHeight(param);
+			if (bandHeight > height) {
+				bandHeight = height;
+			}
+			band = Memory::create((sl_size)width * bandHeight * sizeof(Color));
+			if (band.isNull()) {
+				return sl_false;
+			}
+			Color* colors = (Color*)(band.getData());
+			desc.width = width;
+			desc.stride = width;
+			desc.colors = colors;
+
+			if (nPasses > 1) {
+				for (int pass = 0; pass < nPasses; pass++) {
+					for (sl_uint32 y = 0; y < height; y++) {
+						png_read_row(png_ptr, (png_bytep)(colors + (sl_size)y * width), NULL);
+					}
+				}
+				desc.height = height;
+				sl_uint32 bandHeightOut = Image_Decoder::getBandHeight(param);
+				for (sl_uint32 y = 0; y < height; y += bandHeightOut) {
+					desc.colors = colors + (sl_size)y * width;
+					desc.height = SLIB_MIN(bandHeightOut, height - y);
+					if (!(Image_Decoder::emitBand(param, y, desc))) {
+						return sl_false;
+					}
+				}
+			} else {
+				for (sl_uint32 y = 0; y < height; y += bandHeight) {
+					sl_uint32 n = SLIB_MIN(bandHeight, height - y);
+					for (sl_uint32 i = 0; i < n; i++) {
+						png_read_row(png_ptr, (png_bytep)(colors + (sl_size)i * width), NULL);
+					}
+					desc.height = n;
+					if (!(Image_Decoder::emitBand(param, y, desc))) {
+						return sl_false;
+					}
+				}
+			}
+
+			return sl_true;
+		}
+
+	};
+
+	sl_bool Image::decodePNG(const void* content, sl_size size, const ImageDecodeParam& param)
+	{
+		_slib_image_png_decoder decoder;
+		return decoder.run(content, size, param);
+	}
+
 	static void _slib_image_png_mem_write_callback(png_structp png_ptr, png_bytep data, png_size_t length)
 	{
 		if (png_ptr == NULL)
@@ -0,0 +1,702 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "slib/graphics/image.h"
+
+#include "slib/core/thread_pool.h"
+#include "slib/core/event.h"
+#include "slib/core/system.h"
+#include "slib/core/math.h"
+#include "slib/core/scoped.h"
+#include "slib/core/cpu.h"
+
+#if defined(SLIB_ARCH_IS_X64) || (defined(SLIB_ARCH_IS_X86) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#	define _PRIV_RESAMPLE_USE_SSE2
+#	include <immintrin.h>
+#elif defined(SLIB_ARCH_IS_ARM64) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+#	define _PRIV_RESAMPLE_USE_NEON
+#	include <arm_neon.h>
+#endif
+
+/*
+	The image is resampled in two passes: the source rows are filtered
+	horizontally into a temporary buffer, which is then filtered vertically.
+	The filter weights of each output column and row are computed once, as
+	signed 16-bit fixed-point numbers summing to (1 << 14).
+*/
+
+#define _PRIV_RESAMPLE_PRECISION 14
+#define _PRIV_RESAMPLE_ROUND (1 << (_PRIV_RESAMPLE_PRECISION - 1))
+
+// output pixels from which the resampling is split into the row bands
+#define _PRIV_RESAMPLE_PARALLEL_MIN_PIXELS 65536
+
+namespace slib
+{
+
+	struct _priv_ImageResample_Table
+	{
+		sl_uint32* starts;
+		sl_uint32* counts;
+		sl_int16* weights;
+		// weights per output, padded to the multiple of 8
+		sl_uint32 nTaps;
+		Memory memory;
+	};
+
+	typedef void (*_priv_ImageResample_HorizontalFunc)(Color* dst, const Color* src, const _priv_ImageResample_Table& table, sl_uint32 width);
+	typedef void (*_priv_ImageResample_VerticalFunc)(sl_uint8* dst, const sl_uint8* src, sl_reg pitch, const sl_int16* weights, sl_uint32 count, sl_uint32 size);
+
+	struct _priv_ImageResample_Functions
+	{
+		_priv_ImageResample_HorizontalFunc horizontal;
+		_priv_ImageResample_VerticalFunc vertical;
+	};
+
+	static double _priv_ImageResample_getSupport(StretchMode mode) noexcept
+	{
+		if (mode == StretchMode::Lanczos) {
+			return 3;
+		}
+		return 2;
+	}
+
+	static double _priv_ImageResample_cubic(double x, double B, double C) noexcept
+	{
+		if (x < 0) {
+			x = -x;
+		}
+		double x2 = x * x;
+		double x3 = x2 * x;
+		if (x < 1) {
+			return ((12 - 9 * B - 6 * C) * x3 + (-18 + 12 * B + 6 * C) * x2 + (6 - 2 * B)) / 6;
+		}
+		if (x < 2) {
+			return ((-B - 6 * C) * x3 + (6 * B + 30 * C) * x2 + (-12 * B - 48 * C) * x + (8 * B + 24 * C)) / 6;
+		}
+		return 0;
+	}
+
+	static double _priv_ImageResample_sinc(double x) noexcept
+	{
+		if (x == 0) {
+			return 1;
+		}
+		x *= SLIB_PI;
+		return Math::sin(x) / x;
+	}
+
+	static double _priv_ImageResample_filter(StretchMode mode, double x) noexcept
+	{
+		switch (mode) {
+			case StretchMode::Lanczos:
+				if (x > -3 && x < 3) {
+					return _priv_ImageResample_sinc(x) * _priv_ImageResample_sinc(x / 3);
+				}
+				return 0;
+			case StretchMode::Mitchell:
+				return _priv_ImageResample_cubic(x, 1.0 / 3.0, 1.0 / 3.0);
+			default:
+				return _priv_ImageResample_cubic(x, 0, 0.5);
+		}
+	}
+
+	static sl_bool _priv_ImageResample_buildTable(_priv_ImageResample_Table& table, sl_uint32 nSrc, sl_uint32 nDst, StretchMode mode)
+	{
+		double scale = (double)nSrc / (double)nDst;
+		// widens the filter on downscaling, to cover all the source pixels
+		double filterScale = scale > 1 ? scale : 1;
+		double support = _priv_ImageResample_getSupport(mode) * filterScale;
+		sl_uint32 nTaps = (((sl_uint32)(Math::ceil(support)) * 2 + 1) + 7) & ~7;
+
+		sl_size sizeWeights = (sl_size)nDst * nTaps * sizeof(sl_int16);
+		sl_size sizeBounds = (sl_size)nDst * sizeof(sl_uint32);
+		Memory memory = Memory::create(sizeWeights + sizeBounds * 2);
+		if (memory.isNull()) {
+			return sl_false;
+		}
+		sl_uint8* data = (sl_uint8*)(memory.getData());
+		Base::zeroMemory(data, sizeWeights);
+		table.weights = (sl_int16*)data;
+		table.starts = (sl_uint32*)(data + sizeWeights);
+		table.counts = (sl_uint32*)(data + sizeWeights + sizeBounds);
+		table.nTaps = nTaps;
+		table.memory = memory;
+
+		SLIB_SCOPED_BUFFER(double, 64, values, nTaps)
+		if (!values) {
+			return sl_false;
+		}
+		for (sl_uint32 i = 0; i < nDst; i++) {
+			double center = ((double)i + 0.5) * scale;
+			sl_int32 start = (sl_int32)(Math::floor(center - support + 0.5));
+			if (start < 0) {
+				start = 0;
+			}
+			sl_int32 end = (sl_int32)(Math::floor(center + support + 0.5));
+			if (end > (sl_int32)nSrc) {
+				end = nSrc;
+			}
+			sl_int32 count = end - start;
+			if (count > (sl_int32)nTaps) {
+				count = nTaps;
+			}
+			double sum = 0;
+			for (sl_int32 k = 0; k < count; k++) {
+				double w = _priv_ImageResample_filter(mode, ((double)(start + k) + 0.5 - center) / filterScale);
+				values[k] = w;
+				sum += w;
+			}
+			if (sum == 0) {
+				// never happens for the supported filters, but keeps the output defined
+				sl_int32 k = (sl_int32)center;
+				if (k >= (sl_int32)nSrc) {
+					k = nSrc - 1;
+				}
+				start = k;
+				count = 1;
+				values[0] = 1;
+				sum = 1;
+			}
+			sl_int16* weights = table.weights + (sl_size)i * nTaps;
+			sl_int32 total = 0;
+			sl_int32 kMax = 0;
+			for (sl_int32 k = 0; k < count; k++) {
+				sl_int32 w = (sl_int32)(Math::floor(values[k] / sum * (1 << _PRIV_RESAMPLE_PRECISION) + 0.5));
+				weights[k] = (sl_int16)w;
+				total += w;
+				if (w > weights[kMax]) {
+					kMax = k;
+				}
+			}
+			// the rounding error is moved to the largest weight, so that the flat areas stay unchanged
+			weights[kMax] = (sl_int16)(weights[kMax] + ((1 << _PRIV_RESAMPLE_PRECISION) - total));
+			// trims the weights rounded to zero at both ends
+			sl_int32 first = 0;
+			while (first < count - 1 && !(weights[first])) {
+				first++;
+			}
+			while (count > first + 1 && !(weights[count - 1])) {
+				count--;
+			}
+			if (first) {
+				for (sl_int32 k = first; k < count; k++) {
+					weights[k - first] = weights[k];
+					weights[k] = 0;
+				}
+				start += first;
+				count -= first;
+			}
+			table.starts[i] = start;
+			table.counts[i] = count;
+		}
+		return sl_true;
+	}
+
+	SLIB_INLINE static sl_uint8 _priv_ImageResample_clamp(sl_int32 v) noexcept
+	{
+		v >>= _PRIV_RESAMPLE_PRECISION;
+		if (v < 0) {
+			return 0;
+		}
+		if (v > 255) {
+			return 255;
+		}
+		return (sl_uint8)v;
+	}
+
+#if !defined(_PRIV_RESAMPLE_USE_SSE2) && !defined(_PRIV_RESAMPLE_USE_NEON)
+	static void _priv_ImageResample_horizontal_scalar(Color* dst, const Color* src, const _priv_ImageResample_Table& table, sl_uint32 width)
+	{
+		for (sl_uint32 x = 0; x < width; x++) {
+			const Color* s = src + table.starts[x];
+			const sl_int16* w = table.weights + (sl_size)x * table.nTaps;
+			sl_uint32 count = table.counts[x];
+			sl_int32 r = _PRIV_RESAMPLE_ROUND;
+			sl_int32 g = _PRIV_RESAMPLE_ROUND;
+			sl_int32 b = _PRIV_RESAMPLE_ROUND;
+			sl_int32 a = _PRIV_RESAMPLE_ROUND;
+			for (sl_uint32 k = 0; k < count; k++) {
+				sl_int32 f = w[k];
+				r += s[k].r * f;
+				g += s[k].g * f;
+				b += s[k].b * f;
+				a += s[k].a * f;
+			}
+			Color& d = dst[x];
+			d.r = _priv_ImageResample_clamp(r);
+			d.g = _priv_ImageResample_clamp(g);
+			d.b = _priv_ImageResample_clamp(b);
+			d.a = _priv_ImageResample_clamp(a);
+		}
+	}
+#endif
+
+	static void _priv_ImageResample_vertical_scalar(sl_uint8* dst, const sl_uint8* src, sl_reg pitch, const sl_int16* weights, sl_uint32 count, sl_uint32 size)
+	{
+		for (sl_uint32 i = 0; i < size; i++) {
+			const sl_uint8* s = src + i;
+			sl_int32 v = _PRIV_RESAMPLE_ROUND;
+			for (sl_uint32 k = 0; k < count; k++) {
+				v += *s * weights[k];
+				s += pitch;
+			}
+			dst[i] = _priv_ImageResample_clamp(v);
+		}
+	}
+
+#if defined(_PRIV_RESAMPLE_USE_SSE2)
+	// two adjacent weights, as a pair of `_mm_madd_epi16()`
+	SLIB_INLINE static sl_int32 _priv_ImageResample_pair(const sl_int16* w) noexcept
+	{
+		return (sl_int32)((sl_uint32)(sl_uint16)(w[0]) | ((sl_uint32)(sl_uint16)(w[1]) << 16));
+	}
+
+	SLIB_INLINE static __m128i _priv_ImageResample_horizontalTail_sse2(__m128i sum, const Color* s, const sl_int16* w, sl_uint32 k, sl_uint32 count) noexcept
+	{
+		__m128i zero = _mm_setzero_si128();
+		for (; k + 4 <= count; k += 4) {
+			// interleaves the channels of the pixel pairs: r0 r1 g0 g1 b0 b1 a0 a1 r2 r3 ...
+			__m128i p = _mm_loadu_si128((const __m128i*)(s + k));
+			p = _mm_shuffle_epi32(p, _MM_SHUFFLE(3, 1, 2, 0));
+			p = _mm_unpacklo_epi8(p, _mm_srli_si128(p, 8));
+			__m128i c = _mm_loadl_epi64((const __m128i*)(w + k));
+			sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpacklo_epi8(p, zero), _mm_shuffle_epi32(c, 0)));
+			sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpackhi_epi8(p, zero), _mm_shuffle_epi32(c, 0x55)));
+		}
+		for (; k + 2 <= count; k += 2) {
+			__m128i p = _mm_loadl_epi64((const __m128i*)(s + k));
+			p = _mm_unpacklo_epi8(p, _mm_srli_si128(p, 4));
+			sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpacklo_epi8(p, zero), _mm_set1_epi32(_priv_ImageResample_pair(w + k))));
+		}
+		if (k < count) {
+			__m128i p = _mm_cvtsi32_si128(*((const sl_int32*)(s + k)));
+			p = _mm_unpacklo_epi8(p, zero);
+			sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpacklo_epi8(p, zero), _mm_set1_epi32((sl_uint16)(w[k]))));
+		}
+		return sum;
+	}
+
+	SLIB_INLINE static void _priv_ImageResample_storePixel_sse2(Color* dst, __m128i sum) noexcept
+	{
+		sum = _mm_srai_epi32(sum, _PRIV_RESAMPLE_PRECISION);
+		sum = _mm_packs_epi32(sum, sum);
+		sum = _mm_packus_epi16(sum, sum);
+		*((sl_int32*)dst) = _mm_cvtsi128_si32(sum);
+	}
+
+	static void _priv_ImageResample_horizontal_sse2(Color* dst, const Color* src, const _priv_ImageResample_Table& table, sl_uint32 width)
+	{
+		for (sl_uint32 x = 0; x < width; x++) {
+			__m128i sum = _priv_ImageResample_horizontalTail_sse2(_mm_set1_epi32(_PRIV_RESAMPLE_ROUND), src + table.starts[x], table.weights + (sl_size)x * table.nTaps, 0, table.counts[x]);
+			_priv_ImageResample_storePixel_sse2(dst + x, sum);
+		}
+	}
+
+	static void _priv_ImageResample_vertical_sse2(sl_uint8* dst, const sl_uint8* src, sl_reg pitch, const sl_int16* weights, sl_uint32 count, sl_uint32 size)
+	{
+		__m128i zero = _mm_setzero_si128();
+		__m128i round = _mm_set1_epi32(_PRIV_RESAMPLE_ROUND);
+		sl_uint32 i = 0;
+		for (; i + 16 <= size; i += 16) {
+			__m128i s0 = round;
+			__m128i s1 = round;
+			__m128i s2 = round;
+			__m128i s3 = round;
+			const sl_uint8* p = src + i;
+			sl_uint32 k = 0;
+			for (; k + 2 <= count; k += 2) {
+				__m128i a = _mm_loadu_si128((const __m128i*)p);
+				__m128i b = _mm_loadu_si128((const __m128i*)(p + pitch));
+				__m128i c = _mm_set1_epi32(_priv_ImageResample_pair(weights + k));
+				__m128i lo = _mm_unpacklo_epi8(a, b);
+				__m128i hi = _mm_unpackhi_epi8(a, b);
+				s0 = _mm_add_epi32(s0, _mm_madd_epi16(_mm_unpacklo_epi8(lo, zero), c));
+				s1 = _mm_add_epi32(s1, _mm_madd_epi16(_mm_unpackhi_epi8(lo, zero), c));
+				s2 = _mm_add_epi32(s2, _mm_madd_epi16(_mm_unpacklo_epi8(hi, zero), c));
+				s3 = _mm_add_epi32(s3, _mm_madd_epi16(_mm_unpackhi_epi8(hi, zero), c));
+				p += pitch << 1;
+			}
+			if (k < count) {
+				__m128i a = _mm_loadu_si128((const __m128i*)p);
+				__m128i c = _mm_set1_epi32((sl_uint16)(weights[k]));
+				__m128i lo = _mm_unpacklo_epi8(a, zero);
+				__m128i hi = _mm_unpackhi_epi8(a, zero);
+				s0 = _mm_add_epi32(s0, _mm_madd_epi16(_mm_unpacklo_epi8(lo, zero), c));
+				s1 = _mm_add_epi32(s1, _mm_madd_epi16(_mm_unpackhi_epi8(lo, zero), c));
+				s2 = _mm_add_epi32(s2, _mm_madd_epi16(_mm_unpacklo_epi8(hi, zero), c));
+				s3 = _mm_add_epi32(s3, _mm_madd_epi16(_mm_unpackhi_epi8(hi, zero), c));
+			}
+			s0 = _mm_packs_epi32(_mm_srai_epi32(s0, _PRIV_RESAMPLE_PRECISION), _mm_srai_epi32(s1, _PRIV_RESAMPLE_PRECISION));
+			s2 = _mm_packs_epi32(_mm_srai_epi32(s2, _PRIV_RESAMPLE_PRECISION), _mm_srai_epi32(s3, _PRIV_RESAMPLE_PRECISION));
+			_mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(s0, s2));
+		}
+		_priv_ImageResample_vertical_scalar(dst + i, src + i, pitch, weights, count, size - i);
+	}
+
+	static const _priv_ImageResample_Functions _g_image_resample_functions_sse2 = {
+		_priv_ImageResample_horizontal_sse2,
+		_priv_ImageResample_vertical_sse2
+	};
+
+	SLIB_TARGET_AVX2
+	static void _priv_ImageResample_horizontal_avx2(Color* dst, const Color* src, const _priv_ImageResample_Table& table, sl_uint32 width)
+	{
+		__m256i zero = _mm256_setzero_si256();
+		__m256i indexLo = _mm256_setr_epi32(0, 0, 0, 0, 2, 2, 2, 2);
+		__m256i indexHi = _mm256_setr_epi32(1, 1, 1, 1, 3, 3, 3, 3);
+		for (sl_uint32 x = 0; x < width; x++) {
+			const Color* s = src + table.starts[x];
+			const sl_int16* w = table.weights + (sl_size)x * table.nTaps;
+			sl_uint32 count = table.counts[x];
+			sl_uint32 k = 0;
+			__m256i sum8 = zero;
+			for (; k + 8 <= count; k += 8) {
+				// same as SSE2, in each 128-bit lane: (p0 p1 p2 p3) and (p4 p5 p6 p7)
+				__m256i p = _mm256_loadu_si256((const __m256i*)(s + k));
+				p = _mm256_shuffle_epi32(p, _MM_SHUFFLE(3, 1, 2, 0));
+				p = _mm256_unpacklo_epi8(p, _mm256_srli_si256(p, 8));
+				__m256i c = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(w + k)));
+				sum8 = _mm256_add_epi32(sum8, _mm256_madd_epi16(_mm256_unpacklo_epi8(p, zero), _mm256_permutevar8x32_epi32(c, indexLo)));
+				sum8 = _mm256_add_epi32(sum8, _mm256_madd_epi16(_mm256_unpackhi_epi8(p, zero), _mm256_permutevar8x32_epi32(c, indexHi)));
+			}
+			__m128i sum = _mm_add_epi32(_mm256_castsi256_si128(sum8), _mm256_extracti128_si256(sum8, 1));
+			sum = _priv_ImageResample_horizontalTail_sse2(_mm_add_epi32(sum, _mm_set1_epi32(_PRIV_RESAMPLE_ROUND)), s, w, k, count);
+			_priv_ImageResample_storePixel_sse2(dst + x, sum);
+		}
+	}
+
+	SLIB_TARGET_AVX2
+	static void _priv_ImageResample_vertical_avx2(sl_uint8* dst, const sl_uint8* src, sl_reg pitch, const sl_int16* weights, sl_uint32 count, sl_uint32 size)
+	{
+		// unpacking and packing both work in the 128-bit lanes, so the byte order is kept
+		__m256i zero = _mm256_setzero_si256();
+		__m256i round = _mm256_set1_epi32(_PRIV_RESAMPLE_ROUND);
+		sl_uint32 i = 0;
+		for (; i + 32 <= size; i += 32) {
+			__m256i s0 = round;
+			__m256i s1 = round;
+			__m256i s2 = round;
+			__m256i s3 = round;
+			const sl_uint8* p = src + i;
+			sl_uint32 k = 0;
+			for (; k + 2 <= count; k += 2) {
+				__m256i a = _mm256_loadu_si256((const __m256i*)p);
+				__m256i b = _mm256_loadu_si256((const __m256i*)(p + pitch));
+				__m256i c = _mm256_set1_epi32(_priv_ImageResample_pair(weights + k));
+				__m256i lo = _mm256_unpacklo_epi8(a, b);
+				__m256i hi = _mm256_unpackhi_epi8(a, b);
+				s0 = _mm256_add_epi32(s0, _mm256_madd_epi16(_mm256_unpacklo_epi8(lo, zero), c));
+				s1 = _mm256_add_epi32(s1, _mm256_madd_epi16(_mm256_unpackhi_epi8(lo, zero), c));
+				s2 = _mm256_add_epi32(s2, _mm256_madd_epi16(_mm256_unpacklo_epi8(hi, zero), c));
+				s3 = _mm256_add_epi32(s3, _mm256_madd_epi16(_mm256_unpackhi_epi8(hi, zero), c));
+				p += pitch << 1;
+			}
+			if (k < count) {
+				__m256i a = _mm256_loadu_si256((const __m256i*)p);
+				__m256i c = _mm256_set1_epi32((sl_uint16)(weights[k]));
+				__m256i lo = _mm256_unpacklo_epi8(a, zero);
+				__m256i hi = _mm256_unpackhi_epi8(a, zero);
+				s0 = _mm256_add_epi32(s0, _mm256_madd_epi16(_mm256_unpacklo_epi8(lo, zero), c));
+				s1 = _mm256_add_epi32(s1, _mm256_madd_epi16(_mm256_unpackhi_epi8(lo, zero), c));
+				s2 = _mm256_add_epi32(s2, _mm256_madd_epi16(_mm256_unpacklo_epi8(hi, zero), c));
+				s3 = _mm256_add_epi32(s3, _mm256_madd_epi16(_mm256_unpackhi_epi8(hi, zero), c));
+			}
+			s0 = _mm256_packs_epi32(_mm256_srai_epi32(s0, _PRIV_RESAMPLE_PRECISION), _mm256_srai_epi32(s1, _PRIV_RESAMPLE_PRECISION));
+			s2 = _mm256_packs_epi32(_mm256_srai_epi32(s2, _PRIV_RESAMPLE_PRECISION), _mm256_srai_epi32(s3, _PRIV_RESAMPLE_PRECISION));
+			_mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(s0, s2));
+		}
+		_priv_ImageResample_vertical_sse2(dst + i, src + i, pitch, weights, count, size - i);
+	}
+
+	static const _priv_ImageResample_Functions _g_image_resample_functions_avx2 = {
+		_priv_ImageResample_horizontal_avx2,
+		_priv_ImageResample_vertical_avx2
+	};
+#endif
+
+#if defined(_PRIV_RESAMPLE_USE_NEON)
+	SLIB_INLINE static void _priv_ImageResample_storePixel_neon(Color* dst, int32x4_t sum) noexcept
+	{
+		uint16x4_t v = vqrshrun_n_s32(sum, _PRIV_RESAMPLE_PRECISION);
+		uint8x8_t c = vqmovn_u16(vcombine_u16(v, v));
+		vst1_lane_u32((uint32_t*)dst, vreinterpret_u32_u8(c), 0);
+	}
+
+	static void _priv_ImageResample_horizontal_neon(Color* dst, const Color* src, const _priv_ImageResample_Table& table, sl_uint32 width)
+	{
+		for (sl_uint32 x = 0; x < width; x++) {
+			const Color* s = src + table.starts[x];
+			const sl_int16* w = table.weights + (sl_size)x * table.nTaps;
+			sl_uint32 count = table.counts[x];
+			int32x4_t sum = vdupq_n_s32(0);
+			sl_uint32 k = 0;
+			for (; k + 2 <= count; k += 2) {
+				int16x8_t p = vreinterpretq_s16_u16(vmovl_u8(vld1_u8((const sl_uint8*)(s + k))));
+				sum = vmlal_n_s16(sum, vget_low_s16(p), w[k]);
+				sum = vmlal_n_s16(sum, vget_high_s16(p), w[k + 1]);
+			}
+			if (k < count) {
+				uint32x2_t v = vld1_lane_u32((const uint32_t*)(s + k), vdup_n_u32(0), 0);
+				int16x8_t p = vreinterpretq_s16_u16(vmovl_u8(vreinterpret_u8_u32(v)));
+				sum = vmlal_n_s16(sum, vget_low_s16(p), w[k]);
+			}
+			_priv_ImageResample_storePixel_neon(dst + x, sum);
+		}
+	}
+
+	static void _priv_ImageResample_vertical_neon(sl_uint8* dst, const sl_uint8* src, sl_reg pitch, const sl_int16* weights, sl_uint32 count, sl_uint32 size)
+	{
+		sl_uint32 i = 0;
+		for (; i + 16 <= size; i += 16) {
+			int32x4_t s0 = vdupq_n_s32(0);
+			int32x4_t s1 = s0;
+			int32x4_t s2 = s0;
+			int32x4_t s3 = s0;
+			const sl_uint8* p = src + i;
+			for (sl_uint32 k = 0; k < count; k++) {
+				uint8x16_t a = vld1q_u8(p);
+				int16x8_t lo = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(a)));
+				int16x8_t hi = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(a)));
+				sl_int16 w = weights[k];
+				s0 = vmlal_n_s16(s0, vget_low_s16(lo), w);
+				s1 = vmlal_n_s16(s1, vget_high_s16(lo), w);
+				s2 = vmlal_n_s16(s2, vget_low_s16(hi), w);
+				s3 = vmlal_n_s16(s3, vget_high_s16(hi), w);
+				p += pitch;
+			}
+			uint16x8_t lo = vcombine_u16(vqrshrun_n_s32(s0, _PRIV_RESAMPLE_PRECISION), vqrshrun_n_s32(s1, _PRIV_RESAMPLE_PRECISION));
+			uint16x8_t hi = vcombine_u16(vqrshrun_n_s32(s2, _PRIV_RESAMPLE_PRECISION), vqrshrun_n_s32(s3, _PRIV_RESAMPLE_PRECISION));
+			vst1q_u8(dst + i, vcombine_u8(vqmovn_u16(lo), vqmovn_u16(hi)));
+		}
+		_priv_ImageResample_vertical_scalar(dst + i, src + i, pitch, weights, count, size - i);
+	}
+
+	static const _priv_ImageResample_Functions _g_image_resample_functions_neon = {
+		_priv_ImageResample_horizontal_neon,
+		_priv_ImageResample_vertical_neon
+	};
+#endif
+
+	static const _priv_ImageResample_Functions* _g_image_resample_functions = sl_null;
+
+	static const _priv_ImageResample_Functions* _priv_ImageResample_getFunctions() noexcept
+	{
+		const _priv_ImageResample_Functions* functions = _g_image_resample_functions;
+		if (functions) {
+			return functions;
+		}
+#if defined(_PRIV_RESAMPLE_USE_SSE2)
+		if (Cpu::isSupportingAVX2()) {
+			functions = &_g_image_resample_functions_avx2;
+		} else {
+			functions = &_g_image_resample_functions_sse2;
+		}
+#elif defined(_PRIV_RESAMPLE_USE_NEON)
+		functions = &_g_image_resample_functions_neon;
+#else
+		static const _priv_ImageResample_Functions functionsScalar = {
+			_priv_ImageResample_horizontal_scalar,
+			_priv_ImageResample_vertical_scalar
+		};
+		functions = &functionsScalar;
+#endif
+		_g_image_resample_functions = functions;
+		return functions;
+	}
+
+	// shared by the caller and the tasks on the thread pool; the tasks started after all the bands are taken never touch the images
+	class _priv_ImageResample_Job : public Referable
+	{
+	public:
+		Color* dst;
+		sl_uint32 dstWidth;
+		sl_uint32 dstHeight;
+		sl_int32 dstStride;
+		const Color* src;
+		sl_uint32 srcWidth;
+		sl_uint32 srcHeight;
+		sl_int32 srcStride;
+		BlendMode blend;
+
+		const _priv_ImageResample_Functions* functions;
+		_priv_ImageResample_Table tableX;
+		_priv_ImageResample_Table tableY;
+		sl_bool flagResizeX;
+		sl_bool flagResizeY;
+
+		sl_uint32 nBandRows;
+		sl_int32 nBands;
+		sl_int32 indexNextBand;
+		sl_int32 nRemainingBands;
+		Ref<Event> eventDone;
+
+	public:
+		void run()
+		{
+			for (;;) {
+				sl_int32 index = Base::interlockedIncrement32(&indexNextBand) - 1;
+				if (index >= nBands) {
+					return;
+				}
+				processBand((sl_uint32)index);
+				if (!(Base::interlockedDecrement32(&nRemainingBands))) {
+					if (eventDone.isNotNull()) {
+						eventDone->set();
+					}
+				}
+			}
+		}
+
+		void processBand(sl_uint32 index)
+		{
+			sl_uint32 y0 = index * nBandRows;
+			sl_uint32 y1 = y0 + nBandRows;
+			if (y1 > dstHeight) {
+				y1 = dstHeight;
+			}
+			if (y0 >= y1) {
+				return;
+			}
+			sl_bool flagBlend = blend != BlendMode::Copy;
+			SLIB_SCOPED_BUFFER(Color, 1024, row, flagBlend ? dstWidth : 0)
+			if (flagBlend && !row) {
+				return;
+			}
+			if (!flagResizeY) {
+				for (sl_uint32 y = y0; y < y1; y++) {
+					Color* d = dst + (sl_reg)y * dstStride;
+					functions->horizontal(flagBlend ? row : d, src + (sl_reg)y * srcStride, tableX, dstWidth);
+					if (flagBlend) {
+						Color::blend_PA_NPA(d, row, dstWidth);
+					}
+				}
+				return;
+			}
+			sl_uint32 syStart = tableY.starts[y0];
+			sl_uint32 syEnd = syStart;
+			for (sl_uint32 y = y0; y < y1; y++) {
+				sl_uint32 end = tableY.starts[y] + tableY.counts[y];
+				if (end > syEnd) {
+					syEnd = end;
+				}
+			}
+			const sl_uint8* rows;
+			sl_reg pitch;
+			sl_size sizeTemp = flagResizeX ? (sl_size)(syEnd - syStart) * dstWidth : 0;
+			SLIB_SCOPED_BUFFER(Color, 1024, temp, sizeTemp)
+			if (flagResizeX) {
+				if (!temp) {
+					return;
+				}
+				for (sl_uint32 sy = syStart; sy < syEnd; sy++) {
+					functions->horizontal(temp + (sl_size)(sy - syStart) * dstWidth, src + (sl_reg)sy * srcStride, tableX, dstWidth);
+				}
+				rows = (const sl_uint8*)temp;
+				pitch = (sl_reg)dstWidth << 2;
+			} else {
+				rows = (const sl_uint8*)(src + (sl_reg)syStart * srcStride);
+				pitch = (sl_reg)srcStride << 2;
+			}
+			for (sl_uint32 y = y0; y < y1; y++) {
+				Color* d = dst + (sl_reg)y * dstStride;
+				functions->vertical((sl_uint8*)(flagBlend ? row : d), rows + (sl_reg)(tableY.starts[y] - syStart) * pitch, pitch, tableY.weights + (sl_size)y * tableY.nTaps, tableY.counts[y], dstWidth << 2);
+				if (flagBlend) {
+					Color::blend_PA_NPA(d, row, dstWidth);
+				}
+			}
+		}
+
+	};
+
+	void Image::resample(ImageDesc& dst, const ImageDesc& src, StretchMode stretch, BlendMode blend)
+	{
+		resample(dst, src, stretch, blend, Ref<ThreadPool>::null());
+	}
+
+	void Image::resample(ImageDesc& dst, const ImageDesc& src, StretchMode stretch, BlendMode blend, const Ref<ThreadPool>& threadPool)
+	{
+		if (src.width == 0 || src.height == 0 || src.stride == 0 || src.colors == sl_null) {
+			return;
+		}
+		if (dst.width == 0 || dst.height == 0 || dst.stride == 0 || dst.colors == sl_null) {
+			return;
+		}
+		if (!(stretch == StretchMode::Bicubic || stretch == StretchMode::Mitchell || stretch == StretchMode::Lanczos) || (src.width == dst.width && src.height == dst.height) || (src.width == 1 && src.height == 1)) {
+			draw(dst, src, blend, stretch);
+			return;
+		}
+
+		Ref<_priv_ImageResample_Job> job = new _priv_ImageResample_Job;
+		if (job.isNull()) {
+			return;
+		}
+		job->dst = dst.colors;
+		job->dstWidth = dst.width;
+		job->dstHeight = dst.height;
+		job->dstStride = dst.stride;
+		job->src = src.colors;
+		job->srcWidth = src.width;
+		job->srcHeight = src.height;
+		job->srcStride = src.stride;
+		job->blend = blend;
+		job->functions = _priv_ImageResample_getFunctions();
+		job->flagResizeX = src.width != dst.width;
+		job->flagResizeY = src.height != dst.height;
+		if (job->flagResizeX) {
+			if (!(_priv_ImageResample_buildTable(job->tableX, src.width, dst.width, stretch))) {
+				return;
+			}
+		}
+		if (job->flagResizeY) {
+			if (!(_priv_ImageResample_buildTable(job->tableY, src.height, dst.height, stretch))) {
+				return;
+			}
+		}
+
+		// each band filters its own source rows horizontally, so the bands are kept as few as the workers
+		sl_uint32 nBands = 1;
+		if (threadPool.isNotNull() && (sl_size)(dst.width) * dst.height >= _PRIV_RESAMPLE_PARALLEL_MIN_PIXELS) {
+			nBands = System::getProcessorsCount();
+			sl_uint32 nMaxThreads = threadPool->getMaximumThreadsCount() + 1;
+			if (nBands > nMaxThreads) {
+				nBands = nMaxThreads;
+			}
+			if (nBands > dst.height) {
+				nBands = dst.height;
+			}
+			if (nBands < 1) {
+				nBands = 1;
+			}
+		}
+		job->nBandRows = (dst.height + nBands - 1) / nBands;
+		job->nBands = (sl_int32)nBands;
+		job->indexNextBand = 0;
+		job->nRemainingBands = (sl_int32)nBands;
+		if (nBands > 1) {
+			job->eventDone = Event::create(sl_false);
+			if (job->eventDone.isNotNull()) {
+				for (sl_uint32 i = 1; i < nBands; i++) {
+					if (!(threadPool->addTask([job]() {
+						job->run();
+					}))) {
+						break;
+					}
+				}
+			}
+		}
+		// the caller also takes the bands, so the job completes even when the pool is busy
+		job->run();
+		while (job->nRemainingBands > 0) {
+			job->eventDone->wait();
+		}
+	}
+
+}
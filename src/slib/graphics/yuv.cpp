@@ -11,6 +11,15 @@
 #include "slib/graphics/yuv.h"
 
 #include "slib/core/math.h"
+#include "slib/core/cpu.h"
+
+#if defined(SLIB_ARCH_IS_X64) || (defined(SLIB_ARCH_IS_X86) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#	define _PRIV_YUV_USE_SSE2
+#	include <immintrin.h>
+#elif defined(SLIB_ARCH_IS_ARM64) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+#	define _PRIV_YUV_USE_NEON
+#	include <arm_neon.h>
+#endif
 
 #define YUV_YG 18997 /* round(1.164 * 64 * 256 * 256 / 257) */
 #define YUV_YGB 1160 /* 1.164 * 64 * 16 - adjusted for even error distribution */
@@ -22,28 +31,572 @@
 #define YUV_BG (YUV_UG * 128 + YUV_VG * 128 - YUV_YGB)
 #define YUV_BR (YUV_VR * 128 - YUV_YGB)
 
+/*
+	The SIMD kernels compute the same integer formulas in 16-bit lanes, so all the implementations give the same results.
+
+	- RGB to YUV: the sums never leave the range of 16-bit unsigned integers, and the results never need the clamping.
+	- YUV to RGB: the blue sum exceeds the range of 16-bit signed integers, so it is computed at half scale
+	  ((y1 >> 1) + 64u - 8772) >> 5, which floors to the same value because the dropped bit never reaches the 5th bit.
+*/
+
 namespace slib
 {
 
+	SLIB_INLINE static void _priv_YUV_fromRGB(sl_int32 r, sl_int32 g, sl_int32 b, sl_uint8& Y, sl_uint8& U, sl_uint8& V)
+	{
+		Y = (sl_uint8)(Math::clamp0_255((66 * r + 129 * g + 25 * b + 0x1080) >> 8));
+		U = (sl_uint8)(Math::clamp0_255((112 * b - 74 * g - 38 * r + 0x8080) >> 8));
+		V = (sl_uint8)(Math::clamp0_255((112 * r - 94 * g - 18 * b + 0x8080) >> 8));
+	}
+
+	SLIB_INLINE static void _priv_YUV_toRGB(sl_int32 y, sl_int32 u, sl_int32 v, sl_uint8& R, sl_uint8& G, sl_uint8& B)
+	{
+		sl_int32 y1 = (sl_uint32)(y * 0x0101 * YUV_YG) >> 16;
+		B = (sl_uint8)(Math::clamp0_255((sl_int32)(YUV_BB - (u * YUV_UB) + y1) >> 6));
+		G = (sl_uint8)(Math::clamp0_255((sl_int32)(YUV_BG - (v * YUV_VG + u * YUV_UG) + y1) >> 6));
+		R = (sl_uint8)(Math::clamp0_255((sl_int32)(YUV_BR - (v * YUV_VR) + y1) >> 6));
+	}
+
 	void YUV::convertRGBToYUV(sl_uint8 R, sl_uint8 G, sl_uint8 B, sl_uint8& Y, sl_uint8& U, sl_uint8& V)
 	{
-		sl_int32 _r = R;
-		sl_int32 _g = G;
-		sl_int32 _b = B;
-		Y = (sl_uint8)(Math::clamp0_255((66 * _r + 129 * _g + 25 * _b + 0x1080) >> 8)); // y
-		U = (sl_uint8)(Math::clamp0_255((112 * _b - 74 * _g - 38 * _r + 0x8080) >> 8)); // u
-		V = (sl_uint8)(Math::clamp0_255((112 * _r - 94 * _g - 18 * _b + 0x8080) >> 8)); // v
+		_priv_YUV_fromRGB(R, G, B, Y, U, V);
 	}
 
 	void YUV::convertYUVToRGB(sl_uint8 Y, sl_uint8 U, sl_uint8 V, sl_uint8& R, sl_uint8& G, sl_uint8& B)
 	{
-		sl_int32 _y = Y;
-		sl_int32 _u = U;
-		sl_int32 _v = V;
-		sl_int32 y1 = (sl_uint32)(_y * 0x0101 * YUV_YG) >> 16;
-		B = (sl_uint8)(Math::clamp0_255((sl_int32)(YUV_BB - (_u * YUV_UB) + y1) >> 6));
-		G = (sl_uint8)(Math::clamp0_255((sl_int32)(YUV_BG - (_v * YUV_VG + _u * YUV_UG) + y1) >> 6));
-		R = (sl_uint8)(Math::clamp0_255((sl_int32)(YUV_BR - (_v * YUV_VR) + y1) >> 6));
+		_priv_YUV_toRGB(Y, U, V, R, G, B);
+	}
+
+	typedef void (*_priv_YUV_ToRGBAFunc)(const sl_uint8* Y, const sl_uint8* U, const sl_uint8* V, sl_int32 strideUV, sl_uint8* dst, sl_uint32 width, sl_bool flagBGRA);
+	typedef void (*_priv_YUV_FromRGBAFunc)(const sl_uint8* src0, const sl_uint8* src1, sl_uint8* Y0, sl_uint8* Y1, sl_uint8* U, sl_uint8* V, sl_int32 strideUV, sl_uint32 width, sl_bool flagBGRA);
+
+	struct _priv_YUV_Functions
+	{
+		_priv_YUV_ToRGBAFunc convertYUV420ToRGBA;
+		_priv_YUV_FromRGBAFunc convertRGBAToYUV420;
+	};
+
+	static void _priv_YUV_convertYUV420ToRGBA_scalar(const sl_uint8* Y, const sl_uint8* U, const sl_uint8* V, sl_int32 strideUV, sl_uint8* dst, sl_uint32 width, sl_bool flagBGRA)
+	{
+		sl_uint32 iR = flagBGRA ? 2 : 0;
+		sl_uint32 iB = 2 - iR;
+		for (sl_uint32 x = 0; x < width; x++) {
+			sl_int32 offsetUV = (x >> 1) * strideUV;
+			_priv_YUV_toRGB(Y[x], U[offsetUV], V[offsetUV], dst[iR], dst[1], dst[iB]);
+			dst[3] = 255;
+			dst += 4;
+		}
+	}
+
+	static void _priv_YUV_convertRGBAToYUV420_scalar(const sl_uint8* src0, const sl_uint8* src1, sl_uint8* Y0, sl_uint8* Y1, sl_uint8* U, sl_uint8* V, sl_int32 strideUV, sl_uint32 width, sl_bool flagBGRA)
+	{
+		sl_uint32 iR = flagBGRA ? 2 : 0;
+		sl_uint32 iB = 2 - iR;
+		sl_uint8 u, v;
+		for (sl_uint32 x = 0; x < width; x += 2) {
+			sl_uint32 n = x + 1 < width ? 2 : 1;
+			sl_uint32 su = 0;
+			sl_uint32 sv = 0;
+			for (sl_uint32 k = 0; k < n; k++) {
+				_priv_YUV_fromRGB(src0[iR], src0[1], src0[iB], Y0[x + k], u, v);
+				su += u;
+				sv += v;
+				_priv_YUV_fromRGB(src1[iR], src1[1], src1[iB], Y1[x + k], u, v);
+				su += u;
+				sv += v;
+				src0 += 4;
+				src1 += 4;
+			}
+			*U = (sl_uint8)(su / (n << 1));
+			*V = (sl_uint8)(sv / (n << 1));
+			U += strideUV;
+			V += strideUV;
+		}
+	}
+
+#if defined(_PRIV_YUV_USE_SSE2)
+	SLIB_INLINE static void _priv_YUV_toRGB_sse2(__m128i y, __m128i u, __m128i v, __m128i& r, __m128i& g, __m128i& b)
+	{
+		__m128i y1 = _mm_mulhi_epu16(_mm_or_si128(y, _mm_slli_epi16(y, 8)), _mm_set1_epi16(YUV_YG));
+		b = _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(_mm_srli_epi16(y1, 1), _mm_slli_epi16(u, 6)), _mm_set1_epi16(YUV_BB / 2)), 5);
+		g = _mm_srai_epi16(_mm_sub_epi16(_mm_add_epi16(y1, _mm_set1_epi16(YUV_BG)), _mm_add_epi16(_mm_mullo_epi16(v, _mm_set1_epi16(YUV_VG)), _mm_mullo_epi16(u, _mm_set1_epi16(YUV_UG)))), 6);
+		r = _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(y1, _mm_set1_epi16(YUV_BR)), _mm_mullo_epi16(v, _mm_set1_epi16(-YUV_VR))), 6);
+	}
+
+	// loads the 8 chroma samples as 16-bit lanes
+	SLIB_INLINE static void _priv_YUV_loadUV_sse2(const sl_uint8* U, const sl_uint8* V, sl_int32 strideUV, __m128i& u, __m128i& v)
+	{
+		if (strideUV == 1) {
+			__m128i zero = _mm_setzero_si128();
+			u = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)U), zero);
+			v = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)V), zero);
+		} else {
+			__m128i mask = _mm_set1_epi16(0xFF);
+			if (U < V) {
+				__m128i uv = _mm_loadu_si128((const __m128i*)U);
+				u = _mm_and_si128(uv, mask);
+				v = _mm_srli_epi16(uv, 8);
+			} else {
+				__m128i uv = _mm_loadu_si128((const __m128i*)V);
+				v = _mm_and_si128(uv, mask);
+				u = _mm_srli_epi16(uv, 8);
+			}
+		}
+	}
+
+	static void _priv_YUV_convertYUV420ToRGBA_sse2(const sl_uint8* Y, const sl_uint8* U, const sl_uint8* V, sl_int32 strideUV, sl_uint8* dst, sl_uint32 width, sl_bool flagBGRA)
+	{
+		sl_uint32 x = 0;
+		if (strideUV == 1 || strideUV == 2) {
+			__m128i zero = _mm_setzero_si128();
+			__m128i A = _mm_set1_epi8((char)0xFF);
+			for (; x + 16 <= width; x += 16) {
+				__m128i u, v;
+				_priv_YUV_loadUV_sse2(U, V, strideUV, u, v);
+				__m128i y = _mm_loadu_si128((const __m128i*)(Y + x));
+				__m128i r0, g0, b0, r1, g1, b1;
+				_priv_YUV_toRGB_sse2(_mm_unpacklo_epi8(y, zero), _mm_unpacklo_epi16(u, u), _mm_unpacklo_epi16(v, v), r0, g0, b0);
+				_priv_YUV_toRGB_sse2(_mm_unpackhi_epi8(y, zero), _mm_unpackhi_epi16(u, u), _mm_unpackhi_epi16(v, v), r1, g1, b1);
+				__m128i R = _mm_packus_epi16(r0, r1);
+				__m128i G = _mm_packus_epi16(g0, g1);
+				__m128i B = _mm_packus_epi16(b0, b1);
+				if (flagBGRA) {
+					__m128i t = R;
+					R = B;
+					B = t;
+				}
+				__m128i rg0 = _mm_unpacklo_epi8(R, G);
+				__m128i rg1 = _mm_unpackhi_epi8(R, G);
+				__m128i ba0 = _mm_unpacklo_epi8(B, A);
+				__m128i ba1 = _mm_unpackhi_epi8(B, A);
+				__m128i* d = (__m128i*)(dst + (x << 2));
+				_mm_storeu_si128(d, _mm_unpacklo_epi16(rg0, ba0));
+				_mm_storeu_si128(d + 1, _mm_unpackhi_epi16(rg0, ba0));
+				_mm_storeu_si128(d + 2, _mm_unpacklo_epi16(rg1, ba1));
+				_mm_storeu_si128(d + 3, _mm_unpackhi_epi16(rg1, ba1));
+				U += strideUV << 3;
+				V += strideUV << 3;
+			}
+		}
+		_priv_YUV_convertYUV420ToRGBA_scalar(Y + x, U, V, strideUV, dst + (x << 2), width - x, flagBGRA);
+	}
+
+	// loads 8 pixels as 16-bit lanes
+	SLIB_INLINE static void _priv_YUV_loadRGB_sse2(const sl_uint8* src, sl_bool flagBGRA, __m128i& r, __m128i& g, __m128i& b)
+	{
+		__m128i mask = _mm_set1_epi32(0xFF);
+		__m128i p0 = _mm_loadu_si128((const __m128i*)src);
+		__m128i p1 = _mm_loadu_si128((const __m128i*)(src + 16));
+		r = _mm_packs_epi32(_mm_and_si128(p0, mask), _mm_and_si128(p1, mask));
+		g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 8), mask), _mm_and_si128(_mm_srli_epi32(p1, 8), mask));
+		b = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 16), mask), _mm_and_si128(_mm_srli_epi32(p1, 16), mask));
+		if (flagBGRA) {
+			__m128i t = r;
+			r = b;
+			b = t;
+		}
+	}
+
+	SLIB_INLINE static __m128i _priv_YUV_toY_sse2(__m128i r, __m128i g, __m128i b)
+	{
+		__m128i t = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(66)), _mm_mullo_epi16(g, _mm_set1_epi16(129)));
+		t = _mm_add_epi16(t, _mm_add_epi16(_mm_mullo_epi16(b, _mm_set1_epi16(25)), _mm_set1_epi16(0x1080)));
+		return _mm_srli_epi16(t, 8);
+	}
+
+	SLIB_INLINE static __m128i _priv_YUV_toU_sse2(__m128i r, __m128i g, __m128i b)
+	{
+		__m128i t = _mm_add_epi16(_mm_mullo_epi16(b, _mm_set1_epi16(112)), _mm_set1_epi16((short)0x8080));
+		t = _mm_sub_epi16(t, _mm_add_epi16(_mm_mullo_epi16(g, _mm_set1_epi16(74)), _mm_mullo_epi16(r, _mm_set1_epi16(38))));
+		return _mm_srli_epi16(t, 8);
+	}
+
+	SLIB_INLINE static __m128i _priv_YUV_toV_sse2(__m128i r, __m128i g, __m128i b)
+	{
+		__m128i t = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(112)), _mm_set1_epi16((short)0x8080));
+		t = _mm_sub_epi16(t, _mm_add_epi16(_mm_mullo_epi16(g, _mm_set1_epi16(94)), _mm_mullo_epi16(b, _mm_set1_epi16(18))));
+		return _mm_srli_epi16(t, 8);
+	}
+
+	// averages the chroma of 2x2 pixels, `c0` and `c1` are the upper and lower rows of 8 pixels
+	SLIB_INLINE static __m128i _priv_YUV_average2x2_sse2(__m128i c0, __m128i c1)
+	{
+		return _mm_madd_epi16(_mm_add_epi16(c0, c1), _mm_set1_epi16(1));
+	}
+
+	static void _priv_YUV_convertRGBAToYUV420_sse2(const sl_uint8* src0, const sl_uint8* src1, sl_uint8* Y0, sl_uint8* Y1, sl_uint8* U, sl_uint8* V, sl_int32 strideUV, sl_uint32 width, sl_bool flagBGRA)
+	{
+		sl_uint32 x = 0;
+		if (strideUV == 1 || strideUV == 2) {
+			for (; x + 16 <= width; x += 16) {
+				__m128i r, g, b;
+				__m128i u00, v00, u01, v01, u10, v10, u11, v11;
+				__m128i y0, y1;
+				_priv_YUV_loadRGB_sse2(src0, flagBGRA, r, g, b);
+				y0 = _priv_YUV_toY_sse2(r, g, b);
+				u00 = _priv_YUV_toU_sse2(r, g, b);
+				v00 = _priv_YUV_toV_sse2(r, g, b);
+				_priv_YUV_loadRGB_sse2(src0 + 32, flagBGRA, r, g, b);
+				y1 = _priv_YUV_toY_sse2(r, g, b);
+				u01 = _priv_YUV_toU_sse2(r, g, b);
+				v01 = _priv_YUV_toV_sse2(r, g, b);
+				_mm_storeu_si128((__m128i*)(Y0 + x), _mm_packus_epi16(y0, y1));
+				_priv_YUV_loadRGB_sse2(src1, flagBGRA, r, g, b);
+				y0 = _priv_YUV_toY_sse2(r, g, b);
+				u10 = _priv_YUV_toU_sse2(r, g, b);
+				v10 = _priv_YUV_toV_sse2(r, g, b);
+				_priv_YUV_loadRGB_sse2(src1 + 32, flagBGRA, r, g, b);
+				y1 = _priv_YUV_toY_sse2(r, g, b);
+				u11 = _priv_YUV_toU_sse2(r, g, b);
+				v11 = _priv_YUV_toV_sse2(r, g, b);
+				_mm_storeu_si128((__m128i*)(Y1 + x), _mm_packus_epi16(y0, y1));
+				__m128i u = _mm_srli_epi16(_mm_packs_epi32(_priv_YUV_average2x2_sse2(u00, u10), _priv_YUV_average2x2_sse2(u01, u11)), 2);
+				__m128i v = _mm_srli_epi16(_mm_packs_epi32(_priv_YUV_average2x2_sse2(v00, v10), _priv_YUV_average2x2_sse2(v01, v11)), 2);
+				u = _mm_packus_epi16(u, u);
+				v = _mm_packus_epi16(v, v);
+				if (strideUV == 1) {
+					_mm_storel_epi64((__m128i*)U, u);
+					_mm_storel_epi64((__m128i*)V, v);
+				} else {
+					if (U < V) {
+						_mm_storeu_si128((__m128i*)U, _mm_unpacklo_epi8(u, v));
+					} else {
+						_mm_storeu_si128((__m128i*)V, _mm_unpacklo_epi8(v, u));
+					}
+				}
+				src0 += 64;
+				src1 += 64;
+				U += strideUV << 3;
+				V += strideUV << 3;
+			}
+		}
+		_priv_YUV_convertRGBAToYUV420_scalar(src0, src1, Y0 + x, Y1 + x, U, V, strideUV, width - x, flagBGRA);
+	}
+
+	static const _priv_YUV_Functions _g_yuv_functions_sse2 = {
+		_priv_YUV_convertYUV420ToRGBA_sse2,
+		_priv_YUV_convertRGBAToYUV420_sse2
+	};
+
+	SLIB_TARGET_AVX2 SLIB_INLINE static void _priv_YUV_toRGB_avx2(__m256i y, __m256i u, __m256i v, __m256i& r, __m256i& g, __m256i& b)
+	{
+		__m256i y1 = _mm256_mulhi_epu16(_mm256_or_si256(y, _mm256_slli_epi16(y, 8)), _mm256_set1_epi16(YUV_YG));
+		b = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(_mm256_srli_epi16(y1, 1), _mm256_slli_epi16(u, 6)), _mm256_set1_epi16(YUV_BB / 2)), 5);
+		g = _mm256_srai_epi16(_mm256_sub_epi16(_mm256_add_epi16(y1, _mm256_set1_epi16(YUV_BG)), _mm256_add_epi16(_mm256_mullo_epi16(v, _mm256_set1_epi16(YUV_VG)), _mm256_mullo_epi16(u, _mm256_set1_epi16(YUV_UG)))), 6);
+		r = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(y1, _mm256_set1_epi16(YUV_BR)), _mm256_mullo_epi16(v, _mm256_set1_epi16(-YUV_VR))), 6);
+	}
+
+	SLIB_TARGET_AVX2 static void _priv_YUV_convertYUV420ToRGBA_avx2(const sl_uint8* Y, const sl_uint8* U, const sl_uint8* V, sl_int32 strideUV, sl_uint8* dst, sl_uint32 width, sl_bool flagBGRA)
+	{
+		sl_uint32 x = 0;
+		if (strideUV == 1 || strideUV == 2) {
+			__m256i zero = _mm256_setzero_si256();
+			__m256i A = _mm256_set1_epi8((char)0xFF);
+			for (; x + 32 <= width; x += 32) {
+				// 16 chroma samples in order
+				__m256i u, v;
+				if (strideUV == 1) {
+					u = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)U));
+					v = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)V));
+				} else {
+					__m256i mask = _mm256_set1_epi16(0xFF);
+					if (U < V) {
+						__m256i uv = _mm256_loadu_si256((const __m256i*)U);
+						u = _mm256_and_si256(uv, mask);
+						v = _mm256_srli_epi16(uv, 8);
+					} else {
+						__m256i uv = _mm256_loadu_si256((const __m256i*)V);
+						v = _mm256_and_si256(uv, mask);
+						u = _mm256_srli_epi16(uv, 8);
+					}
+				}
+				// the lanes of (0~7, 16~23) and (8~15, 24~31) pixels
+				__m256i y = _mm256_loadu_si256((const __m256i*)(Y + x));
+				__m256i r0, g0, b0, r1, g1, b1;
+				_priv_YUV_toRGB_avx2(_mm256_unpacklo_epi8(y, zero), _mm256_unpacklo_epi16(u, u), _mm256_unpacklo_epi16(v, v), r0, g0, b0);
+				_priv_YUV_toRGB_avx2(_mm256_unpackhi_epi8(y, zero), _mm256_unpackhi_epi16(u, u), _mm256_unpackhi_epi16(v, v), r1, g1, b1);
+				__m256i R = _mm256_packus_epi16(r0, r1);
+				__m256i G = _mm256_packus_epi16(g0, g1);
+				__m256i B = _mm256_packus_epi16(b0, b1);
+				if (flagBGRA) {
+					__m256i t = R;
+					R = B;
+					B = t;
+				}
+				__m256i rg0 = _mm256_unpacklo_epi8(R, G);
+				__m256i rg1 = _mm256_unpackhi_epi8(R, G);
+				__m256i ba0 = _mm256_unpacklo_epi8(B, A);
+				__m256i ba1 = _mm256_unpackhi_epi8(B, A);
+				__m256i o0 = _mm256_unpacklo_epi16(rg0, ba0);
+				__m256i o1 = _mm256_unpackhi_epi16(rg0, ba0);
+				__m256i o2 = _mm256_unpacklo_epi16(rg1, ba1);
+				__m256i o3 = _mm256_unpackhi_epi16(rg1, ba1);
+				__m256i* d = (__m256i*)(dst + (x << 2));
+				_mm256_storeu_si256(d, _mm256_permute2x128_si256(o0, o1, 0x20));
+				_mm256_storeu_si256(d + 1, _mm256_permute2x128_si256(o2, o3, 0x20));
+				_mm256_storeu_si256(d + 2, _mm256_permute2x128_si256(o0, o1, 0x31));
+				_mm256_storeu_si256(d + 3, _mm256_permute2x128_si256(o2, o3, 0x31));
+				U += strideUV << 4;
+				V += strideUV << 4;
+			}
+		}
+		_priv_YUV_convertYUV420ToRGBA_sse2(Y + x, U, V, strideUV, dst + (x << 2), width - x, flagBGRA);
+	}
+
+	// loads 16 pixels as 16-bit lanes, in the order of (0~3, 8~11, 4~7, 12~15)
+	SLIB_TARGET_AVX2 SLIB_INLINE static void _priv_YUV_loadRGB_avx2(const sl_uint8* src, sl_bool flagBGRA, __m256i& r, __m256i& g, __m256i& b)
+	{
+		__m256i mask = _mm256_set1_epi32(0xFF);
+		__m256i p0 = _mm256_loadu_si256((const __m256i*)src);
+		__m256i p1 = _mm256_loadu_si256((const __m256i*)(src + 32));
+		r = _mm256_packs_epi32(_mm256_and_si256(p0, mask), _mm256_and_si256(p1, mask));
+		g = _mm256_packs_epi32(_mm256_and_si256(_mm256_srli_epi32(p0, 8), mask), _mm256_and_si256(_mm256_srli_epi32(p1, 8), mask));
+		b = _mm256_packs_epi32(_mm256_and_si256(_mm256_srli_epi32(p0, 16), mask), _mm256_and_si256(_mm256_srli_epi32(p1, 16), mask));
+		if (flagBGRA) {
+			__m256i t = r;
+			r = b;
+			b = t;
+		}
+	}
+
+	SLIB_TARGET_AVX2 SLIB_INLINE static void _priv_YUV_fromRGB_avx2(const sl_uint8* src, sl_bool flagBGRA, __m256i& y, __m256i& u, __m256i& v)
+	{
+		__m256i r, g, b;
+		_priv_YUV_loadRGB_avx2(src, flagBGRA, r, g, b);
+		__m256i t = _mm256_add_epi16(_mm256_mullo_epi16(r, _mm256_set1_epi16(66)), _mm256_mullo_epi16(g, _mm256_set1_epi16(129)));
+		t = _mm256_add_epi16(t, _mm256_add_epi16(_mm256_mullo_epi16(b, _mm256_set1_epi16(25)), _mm256_set1_epi16(0x1080)));
+		y = _mm256_srli_epi16(t, 8);
+		t = _mm256_add_epi16(_mm256_mullo_epi16(b, _mm256_set1_epi16(112)), _mm256_set1_epi16((short)0x8080));
+		t = _mm256_sub_epi16(t, _mm256_add_epi16(_mm256_mullo_epi16(g, _mm256_set1_epi16(74)), _mm256_mullo_epi16(r, _mm256_set1_epi16(38))));
+		u = _mm256_srli_epi16(t, 8);
+		t = _mm256_add_epi16(_mm256_mullo_epi16(r, _mm256_set1_epi16(112)), _mm256_set1_epi16((short)0x8080));
+		t = _mm256_sub_epi16(t, _mm256_add_epi16(_mm256_mullo_epi16(g, _mm256_set1_epi16(94)), _mm256_mullo_epi16(b, _mm256_set1_epi16(18))));
+		v = _mm256_srli_epi16(t, 8);
+	}
+
+	// returns 16 chroma samples as bytes
+	SLIB_TARGET_AVX2 SLIB_INLINE static __m128i _priv_YUV_average2x2_avx2(__m256i c00, __m256i c01, __m256i c10, __m256i c11, __m256i order)
+	{
+		__m256i one = _mm256_set1_epi16(1);
+		__m256i s0 = _mm256_madd_epi16(_mm256_add_epi16(c00, c10), one);
+		__m256i s1 = _mm256_madd_epi16(_mm256_add_epi16(c01, c11), one);
+		__m256i c = _mm256_permutevar8x32_epi32(_mm256_srli_epi16(_mm256_packs_epi32(s0, s1), 2), order);
+		c = _mm256_packus_epi16(c, c);
+		return _mm_unpacklo_epi64(_mm256_castsi256_si128(c), _mm256_extracti128_si256(c, 1));
+	}
+
+	SLIB_TARGET_AVX2 static void _priv_YUV_convertRGBAToYUV420_avx2(const sl_uint8* src0, const sl_uint8* src1, sl_uint8* Y0, sl_uint8* Y1, sl_uint8* U, sl_uint8* V, sl_int32 strideUV, sl_uint32 width, sl_bool flagBGRA)
+	{
+		sl_uint32 x = 0;
+		if (strideUV == 1 || strideUV == 2) {
+			__m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+			for (; x + 32 <= width; x += 32) {
+				__m256i y0, y1;
+				__m256i u00, v00, u01, v01, u10, v10, u11, v11;
+				_priv_YUV_fromRGB_avx2(src0, flagBGRA, y0, u00, v00);
+				_priv_YUV_fromRGB_avx2(src0 + 64, flagBGRA, y1, u01, v01);
+				_mm256_storeu_si256((__m256i*)(Y0 + x), _mm256_permutevar8x32_epi32(_mm256_packus_epi16(y0, y1), order));
+				_priv_YUV_fromRGB_avx2(src1, flagBGRA, y0, u10, v10);
+				_priv_YUV_fromRGB_avx2(src1 + 64, flagBGRA, y1, u11, v11);
+				_mm256_storeu_si256((__m256i*)(Y1 + x), _mm256_permutevar8x32_epi32(_mm256_packus_epi16(y0, y1), order));
+				__m128i u = _priv_YUV_average2x2_avx2(u00, u01, u10, u11, order);
+				__m128i v = _priv_YUV_average2x2_avx2(v00, v01, v10, v11, order);
+				if (strideUV == 1) {
+					_mm_storeu_si128((__m128i*)U, u);
+					_mm_storeu_si128((__m128i*)V, v);
+				} else {
+					__m128i* d;
+					if (U < V) {
+						d = (__m128i*)U;
+					} else {
+						d = (__m128i*)V;
+						__m128i t = u;
+						u = v;
+						v = t;
+					}
+					_mm_storeu_si128(d, _mm_unpacklo_epi8(u, v));
+					_mm_storeu_si128(d + 1, _mm_unpackhi_epi8(u, v));
+				}
+				src0 += 128;
+				src1 += 128;
+				U += strideUV << 4;
+				V += strideUV << 4;
+			}
+		}
+		_priv_YUV_convertRGBAToYUV420_sse2(src0, src1, Y0 + x, Y1 + x, U, V, strideUV, width - x, flagBGRA);
+	}
+
+	static const _priv_YUV_Functions _g_yuv_functions_avx2 = {
+		_priv_YUV_convertYUV420ToRGBA_avx2,
+		_priv_YUV_convertRGBAToYUV420_avx2
+	};
+#endif
+
+#if defined(_PRIV_YUV_USE_NEON)
+	SLIB_INLINE static void _priv_YUV_toRGB_neon(uint8x8_t y, uint8x8_t u, uint8x8_t v, uint8x8_t& r, uint8x8_t& g, uint8x8_t& b)
+	{
+		uint16x8_t y16 = vmovl_u8(y);
+		y16 = vorrq_u16(y16, vshlq_n_u16(y16, 8));
+		uint16x4_t y1l = vshrn_n_u32(vmull_n_u16(vget_low_u16(y16), YUV_YG), 16);
+		uint16x4_t y1h = vshrn_n_u32(vmull_n_u16(vget_high_u16(y16), YUV_YG), 16);
+		int16x8_t y1 = vreinterpretq_s16_u16(vcombine_u16(y1l, y1h));
+		int16x8_t u16 = vreinterpretq_s16_u16(vmovl_u8(u));
+		int16x8_t v16 = vreinterpretq_s16_u16(vmovl_u8(v));
+		int16x8_t b16 = vshrq_n_s16(vaddq_s16(vaddq_s16(vshrq_n_s16(y1, 1), vshlq_n_s16(u16, 6)), vdupq_n_s16(YUV_BB / 2)), 5);
+		int16x8_t g16 = vshrq_n_s16(vsubq_s16(vaddq_s16(y1, vdupq_n_s16(YUV_BG)), vaddq_s16(vmulq_n_s16(v16, YUV_VG), vmulq_n_s16(u16, YUV_UG))), 6);
+		int16x8_t r16 = vshrq_n_s16(vaddq_s16(vaddq_s16(y1, vdupq_n_s16(YUV_BR)), vmulq_n_s16(v16, -YUV_VR)), 6);
+		r = vqmovun_s16(r16);
+		g = vqmovun_s16(g16);
+		b = vqmovun_s16(b16);
+	}
+
+	static void _priv_YUV_convertYUV420ToRGBA_neon(const sl_uint8* Y, const sl_uint8* U, const sl_uint8* V, sl_int32 strideUV, sl_uint8* dst, sl_uint32 width, sl_bool flagBGRA)
+	{
+		sl_uint32 x = 0;
+		if (strideUV == 1 || strideUV == 2) {
+			sl_uint32 iR = flagBGRA ? 2 : 0;
+			sl_uint32 iB = 2 - iR;
+			for (; x + 16 <= width; x += 16) {
+				uint8x8_t u, v;
+				if (strideUV == 1) {
+					u = vld1_u8(U);
+					v = vld1_u8(V);
+				} else {
+					if (U < V) {
+						uint8x8x2_t uv = vld2_u8(U);
+						u = uv.val[0];
+						v = uv.val[1];
+					} else {
+						uint8x8x2_t uv = vld2_u8(V);
+						v = uv.val[0];
+						u = uv.val[1];
+					}
+				}
+				uint8x8x2_t u2 = vzip_u8(u, u);
+				uint8x8x2_t v2 = vzip_u8(v, v);
+				uint8x16_t y = vld1q_u8(Y + x);
+				uint8x8_t r0, g0, b0, r1, g1, b1;
+				_priv_YUV_toRGB_neon(vget_low_u8(y), u2.val[0], v2.val[0], r0, g0, b0);
+				_priv_YUV_toRGB_neon(vget_high_u8(y), u2.val[1], v2.val[1], r1, g1, b1);
+				uint8x16x4_t o;
+				o.val[iR] = vcombine_u8(r0, r1);
+				o.val[1] = vcombine_u8(g0, g1);
+				o.val[iB] = vcombine_u8(b0, b1);
+				o.val[3] = vdupq_n_u8(255);
+				vst4q_u8(dst + (x << 2), o);
+				U += strideUV << 3;
+				V += strideUV << 3;
+			}
+		}
+		_priv_YUV_convertYUV420ToRGBA_scalar(Y + x, U, V, strideUV, dst + (x << 2), width - x, flagBGRA);
+	}
+
+	SLIB_INLINE static uint8x8_t _priv_YUV_toY_neon(uint8x8_t r, uint8x8_t g, uint8x8_t b)
+	{
+		uint16x8_t t = vmull_u8(r, vdup_n_u8(66));
+		t = vmlal_u8(t, g, vdup_n_u8(129));
+		t = vmlal_u8(t, b, vdup_n_u8(25));
+		return vshrn_n_u16(vaddq_u16(t, vdupq_n_u16(0x1080)), 8);
+	}
+
+	SLIB_INLINE static uint16x8_t _priv_YUV_toUV_neon(uint8x8_t c0, uint8x8_t c1, uint8x8_t c2, sl_uint8 k1, sl_uint8 k2)
+	{
+		uint16x8_t t = vaddq_u16(vmull_u8(c0, vdup_n_u8(112)), vdupq_n_u16(0x8080));
+		t = vmlsl_u8(t, c1, vdup_n_u8(k1));
+		t = vmlsl_u8(t, c2, vdup_n_u8(k2));
+		return vshrq_n_u16(t, 8);
+	}
+
+	// averages the chroma of 2x2 pixels, `c0x` and `c1x` are the upper and lower rows of 16 pixels
+	SLIB_INLINE static uint8x8_t _priv_YUV_average2x2_neon(uint16x8_t c00, uint16x8_t c01, uint16x8_t c10, uint16x8_t c11)
+	{
+		uint16x4_t s0 = vshrn_n_u32(vpaddlq_u16(vaddq_u16(c00, c10)), 2);
+		uint16x4_t s1 = vshrn_n_u32(vpaddlq_u16(vaddq_u16(c01, c11)), 2);
+		return vmovn_u16(vcombine_u16(s0, s1));
+	}
+
+	static void _priv_YUV_convertRGBAToYUV420_neon(const sl_uint8* src0, const sl_uint8* src1, sl_uint8* Y0, sl_uint8* Y1, sl_uint8* U, sl_uint8* V, sl_int32 strideUV, sl_uint32 width, sl_bool flagBGRA)
+	{
+		sl_uint32 x = 0;
+		if (strideUV == 1 || strideUV == 2) {
+			sl_uint32 iR = flagBGRA ? 2 : 0;
+			sl_uint32 iB = 2 - iR;
+			for (; x + 16 <= width; x += 16) {
+				uint8x16x4_t p0 = vld4q_u8(src0);
+				uint8x16x4_t p1 = vld4q_u8(src1);
+				uint8x8_t r00 = vget_low_u8(p0.val[iR]), g00 = vget_low_u8(p0.val[1]), b00 = vget_low_u8(p0.val[iB]);
+				uint8x8_t r01 = vget_high_u8(p0.val[iR]), g01 = vget_high_u8(p0.val[1]), b01 = vget_high_u8(p0.val[iB]);
+				uint8x8_t r10 = vget_low_u8(p1.val[iR]), g10 = vget_low_u8(p1.val[1]), b10 = vget_low_u8(p1.val[iB]);
+				uint8x8_t r11 = vget_high_u8(p1.val[iR]), g11 = vget_high_u8(p1.val[1]), b11 = vget_high_u8(p1.val[iB]);
+				vst1q_u8(Y0 + x, vcombine_u8(_priv_YUV_toY_neon(r00, g00, b00), _priv_YUV_toY_neon(r01, g01, b01)));
+				vst1q_u8(Y1 + x, vcombine_u8(_priv_YUV_toY_neon(r10, g10, b10), _priv_YUV_toY_neon(r11, g11, b11)));
+				uint8x8_t u = _priv_YUV_average2x2_neon(_priv_YUV_toUV_neon(b00, g00, r00, 74, 38), _priv_YUV_toUV_neon(b01, g01, r01, 74, 38), _priv_YUV_toUV_neon(b10, g10, r10, 74, 38), _priv_YUV_toUV_neon(b11, g11, r11, 74, 38));
+				uint8x8_t v = _priv_YUV_average2x2_neon(_priv_YUV_toUV_neon(r00, g00, b00, 94, 18), _priv_YUV_toUV_neon(r01, g01, b01, 94, 18), _priv_YUV_toUV_neon(r10, g10, b10, 94, 18), _priv_YUV_toUV_neon(r11, g11, b11, 94, 18));
+				if (strideUV == 1) {
+					vst1_u8(U, u);
+					vst1_u8(V, v);
+				} else {
+					uint8x8x2_t uv;
+					if (U < V) {
+						uv.val[0] = u;
+						uv.val[1] = v;
+						vst2_u8(U, uv);
+					} else {
+						uv.val[0] = v;
+						uv.val[1] = u;
+						vst2_u8(V, uv);
+					}
+				}
+				src0 += 64;
+				src1 += 64;
+				U += strideUV << 3;
+				V += strideUV << 3;
+			}
+		}
+		_priv_YUV_convertRGBAToYUV420_scalar(src0, src1, Y0 + x, Y1 + x, U, V, strideUV, width - x, flagBGRA);
+	}
+
+	static const _priv_YUV_Functions _g_yuv_functions_neon = {
+		_priv_YUV_convertYUV420ToRGBA_neon,
+		_priv_YUV_convertRGBAToYUV420_neon
+	};
+#endif
+
+	static const _priv_YUV_Functions* _g_yuv_functions = sl_null;
+
+	static const _priv_YUV_Functions* _priv_YUV_getFunctions()
+	{
+		const _priv_YUV_Functions* functions = _g_yuv_functions;
+		if (functions) {
+			return functions;
+		}
+#if defined(_PRIV_YUV_USE_SSE2)
+		if (Cpu::isSupportingAVX2()) {
+			functions = &_g_yuv_functions_avx2;
+		} else {
+			functions = &_g_yuv_functions_sse2;
+		}
+#elif defined(_PRIV_YUV_USE_NEON)
+		functions = &_g_yuv_functions_neon;
+#else
+		static const _priv_YUV_Functions functionsScalar = {
+			_priv_YUV_convertYUV420ToRGBA_scalar,
+			_priv_YUV_convertRGBAToYUV420_scalar
+		};
+		functions = &functionsScalar;
+#endif
+		_g_yuv_functions = functions;
+		return functions;
+	}
+
+	void YUV::convertYUV420ToRGBA(const sl_uint8* Y, const sl_uint8* U, const sl_uint8* V, sl_int32 strideUV, sl_uint8* RGBA, sl_uint32 width, sl_bool flagBGRA)
+	{
+		_priv_YUV_getFunctions()->convertYUV420ToRGBA(Y, U, V, strideUV, RGBA, width, flagBGRA);
+	}
+
+	void YUV::convertRGBAToYUV420(const sl_uint8* RGBA0, const sl_uint8* RGBA1, sl_uint8* Y0, sl_uint8* Y1, sl_uint8* U, sl_uint8* V, sl_int32 strideUV, sl_uint32 width, sl_bool flagBGRA)
+	{
+		_priv_YUV_getFunctions()->convertRGBAToYUV420(RGBA0, RGBA1, Y0, Y1, U, V, strideUV, width, flagBGRA);
 	}
 
 }
@@ -397,6 +397,144 @@ namespace slib
 		}
 	}
 
+	// maps the sample types stored in the native byte order to the types handled by the batch functions of `AudioUtil`
+	static sl_bool _AudioData_getNativeSampleType(AudioSampleType type, AudioSampleType& _out)
+	{
+		switch (type) {
+			case AudioSampleType::Int8:
+			case AudioSampleType::Uint8:
+			case AudioSampleType::Int16:
+			case AudioSampleType::Uint16:
+			case AudioSampleType::Float:
+				_out = type;
+				return sl_true;
+			case AudioSampleType::Int16LE:
+				_out = AudioSampleType::Int16;
+				return Endian::isLE();
+			case AudioSampleType::Int16BE:
+				_out = AudioSampleType::Int16;
+				return Endian::isBE();
+			case AudioSampleType::Uint16LE:
+				_out = AudioSampleType::Uint16;
+				return Endian::isLE();
+			case AudioSampleType::Uint16BE:
+				_out = AudioSampleType::Uint16;
+				return Endian::isBE();
+			case AudioSampleType::FloatLE:
+				_out = AudioSampleType::Float;
+				return Endian::isLE();
+			case AudioSampleType::FloatBE:
+				_out = AudioSampleType::Float;
+				return Endian::isBE();
+		}
+		return sl_false;
+	}
+
+	template <class IN_TYPE, class OUT_TYPE>
+	static sl_bool _AudioData_mixChannels_Batch(sl_size count, AudioFormat format_in, IN_TYPE* data_in, IN_TYPE* data_in1, AudioFormat format_out, OUT_TYPE* data_out, OUT_TYPE* data_out1)
+	{
+		return sl_false;
+	}
+
+	template <class T>
+	static sl_bool _AudioData_mixChannels_Batch_Same(sl_size count, AudioFormat format_in, T* data_in, T* data_in1, AudioFormat format_out, T* data_out, T* data_out1)
+	{
+		if (AudioFormats::getChannelsCount(format_in) == 1) {
+			if (AudioFormats::isNonInterleaved(format_out)) {
+				Base::copyMemory(data_out, data_in, count * sizeof(T));
+				Base::copyMemory(data_out1, data_in, count * sizeof(T));
+			} else {
+				AudioUtil::copyMonoToStereo(count, data_in, data_out);
+			}
+		} else {
+			if (AudioFormats::isNonInterleaved(format_in)) {
+				AudioUtil::mixSamples(count, data_in, data_in1, data_out);
+			} else {
+				AudioUtil::mixStereoToMono(count, data_in, data_out);
+			}
+		}
+		return sl_true;
+	}
+
+	static sl_bool _AudioData_mixChannels_Batch(sl_size count, AudioFormat format_in, sl_int16* data_in, sl_int16* data_in1, AudioFormat format_out, sl_int16* data_out, sl_int16* data_out1)
+	{
+		return _AudioData_mixChannels_Batch_Same(count, format_in, data_in, data_in1, format_out, data_out, data_out1);
+	}
+
+	static sl_bool _AudioData_mixChannels_Batch(sl_size count, AudioFormat format_in, float* data_in, float* data_in1, AudioFormat format_out, float* data_out, float* data_out1)
+	{
+		return _AudioData_mixChannels_Batch_Same(count, format_in, data_in, data_in1, format_out, data_out, data_out1);
+	}
+
+	template <class IN_TYPE, class OUT_TYPE>
+	static sl_bool _AudioData_copySamples_Batch_Step2(sl_size count, AudioFormat format_in, sl_uint8* data_in, sl_uint8* data_in1, AudioFormat format_out, sl_uint8* data_out, sl_uint8* data_out1)
+	{
+		sl_uint32 nChannels = AudioFormats::getChannelsCount(format_in);
+		if (nChannels != AudioFormats::getChannelsCount(format_out)) {
+			return _AudioData_mixChannels_Batch(count, format_in, (IN_TYPE*)data_in, (IN_TYPE*)data_in1, format_out, (OUT_TYPE*)data_out, (OUT_TYPE*)data_out1);
+		}
+		if (nChannels == 2) {
+			sl_bool flagNonInterleaved = AudioFormats::isNonInterleaved(format_in);
+			if (flagNonInterleaved != AudioFormats::isNonInterleaved(format_out)) {
+				return sl_false;
+			}
+			if (flagNonInterleaved) {
+				AudioUtil::convertSamples(count, (IN_TYPE*)data_in, (OUT_TYPE*)data_out);
+				AudioUtil::convertSamples(count, (IN_TYPE*)data_in1, (OUT_TYPE*)data_out1);
+				return sl_true;
+			}
+		}
+		AudioUtil::convertSamples(count * nChannels, (IN_TYPE*)data_in, (OUT_TYPE*)data_out);
+		return sl_true;
+	}
+
+	template <class IN_TYPE>
+	static sl_bool _AudioData_copySamples_Batch_Step1(sl_size count, AudioFormat format_in, sl_uint8* data_in, sl_uint8* data_in1, AudioSampleType type_out, AudioFormat format_out, sl_uint8* data_out, sl_uint8* data_out1)
+	{
+		switch (type_out) {
+			case AudioSampleType::Int8:
+				return _AudioData_copySamples_Batch_Step2<IN_TYPE, sl_int8>(count, format_in, data_in, data_in1, format_out, data_out, data_out1);
+			case AudioSampleType::Uint8:
+				return _AudioData_copySamples_Batch_Step2<IN_TYPE, sl_uint8>(count, format_in, data_in, data_in1, format_out, data_out, data_out1);
+			case AudioSampleType::Int16:
+				return _AudioData_copySamples_Batch_Step2<IN_TYPE, sl_int16>(count, format_in, data_in, data_in1, format_out, data_out, data_out1);
+			case AudioSampleType::Uint16:
+				return _AudioData_copySamples_Batch_Step2<IN_TYPE, sl_uint16>(count, format_in, data_in, data_in1, format_out, data_out, data_out1);
+			case AudioSampleType::Float:
+				return _AudioData_copySamples_Batch_Step2<IN_TYPE, float>(count, format_in, data_in, data_in1, format_out, data_out, data_out1);
+			default:
+				break;
+		}
+		return sl_false;
+	}
+
+	// uses the vectorized functions of `AudioUtil` when both sides are stored in the native byte order
+	static sl_bool _AudioData_copySamples_Batch(sl_size count, AudioFormat format_in, sl_uint8* data_in, sl_uint8* data_in1, AudioFormat format_out, sl_uint8* data_out, sl_uint8* data_out1)
+	{
+		AudioSampleType type_in, type_out;
+		if (!(_AudioData_getNativeSampleType(AudioFormats::getSampleType(format_in), type_in))) {
+			return sl_false;
+		}
+		if (!(_AudioData_getNativeSampleType(AudioFormats::getSampleType(format_out), type_out))) {
+			return sl_false;
+		}
+		switch (type_in) {
+			case AudioSampleType::Int8:
+				return _AudioData_copySamples_Batch_Step1<sl_int8>(count, format_in, data_in, data_in1, type_out, format_out, data_out, data_out1);
+			case AudioSampleType::Uint8:
+				return _AudioData_copySamples_Batch_Step1<sl_uint8>(count, format_in, data_in, data_in1, type_out, format_out, data_out, data_out1);
+			case AudioSampleType::Int16:
+				return _AudioData_copySamples_Batch_Step1<sl_int16>(count, format_in, data_in, data_in1, type_out, format_out, data_out, data_out1);
+			case AudioSampleType::Uint16:
+				return _AudioData_copySamples_Batch_Step1<sl_uint16>(count, format_in, data_in, data_in1, type_out, format_out, data_out, data_out1);
+			case AudioSampleType::Float:
+				return _AudioData_copySamples_Batch_Step1<float>(count, format_in, data_in, data_in1, type_out, format_out, data_out, data_out1);
+			default:
+				break;
+		}
+		return sl_false;
+	}
+
 	void AudioData::copySamplesFrom(const AudioData& other, sl_size countSamples) const
 	{
 		if (format == AudioFormat::None) {
@@ -415,16 +553,16 @@ namespace slib
 			return;
 		}
 		
-		sl_uint8* data_in = (sl_uint8*)data;
-		sl_uint8* data_in1 = (sl_uint8*)data1;
-		if (AudioFormats::isNonInterleaved(format) && !data_in1) {
-			data_in1 = data_in + getSizeForChannel();
+		sl_uint8* data_in = (sl_uint8*)(other.data);
+		sl_uint8* data_in1 = (sl_uint8*)(other.data1);
+		if (AudioFormats::isNonInterleaved(other.format) && !data_in1) {
+			data_in1 = data_in + other.getSizeForChannel();
 		}
 		
-		sl_uint8* data_out = (sl_uint8*)(other.data);
-		sl_uint8* data_out1 = (sl_uint8*)(other.data1);
-		if (AudioFormats::isNonInterleaved(other.format) && !data_out1) {
-			data_out1 = data_out + other.getSizeForChannel();
+		sl_uint8* data_out = (sl_uint8*)data;
+		sl_uint8* data_out1 = (sl_uint8*)data1;
+		if (AudioFormats::isNonInterleaved(format) && !data_out1) {
+			data_out1 = data_out + getSizeForChannel();
 		}
 		
 		if (format == other.format) {
@@ -439,7 +577,11 @@ namespace slib
 			return;
 		}
 		
-		_AudioData_copySamples(countSamples, format, data_in, data_in1, other.format, data_out, data_out1);
+		if (_AudioData_copySamples_Batch(countSamples, other.format, data_in, data_in1, format, data_out, data_out1)) {
+			return;
+		}
+		
+		_AudioData_copySamples(countSamples, other.format, data_in, data_in1, format, data_out, data_out1);
 	}
 
 	void AudioData::copySamplesFrom(const AudioData& other) const
@@ -0,0 +1,442 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "slib/media/audio_resampler.h"
+
+#include "slib/media/audio_util.h"
+#include "slib/core/math.h"
+
+#if defined(SLIB_ARCH_IS_X64) || (defined(SLIB_ARCH_IS_X86) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#	define _PRIV_AUDIO_RESAMPLER_USE_SSE2
+#	include <immintrin.h>
+#elif defined(SLIB_ARCH_IS_ARM64) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+#	define _PRIV_AUDIO_RESAMPLER_USE_NEON
+#	include <arm_neon.h>
+#endif
+
+#define _PRIV_AUDIO_RESAMPLER_MAX_PHASES 1024
+#define _PRIV_AUDIO_RESAMPLER_MAX_RATIO 64
+#define _PRIV_AUDIO_RESAMPLER_KAISER_BETA 8.0
+// input frames handled at once
+#define _PRIV_AUDIO_RESAMPLER_CHUNK 1024
+
+namespace slib
+{
+
+	AudioResamplerParam::AudioResamplerParam()
+	{
+		samplesPerSecondInput = 44100;
+		samplesPerSecondOutput = 48000;
+		channelsCount = 1;
+		filterLength = 16;
+	}
+
+	AudioResamplerParam::~AudioResamplerParam()
+	{
+	}
+
+
+	static sl_uint32 _priv_AudioResampler_gcd(sl_uint32 a, sl_uint32 b)
+	{
+		while (b) {
+			sl_uint32 t = a % b;
+			a = b;
+			b = t;
+		}
+		return a;
+	}
+
+	// zeroth order modified Bessel function of the first kind
+	static double _priv_AudioResampler_I0(double x)
+	{
+		double sum = 1;
+		double term = 1;
+		double q = x * x / 4;
+		for (sl_uint32 k = 1; k < 64; k++) {
+			term *= q / (double)(k * k);
+			sum += term;
+			if (term < sum * 1e-12) {
+				break;
+			}
+		}
+		return sum;
+	}
+
+	// taps are multiple of 4
+	static float _priv_AudioResampler_dot(const float* x, const float* h, sl_uint32 n)
+	{
+#if defined(_PRIV_AUDIO_RESAMPLER_USE_SSE2)
+		__m128 s0 = _mm_setzero_ps();
+		__m128 s1 = _mm_setzero_ps();
+		sl_uint32 i = 0;
+		for (; i + 8 <= n; i += 8) {
+			s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(h + i)));
+			s1 = _mm_add_ps(s1, _mm_mul_ps(_mm_loadu_ps(x + i + 4), _mm_loadu_ps(h + i + 4)));
+		}
+		if (i < n) {
+			s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(h + i)));
+		}
+		s0 = _mm_add_ps(s0, s1);
+		s0 = _mm_add_ps(s0, _mm_movehl_ps(s0, s0));
+		s0 = _mm_add_ss(s0, _mm_shuffle_ps(s0, s0, 1));
+		return _mm_cvtss_f32(s0);
+#elif defined(_PRIV_AUDIO_RESAMPLER_USE_NEON)
+		float32x4_t s0 = vdupq_n_f32(0);
+		float32x4_t s1 = vdupq_n_f32(0);
+		sl_uint32 i = 0;
+		for (; i + 8 <= n; i += 8) {
+			s0 = vmlaq_f32(s0, vld1q_f32(x + i), vld1q_f32(h + i));
+			s1 = vmlaq_f32(s1, vld1q_f32(x + i + 4), vld1q_f32(h + i + 4));
+		}
+		if (i < n) {
+			s0 = vmlaq_f32(s0, vld1q_f32(x + i), vld1q_f32(h + i));
+		}
+		s0 = vaddq_f32(s0, s1);
+		float32x2_t s = vadd_f32(vget_low_f32(s0), vget_high_f32(s0));
+		return vget_lane_f32(vpadd_f32(s, s), 0);
+#else
+		float s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+		for (sl_uint32 i = 0; i < n; i += 4) {
+			s0 += x[i] * h[i];
+			s1 += x[i + 1] * h[i + 1];
+			s2 += x[i + 2] * h[i + 2];
+			s3 += x[i + 3] * h[i + 3];
+		}
+		return (s0 + s1) + (s2 + s3);
+#endif
+	}
+
+	template <class T>
+	static void _priv_AudioResampler_deinterleave(const T* input, sl_size count, sl_uint32 nChannels, float* planes, sl_size stride)
+	{
+		if (nChannels == 1) {
+			AudioUtil::convertSamples(count, input, planes);
+			return;
+		}
+		for (sl_uint32 iChannel = 0; iChannel < nChannels; iChannel++) {
+			const T* s = input + iChannel;
+			float* d = planes + iChannel * stride;
+			for (sl_size i = 0; i < count; i++) {
+				AudioUtil::convertSample(*s, d[i]);
+				s += nChannels;
+			}
+		}
+	}
+
+	static AudioData _priv_AudioResampler_getSubData(const AudioData& data, sl_size offset, sl_size count)
+	{
+		AudioData ret;
+		ret.format = data.format;
+		ret.count = count;
+		sl_uint8* p = (sl_uint8*)(data.data);
+		sl_uint32 nBytes = AudioFormats::getBytesPerSample(data.format);
+		if (AudioFormats::isNonInterleaved(data.format)) {
+			sl_uint8* p1 = (sl_uint8*)(data.data1);
+			if (!p1) {
+				p1 = p + data.getSizeForChannel();
+			}
+			ret.data = p + offset * nBytes;
+			ret.data1 = p1 + offset * nBytes;
+		} else {
+			ret.data = p + offset * nBytes * AudioFormats::getChannelsCount(data.format);
+		}
+		return ret;
+	}
+
+
+	SLIB_DEFINE_OBJECT(AudioResampler, Object)
+
+	AudioResampler::AudioResampler()
+	{
+		m_nSamplesPerSecondInput = 0;
+		m_nSamplesPerSecondOutput = 0;
+		m_nChannels = 0;
+		m_L = 1;
+		m_M = 1;
+		m_nPhases = 1;
+		m_nTaps = 0;
+		m_nBufferCapacity = 0;
+		m_nBuffered = 0;
+		m_pos = 0;
+		m_frac = 0;
+	}
+
+	AudioResampler::~AudioResampler()
+	{
+	}
+
+	Ref<AudioResampler> AudioResampler::create(const AudioResamplerParam& param)
+	{
+		sl_uint32 rateIn = param.samplesPerSecondInput;
+		sl_uint32 rateOut = param.samplesPerSecondOutput;
+		sl_uint32 nChannels = param.channelsCount;
+		if (!rateIn || !rateOut || !nChannels) {
+			return sl_null;
+		}
+		if ((sl_uint64)rateIn > (sl_uint64)rateOut * _PRIV_AUDIO_RESAMPLER_MAX_RATIO || (sl_uint64)rateOut > (sl_uint64)rateIn * _PRIV_AUDIO_RESAMPLER_MAX_RATIO) {
+			return sl_null;
+		}
+		sl_uint32 g = _priv_AudioResampler_gcd(rateIn, rateOut);
+		sl_uint32 L = rateOut / g;
+		sl_uint32 M = rateIn / g;
+		sl_uint32 nPhases = L;
+		if (nPhases > _PRIV_AUDIO_RESAMPLER_MAX_PHASES) {
+			nPhases = _PRIV_AUDIO_RESAMPLER_MAX_PHASES;
+		}
+		
+		// cutoff, relative to the input Nyquist frequency
+		double fc = 1;
+		if (L < M) {
+			fc = (double)L / (double)M;
+		}
+		sl_uint32 filterLength = param.filterLength;
+		if (filterLength < 2) {
+			filterLength = 2;
+		}
+		// half length in input samples, rounded up to keep the taps multiple of 4
+		sl_uint32 H = (sl_uint32)(Math::ceil(filterLength / fc));
+		H = (H + 1) & ~((sl_uint32)1);
+		sl_uint32 nTaps = H * 2;
+		
+		Array<float> filters = Array<float>::create((nPhases + 1) * nTaps);
+		if (filters.isNull()) {
+			return sl_null;
+		}
+		Array<double> kernel = Array<double>::create(nTaps);
+		if (kernel.isNull()) {
+			return sl_null;
+		}
+		{
+			float* f = filters.getData();
+			double* h = kernel.getData();
+			double beta = _PRIV_AUDIO_RESAMPLER_KAISER_BETA;
+			double I0beta = _priv_AudioResampler_I0(beta);
+			for (sl_uint32 iPhase = 0; iPhase <= nPhases; iPhase++) {
+				double t = (double)iPhase / (double)nPhases;
+				double sum = 0;
+				for (sl_uint32 k = 0; k < nTaps; k++) {
+					double d = (double)k - (double)(H - 1) - t;
+					double u = d / (double)H;
+					double v = 0;
+					if (u > -1 && u < 1) {
+						double x = fc * d;
+						double sinc = 1;
+						if (x > 1e-9 || x < -1e-9) {
+							sinc = Math::sin(SLIB_PI_LONG * x) / (SLIB_PI_LONG * x);
+						}
+						v = fc * sinc * _priv_AudioResampler_I0(beta * Math::sqrt(1 - u * u)) / I0beta;
+					}
+					h[k] = v;
+					sum += v;
+				}
+				// unity gain at DC for every phase
+				for (sl_uint32 k = 0; k < nTaps; k++) {
+					f[k] = (float)(h[k] / sum);
+				}
+				f += nTaps;
+			}
+		}
+		
+		sl_size nBufferCapacity = nTaps + _PRIV_AUDIO_RESAMPLER_CHUNK;
+		Array<float> buffer = Array<float>::create(nBufferCapacity * nChannels);
+		if (buffer.isNull()) {
+			return sl_null;
+		}
+		
+		Ref<AudioResampler> ret = new AudioResampler;
+		if (ret.isNull()) {
+			return sl_null;
+		}
+		ret->m_nSamplesPerSecondInput = rateIn;
+		ret->m_nSamplesPerSecondOutput = rateOut;
+		ret->m_nChannels = nChannels;
+		ret->m_L = L;
+		ret->m_M = M;
+		ret->m_nPhases = nPhases;
+		ret->m_nTaps = nTaps;
+		ret->m_filters = filters;
+		ret->m_buffer = buffer;
+		ret->m_nBufferCapacity = nBufferCapacity;
+		ret->m_bufOutput = Array<float>::create(ret->getMaxOutputCount(_PRIV_AUDIO_RESAMPLER_CHUNK) * nChannels);
+		if (ret->m_bufOutput.isNull()) {
+			return sl_null;
+		}
+		ret->reset();
+		return ret;
+	}
+
+	sl_uint32 AudioResampler::getInputSamplesCountPerSecond() const
+	{
+		return m_nSamplesPerSecondInput;
+	}
+
+	sl_uint32 AudioResampler::getOutputSamplesCountPerSecond() const
+	{
+		return m_nSamplesPerSecondOutput;
+	}
+
+	sl_uint32 AudioResampler::getChannelsCount() const
+	{
+		return m_nChannels;
+	}
+
+	sl_size AudioResampler::getMaxOutputCount(sl_size countInput) const
+	{
+		return (sl_size)((sl_uint64)countInput * m_L / m_M) + 2;
+	}
+
+	void AudioResampler::reset()
+	{
+		// the first output is aligned to the first input sample
+		sl_uint32 H = m_nTaps >> 1;
+		Base::zeroMemory(m_buffer.getData(), m_nBufferCapacity * m_nChannels * sizeof(float));
+		m_nBuffered = H - 1;
+		m_pos = H - 1;
+		m_frac = 0;
+	}
+
+	sl_size AudioResampler::_processPlanar(sl_size countInput, float* output)
+	{
+		m_nBuffered += countInput;
+		
+		sl_uint32 nChannels = m_nChannels;
+		sl_uint32 nTaps = m_nTaps;
+		sl_uint32 H = nTaps >> 1;
+		sl_uint32 L = m_L;
+		sl_uint32 M = m_M;
+		sl_uint32 nPhases = m_nPhases;
+		const float* filters = m_filters.getData();
+		float* buffer = m_buffer.getData();
+		sl_size stride = m_nBufferCapacity;
+		sl_size nBuffered = m_nBuffered;
+		sl_size pos = m_pos;
+		sl_uint32 frac = m_frac;
+		
+		sl_size nOutput = 0;
+		while (pos + H < nBuffered) {
+			sl_uint32 iPhase;
+			if (nPhases == L) {
+				iPhase = frac;
+			} else {
+				iPhase = (sl_uint32)(((sl_uint64)frac * nPhases + (L >> 1)) / L);
+			}
+			const float* h = filters + iPhase * nTaps;
+			const float* x = buffer + pos + 1 - H;
+			for (sl_uint32 iChannel = 0; iChannel < nChannels; iChannel++) {
+				*(output++) = _priv_AudioResampler_dot(x, h, nTaps);
+				x += stride;
+			}
+			nOutput++;
+			frac += M;
+			if (frac >= L) {
+				pos += frac / L;
+				frac %= L;
+			}
+		}
+		
+		// drop the samples which are not needed any more
+		sl_size nDrop = pos + 1 - H;
+		if (nDrop > nBuffered) {
+			nDrop = nBuffered;
+		}
+		if (nDrop) {
+			for (sl_uint32 iChannel = 0; iChannel < nChannels; iChannel++) {
+				float* p = buffer + iChannel * stride;
+				Base::moveMemory(p, p + nDrop, (nBuffered - nDrop) * sizeof(float));
+			}
+			nBuffered -= nDrop;
+			pos -= nDrop;
+		}
+		
+		m_nBuffered = nBuffered;
+		m_pos = pos;
+		m_frac = frac;
+		return nOutput;
+	}
+
+	sl_size AudioResampler::process(const float* input, sl_size countInput, float* output)
+	{
+		sl_uint32 nChannels = m_nChannels;
+		sl_size nOutput = 0;
+		while (countInput > 0) {
+			sl_size n = countInput;
+			if (n > _PRIV_AUDIO_RESAMPLER_CHUNK) {
+				n = _PRIV_AUDIO_RESAMPLER_CHUNK;
+			}
+			_priv_AudioResampler_deinterleave(input, n, nChannels, m_buffer.getData() + m_nBuffered, m_nBufferCapacity);
+			nOutput += _processPlanar(n, output + nOutput * nChannels);
+			input += n * nChannels;
+			countInput -= n;
+		}
+		return nOutput;
+	}
+
+	sl_size AudioResampler::process(const sl_int16* input, sl_size countInput, sl_int16* output)
+	{
+		sl_uint32 nChannels = m_nChannels;
+		float* bufOutput = m_bufOutput.getData();
+		sl_size nOutput = 0;
+		while (countInput > 0) {
+			sl_size n = countInput;
+			if (n > _PRIV_AUDIO_RESAMPLER_CHUNK) {
+				n = _PRIV_AUDIO_RESAMPLER_CHUNK;
+			}
+			_priv_AudioResampler_deinterleave(input, n, nChannels, m_buffer.getData() + m_nBuffered, m_nBufferCapacity);
+			sl_size m = _processPlanar(n, bufOutput);
+			AudioUtil::convertSamples(m * nChannels, bufOutput, output + nOutput * nChannels);
+			nOutput += m;
+			input += n * nChannels;
+			countInput -= n;
+		}
+		return nOutput;
+	}
+
+	sl_size AudioResampler::process(const AudioData& input, const AudioData& output)
+	{
+		sl_uint32 nChannels = m_nChannels;
+		if (nChannels != 1 && nChannels != 2) {
+			return 0;
+		}
+		if (input.format == AudioFormat::None || output.format == AudioFormat::None) {
+			return 0;
+		}
+		float samples[_PRIV_AUDIO_RESAMPLER_CHUNK * 2];
+		AudioData temp;
+		temp.format = nChannels == 1 ? AudioFormat::Float_Mono : AudioFormat::Float_Stereo;
+		temp.data = samples;
+		AudioData tempOutput;
+		tempOutput.format = temp.format;
+		tempOutput.data = m_bufOutput.getData();
+		
+		sl_size nInput = 0;
+		sl_size nOutput = 0;
+		while (nInput < input.count) {
+			sl_size n = input.count - nInput;
+			if (n > _PRIV_AUDIO_RESAMPLER_CHUNK) {
+				n = _PRIV_AUDIO_RESAMPLER_CHUNK;
+			}
+			temp.count = n;
+			temp.copySamplesFrom(_priv_AudioResampler_getSubData(input, nInput, n), n);
+			_priv_AudioResampler_deinterleave(samples, n, nChannels, m_buffer.getData() + m_nBuffered, m_nBufferCapacity);
+			sl_size m = _processPlanar(n, m_bufOutput.getData());
+			if (nOutput + m > output.count) {
+				m = output.count - nOutput;
+			}
+			if (m) {
+				tempOutput.count = m;
+				_priv_AudioResampler_getSubData(output, nOutput, m).copySamplesFrom(tempOutput, m);
+				nOutput += m;
+			}
+			nInput += n;
+		}
+		return nOutput;
+	}
+
+}
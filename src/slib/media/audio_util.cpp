@@ -10,6 +10,14 @@
 
 #include "slib/media/audio_util.h"
 
+#if defined(SLIB_ARCH_IS_X64) || (defined(SLIB_ARCH_IS_X86) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#	define _PRIV_AUDIO_USE_SSE2
+#	include <immintrin.h>
+#elif defined(SLIB_ARCH_IS_ARM64) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+#	define _PRIV_AUDIO_USE_NEON
+#	include <arm_neon.h>
+#endif
+
 #define _DEFINE_CONVERT_SAMPLES(TYPE_IN, TYPE_OUT) \
 	void AudioUtil::convertSamples(sl_size count, const TYPE_IN* in, TYPE_OUT* out) \
 	{ \
@@ -18,26 +26,32 @@
 		} \
 	}
 
+// vectorized main loop (`_PRIV_AUDIO_CONVERT_BODY` consumes `STEP` samples from `i`), followed by the scalar tail
+#define _DEFINE_CONVERT_SAMPLES_SIMD(TYPE_IN, TYPE_OUT, STEP) \
+	void AudioUtil::convertSamples(sl_size count, const TYPE_IN* in, TYPE_OUT* out) \
+	{ \
+		sl_size i = 0; \
+		for (; i + STEP <= count; i += STEP) { \
+			_PRIV_AUDIO_CONVERT_BODY \
+		} \
+		for (; i < count; i++) { \
+			convertSample(in[i], out[i]); \
+		} \
+	}
+
 namespace slib
 {
 
 	_DEFINE_CONVERT_SAMPLES(sl_int8, sl_int8)
 	_DEFINE_CONVERT_SAMPLES(sl_int8, sl_uint8)
-	_DEFINE_CONVERT_SAMPLES(sl_int8, sl_int16)
 	_DEFINE_CONVERT_SAMPLES(sl_int8, sl_uint16)
-	_DEFINE_CONVERT_SAMPLES(sl_int8, float)
 
 	_DEFINE_CONVERT_SAMPLES(sl_uint8, sl_int8)
 	_DEFINE_CONVERT_SAMPLES(sl_uint8, sl_uint8)
-	_DEFINE_CONVERT_SAMPLES(sl_uint8, sl_int16)
 	_DEFINE_CONVERT_SAMPLES(sl_uint8, sl_uint16)
-	_DEFINE_CONVERT_SAMPLES(sl_uint8, float)
 
-	_DEFINE_CONVERT_SAMPLES(sl_int16, sl_int8)
-	_DEFINE_CONVERT_SAMPLES(sl_int16, sl_uint8)
 	_DEFINE_CONVERT_SAMPLES(sl_int16, sl_int16)
 	_DEFINE_CONVERT_SAMPLES(sl_int16, sl_uint16)
-	_DEFINE_CONVERT_SAMPLES(sl_int16, float)
 
 	_DEFINE_CONVERT_SAMPLES(sl_uint16, sl_int8)
 	_DEFINE_CONVERT_SAMPLES(sl_uint16, sl_uint8)
@@ -45,10 +59,403 @@ namespace slib
 	_DEFINE_CONVERT_SAMPLES(sl_uint16, sl_uint16)
 	_DEFINE_CONVERT_SAMPLES(sl_uint16, float)
 
+	_DEFINE_CONVERT_SAMPLES(float, sl_uint16)
+	_DEFINE_CONVERT_SAMPLES(float, float)
+
+#if defined(_PRIV_AUDIO_USE_SSE2)
+
+	// the results are identical to `convertSample`: power-of-two scales are exact, and clamping before the truncation gives the same integers as clamping after it
+
+	SLIB_INLINE static __m128i _priv_AudioUtil_floatToS16(const float* in, __m128 scale, __m128 vMin, __m128 vMax)
+	{
+		__m128 f0 = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in), scale), vMin), vMax);
+		__m128 f1 = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + 4), scale), vMin), vMax);
+		return _mm_packs_epi32(_mm_cvttps_epi32(f0), _mm_cvttps_epi32(f1));
+	}
+
+	SLIB_INLINE static __m128i _priv_AudioUtil_floatToS8(const float* in)
+	{
+		__m128 scale = _mm_set1_ps(128.0f);
+		__m128 vMin = _mm_set1_ps(-128.0f);
+		__m128 vMax = _mm_set1_ps(127.0f);
+		__m128i a = _priv_AudioUtil_floatToS16(in, scale, vMin, vMax);
+		__m128i b = _priv_AudioUtil_floatToS16(in + 8, scale, vMin, vMax);
+		return _mm_packs_epi16(a, b);
+	}
+
+	SLIB_INLINE static void _priv_AudioUtil_S16ToFloat(__m128i v, float* out, __m128 scale)
+	{
+		__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+		__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+		_mm_storeu_ps(out, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+		_mm_storeu_ps(out + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+	}
+
+	SLIB_INLINE static void _priv_AudioUtil_S8ToFloat(__m128i v, float* out)
+	{
+		__m128 scale = _mm_set1_ps(1.0f / 128.0f);
+		_priv_AudioUtil_S16ToFloat(_mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8), out, scale);
+		_priv_AudioUtil_S16ToFloat(_mm_srai_epi16(_mm_unpackhi_epi8(v, v), 8), out + 8, scale);
+	}
+
+#	define _PRIV_AUDIO_CONVERT_BODY \
+		__m128i v = _mm_loadu_si128((const __m128i*)(in + i)); \
+		_mm_storeu_si128((__m128i*)(out + i), _mm_unpacklo_epi8(_mm_setzero_si128(), v)); \
+		_mm_storeu_si128((__m128i*)(out + i + 8), _mm_unpackhi_epi8(_mm_setzero_si128(), v));
+	_DEFINE_CONVERT_SAMPLES_SIMD(sl_int8, sl_int16, 16)
+#	undef _PRIV_AUDIO_CONVERT_BODY
+
+#	define _PRIV_AUDIO_CONVERT_BODY \
+		__m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(in + i)), _mm_set1_epi8((char)0x80)); \
+		_mm_storeu_si128((__m128i*)(out + i), _mm_unpacklo_epi8(_mm_setzero_si128(), v)); \
+		_mm_storeu_si128((__m128i*)(out + i + 8), _mm_unpackhi_epi8(_mm_setzero_si128(), v));
+	_DEFINE_CONVERT_SAMPLES_SIMD(sl_uint8, sl_int16, 16)
+#	undef _PRIV_AUDIO_CONVERT_BODY
+
+#	define _PRIV_AUDIO_CONVERT_BODY \
+		_priv_AudioUtil_S8ToFloat(_mm_loadu_si128((const __m128i*)(in + i)), out + i);
+	_DEFINE_CONVERT_SAMPLES_SIMD(sl_int8, float, 16)
+#	undef _PRIV_AUDIO_CONVERT_BODY
+
+#	define _PRIV_AUDIO_CONVERT_BODY \
+		_priv_AudioUtil_S8ToFloat(_mm_xor_si128(_mm_loadu_si128((const __m128i*)(in + i)), _mm_set1_epi8((char)0x80)), out + i);
+	_DEFINE_CONVERT_SAMPLES_SIMD(sl_uint8, float, 16)
+#	undef _PRIV_AUDIO_CONVERT_BODY
+
+#	define _PRIV_AUDIO_CONVERT_BODY \
+		__m128i a = _mm_srai_epi16(_mm_loadu_si128((const __m128i*)(in + i)), 8); \
+		__m128i b = _mm_srai_epi16(_mm_loadu_si128((const __m128i*)(in + i + 8)), 8); \
+		_mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi16(a, b));
+	_DEFINE_CONVERT_SAMPLES_SIMD(sl_int16, sl_int8, 16)
+#	undef _PRIV_AUDIO_CONVERT_BODY
+
+#	define _PRIV_AUDIO_CONVERT_BODY \
+		__m128i a = _mm_srai_epi16(_mm_loadu_si128((const __m128i*)(in + i)), 8); \
+		__m128i b = _mm_srai_epi16(_mm_loadu_si128((const __m128i*)(in + i + 8)), 8); \
+		_mm_storeu_si128((__m128i*)(out + i), _mm_xor_si128(_mm_packs_epi16(a, b), _mm_set1_epi8((char)0x80)));
+	_DEFINE_CONVERT_SAMPLES_SIMD(sl_int16, sl_uint8, 16)
+#	undef _PRIV_AUDIO_CONVERT_BODY
+
+#	define _PRIV_AUDIO_CONVERT_BODY \
+		_priv_AudioUtil_S16ToFloat(_mm_loadu_si128((const __m128i*)(in + i)), out + i, _mm_set1_ps(1.0f / 32768.0f));
+	_DEFINE_CONVERT_SAMPLES_SIMD(sl_int16, float, 8)
+#	undef _PRIV_AUDIO_CONVERT_BODY
+
+#	define _PRIV_AUDIO_CONVERT_BODY \
+		_mm_storeu_si128((__m128i*)(out + i), _priv_AudioUtil_floatToS8(in + i));
+	_DEFINE_CONVERT_SAMPLES_SIMD(float, sl_int8, 16)
+#	undef _PRIV_AUDIO_CONVERT_BODY
+
+#	define _PRIV_AUDIO_CONVERT_BODY \
+		_mm_storeu_si128((__m128i*)(out + i), _mm_xor_si128(_priv_AudioUtil_floatToS8(in + i), _mm_set1_epi8((char)0x80)));
+	_DEFINE_CONVERT_SAMPLES_SIMD(float, sl_uint8, 16)
+#	undef _PRIV_AUDIO_CONVERT_BODY
+
+#	define _PRIV_AUDIO_CONVERT_BODY \
+		_mm_storeu_si128((__m128i*)(out + i), _priv_AudioUtil_floatToS16(in + i, _mm_set1_ps(32768.0f), _mm_set1_ps(-32768.0f), _mm_set1_ps(32767.0f)));
+	_DEFINE_CONVERT_SAMPLES_SIMD(float, sl_int16, 8)
+#	undef _PRIV_AUDIO_CONVERT_BODY
+
+	void AudioUtil::mixSamples(sl_size count, const sl_int16* in1, const sl_int16* in2, sl_int16* out)
+	{
+		sl_size i = 0;
+		for (; i + 8 <= count; i += 8) {
+			__m128i a = _mm_loadu_si128((const __m128i*)(in1 + i));
+			__m128i b = _mm_loadu_si128((const __m128i*)(in2 + i));
+			// (a + b) >> 1 without overflow: (a >> 1) + (b >> 1) + (a & b & 1)
+			__m128i c = _mm_add_epi16(_mm_add_epi16(_mm_srai_epi16(a, 1), _mm_srai_epi16(b, 1)), _mm_and_si128(_mm_and_si128(a, b), _mm_set1_epi16(1)));
+			_mm_storeu_si128((__m128i*)(out + i), c);
+		}
+		for (; i < count; i++) {
+			mixSamples(in1[i], in2[i], out[i]);
+		}
+	}
+
+	void AudioUtil::mixSamples(sl_size count, const float* in1, const float* in2, float* out)
+	{
+		sl_size i = 0;
+		__m128 half = _mm_set1_ps(0.5f);
+		for (; i + 4 <= count; i += 4) {
+			_mm_storeu_ps(out + i, _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(in1 + i), _mm_loadu_ps(in2 + i)), half));
+		}
+		for (; i < count; i++) {
+			mixSamples(in1[i], in2[i], out[i]);
+		}
+	}
+
+	void AudioUtil::mixStereoToMono(sl_size count, const sl_int16* in, sl_int16* out)
+	{
+		sl_size i = 0;
+		__m128i ones = _mm_set1_epi16(1);
+		for (; i + 8 <= count; i += 8) {
+			__m128i a = _mm_srai_epi32(_mm_madd_epi16(_mm_loadu_si128((const __m128i*)(in + (i << 1))), ones), 1);
+			__m128i b = _mm_srai_epi32(_mm_madd_epi16(_mm_loadu_si128((const __m128i*)(in + (i << 1) + 8)), ones), 1);
+			_mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi32(a, b));
+		}
+		for (; i < count; i++) {
+			mixSamples(in[i << 1], in[(i << 1) + 1], out[i]);
+		}
+	}
+
+	void AudioUtil::mixStereoToMono(sl_size count, const float* in, float* out)
+	{
+		sl_size i = 0;
+		__m128 half = _mm_set1_ps(0.5f);
+		for (; i + 4 <= count; i += 4) {
+			__m128 a = _mm_loadu_ps(in + (i << 1));
+			__m128 b = _mm_loadu_ps(in + (i << 1) + 4);
+			__m128 l = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+			__m128 r = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+			_mm_storeu_ps(out + i, _mm_mul_ps(_mm_add_ps(l, r), half));
+		}
+		for (; i < count; i++) {
+			mixSamples(in[i << 1], in[(i << 1) + 1], out[i]);
+		}
+	}
+
+	void AudioUtil::copyMonoToStereo(sl_size count, const sl_int16* in, sl_int16* out)
+	{
+		sl_size i = 0;
+		for (; i + 8 <= count; i += 8) {
+			__m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+			_mm_storeu_si128((__m128i*)(out + (i << 1)), _mm_unpacklo_epi16(v, v));
+			_mm_storeu_si128((__m128i*)(out + (i << 1) + 8), _mm_unpackhi_epi16(v, v));
+		}
+		for (; i < count; i++) {
+			out[i << 1] = out[(i << 1) + 1] = in[i];
+		}
+	}
+
+	void AudioUtil::copyMonoToStereo(sl_size count, const float* in, float* out)
+	{
+		sl_size i = 0;
+		for (; i + 4 <= count; i += 4) {
+			__m128 v = _mm_loadu_ps(in + i);
+			_mm_storeu_ps(out + (i << 1), _mm_unpacklo_ps(v, v));
+			_mm_storeu_ps(out + (i << 1) + 4, _mm_unpackhi_ps(v, v));
+		}
+		for (; i < count; i++) {
+			out[i << 1] = out[(i << 1) + 1] = in[i];
+		}
+	}
+
+#elif defined(_PRIV_AUDIO_USE_NEON)
+
+	SLIB_INLINE static int16x8_t _priv_AudioUtil_floatToS16(const float* in, float scale, float fMin, float fMax)
+	{
+		float32x4_t vMin = vdupq_n_f32(fMin);
+		float32x4_t vMax = vdupq_n_f32(fMax);
+		float32x4_t f0 = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(in), scale), vMin), vMax);
+		float32x4_t f1 = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(in + 4), scale), vMin), vMax);
+		return vcombine_s16(vmovn_s32(vcvtq_s32_f32(f0)), vmovn_s32(vcvtq_s32_f32(f1)));
+	}
+
+	SLIB_INLINE static int8x16_t _priv_AudioUtil_floatToS8(const float* in)
+	{
+		int16x8_t a = _priv_AudioUtil_floatToS16(in, 128.0f, -128.0f, 127.0f);
+		int16x8_t b = _priv_AudioUtil_floatToS16(in + 8, 128.0f, -128.0f, 127.0f);
+		return vcombine_s8(vmovn_s16(a), vmovn_s16(b));
+	}
+
+	SLIB_INLINE static void _priv_AudioUtil_S16ToFloat(int16x8_t v, float* out, float scale)
+	{
+		vst1q_f32(out, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+		vst1q_f32(out + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+	}
+
+	SLIB_INLINE static void _priv_AudioUtil_S8ToFloat(int8x16_t v, float* out)
+	{
+		_priv_AudioUtil_S16ToFloat(vmovl_s8(vget_low_s8(v)), out, 1.0f / 128.0f);
+		_priv_AudioUtil_S16ToFloat(vmovl_s8(vget_high_s8(v)), out + 8, 1.0f / 128.0f);
+	}
+
+	SLIB_INLINE static int8x16_t _priv_AudioUtil_loadU8AsS8(const sl_uint8* in)
+	{
+		return vreinterpretq_s8_u8(veorq_u8(vld1q_u8(in), vdupq_n_u8(0x80)));
+	}
+
+#	define _PRIV_AUDIO_CONVERT_BODY \
+		int8x16_t v = vld1q_s8(in + i); \
+		vst1q_s16(out + i, vshlq_n_s16(vmovl_s8(vget_low_s8(v)), 8)); \
+		vst1q_s16(out + i + 8, vshlq_n_s16(vmovl_s8(vget_high_s8(v)), 8));
+	_DEFINE_CONVERT_SAMPLES_SIMD(sl_int8, sl_int16, 16)
+#	undef _PRIV_AUDIO_CONVERT_BODY
+
+#	define _PRIV_AUDIO_CONVERT_BODY \
+		int8x16_t v = _priv_AudioUtil_loadU8AsS8(in + i); \
+		vst1q_s16(out + i, vshlq_n_s16(vmovl_s8(vget_low_s8(v)), 8)); \
+		vst1q_s16(out + i + 8, vshlq_n_s16(vmovl_s8(vget_high_s8(v)), 8));
+	_DEFINE_CONVERT_SAMPLES_SIMD(sl_uint8, sl_int16, 16)
+#	undef _PRIV_AUDIO_CONVERT_BODY
+
+#	define _PRIV_AUDIO_CONVERT_BODY \
+		_priv_AudioUtil_S8ToFloat(vld1q_s8(in + i), out + i);
+	_DEFINE_CONVERT_SAMPLES_SIMD(sl_int8, float, 16)
+#	undef _PRIV_AUDIO_CONVERT_BODY
+
+#	define _PRIV_AUDIO_CONVERT_BODY \
+		_priv_AudioUtil_S8ToFloat(_priv_AudioUtil_loadU8AsS8(in + i), out + i);
+	_DEFINE_CONVERT_SAMPLES_SIMD(sl_uint8, float, 16)
+#	undef _PRIV_AUDIO_CONVERT_BODY
+
+#	define _PRIV_AUDIO_CONVERT_BODY \
+		vst1q_s8(out + i, vcombine_s8(vshrn_n_s16(vld1q_s16(in + i), 8), vshrn_n_s16(vld1q_s16(in + i + 8), 8)));
+	_DEFINE_CONVERT_SAMPLES_SIMD(sl_int16, sl_int8, 16)
+#	undef _PRIV_AUDIO_CONVERT_BODY
+
+#	define _PRIV_AUDIO_CONVERT_BODY \
+		int8x16_t v = vcombine_s8(vshrn_n_s16(vld1q_s16(in + i), 8), vshrn_n_s16(vld1q_s16(in + i + 8), 8)); \
+		vst1q_u8(out + i, veorq_u8(vreinterpretq_u8_s8(v), vdupq_n_u8(0x80)));
+	_DEFINE_CONVERT_SAMPLES_SIMD(sl_int16, sl_uint8, 16)
+#	undef _PRIV_AUDIO_CONVERT_BODY
+
+#	define _PRIV_AUDIO_CONVERT_BODY \
+		_priv_AudioUtil_S16ToFloat(vld1q_s16(in + i), out + i, 1.0f / 32768.0f);
+	_DEFINE_CONVERT_SAMPLES_SIMD(sl_int16, float, 8)
+#	undef _PRIV_AUDIO_CONVERT_BODY
+
+#	define _PRIV_AUDIO_CONVERT_BODY \
+		vst1q_s8(out + i, _priv_AudioUtil_floatToS8(in + i));
+	_DEFINE_CONVERT_SAMPLES_SIMD(float, sl_int8, 16)
+#	undef _PRIV_AUDIO_CONVERT_BODY
+
+#	define _PRIV_AUDIO_CONVERT_BODY \
+		vst1q_u8(out + i, veorq_u8(vreinterpretq_u8_s8(_priv_AudioUtil_floatToS8(in + i)), vdupq_n_u8(0x80)));
+	_DEFINE_CONVERT_SAMPLES_SIMD(float, sl_uint8, 16)
+#	undef _PRIV_AUDIO_CONVERT_BODY
+
+#	define _PRIV_AUDIO_CONVERT_BODY \
+		vst1q_s16(out + i, _priv_AudioUtil_floatToS16(in + i, 32768.0f, -32768.0f, 32767.0f));
+	_DEFINE_CONVERT_SAMPLES_SIMD(float, sl_int16, 8)
+#	undef _PRIV_AUDIO_CONVERT_BODY
+
+	void AudioUtil::mixSamples(sl_size count, const sl_int16* in1, const sl_int16* in2, sl_int16* out)
+	{
+		sl_size i = 0;
+		for (; i + 8 <= count; i += 8) {
+			vst1q_s16(out + i, vhaddq_s16(vld1q_s16(in1 + i), vld1q_s16(in2 + i)));
+		}
+		for (; i < count; i++) {
+			mixSamples(in1[i], in2[i], out[i]);
+		}
+	}
+
+	void AudioUtil::mixSamples(sl_size count, const float* in1, const float* in2, float* out)
+	{
+		sl_size i = 0;
+		for (; i + 4 <= count; i += 4) {
+			vst1q_f32(out + i, vmulq_n_f32(vaddq_f32(vld1q_f32(in1 + i), vld1q_f32(in2 + i)), 0.5f));
+		}
+		for (; i < count; i++) {
+			mixSamples(in1[i], in2[i], out[i]);
+		}
+	}
+
+	void AudioUtil::mixStereoToMono(sl_size count, const sl_int16* in, sl_int16* out)
+	{
+		sl_size i = 0;
+		for (; i + 8 <= count; i += 8) {
+			int16x8x2_t v = vld2q_s16(in + (i << 1));
+			vst1q_s16(out + i, vhaddq_s16(v.val[0], v.val[1]));
+		}
+		for (; i < count; i++) {
+			mixSamples(in[i << 1], in[(i << 1) + 1], out[i]);
+		}
+	}
+
+	void AudioUtil::mixStereoToMono(sl_size count, const float* in, float* out)
+	{
+		sl_size i = 0;
+		for (; i + 4 <= count; i += 4) {
+			float32x4x2_t v = vld2q_f32(in + (i << 1));
+			vst1q_f32(out + i, vmulq_n_f32(vaddq_f32(v.val[0], v.val[1]), 0.5f));
+		}
+		for (; i < count; i++) {
+			mixSamples(in[i << 1], in[(i << 1) + 1], out[i]);
+		}
+	}
+
+	void AudioUtil::copyMonoToStereo(sl_size count, const sl_int16* in, sl_int16* out)
+	{
+		sl_size i = 0;
+		for (; i + 8 <= count; i += 8) {
+			int16x8x2_t v;
+			v.val[0] = v.val[1] = vld1q_s16(in + i);
+			vst2q_s16(out + (i << 1), v);
+		}
+		for (; i < count; i++) {
+			out[i << 1] = out[(i << 1) + 1] = in[i];
+		}
+	}
+
+	void AudioUtil::copyMonoToStereo(sl_size count, const float* in, float* out)
+	{
+		sl_size i = 0;
+		for (; i + 4 <= count; i += 4) {
+			float32x4x2_t v;
+			v.val[0] = v.val[1] = vld1q_f32(in + i);
+			vst2q_f32(out + (i << 1), v);
+		}
+		for (; i < count; i++) {
+			out[i << 1] = out[(i << 1) + 1] = in[i];
+		}
+	}
+
+#else
+
+	_DEFINE_CONVERT_SAMPLES(sl_int8, sl_int16)
+	_DEFINE_CONVERT_SAMPLES(sl_int8, float)
+	_DEFINE_CONVERT_SAMPLES(sl_uint8, sl_int16)
+	_DEFINE_CONVERT_SAMPLES(sl_uint8, float)
+	_DEFINE_CONVERT_SAMPLES(sl_int16, sl_int8)
+	_DEFINE_CONVERT_SAMPLES(sl_int16, sl_uint8)
+	_DEFINE_CONVERT_SAMPLES(sl_int16, float)
 	_DEFINE_CONVERT_SAMPLES(float, sl_int8)
 	_DEFINE_CONVERT_SAMPLES(float, sl_uint8)
 	_DEFINE_CONVERT_SAMPLES(float, sl_int16)
-	_DEFINE_CONVERT_SAMPLES(float, sl_uint16)
-	_DEFINE_CONVERT_SAMPLES(float, float)
+
+	void AudioUtil::mixSamples(sl_size count, const sl_int16* in1, const sl_int16* in2, sl_int16* out)
+	{
+		for (sl_size i = 0; i < count; i++) {
+			mixSamples(in1[i], in2[i], out[i]);
+		}
+	}
+
+	void AudioUtil::mixSamples(sl_size count, const float* in1, const float* in2, float* out)
+	{
+		for (sl_size i = 0; i < count; i++) {
+			mixSamples(in1[i], in2[i], out[i]);
+		}
+	}
+
+	void AudioUtil::mixStereoToMono(sl_size count, const sl_int16* in, sl_int16* out)
+	{
+		for (sl_size i = 0; i < count; i++) {
+			mixSamples(in[i << 1], in[(i << 1) + 1], out[i]);
+		}
+	}
+
+	void AudioUtil::mixStereoToMono(sl_size count, const float* in, float* out)
+	{
+		for (sl_size i = 0; i < count; i++) {
+			mixSamples(in[i << 1], in[(i << 1) + 1], out[i]);
+		}
+	}
+
+	void AudioUtil::copyMonoToStereo(sl_size count, const sl_int16* in, sl_int16* out)
+	{
+		for (sl_size i = 0; i < count; i++) {
+			out[i << 1] = out[(i << 1) + 1] = in[i];
+		}
+	}
+
+	void AudioUtil::copyMonoToStereo(sl_size count, const float* in, float* out)
+	{
+		for (sl_size i = 0; i < count; i++) {
+			out[i << 1] = out[(i << 1) + 1] = in[i];
+		}
+	}
+
+#endif
 
 }
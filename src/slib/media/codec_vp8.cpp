@@ -13,6 +13,7 @@
 #include "slib/core/log.h"
 #include "slib/core/io.h"
 #include "slib/core/scoped.h"
+#include "slib/core/mio.h"
 
 #include "thirdparty/libvpx/vpx1.4/vpx_config.h"
 #include "thirdparty/libvpx/vpx1.4/vpx/vp8cx.h"
@@ -22,6 +23,9 @@
 
 typedef vpx_codec_iface_t *(*vpx_codec_interface)(void);
 
+// frame packets written for one input frame
+#define _PRIV_VP8_MAX_PACKETS 8
+
 namespace slib
 {
 
@@ -168,10 +172,39 @@ namespace slib
 			return sl_null;
 		}
 
-		Memory encode(const VideoFrame& input) override
+		sl_bool _encodeFrame(const VideoFrame& input)
 		{
-			if (m_nWidth == input.image.width && m_nHeight == input.image.height) {
-				
+			if (m_nWidth != input.image.width || m_nHeight != input.image.height) {
+				logError("VideoFrame size is wrong.");
+				return sl_false;
+			}
+			
+			vpx_image_t* image = m_codec_image;
+			vpx_image_t imageWrap;
+			
+			BitmapData src(input.image);
+			src.fillDefaultValues();
+			if ((src.format == BitmapFormat::YUV_I420 || src.format == BitmapFormat::YUV_YV12) && src.data && src.pitch > 0 && src.pitch1 > 0 && src.pitch2 > 0) {
+				// the encoder copies the frame into its own buffer, so the planes of the input can be used directly
+				imageWrap = *m_codec_image;
+				imageWrap.img_data = sl_null;
+				imageWrap.img_data_owner = 0;
+				imageWrap.self_allocd = 0;
+				imageWrap.planes[VPX_PLANE_Y] = (unsigned char*)(src.data);
+				imageWrap.stride[VPX_PLANE_Y] = src.pitch;
+				if (src.format == BitmapFormat::YUV_I420) {
+					imageWrap.planes[VPX_PLANE_U] = (unsigned char*)(src.data1);
+					imageWrap.stride[VPX_PLANE_U] = src.pitch1;
+					imageWrap.planes[VPX_PLANE_V] = (unsigned char*)(src.data2);
+					imageWrap.stride[VPX_PLANE_V] = src.pitch2;
+				} else {
+					imageWrap.planes[VPX_PLANE_U] = (unsigned char*)(src.data2);
+					imageWrap.stride[VPX_PLANE_U] = src.pitch2;
+					imageWrap.planes[VPX_PLANE_V] = (unsigned char*)(src.data1);
+					imageWrap.stride[VPX_PLANE_V] = src.pitch1;
+				}
+				image = &imageWrap;
+			} else {
 				BitmapData dst;
 				dst.width = m_codec_image->w;
 				dst.height = m_codec_image->h;
@@ -184,35 +217,75 @@ namespace slib
 				dst.pitch2 = m_codec_image->stride[2];
 				
 				dst.copyPixelsFrom(input.image);
-				
-				sl_int32 flags = 0;
-				if (m_nProcessFrameCount > 0 && m_nProcessFrameCount % m_nKeyFrameInterval == 0) {
-					flags |= VPX_EFLAG_FORCE_KF;
-				}
-				vpx_codec_err_t res = vpx_codec_encode(m_codec, m_codec_image, m_nProcessFrameCount++, 1, flags, VPX_DL_REALTIME);
-				if (res == VPX_CODEC_OK) {
-					vpx_codec_iter_t iter = sl_null;
-					const vpx_codec_cx_pkt_t *pkt = sl_null;
-					MemoryWriter encodeWriter;
-
-					while ((pkt = vpx_codec_get_cx_data(m_codec, &iter)) != sl_null) {
-						if (pkt->kind == VPX_CODEC_CX_FRAME_PKT) {
-							//const int keyframe = (pkt->data.frame.flags & VPX_FRAME_IS_KEY) != 0;
-							encodeWriter.writeInt64(pkt->data.frame.pts);
-							encodeWriter.writeInt64(pkt->data.frame.sz);
-							encodeWriter.write(pkt->data.frame.buf, pkt->data.frame.sz);
-						}
+			}
+			
+			sl_int32 flags = 0;
+			if (m_nProcessFrameCount > 0 && m_nProcessFrameCount % m_nKeyFrameInterval == 0) {
+				flags |= VPX_EFLAG_FORCE_KF;
+			}
+			vpx_codec_err_t res = vpx_codec_encode(m_codec, image, m_nProcessFrameCount++, 1, flags, VPX_DL_REALTIME);
+			if (res == VPX_CODEC_OK) {
+				return sl_true;
+			}
+			logError("Failed to encode bitmap data.");
+			return sl_false;
+		}
+		
+		// each packet is written as [pts: 8 bytes][size: 8 bytes][data]. `output` is allocated when `pMemory` is not null
+		sl_size _writePackets(void* output, sl_size sizeOutput, Memory* pMemory)
+		{
+			const vpx_codec_cx_pkt_t* packets[_PRIV_VP8_MAX_PACKETS];
+			sl_uint32 nPackets = 0;
+			sl_size size = 0;
+			vpx_codec_iter_t iter = sl_null;
+			const vpx_codec_cx_pkt_t *pkt = sl_null;
+			while ((pkt = vpx_codec_get_cx_data(m_codec, &iter)) != sl_null) {
+				if (pkt->kind == VPX_CODEC_CX_FRAME_PKT) {
+					if (nPackets < _PRIV_VP8_MAX_PACKETS) {
+						packets[nPackets++] = pkt;
+						size += 16 + pkt->data.frame.sz;
 					}
-
-					return encodeWriter.getData();
-					
-				} else {
-					logError("Failed to encode bitmap data.");
 				}
-			} else {
-				logError("VideoFrame size is wrong.");
 			}
-			return sl_null;
+			if (!size) {
+				return 0;
+			}
+			if (pMemory) {
+				Memory mem = Memory::create(size);
+				if (mem.isNull()) {
+					return 0;
+				}
+				*pMemory = mem;
+				output = mem.getData();
+			} else if (size > sizeOutput) {
+				return 0;
+			}
+			sl_uint8* p = (sl_uint8*)output;
+			for (sl_uint32 i = 0; i < nPackets; i++) {
+				pkt = packets[i];
+				MIO::writeInt64LE(p, pkt->data.frame.pts);
+				MIO::writeInt64LE(p + 8, pkt->data.frame.sz);
+				Base::copyMemory(p + 16, pkt->data.frame.buf, pkt->data.frame.sz);
+				p += 16 + pkt->data.frame.sz;
+			}
+			return size;
+		}
+
+		Memory encode(const VideoFrame& input) override
+		{
+			Memory ret;
+			if (_encodeFrame(input)) {
+				_writePackets(sl_null, 0, &ret);
+			}
+			return ret;
+		}
+		
+		sl_size encode(const VideoFrame& input, void* output, sl_size sizeOutput) override
+		{
+			if (_encodeFrame(input)) {
+				return _writePackets(output, sizeOutput, sl_null);
+			}
+			return 0;
 		}
 
 		void setBitrate(sl_uint32 _bitrate) override
@@ -308,13 +381,17 @@ namespace slib
 			}
 		}
 
-		sl_bool decode(const void* input, const sl_uint32& inputSize , VideoFrame& output)
+		sl_bool decode(const void* input, const sl_uint32& inputSize, VideoFrame& output) override
 		{
-			MemoryReader reader(input, inputSize);
-			sl_int64 pts = reader.readInt64();
-			SLIB_UNUSED(pts);
-			sl_int64 size = reader.readInt64();
+			if (inputSize < 16) {
+				return sl_false;
+			}
+			sl_int64 size = MIO::readInt64LE((sl_uint8*)input + 8);
+			if (size <= 0 || size > (sl_int64)(inputSize - 16)) {
+				return sl_false;
+			}
 
+			sl_bool flagDecoded = sl_false;
 			if (!vpx_codec_decode(m_codec, (sl_uint8*)input + 16, (unsigned int)size, NULL, 0)) {
 				
 				vpx_codec_iter_t iter = NULL;
@@ -323,21 +400,18 @@ namespace slib
 
 				while ((image = vpx_codec_get_frame(m_codec, &iter)) != NULL) {
 					
-					BitmapData src;
-					src.width = image->w;
-					src.height = image->h;
-					src.format = BitmapFormat::YUV_I420;
-					src.data = image->planes[0];
-					src.pitch = image->stride[0];
-					src.data1 = image->planes[1];
-					src.pitch1 = image->stride[1];
-					src.data2 = image->planes[2];
-					src.pitch2 = image->stride[2];
-					
-					output.image.copyPixelsFrom(src);				
+					if (output.image.data) {
+						VideoFrame src;
+						src.setI420(image->d_w, image->d_h, image->planes[0], image->stride[0], image->planes[1], image->stride[1], image->planes[2], image->stride[2]);
+						output.image.copyPixelsFrom(src.image);
+					} else {
+						// refers to the frame buffer of the decoder, valid until the next call
+						output.setI420(image->d_w, image->d_h, image->planes[0], image->stride[0], image->planes[1], image->stride[1], image->planes[2], image->stride[2]);
+					}
+					flagDecoded = sl_true;
 				}
 			}
-			return sl_false;
+			return flagDecoded;
 		}
 	};
 
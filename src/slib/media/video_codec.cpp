@@ -27,6 +27,17 @@ namespace slib
 	{
 	}
 
+	sl_size VideoEncoder::encode(const VideoFrame& input, void* output, sl_size sizeOutput)
+	{
+		Memory mem = encode(input);
+		sl_size size = mem.getSize();
+		if (size && size <= sizeOutput) {
+			Base::copyMemory(output, mem.getData(), size);
+			return size;
+		}
+		return 0;
+	}
+
 	sl_uint32 VideoEncoder::getBitrate()
 	{
 		return m_bitrate;
@@ -23,4 +23,118 @@ namespace slib
 	{
 	}
 
+	void VideoFrame::setI420(sl_uint32 width, sl_uint32 height, const void* dataY, sl_int32 pitchY, const void* dataU, sl_int32 pitchU, const void* dataV, sl_int32 pitchV, const Ref<Referable>& ref)
+	{
+		image.width = width;
+		image.height = height;
+		image.format = BitmapFormat::YUV_I420;
+		image.data = (void*)dataY;
+		image.pitch = pitchY;
+		image.ref = ref;
+		image.data1 = (void*)dataU;
+		image.pitch1 = pitchU;
+		image.ref1.setNull();
+		image.data2 = (void*)dataV;
+		image.pitch2 = pitchV;
+		image.ref2.setNull();
+	}
+
+
+	SLIB_DEFINE_OBJECT(VideoFramePool, Object)
+
+	VideoFramePool::VideoFramePool()
+	{
+		m_width = 0;
+		m_height = 0;
+		m_format = BitmapFormat::None;
+		m_sizeBuffer = 0;
+		m_nMaxBuffers = 0;
+	}
+
+	VideoFramePool::~VideoFramePool()
+	{
+	}
+
+	Ref<VideoFramePool> VideoFramePool::create(sl_uint32 width, sl_uint32 height, BitmapFormat format, sl_uint32 maxBuffersCount)
+	{
+		BitmapData bd;
+		bd.width = width;
+		bd.height = height;
+		bd.format = format;
+		sl_size size = bd.getTotalSize();
+		if (!size) {
+			return sl_null;
+		}
+		Ref<VideoFramePool> ret = new VideoFramePool;
+		if (ret.isNotNull()) {
+			ret->m_width = width;
+			ret->m_height = height;
+			ret->m_format = format;
+			ret->m_sizeBuffer = size;
+			ret->m_nMaxBuffers = maxBuffersCount;
+			return ret;
+		}
+		return sl_null;
+	}
+
+	sl_bool VideoFramePool::getFrame(VideoFrame& frame)
+	{
+		Memory mem;
+		{
+			ObjectLocker lock(&m_buffers);
+			sl_size n = m_buffers.getCount();
+			Memory* buffers = m_buffers.getData();
+			for (sl_size i = 0; i < n; i++) {
+				// only the pool refers to the buffer
+				if (buffers[i].ref->getReferenceCount() == 1) {
+					mem = buffers[i];
+					break;
+				}
+			}
+			if (mem.isNull()) {
+				if (m_nMaxBuffers && n >= m_nMaxBuffers) {
+					return sl_false;
+				}
+				mem = Memory::create(m_sizeBuffer);
+				if (mem.isNull()) {
+					return sl_false;
+				}
+				if (!(m_buffers.add_NoLock(mem))) {
+					return sl_false;
+				}
+			}
+		}
+		BitmapData& image = frame.image;
+		image = BitmapData();
+		image.width = m_width;
+		image.height = m_height;
+		image.format = m_format;
+		image.data = mem.getData();
+		image.ref = mem.ref;
+		image.fillDefaultValues();
+		frame.rotation = RotationMode::Rotate0;
+		frame.flip = FlipMode::None;
+		return sl_true;
+	}
+
+	sl_uint32 VideoFramePool::getWidth() const
+	{
+		return m_width;
+	}
+
+	sl_uint32 VideoFramePool::getHeight() const
+	{
+		return m_height;
+	}
+
+	BitmapFormat VideoFramePool::getFormat() const
+	{
+		return m_format;
+	}
+
+	sl_size VideoFramePool::getBuffersCount() const
+	{
+		return m_buffers.getCount();
+	}
+
 }
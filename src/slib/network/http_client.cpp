@@ -0,0 +1,1225 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "slib/network/http_client.h"
+
+#include "slib/network/url.h"
+#include "slib/network/async.h"
+#include "slib/core/linked_list.h"
+#include "slib/core/math.h"
+#include "slib/core/time.h"
+#include "slib/core/log.h"
+
+#define TAG "HttpClient"
+
+// request bodies up to this size are sent with the header in one packet
+#define SIZE_MERGE_BODY 0x4000
+// idempotent requests are sent again when the connection is closed before their responses
+#define MAX_RETRIES 2
+
+namespace slib
+{
+
+/******************************************************
+			HttpClientLatencyHistogram
+******************************************************/
+
+	HttpClientLatencyHistogram::HttpClientLatencyHistogram()
+	{
+		clear();
+	}
+
+	HttpClientLatencyHistogram::~HttpClientLatencyHistogram()
+	{
+	}
+
+	void HttpClientLatencyHistogram::add(sl_uint64 latency)
+	{
+		if (count == 0 || latency < min) {
+			min = latency;
+		}
+		if (latency > max) {
+			max = latency;
+		}
+		count++;
+		sum += latency;
+		buckets[getBucketIndex(latency)]++;
+	}
+
+	void HttpClientLatencyHistogram::clear()
+	{
+		count = 0;
+		countErrors = 0;
+		sum = 0;
+		min = 0;
+		max = 0;
+		Base::zeroMemory(buckets, sizeof(buckets));
+	}
+
+	sl_uint64 HttpClientLatencyHistogram::getMean() const
+	{
+		if (count) {
+			return sum / count;
+		}
+		return 0;
+	}
+
+	sl_uint64 HttpClientLatencyHistogram::getPercentile(double percent) const
+	{
+		if (!count) {
+			return 0;
+		}
+		sl_uint64 target = (sl_uint64)(Math::ceil((double)count * percent / 100.0));
+		if (target < 1) {
+			target = 1;
+		}
+		if (target > count) {
+			target = count;
+		}
+		sl_uint64 n = 0;
+		for (sl_uint32 i = 0; i < SLIB_HTTP_CLIENT_LATENCY_BUCKETS; i++) {
+			n += buckets[i];
+			if (n >= target) {
+				sl_uint64 bound = getBucketUpperBound(i);
+				if (bound > max) {
+					return max;
+				}
+				if (bound < min) {
+					return min;
+				}
+				return bound;
+			}
+		}
+		return max;
+	}
+
+	sl_uint32 HttpClientLatencyHistogram::getBucketIndex(sl_uint64 latency)
+	{
+		if (latency < 8) {
+			return (sl_uint32)latency;
+		}
+		sl_uint32 nBits = Math::getMostSignificantBits(latency);
+		sl_uint32 index = 8 + ((nBits - 4) << 2) + (sl_uint32)((latency >> (nBits - 3)) & 3);
+		if (index >= SLIB_HTTP_CLIENT_LATENCY_BUCKETS) {
+			return SLIB_HTTP_CLIENT_LATENCY_BUCKETS - 1;
+		}
+		return index;
+	}
+
+	sl_uint64 HttpClientLatencyHistogram::getBucketUpperBound(sl_uint32 index)
+	{
+		if (index < 8) {
+			return index;
+		}
+		if (index >= SLIB_HTTP_CLIENT_LATENCY_BUCKETS - 1) {
+			return SLIB_UINT64_MAX;
+		}
+		index -= 8;
+		sl_uint32 shift = (index >> 2) + 1;
+		return ((sl_uint64)(5 + (index & 3)) << shift) - 1;
+	}
+
+
+/******************************************************
+					HttpClientParam
+******************************************************/
+
+	HttpClientParam::HttpClientParam()
+	{
+		maxConnectionsPerOrigin = 8;
+		maxPipelinedRequests = 1;
+		maxIdleTime = 30000;
+		readBufferSize = 0x10000;
+		maxResponseHeaderSize = 0x10000;
+		flagLogError = sl_true;
+	}
+
+	HttpClientParam::~HttpClientParam()
+	{
+	}
+
+
+/******************************************************
+					HttpClientRequest
+******************************************************/
+
+	SLIB_DEFINE_OBJECT(HttpClientRequest, Object)
+
+	HttpClientRequest::HttpClientRequest()
+	{
+		setStoringResponseContent(sl_false);
+
+		m_sizeResponseContent = 0;
+
+		m_flagCompleted = sl_false;
+		m_flagError = sl_false;
+		m_flagCancelled = sl_false;
+
+		m_timeSent = 0;
+		m_timeToFirstByte = 0;
+		m_latency = 0;
+		m_nRetries = 0;
+
+		m_connection = sl_null;
+	}
+
+	HttpClientRequest::~HttpClientRequest()
+	{
+	}
+
+	Ref<HttpClientRequest> HttpClientRequest::create(HttpMethod method, const String& url)
+	{
+		Ref<HttpClientRequest> ret = new HttpClientRequest;
+		if (ret.isNotNull()) {
+			Url u;
+			u.parse(url);
+			ret->m_url = url;
+			ret->setMethod(method);
+			ret->setPath(u.path);
+			ret->setQuery(u.query);
+			return ret;
+		}
+		return sl_null;
+	}
+
+	String HttpClientRequest::getUrl() const
+	{
+		return m_url;
+	}
+
+	const Memory& HttpClientRequest::getRequestBody() const
+	{
+		return m_requestBody;
+	}
+
+	void HttpClientRequest::setRequestBody(const Memory& body)
+	{
+		m_requestBody = body;
+	}
+
+	Memory HttpClientRequest::getResponseContent() const
+	{
+		return m_bufResponseContent.merge();
+	}
+
+	sl_uint64 HttpClientRequest::getResponseContentSize() const
+	{
+		return m_sizeResponseContent;
+	}
+
+	sl_bool HttpClientRequest::isCompleted() const
+	{
+		return m_flagCompleted;
+	}
+
+	sl_bool HttpClientRequest::isError() const
+	{
+		if (m_responseCode >= HttpStatus::BadRequest) {
+			return sl_true;
+		}
+		return m_flagError;
+	}
+
+	String HttpClientRequest::getErrorMessage() const
+	{
+		return m_errorMessage;
+	}
+
+	sl_uint64 HttpClientRequest::getTimeToFirstByte() const
+	{
+		return m_timeToFirstByte;
+	}
+
+	sl_uint64 HttpClientRequest::getLatency() const
+	{
+		return m_latency;
+	}
+
+	void HttpClientRequest::cancel()
+	{
+		Ref<HttpClient> client = m_client;
+		if (client.isNotNull()) {
+			client->m_ioLoop->addTask(SLIB_BIND_REF(void(), HttpClient, _cancel, client.get(), Ref<HttpClientRequest>(this)));
+		}
+	}
+
+	void HttpClientRequest::_onResponse()
+	{
+		if (m_flagCompleted) {
+			return;
+		}
+		getOnResponse()(this);
+	}
+
+	void HttpClientRequest::_onReceiveContent(const void* data, sl_size size)
+	{
+		if (m_flagCompleted) {
+			return;
+		}
+		m_sizeResponseContent += size;
+		if (isStoringResponseContent()) {
+			m_bufResponseContent.add(Memory::create(data, size));
+		}
+		getOnReceiveContent()(this, data, size);
+	}
+
+	void HttpClientRequest::_onComplete(sl_bool flagError, const String& errorMessage)
+	{
+		if (m_flagCompleted) {
+			return;
+		}
+		m_flagCompleted = sl_true;
+		m_flagError = flagError;
+		m_errorMessage = errorMessage;
+		if (m_timeSent) {
+			m_latency = Time::now().toInt() - m_timeSent;
+		}
+		m_connection = sl_null;
+		m_origin.setNull();
+		getOnComplete()(this);
+	}
+
+	sl_bool HttpClientRequest::_isIdempotent() const
+	{
+		switch (m_method) {
+			case HttpMethod::GET:
+			case HttpMethod::HEAD:
+			case HttpMethod::OPTIONS:
+			case HttpMethod::TRACE:
+				return sl_true;
+			default:
+				return sl_false;
+		}
+	}
+
+
+/******************************************************
+					HttpClientOrigin
+******************************************************/
+
+	class HttpClientOrigin : public Referable
+	{
+	public:
+		HttpClient* m_client;
+		String m_name;
+		String m_host;
+		SocketAddress m_address;
+
+		CLinkedList< Ref<HttpClientRequest> > m_requestsPending;
+		CLinkedList< Ref<HttpClientConnection> > m_connections;
+		// most recently used at back
+		CLinkedList< Ref<HttpClientConnection> > m_connectionsIdle;
+
+		SpinLock m_lockHistogram;
+		HttpClientLatencyHistogram m_histogram;
+
+	public:
+		HttpClientOrigin(HttpClient* client, const String& name, const String& host, const SocketAddress& address);
+
+		~HttpClientOrigin();
+
+	public:
+		void dispatch();
+
+		void completeRequest(const Ref<HttpClientRequest>& request, sl_bool flagError, const String& errorMessage);
+
+		void releaseConnection(HttpClientConnection* connection);
+
+		void removeConnection(HttpClientConnection* connection);
+
+		void close();
+
+	protected:
+		Ref<HttpClientConnection> _getIdleConnection();
+
+		Ref<HttpClientConnection> _getPipeliningConnection();
+
+	};
+
+
+/******************************************************
+					HttpClientConnection
+******************************************************/
+
+	/*
+		Response framing (RFC 7230, 3.3.3). The content is passed to the request directly from the read buffer.
+
+		chunked-body   = *chunk last-chunk trailer-part CRLF
+		chunk          = chunk-size [ chunk-ext ] CRLF chunk-data CRLF
+	*/
+	enum class _priv_HttpClientState
+	{
+		Header = 0,
+		Content = 1,
+		ChunkSize = 2,
+		ChunkExtension = 3,
+		ChunkSizeLF = 4,
+		ChunkData = 5,
+		ChunkDataCR = 6,
+		ChunkDataLF = 7,
+		Trailer = 8,
+		TrailerLF = 9,
+		TearDown = 10
+	};
+
+	class HttpClientConnection : public Referable
+	{
+	public:
+		HttpClientOrigin* m_origin;
+		Ref<AsyncTcpSocket> m_socket;
+		Memory m_bufRead;
+		sl_uint32 m_maxHeaderSize;
+
+		sl_bool m_flagConnected;
+		sl_bool m_flagClosed;
+		sl_bool m_flagReading;
+
+		// the front request receives the response
+		CLinkedList< Ref<HttpClientRequest> > m_requests;
+		sl_uint32 m_nCompleted;
+		sl_uint64 m_timeLastUsed;
+
+		_priv_HttpClientState m_state;
+		HttpHeaderReader m_readerHeader;
+		sl_bool m_flagResponseStarted;
+		sl_bool m_flagKeepAlive;
+		sl_uint64 m_sizeContentRemain;
+		sl_bool m_flagChunkSize;
+		sl_uint32 m_sizeTrailerField;
+
+	public:
+		HttpClientConnection()
+		{
+			m_origin = sl_null;
+			m_maxHeaderSize = 0;
+			m_flagConnected = sl_false;
+			m_flagClosed = sl_false;
+			m_flagReading = sl_false;
+			m_nCompleted = 0;
+			m_timeLastUsed = 0;
+			m_state = _priv_HttpClientState::Header;
+			m_flagResponseStarted = sl_false;
+			m_flagKeepAlive = sl_false;
+			m_sizeContentRemain = 0;
+			m_flagChunkSize = sl_false;
+			m_sizeTrailerField = 0;
+		}
+
+		~HttpClientConnection()
+		{
+			if (m_socket.isNotNull()) {
+				m_socket->close();
+			}
+		}
+
+	public:
+		static Ref<HttpClientConnection> create(HttpClientOrigin* origin)
+		{
+			const HttpClientParam& param = origin->m_client->m_param;
+			Memory bufRead = Memory::create(param.readBufferSize);
+			if (bufRead.isNull()) {
+				return sl_null;
+			}
+			Ref<HttpClientConnection> ret = new HttpClientConnection;
+			if (ret.isNotNull()) {
+				ret->m_origin = origin;
+				ret->m_bufRead = bufRead;
+				ret->m_maxHeaderSize = param.maxResponseHeaderSize;
+				AsyncTcpSocketParam sp;
+				sp.ioLoop = origin->m_client->m_ioLoop;
+				sp.flagIPv6 = origin->m_address.ip.isIPv6();
+				sp.flagLogError = param.flagLogError;
+				sp.connectAddress = origin->m_address;
+				sp.onConnect = SLIB_FUNCTION_WEAKREF(HttpClientConnection, onConnect, ret);
+				Ref<AsyncTcpSocket> socket = AsyncTcpSocket::create(sp);
+				if (socket.isNotNull()) {
+					ret->m_socket = socket;
+					return ret;
+				}
+			}
+			return sl_null;
+		}
+
+		sl_uint32 getRequestsCount()
+		{
+			return (sl_uint32)(m_requests.getCount());
+		}
+
+		sl_bool isPipelining()
+		{
+			if (!m_flagKeepAlive && m_nCompleted) {
+				return sl_false;
+			}
+			Link< Ref<HttpClientRequest> >* link = m_requests.getFront();
+			while (link) {
+				if (!(link->value->_isIdempotent())) {
+					return sl_false;
+				}
+				link = link->next;
+			}
+			return sl_true;
+		}
+
+		void addRequest(const Ref<HttpClientRequest>& request)
+		{
+			request->m_connection = this;
+			m_requests.pushBack_NoLock(request);
+			if (m_flagConnected) {
+				_sendRequest(request.get());
+			}
+		}
+
+		void close()
+		{
+			if (m_flagClosed) {
+				return;
+			}
+			m_flagClosed = sl_true;
+			m_socket->close();
+			m_origin->removeConnection(this);
+		}
+
+		// closes the connection, retrying or failing the requests on it
+		void closeWithError(const String& errorMessage)
+		{
+			if (m_flagClosed) {
+				return;
+			}
+			Ref<HttpClientConnection> thiz = this;
+			HttpClientOrigin* origin = m_origin;
+			sl_bool flagReused = m_nCompleted > 0;
+			sl_bool flagResponseStarted = m_flagResponseStarted;
+			sl_bool flagConnected = m_flagConnected;
+			close();
+
+			CLinkedList< Ref<HttpClientRequest> > requestsRetry;
+			CLinkedList< Ref<HttpClientRequest> > requestsFailed;
+			sl_bool flagFront = sl_true;
+			Ref<HttpClientRequest> request;
+			while (m_requests.popFront_NoLock(&request)) {
+				request->m_connection = sl_null;
+				if (request->m_flagCompleted) {
+					flagFront = sl_false;
+					continue;
+				}
+				sl_bool flagRetry = sl_false;
+				if (flagConnected && request->_isIdempotent() && request->m_nRetries < MAX_RETRIES) {
+					if (flagFront) {
+						// the server closed a kept-alive connection before receiving the request
+						flagRetry = flagReused && !flagResponseStarted;
+					} else {
+						flagRetry = sl_true;
+					}
+				}
+				if (flagRetry) {
+					request->m_nRetries++;
+					requestsRetry.pushBack_NoLock(request);
+				} else {
+					requestsFailed.pushBack_NoLock(request);
+				}
+				flagFront = sl_false;
+			}
+			// retried requests are sent before the others in the queue, keeping their order
+			while (requestsRetry.popBack_NoLock(&request)) {
+				origin->m_requestsPending.pushFront_NoLock(request);
+			}
+			while (requestsFailed.popFront_NoLock(&request)) {
+				origin->completeRequest(request, sl_true, errorMessage);
+			}
+			origin->dispatch();
+		}
+
+	protected:
+		void _sendRequest(HttpClientRequest* request)
+		{
+			Memory body = request->m_requestBody;
+			sl_size sizeBody = body.getSize();
+			if (sizeBody || request->getMethod() == HttpMethod::POST || request->getMethod() == HttpMethod::PUT) {
+				if (!(request->isChunkedRequest())) {
+					request->setRequestContentLengthHeader(sizeBody);
+				}
+			}
+			Memory header = request->makeRequestPacket();
+			request->m_timeSent = Time::now().toInt();
+			sl_bool flagSuccess;
+			if (sizeBody && sizeBody <= SIZE_MERGE_BODY) {
+				MemoryBuffer buf;
+				buf.add(header);
+				buf.add(body);
+				flagSuccess = m_socket->send(buf.merge(), sl_null);
+			} else {
+				flagSuccess = m_socket->send(header, sl_null);
+				if (flagSuccess && sizeBody) {
+					flagSuccess = m_socket->send(body, sl_null);
+				}
+			}
+			if (!flagSuccess) {
+				closeWithError("Failed to send the request");
+			}
+		}
+
+		void _read()
+		{
+			if (m_flagClosed || m_flagReading) {
+				return;
+			}
+			m_flagReading = sl_true;
+			if (!(m_socket->receive(m_bufRead, SLIB_FUNCTION_WEAKREF(HttpClientConnection, onReadStream, this)))) {
+				m_flagReading = sl_false;
+				closeWithError("Failed to read the response");
+			}
+		}
+
+		void _beginResponse(HttpClientRequest* request)
+		{
+			Memory header = m_readerHeader.mergeHeader();
+			m_readerHeader.clear();
+			if (request->parseResponsePacket(header.getData(), header.getSize()) <= 0) {
+				closeWithError("Invalid response header");
+				return;
+			}
+			sl_uint32 status = (sl_uint32)(request->getResponseCode());
+			if (status >= 100 && status < 200) {
+				if (status == 101) {
+					closeWithError("Protocol upgrade is not supported");
+					return;
+				}
+				// interim response
+				request->clearResponseHeaders();
+				m_state = _priv_HttpClientState::Header;
+				return;
+			}
+			String connection = request->getResponseHeader(HttpHeaders::Connection);
+			if (request->getResponseVersion() == "HTTP/1.0") {
+				m_flagKeepAlive = connection.equalsIgnoreCase("keep-alive");
+			} else {
+				m_flagKeepAlive = !(connection.equalsIgnoreCase("close"));
+			}
+			request->_onResponse();
+			if (m_flagClosed) {
+				return;
+			}
+			if (request->getMethod() == HttpMethod::HEAD || status == 204 || status == 304) {
+				_completeResponse();
+			} else if (request->isChunkedResponse()) {
+				m_state = _priv_HttpClientState::ChunkSize;
+				m_sizeContentRemain = 0;
+				m_flagChunkSize = sl_false;
+			} else if (request->containsResponseHeader(HttpHeaders::ContentLength)) {
+				m_sizeContentRemain = request->getResponseContentLengthHeader();
+				if (m_sizeContentRemain) {
+					m_state = _priv_HttpClientState::Content;
+				} else {
+					_completeResponse();
+				}
+			} else {
+				// the content ends at closing the connection
+				m_state = _priv_HttpClientState::TearDown;
+				m_flagKeepAlive = sl_false;
+			}
+		}
+
+		void _completeResponse()
+		{
+			Ref<HttpClientRequest> request;
+			m_requests.popFront_NoLock(&request);
+			m_state = _priv_HttpClientState::Header;
+			m_flagResponseStarted = sl_false;
+			m_nCompleted++;
+			m_timeLastUsed = Time::now().toInt();
+
+			Ref<HttpClientConnection> thiz = this;
+			HttpClientOrigin* origin = m_origin;
+			sl_bool flagKeepAlive = m_flagKeepAlive;
+			if (request.isNotNull()) {
+				request->m_connection = sl_null;
+				origin->completeRequest(request, sl_false, String::null());
+			}
+			if (m_flagClosed) {
+				return;
+			}
+			if (!flagKeepAlive) {
+				closeWithError("Connection is closed by the server");
+				return;
+			}
+			if (m_requests.isEmpty()) {
+				origin->releaseConnection(this);
+				origin->dispatch();
+			}
+		}
+
+		// returns sl_false when the connection is closed
+		sl_bool _processInput(const sl_uint8* data, sl_size size)
+		{
+			while (size > 0) {
+				if (m_flagClosed) {
+					return sl_false;
+				}
+				Ref<HttpClientRequest> request;
+				if (!(m_requests.getFrontValue_NoLock(&request))) {
+					closeWithError("Unexpected data from the server");
+					return sl_false;
+				}
+				if (!m_flagResponseStarted) {
+					m_flagResponseStarted = sl_true;
+					request->m_timeToFirstByte = Time::now().toInt() - request->m_timeSent;
+				}
+				switch (m_state) {
+					case _priv_HttpClientState::Header:
+						{
+							sl_size posBody = 0;
+							if (m_readerHeader.add(data, size, posBody)) {
+								data += posBody;
+								size -= posBody;
+								_beginResponse(request.get());
+							} else {
+								if (m_readerHeader.getHeaderSize() > m_maxHeaderSize) {
+									closeWithError("Too large response header");
+									return sl_false;
+								}
+								return sl_true;
+							}
+						}
+						break;
+					case _priv_HttpClientState::Content:
+						{
+							sl_size n = size;
+							if (n > m_sizeContentRemain) {
+								n = (sl_size)m_sizeContentRemain;
+							}
+							request->_onReceiveContent(data, n);
+							data += n;
+							size -= n;
+							m_sizeContentRemain -= n;
+							if (!m_sizeContentRemain) {
+								_completeResponse();
+							}
+						}
+						break;
+					case _priv_HttpClientState::TearDown:
+						request->_onReceiveContent(data, size);
+						return sl_true;
+					case _priv_HttpClientState::ChunkData:
+						{
+							sl_size n = size;
+							if (n > m_sizeContentRemain) {
+								n = (sl_size)m_sizeContentRemain;
+							}
+							request->_onReceiveContent(data, n);
+							data += n;
+							size -= n;
+							m_sizeContentRemain -= n;
+							if (!m_sizeContentRemain) {
+								m_state = _priv_HttpClientState::ChunkDataCR;
+							}
+						}
+						break;
+					default:
+						if (!(_processChunkControl(*data))) {
+							closeWithError("Invalid chunked content");
+							return sl_false;
+						}
+						data++;
+						size--;
+						break;
+				}
+			}
+			return !m_flagClosed;
+		}
+
+		sl_bool _processChunkControl(sl_uint8 ch)
+		{
+			switch (m_state) {
+				case _priv_HttpClientState::ChunkSize:
+					{
+						sl_uint32 v = SLIB_CHAR_HEX_TO_INT(ch);
+						if (v < 16) {
+							if (m_sizeContentRemain >> 59) {
+								return sl_false;
+							}
+							m_sizeContentRemain = (m_sizeContentRemain << 4) | v;
+							m_flagChunkSize = sl_true;
+							return sl_true;
+						}
+						// a line without the size is not the last chunk
+						if (!m_flagChunkSize) {
+							return sl_false;
+						}
+						if (ch == '\r') {
+							m_state = _priv_HttpClientState::ChunkSizeLF;
+						} else {
+							m_state = _priv_HttpClientState::ChunkExtension;
+						}
+						return sl_true;
+					}
+				case _priv_HttpClientState::ChunkExtension:
+					if (ch == '\r') {
+						m_state = _priv_HttpClientState::ChunkSizeLF;
+					}
+					return sl_true;
+				case _priv_HttpClientState::ChunkSizeLF:
+					if (ch != '\n') {
+						return sl_false;
+					}
+					if (m_sizeContentRemain) {
+						m_state = _priv_HttpClientState::ChunkData;
+					} else {
+						// last chunk
+						m_state = _priv_HttpClientState::Trailer;
+						m_sizeTrailerField = 0;
+					}
+					return sl_true;
+				case _priv_HttpClientState::ChunkDataCR:
+					if (ch != '\r') {
+						return sl_false;
+					}
+					m_state = _priv_HttpClientState::ChunkDataLF;
+					return sl_true;
+				case _priv_HttpClientState::ChunkDataLF:
+					if (ch != '\n') {
+						return sl_false;
+					}
+					m_state = _priv_HttpClientState::ChunkSize;
+					m_sizeContentRemain = 0;
+					m_flagChunkSize = sl_false;
+					return sl_true;
+				case _priv_HttpClientState::Trailer:
+					if (ch == '\r') {
+						m_state = _priv_HttpClientState::TrailerLF;
+					} else {
+						m_sizeTrailerField++;
+					}
+					return sl_true;
+				case _priv_HttpClientState::TrailerLF:
+					if (ch != '\n') {
+						return sl_false;
+					}
+					if (m_sizeTrailerField) {
+						m_state = _priv_HttpClientState::Trailer;
+						m_sizeTrailerField = 0;
+					} else {
+						_completeResponse();
+					}
+					return sl_true;
+				default:
+					return sl_false;
+			}
+		}
+
+	public:
+		void onConnect(AsyncTcpSocket* socket, const SocketAddress& address, sl_bool flagError)
+		{
+			if (m_flagClosed) {
+				return;
+			}
+			if (flagError) {
+				closeWithError("Failed to connect to " + m_origin->m_name);
+				return;
+			}
+			m_flagConnected = sl_true;
+			m_timeLastUsed = Time::now().toInt();
+			Link< Ref<HttpClientRequest> >* link = m_requests.getFront();
+			while (link) {
+				_sendRequest(link->value.get());
+				if (m_flagClosed) {
+					return;
+				}
+				link = link->next;
+			}
+			_read();
+		}
+
+		void onReadStream(AsyncStreamResult* result)
+		{
+			m_flagReading = sl_false;
+			if (m_flagClosed) {
+				return;
+			}
+			Ref<HttpClientConnection> thiz = this;
+			if (result->size) {
+				if (!(_processInput((sl_uint8*)(result->data), result->size))) {
+					return;
+				}
+			}
+			if (result->flagError) {
+				if (m_state == _priv_HttpClientState::TearDown && m_requests.isNotEmpty()) {
+					_completeResponse();
+				}
+				closeWithError("Connection is closed by the server");
+				return;
+			}
+			// keeps reading while idle, to detect the connection closed by the server
+			_read();
+		}
+
+	};
+
+
+/******************************************************
+				HttpClientOrigin (implementation)
+******************************************************/
+
+	HttpClientOrigin::HttpClientOrigin(HttpClient* client, const String& name, const String& host, const SocketAddress& address)
+	{
+		m_client = client;
+		m_name = name;
+		m_host = host;
+		m_address = address;
+	}
+
+	HttpClientOrigin::~HttpClientOrigin()
+	{
+	}
+
+	void HttpClientOrigin::dispatch()
+	{
+		const HttpClientParam& param = m_client->m_param;
+		Ref<HttpClientRequest> request;
+		while (m_requestsPending.getFrontValue_NoLock(&request)) {
+			if (request->m_flagCompleted) {
+				m_requestsPending.popFront_NoLock();
+				continue;
+			}
+			Ref<HttpClientConnection> connection = _getIdleConnection();
+			if (connection.isNull()) {
+				if (m_connections.getCount() < param.maxConnectionsPerOrigin) {
+					connection = HttpClientConnection::create(this);
+					if (connection.isNull()) {
+						m_requestsPending.popFront_NoLock();
+						completeRequest(request, sl_true, "Failed to connect to " + m_name);
+						continue;
+					}
+					m_connections.pushBack_NoLock(connection);
+				} else if (param.maxPipelinedRequests > 1 && request->_isIdempotent()) {
+					connection = _getPipeliningConnection();
+				}
+			}
+			if (connection.isNull()) {
+				break;
+			}
+			m_requestsPending.popFront_NoLock();
+			connection->addRequest(request);
+		}
+	}
+
+	void HttpClientOrigin::completeRequest(const Ref<HttpClientRequest>& request, sl_bool flagError, const String& errorMessage)
+	{
+		if (request->m_flagCompleted) {
+			return;
+		}
+		if (request->m_timeSent) {
+			sl_uint64 latency = Time::now().toInt() - request->m_timeSent;
+			SpinLocker lock(&m_lockHistogram);
+			if (flagError) {
+				m_histogram.countErrors++;
+			} else {
+				m_histogram.add(latency);
+			}
+		}
+		request->_onComplete(flagError, errorMessage);
+	}
+
+	void HttpClientOrigin::releaseConnection(HttpClientConnection* connection)
+	{
+		if (connection->m_flagClosed) {
+			return;
+		}
+		m_connectionsIdle.pushBack_NoLock(connection);
+	}
+
+	void HttpClientOrigin::removeConnection(HttpClientConnection* connection)
+	{
+		Ref<HttpClientConnection> ref = connection;
+		m_connectionsIdle.remove_NoLock(ref);
+		m_connections.remove_NoLock(ref);
+	}
+
+	void HttpClientOrigin::close()
+	{
+		Ref<HttpClientConnection> connection;
+		while (m_connections.getFrontValue_NoLock(&connection)) {
+			connection->closeWithError("HttpClient is released");
+		}
+		Ref<HttpClientRequest> request;
+		while (m_requestsPending.popFront_NoLock(&request)) {
+			completeRequest(request, sl_true, "HttpClient is released");
+		}
+	}
+
+	Ref<HttpClientConnection> HttpClientOrigin::_getIdleConnection()
+	{
+		sl_uint64 now = Time::now().toInt();
+		sl_uint64 maxIdleTime = (sl_uint64)(m_client->m_param.maxIdleTime) * 1000;
+		Ref<HttpClientConnection> connection;
+		while (m_connectionsIdle.popBack_NoLock(&connection)) {
+			if (connection->m_flagClosed) {
+				continue;
+			}
+			if (connection->m_requests.isNotEmpty()) {
+				continue;
+			}
+			if (now - connection->m_timeLastUsed > maxIdleTime) {
+				// the least recently used ones are in front
+				connection->close();
+				while (m_connectionsIdle.popFront_NoLock(&connection)) {
+					connection->close();
+				}
+				return sl_null;
+			}
+			return connection;
+		}
+		return sl_null;
+	}
+
+	Ref<HttpClientConnection> HttpClientOrigin::_getPipeliningConnection()
+	{
+		sl_uint32 maxRequests = m_client->m_param.maxPipelinedRequests;
+		Ref<HttpClientConnection> ret;
+		sl_uint32 nMin = maxRequests;
+		Link< Ref<HttpClientConnection> >* link = m_connections.getFront();
+		while (link) {
+			HttpClientConnection* connection = link->value.get();
+			sl_uint32 n = connection->getRequestsCount();
+			if (n < nMin && connection->isPipelining()) {
+				nMin = n;
+				ret = connection;
+			}
+			link = link->next;
+		}
+		return ret;
+	}
+
+
+/******************************************************
+						HttpClient
+******************************************************/
+
+	SLIB_DEFINE_OBJECT(HttpClient, Object)
+
+	HttpClient::HttpClient()
+	{
+		m_flagOwnLoop = sl_false;
+		m_flagReleased = sl_false;
+	}
+
+	HttpClient::~HttpClient()
+	{
+		if (m_flagOwnLoop) {
+			m_ioLoop->release();
+		}
+		if (!m_flagReleased) {
+			m_flagReleased = sl_true;
+			_release();
+		}
+	}
+
+	Ref<HttpClient> HttpClient::create(const HttpClientParam& param)
+	{
+		Ref<AsyncIoLoop> loop = param.ioLoop;
+		sl_bool flagOwnLoop = sl_false;
+		if (loop.isNull()) {
+			loop = AsyncIoLoop::create();
+			if (loop.isNull()) {
+				return sl_null;
+			}
+			flagOwnLoop = sl_true;
+		}
+		Ref<HttpClient> ret = new HttpClient;
+		if (ret.isNotNull()) {
+			ret->m_param = param;
+			if (!(ret->m_param.maxConnectionsPerOrigin)) {
+				ret->m_param.maxConnectionsPerOrigin = 1;
+			}
+			if (!(ret->m_param.readBufferSize)) {
+				ret->m_param.readBufferSize = 0x10000;
+			}
+			ret->m_ioLoop = loop;
+			ret->m_flagOwnLoop = flagOwnLoop;
+			return ret;
+		}
+		if (flagOwnLoop) {
+			loop->release();
+		}
+		return sl_null;
+	}
+
+	Ref<HttpClient> HttpClient::create()
+	{
+		HttpClientParam param;
+		return create(param);
+	}
+
+	void HttpClient::release()
+	{
+		ObjectLocker lock(this);
+		if (m_flagReleased) {
+			return;
+		}
+		m_flagReleased = sl_true;
+		lock.unlock();
+		if (m_flagOwnLoop) {
+			m_ioLoop->release();
+			_release();
+		} else {
+			m_ioLoop->addTask(SLIB_FUNCTION_REF(HttpClient, _release, this));
+		}
+	}
+
+	sl_bool HttpClient::isReleased()
+	{
+		return m_flagReleased;
+	}
+
+	const HttpClientParam& HttpClient::getParam()
+	{
+		return m_param;
+	}
+
+	Ref<AsyncIoLoop> HttpClient::getAsyncIoLoop()
+	{
+		return m_ioLoop;
+	}
+
+	sl_bool HttpClient::send(const Ref<HttpClientRequest>& request)
+	{
+		if (request.isNull()) {
+			return sl_false;
+		}
+		if (m_flagReleased) {
+			return sl_false;
+		}
+		request->m_client = this;
+		return m_ioLoop->addTask(SLIB_BIND_REF(void(), HttpClient, _send, this, request));
+	}
+
+	Ref<HttpClientRequest> HttpClient::send(HttpMethod method, const String& url, const Function<void(HttpClientRequest*)>& onComplete)
+	{
+		Ref<HttpClientRequest> request = HttpClientRequest::create(method, url);
+		if (request.isNotNull()) {
+			request->setStoringResponseContent(sl_true);
+			request->setOnComplete(onComplete);
+			if (send(request)) {
+				return request;
+			}
+		}
+		return sl_null;
+	}
+
+	List<String> HttpClient::getOrigins()
+	{
+		return m_origins.getAllKeys();
+	}
+
+	sl_bool HttpClient::getLatencyHistogram(const String& name, HttpClientLatencyHistogram* _out)
+	{
+		Ref<HttpClientOrigin> origin;
+		if (m_origins.get(name, &origin)) {
+			if (_out) {
+				SpinLocker lock(&(origin->m_lockHistogram));
+				*_out = origin->m_histogram;
+			}
+			return sl_true;
+		}
+		return sl_false;
+	}
+
+	void HttpClient::clearLatencyHistograms()
+	{
+		for (auto& name : m_origins.getAllKeys()) {
+			Ref<HttpClientOrigin> origin;
+			if (m_origins.get(name, &origin)) {
+				SpinLocker lock(&(origin->m_lockHistogram));
+				origin->m_histogram.clear();
+			}
+		}
+	}
+
+	void HttpClient::_send(const Ref<HttpClientRequest>& request)
+	{
+		if (m_flagReleased) {
+			request->_onComplete(sl_true, "HttpClient is released");
+			return;
+		}
+		Url url;
+		url.parse(request->m_url);
+		String scheme = url.scheme;
+		if (scheme.isNotEmpty() && !(scheme.equalsIgnoreCase("http"))) {
+			request->_onComplete(sl_true, "Not supported scheme: " + scheme);
+			return;
+		}
+		String host = url.host;
+		if (host.isEmpty()) {
+			request->_onComplete(sl_true, "Invalid url: " + request->m_url);
+			return;
+		}
+		String name = host;
+		sl_reg indexPort = host.lastIndexOf(':');
+		if (indexPort < 0 || indexPort < host.lastIndexOf(']')) {
+			name = host + ":80";
+		}
+		Ref<HttpClientOrigin> origin;
+		if (!(m_origins.get(name, &origin))) {
+			// resolved once for each origin
+			SocketAddress address;
+			if (!(address.setHostAddress(name)) || !(address.port)) {
+				if (m_param.flagLogError) {
+					LogError(TAG, "Failed to resolve the host: %s", name);
+				}
+				request->_onComplete(sl_true, "Failed to resolve the host: " + name);
+				return;
+			}
+			origin = new HttpClientOrigin(this, name, host, address);
+			if (origin.isNull()) {
+				request->_onComplete(sl_true, "Out of memory");
+				return;
+			}
+			m_origins.put(name, origin);
+		}
+		if (!(request->containsRequestHeader(HttpHeaders::Host))) {
+			request->setHost(host);
+		}
+		request->m_origin = origin;
+		origin->m_requestsPending.pushBack_NoLock(request);
+		origin->dispatch();
+	}
+
+	void HttpClient::_cancel(const Ref<HttpClientRequest>& request)
+	{
+		if (request->m_flagCompleted) {
+			return;
+		}
+		request->m_flagCancelled = sl_true;
+		Ref<HttpClientOrigin> origin = request->m_origin;
+		HttpClientConnection* connection = request->m_connection;
+		if (connection) {
+			// the response is not read anymore, so the connection can not be reused
+			Ref<HttpClientConnection> ref = connection;
+			request->_onComplete(sl_true, "Cancelled");
+			ref->closeWithError("Cancelled");
+		} else {
+			if (origin.isNotNull()) {
+				origin->m_requestsPending.remove_NoLock(request);
+			}
+			request->_onComplete(sl_true, "Cancelled");
+		}
+	}
+
+	void HttpClient::_release()
+	{
+		for (auto& name : m_origins.getAllKeys()) {
+			Ref<HttpClientOrigin> origin;
+			if (m_origins.get(name, &origin)) {
+				origin->close();
+			}
+		}
+		m_origins.removeAll();
+	}
+
+}
@@ -12,6 +12,7 @@
 
 #include "slib/network/url.h"
 #include "slib/core/safe_static.h"
+#include "slib/core/string_interner.h"
 #include "slib/core/variant.h"
 
 namespace slib
@@ -149,6 +150,7 @@ namespace slib
 	DEFINE_HTTP_HEADER(AcceptEncoding, "Accept-Encoding")
 	DEFINE_HTTP_HEADER(TransferEncoding, "Transfer-Encoding")
 	DEFINE_HTTP_HEADER(ContentEncoding, "Content-Encoding")
+	DEFINE_HTTP_HEADER(Connection, "Connection")
 
 	DEFINE_HTTP_HEADER(Range, "Range")
 	DEFINE_HTTP_HEADER(ContentRange, "Content-Range")
@@ -157,6 +159,51 @@ namespace slib
 	DEFINE_HTTP_HEADER(Origin, "Origin")
 	DEFINE_HTTP_HEADER(AccessControlAllowOrigin, "Access-Control-Allow-Origin")
 
+	class _HttpHeader_Names
+	{
+	public:
+		// read only after construction
+		StringInterner names{sl_false};
+
+		_HttpHeader_Names()
+		{
+			// the static names are adopted, so the parsed names share them
+			const String* statics[] = {
+				&(HttpHeaders::ContentLength), &(HttpHeaders::ContentType), &(HttpHeaders::Host), &(HttpHeaders::AcceptEncoding),
+				&(HttpHeaders::TransferEncoding), &(HttpHeaders::ContentEncoding), &(HttpHeaders::Connection), &(HttpHeaders::Range),
+				&(HttpHeaders::ContentRange), &(HttpHeaders::AcceptRanges), &(HttpHeaders::Origin), &(HttpHeaders::AccessControlAllowOrigin)
+			};
+			for (sl_size i = 0; i < sizeof(statics) / sizeof(statics[0]); i++) {
+				names.intern(*(statics[i]));
+			}
+			static const char* list[] = {
+				"Host", "User-Agent", "Accept", "Accept-Encoding", "Accept-Language", "Accept-Ranges",
+				"Connection", "Keep-Alive", "Upgrade", "Content-Length", "Content-Type", "Content-Encoding",
+				"Content-Range", "Content-Disposition", "Transfer-Encoding", "Range", "Cookie", "Set-Cookie",
+				"Cache-Control", "Pragma", "Expires", "Date", "Server", "Location", "Referer", "Origin",
+				"Authorization", "Last-Modified", "ETag", "If-Modified-Since", "If-None-Match", "Vary",
+				"Access-Control-Allow-Origin", "X-Forwarded-For", "X-Requested-With"
+			};
+			for (sl_size i = 0; i < sizeof(list) / sizeof(list[0]); i++) {
+				String name = list[i];
+				names.intern(name);
+				names.intern(name.toLower());
+			}
+		}
+	};
+
+	String HttpHeaders::getName(const sl_char8* name, sl_size len)
+	{
+		SLIB_SAFE_STATIC(_HttpHeader_Names, t)
+		if (!(SLIB_SAFE_STATIC_CHECK_FREED(t))) {
+			String ret = t.names.find(name, len);
+			if (ret.isNotNull()) {
+				return ret;
+			}
+		}
+		return String::fromUtf8(name, len);
+	}
+
 	sl_reg HttpHeaders::parseHeaders(HttpHeaderMap& map, const void* _data, sl_size size)
 	{
 		const sl_char8* data = (const sl_char8*)_data;
@@ -193,7 +240,7 @@ namespace slib
 			String name;
 			String value;
 			if (indexSplit != 0) {
-				name = String::fromUtf8(data + posStart, indexSplit - posStart);
+				name = getName(data + posStart, indexSplit - posStart);
 				sl_size startValue = indexSplit + 1;
 				sl_size endValue = posCurrent;
 				while (startValue < endValue) {
@@ -210,7 +257,7 @@ namespace slib
 				}
 				value = Url::decodeUriComponentByUTF8(String::fromUtf8(data + startValue, endValue - startValue));
 			} else {
-				name = String::fromUtf8(data + posStart, posCurrent - posStart);
+				name = getName(data + posStart, posCurrent - posStart);
 			}
 			map.add_NoLock(name, value);
 			posCurrent += 2;
@@ -469,6 +516,11 @@ namespace slib
 		return m_parameters.find_NoLock(name) != sl_null;
 	}
 
+	void HttpRequest::setParameter(const String& name, const String& value)
+	{
+		m_parameters.put_NoLock(name, value);
+	}
+
 	const HashMap<String, String>& HttpRequest::getQueryParameters() const
 	{
 		return m_queryParameters;
@@ -10,6 +10,9 @@
 
 #include "slib/network/http_io.h"
 
+#include "slib/network/url.h"
+#include "slib/core/json_writer.h"
+
 namespace slib
 {
 
@@ -44,6 +47,15 @@ namespace slib
 		m_bufferOutput.write(mem);
 	}
 
+	void HttpOutputBuffer::writeJson(const Variant& value)
+	{
+		AsyncOutputBuffer* output = &m_bufferOutput;
+		JsonWriter writer([output](const Memory& mem) {
+			output->write(mem);
+		});
+		writer.write(value);
+	}
+
 	void HttpOutputBuffer::copyFrom(AsyncStream* stream, sl_uint64 size)
 	{
 		m_bufferOutput.copyFrom(stream, size);
@@ -59,6 +71,11 @@ namespace slib
 		m_bufferOutput.copyFromFile(path, dispatcher);
 	}
 
+	void HttpOutputBuffer::copyFromFile(const Ref<File>& file, sl_uint64 offset, sl_uint64 size)
+	{
+		m_bufferOutput.copyFromFile(file, offset, size);
+	}
+
 	sl_uint64 HttpOutputBuffer::getOutputLength() const
 	{
 		return m_bufferOutput.getOutputLength();
@@ -150,6 +167,757 @@ namespace slib
 		m_buffer.clear();
 	}
 
+/***********************************************************************
+						HttpRequestParser
+***********************************************************************/
+
+#define PARSER_STATE_START 0
+#define PARSER_STATE_METHOD 1
+#define PARSER_STATE_URI 2
+#define PARSER_STATE_VERSION 3
+#define PARSER_STATE_VERSION_LF 4
+#define PARSER_STATE_LINE_START 5
+#define PARSER_STATE_NAME 6
+#define PARSER_STATE_VALUE_START 7
+#define PARSER_STATE_VALUE 8
+#define PARSER_STATE_LINE_LF 9
+#define PARSER_STATE_HEADER_END_LF 10
+#define PARSER_STATE_BODY 20
+#define PARSER_STATE_CHUNK_SIZE 21
+#define PARSER_STATE_CHUNK_EXTENSION 22
+#define PARSER_STATE_CHUNK_SIZE_LF 23
+#define PARSER_STATE_CHUNK_DATA 24
+#define PARSER_STATE_CHUNK_DATA_CR 25
+#define PARSER_STATE_CHUNK_DATA_LF 26
+#define PARSER_STATE_TRAILER_START 27
+#define PARSER_STATE_TRAILER 28
+#define PARSER_STATE_TRAILER_END_LF 29
+#define PARSER_STATE_COMPLETE 100
+#define PARSER_STATE_ERROR 101
+
+#define PARSER_MIN_BUFFER_SIZE 1024
+#define PARSER_MAX_BODY_PREALLOCATION 0x100000
+
+	SLIB_STATIC_STRING(_g_sz_http_version_1_1, "HTTP/1.1");
+	SLIB_STATIC_STRING(_g_sz_http_version_1_0, "HTTP/1.0");
+
+	static String _HttpRequestParser_getString(const sl_char8* data, const HttpRequestParser::Range& range)
+	{
+		return String::fromUtf8(data + range.offset, range.length);
+	}
+
+	static sl_bool _HttpRequestParser_equals(const String& str, const sl_char8* data, const HttpRequestParser::Range& range)
+	{
+		return str.getLength() == range.length && Base::equalsMemory(str.getData(), data + range.offset, range.length);
+	}
+
+	static sl_bool _HttpRequestParser_equalsIgnoreCase(const char* str, sl_size len, const sl_char8* data, const HttpRequestParser::Range& range)
+	{
+		if (len != range.length) {
+			return sl_false;
+		}
+		data += range.offset;
+		for (sl_size i = 0; i < len; i++) {
+			if (SLIB_CHAR_LOWER_TO_UPPER(data[i]) != SLIB_CHAR_LOWER_TO_UPPER(str[i])) {
+				return sl_false;
+			}
+		}
+		return sl_true;
+	}
+
+	// tchar of RFC 7230: the characters of methods and header field names
+	static sl_bool _HttpRequestParser_isTokenChar(sl_char8 ch)
+	{
+		if (SLIB_CHAR_IS_ALNUM(ch)) {
+			return sl_true;
+		}
+		switch (ch) {
+			case '!': case '#': case '$': case '%': case '&': case '\'': case '*': case '+':
+			case '-': case '.': case '^': case '_': case '`': case '|': case '~':
+				return sl_true;
+		}
+		return sl_false;
+	}
+
+	// `flagChunked` tells whether the codings seen so far end with "chunked", and is updated with the codings in `s`
+	static sl_bool _HttpRequestParser_parseTransferCodings(const sl_char8* s, sl_uint32 len, sl_bool& flagChunked)
+	{
+		sl_uint32 pos = 0;
+		while (pos < len) {
+			while (pos < len && (s[pos] == ' ' || s[pos] == '\t' || s[pos] == ',')) {
+				pos++;
+			}
+			if (pos == len) {
+				break;
+			}
+			sl_uint32 start = pos;
+			while (pos < len && s[pos] != ',' && s[pos] != ';' && s[pos] != ' ' && s[pos] != '\t') {
+				pos++;
+			}
+			sl_uint32 n = pos - start;
+			// transfer parameters
+			while (pos < len && s[pos] != ',') {
+				pos++;
+			}
+			if (flagChunked) {
+				// a coding is applied after "chunked"
+				return sl_false;
+			}
+			if (n == 7) {
+				flagChunked = sl_true;
+				for (sl_uint32 i = 0; i < 7; i++) {
+					if (SLIB_CHAR_LOWER_TO_UPPER(s[start + i]) != "CHUNKED"[i]) {
+						flagChunked = sl_false;
+						break;
+					}
+				}
+			}
+		}
+		return sl_true;
+	}
+
+	HttpRequestParser::HttpRequestParser()
+	{
+		m_maxHeaderSize = 0x10000;
+		m_maxBodySize = 0x2000000;
+		m_fields = sl_null;
+		m_nFieldsCapacity = 0;
+		m_maxFields = SLIB_HTTP_REQUEST_PARSER_MAX_HEADERS;
+		reset();
+	}
+
+	HttpRequestParser::~HttpRequestParser()
+	{
+		if (m_fields) {
+			delete[] m_fields;
+		}
+	}
+
+	sl_size HttpRequestParser::parse(const void* _data, sl_size size)
+	{
+		if (m_state == PARSER_STATE_COMPLETE || m_state == PARSER_STATE_ERROR) {
+			return 0;
+		}
+		const sl_char8* data = (const sl_char8*)_data;
+		sl_size pos = 0;
+		if (m_flagHeaderCompleted) {
+			if (!(_parseBody(data, size, pos))) {
+				m_state = PARSER_STATE_ERROR;
+			}
+		} else {
+			if (!(_parseHeader(data, size, pos))) {
+				m_state = PARSER_STATE_ERROR;
+			}
+		}
+		return pos;
+	}
+
+	sl_bool HttpRequestParser::isHeaderCompleted() const
+	{
+		return m_flagHeaderCompleted;
+	}
+
+	sl_bool HttpRequestParser::isCompleted() const
+	{
+		return m_state == PARSER_STATE_COMPLETE;
+	}
+
+	sl_bool HttpRequestParser::isError() const
+	{
+		return m_state == PARSER_STATE_ERROR;
+	}
+
+	Memory HttpRequestParser::getHeader() const
+	{
+		return m_header;
+	}
+
+	const HttpRequestParser::Range& HttpRequestParser::getMethod() const
+	{
+		return m_method;
+	}
+
+	const HttpRequestParser::Range& HttpRequestParser::getPath() const
+	{
+		return m_path;
+	}
+
+	const HttpRequestParser::Range& HttpRequestParser::getQuery() const
+	{
+		return m_query;
+	}
+
+	const HttpRequestParser::Range& HttpRequestParser::getVersion() const
+	{
+		return m_version;
+	}
+
+	sl_uint32 HttpRequestParser::getHeaderFieldsCount() const
+	{
+		return m_nFields;
+	}
+
+	const HttpRequestParser::HeaderField* HttpRequestParser::getHeaderFields() const
+	{
+		return m_fields;
+	}
+
+	sl_bool HttpRequestParser::isChunked() const
+	{
+		return m_flagChunked;
+	}
+
+	sl_uint64 HttpRequestParser::getContentLength() const
+	{
+		return m_contentLength;
+	}
+
+	Memory HttpRequestParser::getBody() const
+	{
+		if (m_sizeBody == 0) {
+			return sl_null;
+		}
+		if (m_sizeBody == m_body.getSize()) {
+			return m_body;
+		}
+		return m_body.sub(0, m_sizeBody);
+	}
+
+	void HttpRequestParser::applyRequest(HttpRequest& request) const
+	{
+		const sl_char8* header = (const sl_char8*)(m_header.getData());
+		if (!header) {
+			return;
+		}
+		sl_bool flagKnownMethod = sl_false;
+		for (int i = (int)(HttpMethod::GET); i <= (int)(HttpMethod::TRACE); i++) {
+			if (_HttpRequestParser_equals(HttpMethods::toString((HttpMethod)i), header, m_method)) {
+				request.setMethod((HttpMethod)i);
+				flagKnownMethod = sl_true;
+				break;
+			}
+		}
+		if (!flagKnownMethod) {
+			request.setMethod(_HttpRequestParser_getString(header, m_method));
+		}
+		request.setPath(_HttpRequestParser_getString(header, m_path));
+		if (m_posQuery) {
+			request.setQuery(_HttpRequestParser_getString(header, m_query));
+		} else {
+			request.setQuery(String::null());
+		}
+		if (_HttpRequestParser_equals(_g_sz_http_version_1_1, header, m_version)) {
+			request.setRequestVersion(_g_sz_http_version_1_1);
+		} else if (_HttpRequestParser_equals(_g_sz_http_version_1_0, header, m_version)) {
+			request.setRequestVersion(_g_sz_http_version_1_0);
+		} else {
+			request.setRequestVersion(_HttpRequestParser_getString(header, m_version));
+		}
+		for (sl_uint32 i = 0; i < m_nFields; i++) {
+			const HeaderField& field = m_fields[i];
+			String value = _HttpRequestParser_getString(header, field.value);
+			if (Base::findMemory(header + field.value.offset, '%', field.value.length)) {
+				value = Url::decodeUriComponentByUTF8(value);
+			}
+			request.addRequestHeader(HttpHeaders::getName(header + field.name.offset, field.name.length), value);
+		}
+	}
+
+	void HttpRequestParser::setMaxHeaderSize(sl_size size)
+	{
+		if (size > 0x7fffffff) {
+			size = 0x7fffffff;
+		}
+		m_maxHeaderSize = size;
+	}
+
+	void HttpRequestParser::setMaxBodySize(sl_uint64 size)
+	{
+		m_maxBodySize = size;
+	}
+
+	void HttpRequestParser::setMaxHeaderFieldsCount(sl_uint32 count)
+	{
+		m_maxFields = count;
+	}
+
+	void HttpRequestParser::reset()
+	{
+		m_state = PARSER_STATE_START;
+		m_flagHeaderCompleted = sl_false;
+		m_sizeHeader = 0;
+		m_header.setNull();
+		Base::zeroMemory(&m_method, sizeof(Range));
+		Base::zeroMemory(&m_path, sizeof(Range));
+		Base::zeroMemory(&m_query, sizeof(Range));
+		Base::zeroMemory(&m_version, sizeof(Range));
+		m_posQuery = 0;
+		m_nFields = 0;
+		m_posToken = 0;
+		m_posValue = 0;
+		m_endValue = 0;
+		m_flagChunked = sl_false;
+		m_contentLength = 0;
+		m_sizeChunkRemain = 0;
+		m_flagChunkSize = sl_false;
+		m_body.setNull();
+		m_sizeBody = 0;
+	}
+
+	sl_bool HttpRequestParser::_parseHeader(const sl_char8* data, sl_size size, sl_size& pos)
+	{
+		if (m_state == PARSER_STATE_START) {
+			// empty lines preceding the request line are ignored
+			while (pos < size && (data[pos] == '\r' || data[pos] == '\n')) {
+				pos++;
+			}
+			if (pos == size) {
+				return sl_true;
+			}
+			m_state = PARSER_STATE_METHOD;
+		}
+		sl_size start = pos;
+		sl_uint32 base = m_sizeHeader - (sl_uint32)start;
+		sl_bool flagCompleted = sl_false;
+		while (pos < size && !flagCompleted) {
+			sl_char8 ch = data[pos];
+			sl_uint32 off = base + (sl_uint32)pos;
+			switch (m_state) {
+				case PARSER_STATE_METHOD:
+					if (ch == ' ') {
+						if (!off) {
+							return sl_false;
+						}
+						m_method.length = off;
+						m_path.offset = off + 1;
+						m_state = PARSER_STATE_URI;
+					} else if (!(_HttpRequestParser_isTokenChar(ch))) {
+						return sl_false;
+					}
+					break;
+				case PARSER_STATE_URI:
+					if (ch == ' ') {
+						if (m_posQuery) {
+							m_path.length = m_posQuery - 1 - m_path.offset;
+							m_query.offset = m_posQuery;
+							m_query.length = off - m_posQuery;
+						} else {
+							m_path.length = off - m_path.offset;
+						}
+						if (off == m_path.offset) {
+							return sl_false;
+						}
+						m_version.offset = off + 1;
+						m_state = PARSER_STATE_VERSION;
+					} else if (ch == '?') {
+						if (!m_posQuery) {
+							m_posQuery = off + 1;
+						}
+					} else if (ch == '\r' || ch == '\n') {
+						return sl_false;
+					}
+					break;
+				case PARSER_STATE_VERSION:
+					if (ch == '\r') {
+						m_version.length = off - m_version.offset;
+						m_state = PARSER_STATE_VERSION_LF;
+					} else if (ch == '\n') {
+						m_version.length = off - m_version.offset;
+						m_state = PARSER_STATE_LINE_START;
+					}
+					break;
+				case PARSER_STATE_VERSION_LF:
+				case PARSER_STATE_LINE_LF:
+					if (ch != '\n') {
+						return sl_false;
+					}
+					m_state = PARSER_STATE_LINE_START;
+					break;
+				case PARSER_STATE_LINE_START:
+					if (ch == '\r') {
+						m_state = PARSER_STATE_HEADER_END_LF;
+					} else if (ch == '\n') {
+						flagCompleted = sl_true;
+					} else if (!(_HttpRequestParser_isTokenChar(ch))) {
+						// obsolete line folding and empty names are rejected
+						return sl_false;
+					} else {
+						if (!(_reserveField())) {
+							return sl_false;
+						}
+						m_posToken = off;
+						m_state = PARSER_STATE_NAME;
+					}
+					break;
+				case PARSER_STATE_NAME:
+					if (ch == ':') {
+						m_fields[m_nFields].name.offset = m_posToken;
+						m_fields[m_nFields].name.length = off - m_posToken;
+						m_state = PARSER_STATE_VALUE_START;
+					} else if (!(_HttpRequestParser_isTokenChar(ch))) {
+						// whitespace before the colon would hide the name from the framing checks (RFC 7230, 3.2.4), and a line without colon is not a field
+						return sl_false;
+					}
+					break;
+				case PARSER_STATE_VALUE_START:
+					if (ch == '\r' || ch == '\n') {
+						m_posValue = off;
+						_addField(off);
+						m_state = ch == '\r' ? PARSER_STATE_LINE_LF : PARSER_STATE_LINE_START;
+					} else if (ch != ' ' && ch != '\t') {
+						m_posValue = off;
+						m_endValue = off + 1;
+						m_state = PARSER_STATE_VALUE;
+					}
+					break;
+				case PARSER_STATE_VALUE:
+					if (ch == '\r' || ch == '\n') {
+						_addField(m_endValue);
+						m_state = ch == '\r' ? PARSER_STATE_LINE_LF : PARSER_STATE_LINE_START;
+					} else if (ch != ' ' && ch != '\t') {
+						m_endValue = off + 1;
+					}
+					break;
+				case PARSER_STATE_HEADER_END_LF:
+					if (ch != '\n') {
+						return sl_false;
+					}
+					flagCompleted = sl_true;
+					break;
+				default:
+					return sl_false;
+			}
+			pos++;
+		}
+		sl_size n = pos - start;
+		if (m_sizeHeader + n > m_maxHeaderSize) {
+			return sl_false;
+		}
+		if (flagCompleted) {
+			if (m_sizeHeader) {
+				if (!(_appendHeader(data + start, n))) {
+					return sl_false;
+				}
+				m_sizeHeader += (sl_uint32)n;
+				m_header = m_bufHeader.sub(0, m_sizeHeader);
+				m_bufHeader.setNull();
+			} else {
+				// the whole header section was received at once
+				m_sizeHeader = (sl_uint32)n;
+				m_header = Memory::create(data + start, n);
+				if (m_header.isNull()) {
+					return sl_false;
+				}
+			}
+			return _completeHeader();
+		} else {
+			if (!(_appendHeader(data + start, n))) {
+				return sl_false;
+			}
+			m_sizeHeader += (sl_uint32)n;
+		}
+		return sl_true;
+	}
+
+	sl_bool HttpRequestParser::_reserveField()
+	{
+		if (m_nFields < m_nFieldsCapacity) {
+			return sl_true;
+		}
+		if (m_nFields >= m_maxFields) {
+			return sl_false;
+		}
+		sl_uint32 n = m_nFieldsCapacity ? m_nFieldsCapacity << 1 : 16;
+		if (n > m_maxFields) {
+			n = m_maxFields;
+		}
+		HeaderField* fields = new HeaderField[n];
+		if (!fields) {
+			return sl_false;
+		}
+		if (m_fields) {
+			Base::copyMemory(fields, m_fields, sizeof(HeaderField) * m_nFields);
+			delete[] m_fields;
+		}
+		m_fields = fields;
+		m_nFieldsCapacity = n;
+		return sl_true;
+	}
+
+	void HttpRequestParser::_addField(sl_uint32 endValue)
+	{
+		HeaderField& field = m_fields[m_nFields];
+		field.value.offset = m_posValue;
+		field.value.length = endValue - m_posValue;
+		m_nFields++;
+	}
+
+	sl_bool HttpRequestParser::_completeHeader()
+	{
+		m_flagHeaderCompleted = sl_true;
+		const sl_char8* header = (const sl_char8*)(m_header.getData());
+		sl_bool flagContentLength = sl_false;
+		sl_bool flagTransferEncoding = sl_false;
+		for (sl_uint32 i = 0; i < m_nFields; i++) {
+			HeaderField& field = m_fields[i];
+			if (_HttpRequestParser_equalsIgnoreCase("Content-Length", 14, header, field.name)) {
+				if (!(field.value.length)) {
+					return sl_false;
+				}
+				sl_uint64 n = 0;
+				const sl_char8* s = header + field.value.offset;
+				for (sl_uint32 k = 0; k < field.value.length; k++) {
+					sl_char8 ch = s[k];
+					if (ch < '0' || ch > '9') {
+						return sl_false;
+					}
+					if (n > (SLIB_UINT64_MAX - 9) / 10) {
+						return sl_false;
+					}
+					n = n * 10 + (ch - '0');
+				}
+				if (flagContentLength && n != m_contentLength) {
+					return sl_false;
+				}
+				flagContentLength = sl_true;
+				m_contentLength = n;
+			} else if (_HttpRequestParser_equalsIgnoreCase("Transfer-Encoding", 17, header, field.name)) {
+				// the fields are combined into one list of codings, and "chunked" must be the final one (RFC 9112 6.1)
+				flagTransferEncoding = sl_true;
+				if (!(_HttpRequestParser_parseTransferCodings(header + field.value.offset, field.value.length, m_flagChunked))) {
+					return sl_false;
+				}
+			}
+		}
+		if (flagTransferEncoding) {
+			// the length of the body could not be determined, or would be ambiguous (request smuggling)
+			if (!m_flagChunked || flagContentLength) {
+				return sl_false;
+			}
+		}
+		if (m_flagChunked) {
+			m_contentLength = 0;
+			m_state = PARSER_STATE_CHUNK_SIZE;
+			return sl_true;
+		}
+		if (m_contentLength > m_maxBodySize) {
+			return sl_false;
+		}
+		if (m_contentLength) {
+			m_state = PARSER_STATE_BODY;
+		} else {
+			m_state = PARSER_STATE_COMPLETE;
+		}
+		return sl_true;
+	}
+
+	sl_bool HttpRequestParser::_parseBody(const sl_char8* data, sl_size size, sl_size& pos)
+	{
+		while (pos < size) {
+			sl_char8 ch = data[pos];
+			switch (m_state) {
+				case PARSER_STATE_BODY:
+					{
+						sl_uint64 n = m_contentLength - m_sizeBody;
+						if (n > size - pos) {
+							n = size - pos;
+						}
+						if (!(_appendBody(data + pos, (sl_size)n))) {
+							return sl_false;
+						}
+						pos += (sl_size)n;
+						if (m_sizeBody == m_contentLength) {
+							m_state = PARSER_STATE_COMPLETE;
+							return sl_true;
+						}
+					}
+					continue;
+				case PARSER_STATE_CHUNK_SIZE:
+					{
+						sl_uint32 h = SLIB_CHAR_HEX_TO_INT(ch);
+						if (h < 16) {
+							if (m_sizeChunkRemain > (SLIB_UINT64_MAX >> 4)) {
+								return sl_false;
+							}
+							m_sizeChunkRemain = (m_sizeChunkRemain << 4) | h;
+							m_flagChunkSize = sl_true;
+							break;
+						}
+					}
+					if (!m_flagChunkSize) {
+						return sl_false;
+					}
+					if (ch == ';' || ch == ' ' || ch == '\t') {
+						m_state = PARSER_STATE_CHUNK_EXTENSION;
+						break;
+					}
+					if (ch == '\r') {
+						m_state = PARSER_STATE_CHUNK_SIZE_LF;
+						break;
+					}
+					if (ch != '\n') {
+						return sl_false;
+					}
+					// fall through
+				case PARSER_STATE_CHUNK_SIZE_LF:
+					if (ch != '\n') {
+						return sl_false;
+					}
+					m_flagChunkSize = sl_false;
+					if (m_sizeChunkRemain) {
+						if (m_contentLength + m_sizeChunkRemain > m_maxBodySize || m_contentLength + m_sizeChunkRemain < m_contentLength) {
+							return sl_false;
+						}
+						m_state = PARSER_STATE_CHUNK_DATA;
+					} else {
+						m_state = PARSER_STATE_TRAILER_START;
+					}
+					break;
+				case PARSER_STATE_CHUNK_EXTENSION:
+					if (ch == '\r') {
+						m_state = PARSER_STATE_CHUNK_SIZE_LF;
+					} else if (ch == '\n') {
+						m_state = PARSER_STATE_CHUNK_SIZE_LF;
+						continue;
+					}
+					break;
+				case PARSER_STATE_CHUNK_DATA:
+					{
+						sl_uint64 n = m_sizeChunkRemain;
+						if (n > size - pos) {
+							n = size - pos;
+						}
+						if (!(_appendBody(data + pos, (sl_size)n))) {
+							return sl_false;
+						}
+						pos += (sl_size)n;
+						m_sizeChunkRemain -= n;
+						m_contentLength += n;
+						if (!m_sizeChunkRemain) {
+							m_state = PARSER_STATE_CHUNK_DATA_CR;
+						}
+					}
+					continue;
+				case PARSER_STATE_CHUNK_DATA_CR:
+					if (ch == '\r') {
+						m_state = PARSER_STATE_CHUNK_DATA_LF;
+					} else if (ch == '\n') {
+						m_state = PARSER_STATE_CHUNK_SIZE;
+					} else {
+						return sl_false;
+					}
+					break;
+				case PARSER_STATE_CHUNK_DATA_LF:
+					if (ch != '\n') {
+						return sl_false;
+					}
+					m_state = PARSER_STATE_CHUNK_SIZE;
+					break;
+				case PARSER_STATE_TRAILER_START:
+					if (ch == '\r') {
+						m_state = PARSER_STATE_TRAILER_END_LF;
+					} else if (ch == '\n') {
+						pos++;
+						m_state = PARSER_STATE_COMPLETE;
+						return sl_true;
+					} else {
+						m_state = PARSER_STATE_TRAILER;
+					}
+					break;
+				case PARSER_STATE_TRAILER:
+					// trailer fields are skipped, but counted against the header limit
+					m_sizeHeader++;
+					if (m_sizeHeader > m_maxHeaderSize) {
+						return sl_false;
+					}
+					if (ch == '\n') {
+						m_state = PARSER_STATE_TRAILER_START;
+					}
+					break;
+				case PARSER_STATE_TRAILER_END_LF:
+					if (ch != '\n') {
+						return sl_false;
+					}
+					pos++;
+					m_state = PARSER_STATE_COMPLETE;
+					return sl_true;
+				default:
+					return sl_false;
+			}
+			pos++;
+		}
+		return sl_true;
+	}
+
+	sl_bool HttpRequestParser::_appendHeader(const void* data, sl_size size)
+	{
+		if (!size) {
+			return sl_true;
+		}
+		sl_size sizeNew = m_sizeHeader + size;
+		sl_size capacity = m_bufHeader.getSize();
+		if (sizeNew > capacity) {
+			capacity <<= 1;
+			if (capacity < sizeNew) {
+				capacity = sizeNew;
+			}
+			if (capacity < PARSER_MIN_BUFFER_SIZE) {
+				capacity = PARSER_MIN_BUFFER_SIZE;
+			}
+			Memory mem = Memory::create(capacity);
+			if (mem.isNull()) {
+				return sl_false;
+			}
+			if (m_sizeHeader) {
+				Base::copyMemory(mem.getData(), m_bufHeader.getData(), m_sizeHeader);
+			}
+			m_bufHeader = mem;
+		}
+		Base::copyMemory((sl_uint8*)(m_bufHeader.getData()) + m_sizeHeader, data, size);
+		return sl_true;
+	}
+
+	sl_bool HttpRequestParser::_appendBody(const void* data, sl_size size)
+	{
+		if (!size) {
+			return sl_true;
+		}
+		sl_size sizeNew = m_sizeBody + size;
+		sl_size capacity = m_body.getSize();
+		if (sizeNew > capacity) {
+			if (m_flagChunked) {
+				capacity <<= 1;
+				if (capacity < PARSER_MIN_BUFFER_SIZE) {
+					capacity = PARSER_MIN_BUFFER_SIZE;
+				}
+			} else {
+				// the declared length is trusted only up to a limit, until the data actually arrives
+				if (capacity) {
+					capacity <<= 1;
+				} else {
+					capacity = PARSER_MAX_BODY_PREALLOCATION;
+				}
+				if (capacity > m_contentLength) {
+					capacity = (sl_size)m_contentLength;
+				}
+			}
+			if (capacity < sizeNew) {
+				capacity = sizeNew;
+			}
+			Memory mem = Memory::create(capacity);
+			if (mem.isNull()) {
+				return sl_false;
+			}
+			if (m_sizeBody) {
+				Base::copyMemory(mem.getData(), m_body.getData(), m_sizeBody);
+			}
+			m_body = mem;
+		}
+		Base::copyMemory((sl_uint8*)(m_body.getData()) + m_sizeBody, data, size);
+		m_sizeBody = sizeNew;
+		return sl_true;
+	}
+
 /***********************************************************************
 						HttpContentReader
 ***********************************************************************/
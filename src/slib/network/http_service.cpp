@@ -14,6 +14,7 @@
 #include "slib/core/asset.h"
 #include "slib/core/file.h"
 #include "slib/core/log.h"
+#include "slib/core/system.h"
 #include "slib/core/json.h"
 #include "slib/core/content_type.h"
 
@@ -26,7 +27,7 @@ namespace slib
 			HttpServiceContext
 **********************************************/
 
-	SLIB_DEFINE_OBJECT(HttpServiceContext, Object)
+	SLIB_DEFINE_OBJECT(HttpServiceContext, LightObject)
 
 	HttpServiceContext::HttpServiceContext()
 	{
@@ -103,6 +104,13 @@ namespace slib
 
 	Ref<AsyncIoLoop> HttpServiceContext::getAsyncIoLoop()
 	{
+		Ref<AsyncStream> io = getIO();
+		if (io.isNotNull()) {
+			Ref<AsyncIoLoop> loop = io->getIoLoop();
+			if (loop.isNotNull()) {
+				return loop;
+			}
+		}
 		Ref<HttpService> service = getService();
 		if (service.isNotNull()) {
 			return service->getAsyncIoLoop();
@@ -159,6 +167,11 @@ namespace slib
 	{
 		m_flagClosed = sl_true;
 		m_flagReading = sl_false;
+		
+		m_dataInputPending = sl_null;
+		m_sizeInputPending = 0;
+		m_flagProcessingInput = sl_false;
+		m_flagResumingInput = sl_false;
 	}
 
 	HttpServiceConnection::~HttpServiceConnection()
@@ -183,6 +196,10 @@ namespace slib
 						ret->m_io = io;
 						ret->m_output = output;
 						ret->m_bufRead = bufRead;
+						const HttpServiceParam& param = service->getParam();
+						ret->m_parser.setMaxHeaderSize((sl_size)(param.maxRequestHeadersSize));
+						ret->m_parser.setMaxHeaderFieldsCount(param.maxRequestHeaderFieldsCount);
+						ret->m_parser.setMaxBodySize(param.maxRequestBodySize);
 						ret->m_flagClosed = sl_false;
 						return ret;
 					}
@@ -213,6 +230,27 @@ namespace slib
 		m_contextCurrent.setNull();
 		if (data && size > 0) {
 			_processInput(data, size);
+			return;
+		}
+		Memory mem;
+		const sl_uint8* pending;
+		sl_uint32 sizePending;
+		{
+			ObjectLocker lock(this);
+			if (m_flagProcessingInput) {
+				// the input loop continues with the pending input
+				m_flagResumingInput = sl_true;
+				return;
+			}
+			mem = m_memInputPending;
+			pending = m_dataInputPending;
+			sizePending = m_sizeInputPending;
+			m_memInputPending.setNull();
+			m_dataInputPending = sl_null;
+			m_sizeInputPending = 0;
+		}
+		if (sizePending) {
+			_processInput(pending, sizePending, mem);
 		} else {
 			_read();
 		}
@@ -249,88 +287,126 @@ namespace slib
 		}
 	}
 
-	void HttpServiceConnection::_processInput(const void* _data, sl_uint32 size)
+	void HttpServiceConnection::_processInput(const void* data, sl_uint32 size)
+	{
+		const sl_uint8* bufRead = (const sl_uint8*)(m_bufRead.getData());
+		if ((const sl_uint8*)data >= bufRead && (const sl_uint8*)data < bufRead + m_bufRead.getSize()) {
+			_processInput(data, size, m_bufRead);
+		} else {
+			_processInput(data, size, sl_null);
+		}
+	}
+
+	void HttpServiceConnection::_processInput(const void* _data, sl_uint32 size, const Memory& _mem)
 	{
 		Ref<HttpService> service = m_service;
 		if (service.isNull()) {
 			return;
 		}
-		if (m_flagClosed) {
-			return;
+		{
+			ObjectLocker lock(this);
+			if (m_flagClosed) {
+				return;
+			}
+			m_flagProcessingInput = sl_true;
+			m_flagResumingInput = sl_false;
 		}
-		
-		const HttpServiceParam& param = service->getParam();
-		sl_uint64 maxRequestHeadersSize = param.maxRequestHeadersSize;
-		sl_uint64 maxRequestBodySize = param.maxRequestBodySize;
-
-		char* data = (char*)_data;
-		Ref<HttpServiceContext> _context = m_contextCurrent;
-		if (_context.isNull()) {
-			_context = HttpServiceContext::create(this);
-			if (_context.isNull()) {
-				sendResponse_ServerError();
+		const sl_uint8* data = (const sl_uint8*)_data;
+		Memory mem = _mem;
+		for (;;) {
+			if (!(_processRequest(service.get(), data, size, mem))) {
+				break;
+			}
+			// the next request is parsed only after the response of the current one is completed
+			ObjectLocker lock(this);
+			if (!m_flagResumingInput) {
+				m_flagProcessingInput = sl_false;
 				return;
 			}
-			m_contextCurrent = _context;
-			_context->setProcessingByThread(param.flagProcessByThreads);
-		}
-		HttpServiceContext* context = _context.get();
-		if (context->m_requestHeader.isEmpty()) {
-			sl_size posBody;
-			if (context->m_requestHeaderReader.add(data, size, posBody)) {
-				context->m_requestHeader = context->m_requestHeaderReader.mergeHeader();
-				if (context->m_requestHeader.isEmpty()) {
-					sendResponse_ServerError();
-					return;
-				}
-				if (posBody > size) {
-					sendResponse_ServerError();
-					return;
-				}
-				context->m_requestHeaderReader.clear();
-				Memory header = context->getRawRequestHeader();
-				sl_reg iRet = context->parseRequestPacket(header.getData(), header.getSize());
-				if (iRet != (sl_reg)(context->m_requestHeader.getSize())) {
-					sendResponse_BadRequest();
-					return;
-				}
-				context->m_requestContentLength = context->getRequestContentLengthHeader();
-				if (context->m_requestContentLength > maxRequestBodySize) {
-					sendResponse_BadRequest();
-					return;
-				}
-				context->m_requestBody = Memory::create(data + posBody, size - (sl_uint32)posBody);
-				if (!(context->m_requestBodyBuffer.add(context->m_requestBody))) {
+			m_flagResumingInput = sl_false;
+			mem = m_memInputPending;
+			data = m_dataInputPending;
+			size = m_sizeInputPending;
+			m_memInputPending.setNull();
+			m_dataInputPending = sl_null;
+			m_sizeInputPending = 0;
+			if (!size) {
+				break;
+			}
+		}
+		{
+			ObjectLocker lock(this);
+			m_flagProcessingInput = sl_false;
+		}
+		_read();
+	}
+
+	sl_bool HttpServiceConnection::_processRequest(HttpService* service, const sl_uint8*& data, sl_uint32& size, Memory& mem)
+	{
+		HttpRequestParser& parser = m_parser;
+		for (;;) {
+			sl_bool flagHeaderCompleted = parser.isHeaderCompleted();
+			sl_uint32 n = (sl_uint32)(parser.parse(data, size));
+			data += n;
+			size -= n;
+			if (parser.isError()) {
+				parser.reset();
+				m_contextCurrent.setNull();
+				size = 0;
+				sendResponse_BadRequest();
+				return sl_true;
+			}
+			if (!flagHeaderCompleted && parser.isHeaderCompleted()) {
+				Ref<HttpServiceContext> context = HttpServiceContext::create(this);
+				if (context.isNull()) {
+					parser.reset();
+					size = 0;
 					sendResponse_ServerError();
-					return;
+					return sl_true;
 				}
+				context->setProcessingByThread(service->getParam().flagProcessByThreads);
+				context->m_requestHeader = parser.getHeader();
+				parser.applyRequest(*(context.get()));
+				context->m_requestContentLength = parser.getContentLength();
 				context->applyQueryToParameters();
+				m_contextCurrent = context;
 				if (service->preprocessRequest(context)) {
-					return;
-				}
-			} else {
-				if (context->m_requestHeaderReader.getHeaderSize() > maxRequestHeadersSize) {
-					sendResponse_BadRequest();
-					return;
+					// the service takes over the connection, and the remaining input is passed as the body
+					context->m_requestBody = Memory::create(data, size);
+					parser.reset();
+					size = 0;
+					return sl_true;
 				}
 			}
-		} else {
-			if (!(context->m_requestBodyBuffer.add(Memory::create(data, size)))) {
-				sendResponse_ServerError();
-				return;
-			}
-		}
-		if (context->m_requestHeader.isNotEmpty()) {
-			if (context->m_requestBodyBuffer.getSize() >= context->m_requestContentLength) {
-
+			if (parser.isCompleted()) {
+				Ref<HttpServiceContext> context = m_contextCurrent;
 				m_contextCurrent.setNull();
-
-				context->m_requestBody = context->m_requestBodyBuffer.merge();
-				if (context->m_requestContentLength > 0 && context->m_requestBody.isEmpty()) {
+				if (context.isNull()) {
+					parser.reset();
+					size = 0;
 					sendResponse_ServerError();
-					return;
+					return sl_true;
 				}
-				context->m_requestBodyBuffer.clear();
+				context->m_requestBody = parser.getBody();
+				context->m_requestContentLength = parser.getContentLength();
+				parser.reset();
+				
+				if (size) {
+					if (mem.isNull()) {
+						mem = Memory::create(data, size);
+						if (mem.isNull()) {
+							size = 0;
+							sendResponse_ServerError();
+							return sl_true;
+						}
+						data = (const sl_uint8*)(mem.getData());
+					}
+					ObjectLocker lock(this);
+					m_memInputPending = mem;
+					m_dataInputPending = data;
+					m_sizeInputPending = size;
+				}
+				size = 0;
 
 				if (context->getMethod() == HttpMethod::POST) {
 					String reqContentType = context->getRequestContentTypeNoParams();
@@ -343,17 +419,19 @@ namespace slib
 				if (context->isProcessingByThread()) {
 					Ref<ThreadPool> threadPool = service->getThreadPool();
 					if (threadPool.isNotNull()) {
-						threadPool->addTask(SLIB_BIND_WEAKREF(void(), HttpServiceConnection, _processContext, this, _context));
+						threadPool->addTask(SLIB_BIND_WEAKREF(void(), HttpServiceConnection, _processContext, this, context));
 					} else {
 						sendResponse_ServerError();
-						return;
 					}
 				} else {
 					_processContext(context);
 				}
+				return sl_true;
+			}
+			if (!size) {
+				return sl_false;
 			}
 		}
-		_read();
 	}
 
 	void HttpServiceConnection::_processContext(const Ref<HttpServiceContext>& context)
@@ -518,12 +596,16 @@ namespace slib
 	class _DefaultHttpServiceConnectionProvider : public HttpServiceConnectionProvider, public IAsyncTcpServerListener
 	{
 	public:
-		Ref<AsyncTcpServer> m_server;
-		Ref<AsyncIoLoop> m_loop;
+		CList< Ref<AsyncTcpServer> > m_servers;
+		
+		// loops receiving the connections accepted by a single listener (round-robin)
+		List< Ref<AsyncIoLoop> > m_loopsDistributed;
+		sl_reg m_indexLoopNext;
 
 	public:
 		_DefaultHttpServiceConnectionProvider()
 		{
+			m_indexLoopNext = 0;
 		}
 
 		~_DefaultHttpServiceConnectionProvider()
@@ -534,39 +616,79 @@ namespace slib
 	public:
 		static Ref<HttpServiceConnectionProvider> create(HttpService* service, const SocketAddress& addressListen)
 		{
-			Ref<AsyncIoLoop> loop = service->getAsyncIoLoop();
-			if (loop.isNotNull()) {
-				Ref<_DefaultHttpServiceConnectionProvider> ret = new _DefaultHttpServiceConnectionProvider;
-				if (ret.isNotNull()) {
-					ret->m_loop = loop;
-					ret->setService(service);
-					AsyncTcpServerParam sp;
-					sp.bindAddress = addressListen;
-					sp.listener.setWeak(ret);
-					sp.ioLoop = loop;
-					Ref<AsyncTcpServer> server = AsyncTcpServer::create(sp);
-					if (server.isNotNull()) {
-						ret->m_server = server;
-						return ret;
-					}
+			List< Ref<AsyncIoLoop> > loops = service->getAsyncIoLoops();
+			if (loops.isEmpty()) {
+				return sl_null;
+			}
+			Ref<_DefaultHttpServiceConnectionProvider> ret = new _DefaultHttpServiceConnectionProvider;
+			if (ret.isNull()) {
+				return sl_null;
+			}
+			ret->setService(service);
+#if defined(SLIB_PLATFORM_IS_LINUX)
+			// the kernel balances incoming connections between the listeners sharing the port
+			if (loops.getCount() > 1 && addressListen.port != 0) {
+				if (ret->_listenSharded(addressListen, loops)) {
+					return ret;
 				}
 			}
+#endif
+			Ref<AsyncTcpServer> server = ret->_listen(addressListen, loops.getValueAt(0), sl_false);
+			if (server.isNotNull()) {
+				ret->m_servers.add(server);
+				if (loops.getCount() > 1) {
+					ret->m_loopsDistributed = loops;
+				}
+				return ret;
+			}
 			return sl_null;
 		}
 		
+		Ref<AsyncTcpServer> _listen(const SocketAddress& addressListen, const Ref<AsyncIoLoop>& loop, sl_bool flagReusePort)
+		{
+			AsyncTcpServerParam sp;
+			sp.bindAddress = addressListen;
+			sp.listener.setWeak(this);
+			sp.ioLoop = loop;
+			sp.flagReusePort = flagReusePort;
+			return AsyncTcpServer::create(sp);
+		}
+		
+		sl_bool _listenSharded(const SocketAddress& addressListen, const List< Ref<AsyncIoLoop> >& loops)
+		{
+			ListElements< Ref<AsyncIoLoop> > list(loops);
+			for (sl_size i = 0; i < list.count; i++) {
+				Ref<AsyncTcpServer> server = _listen(addressListen, list[i], sl_true);
+				if (server.isNull()) {
+					release();
+					return sl_false;
+				}
+				m_servers.add(server);
+			}
+			return sl_true;
+		}
+		
 		void release()
 		{
-			ObjectLocker lock(this);
-			if (m_server.isNotNull()) {
-				m_server->close();
+			ListLocker< Ref<AsyncTcpServer> > servers(m_servers);
+			for (sl_size i = 0; i < servers.count; i++) {
+				servers[i]->close();
 			}
+			m_servers.removeAll_NoLock();
 		}
 
 		void onAccept(AsyncTcpServer* socketListen, const Ref<Socket>& socketAccept, const SocketAddress& address)
 		{
 			Ref<HttpService> service = getService();
 			if (service.isNotNull()) {
-				Ref<AsyncIoLoop> loop = m_loop;
+				Ref<AsyncIoLoop> loop;
+				ListElements< Ref<AsyncIoLoop> > loops(m_loopsDistributed);
+				if (loops.count > 0) {
+					sl_size index = (sl_size)(Base::interlockedIncrement(&m_indexLoopNext));
+					loop = loops[index % loops.count];
+				} else {
+					loop = socketListen->getIoLoop();
+				}
 				if (loop.isNull()) {
 					return;
 				}
@@ -607,9 +729,12 @@ namespace slib
 		maxThreadsCount = 32;
 		flagProcessByThreads = sl_true;
 		
+		ioLoopsCount = 0;
+		
 		flagUseAsset = sl_false;
 		
 		maxRequestHeadersSize = 0x10000; // 64KB
+		maxRequestHeaderFieldsCount = SLIB_HTTP_REQUEST_PARSER_MAX_HEADERS;
 		maxRequestBodySize = 0x2000000; // 32MB
 		
 		flagAllowCrossOrigin = sl_false;
@@ -639,30 +764,41 @@ namespace slib
 
 	sl_bool HttpService::_init(const HttpServiceParam& param)
 	{
-		Ref<AsyncIoLoop> ioLoop = AsyncIoLoop::create(sl_false);
-		if (ioLoop.isNotNull()) {
-			Ref<ThreadPool> threadPool = ThreadPool::create();
-			if (threadPool.isNotNull()) {
-				threadPool->setMaximumThreadsCount(param.maxThreadsCount);
-				
-				m_ioLoop = ioLoop;
-				m_threadPool = threadPool;
-				m_param = param;
-				if (param.port) {
-					if (! (addHttpService(param.addressBind, param.port))) {
-						return sl_false;
-					}
-				}
-				if (param.processor.isNotNull()) {
-					addProcessor(param.processor);
-				}
-				
-				ioLoop->start();
-
-				return sl_true;
+		sl_uint32 nLoops = param.ioLoopsCount;
+		if (!nLoops) {
+			nLoops = System::getProcessorsCount();
+		}
+		for (sl_uint32 i = 0; i < nLoops; i++) {
+			Ref<AsyncIoLoop> ioLoop = AsyncIoLoop::create(sl_false);
+			if (ioLoop.isNull()) {
+				return sl_false;
 			}
+			m_ioLoops.add(ioLoop);
 		}
-		return sl_false;
+		Ref<ThreadPool> threadPool = ThreadPool::create();
+		if (threadPool.isNull()) {
+			return sl_false;
+		}
+		threadPool->setMaximumThreadsCount(param.maxThreadsCount);
+		
+		m_ioLoop = m_ioLoops.getValueAt(0);
+		m_threadPool = threadPool;
+		m_param = param;
+		if (param.port) {
+			if (! (addHttpService(param.addressBind, param.port))) {
+				return sl_false;
+			}
+		}
+		if (param.processor.isNotNull()) {
+			addProcessor(param.processor);
+		}
+		
+		ListLocker< Ref<AsyncIoLoop> > loops(m_ioLoops);
+		for (sl_size i = 0; i < loops.count; i++) {
+			loops[i]->start();
+		}
+
+		return sl_true;
 	}
 
 	Ref<HttpService> HttpService::create(const HttpServiceParam& param)
@@ -694,11 +830,14 @@ namespace slib
 		}
 		m_connectionProviders.removeAll();
 		
-		Ref<AsyncIoLoop> ioLoop = m_ioLoop;
-		if (ioLoop.isNotNull()) {
-			ioLoop->release();
-			m_ioLoop.setNull();
+		{
+			ListLocker< Ref<AsyncIoLoop> > loops(m_ioLoops);
+			for (sl_size i = 0; i < loops.count; i++) {
+				loops[i]->release();
+			}
 		}
+		m_ioLoops.removeAll();
+		m_ioLoop.setNull();
 		Ref<ThreadPool> threadPool = m_threadPool;
 		if (threadPool.isNotNull()) {
 			threadPool->release();
@@ -718,6 +857,11 @@ namespace slib
 		return m_ioLoop;
 	}
 
+	List< Ref<AsyncIoLoop> > HttpService::getAsyncIoLoops()
+	{
+		return m_ioLoops.duplicate();
+	}
+
 	Ref<ThreadPool> HttpService::getThreadPool()
 	{
 		return m_threadPool;
@@ -852,6 +996,12 @@ namespace slib
 
 			context->setResponseAcceptRanges(sl_true);
 
+			// with sendfile(), the body goes from the page cache to the socket without passing through user-space buffers
+			Ref<File> file;
+			if (Socket::isSupportingSendFile()) {
+				file = File::openForRead(path);
+			}
+
 			String rangeHeader = context->getRequestRange();
 			
 			if (rangeHeader.isNotEmpty()) {
@@ -861,10 +1011,14 @@ namespace slib
 				
 				if (processRangeRequest(context, totalSize, rangeHeader, start, len)) {
 
-					Ref<AsyncFile> file = AsyncFile::openForRead(path, m_threadPool);
 					if (file.isNotNull()) {
-						file->seek(start);
-						context->copyFrom(file.get(), len);
+						context->copyFromFile(file, start, len);
+						return sl_true;
+					}
+					Ref<AsyncStream> stream = AsyncFile::openStream(path, FileMode::Read, context->getAsyncIoLoop(), m_threadPool);
+					if (stream.isNotNull()) {
+						stream->seek(start);
+						context->copyFrom(stream.get(), len);
 						return sl_true;
 					}
 					
@@ -873,9 +1027,16 @@ namespace slib
 				}
 				
 			} else {
-				if (totalSize > 100000) {
-					context->copyFromFile(path, m_threadPool);
+				if (file.isNotNull()) {
+					context->copyFromFile(file, 0, totalSize);
 					return sl_true;
+				}
+				if (totalSize > 100000) {
+					Ref<AsyncStream> stream = AsyncFile::openStream(path, FileMode::Read, context->getAsyncIoLoop(), m_threadPool);
+					if (stream.isNotNull()) {
+						context->copyFrom(stream.get(), totalSize);
+						return sl_true;
+					}
 				} else {
 					Memory mem = File::readAllBytes(path);
 					if (mem.isNotEmpty()) {
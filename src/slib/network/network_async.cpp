@@ -346,6 +346,7 @@ namespace slib
 		
 		flagAutoStart = sl_true;
 		flagLogError = sl_true;
+		flagReusePort = sl_false;
 	}
 
 	AsyncTcpServerParam::~AsyncTcpServerParam()
@@ -391,6 +392,14 @@ namespace slib
 			 */
 			socket->setOption_ReuseAddress(sl_true);
 #endif
+			if (param.flagReusePort) {
+				if (!(socket->setOption_ReusePort(sl_true))) {
+					if (param.flagLogError) {
+						LogError(TAG, "AsyncTcpServer failed to set SO_REUSEPORT: %s", socket->getLastErrorMessage());
+					}
+					return sl_null;
+				}
+			}
 
 			if (!(socket->bind(param.bindAddress))) {
 				if (param.flagLogError) {
@@ -64,6 +64,11 @@ namespace slib
 			m_socket.setNull();
 		}
 		
+		sl_bool isSupportingSendFile() override
+		{
+			return Socket::isSupportingSendFile();
+		}
+		
 		void processRead(sl_bool flagError)
 		{
 			Ref<Socket> socket = m_socket;
@@ -127,7 +132,12 @@ namespace slib
 					}
 				}
 				sl_uint32 size = request->size - m_sizeWritten;
-				sl_int32 n = socket->send((char*)(request->data) + m_sizeWritten, size);
+				sl_int32 n;
+				if (request->file.isNotNull()) {
+					n = socket->sendFile(request->file->getHandle(), request->fileOffset + m_sizeWritten, size);
+				} else {
+					n = socket->send((char*)(request->data) + m_sizeWritten, size);
+				}
 				if (n > 0) {
 					m_sizeWritten += n;
 					if (m_sizeWritten >= request->size) {
@@ -23,6 +23,7 @@
 #	include <unistd.h>
 #	include <sys/socket.h>
 #	if defined(SLIB_PLATFORM_IS_LINUX)
+#		include <sys/sendfile.h>
 #		include <linux/tcp.h>
 #		include <linux/if.h>
 #		include <linux/if_packet.h>
@@ -30,6 +31,9 @@
 #	else
 #		include <netinet/tcp.h>
 #	endif
+#	if defined(SLIB_PLATFORM_IS_APPLE)
+#		include <sys/uio.h>
+#	endif
 #	include <netinet/in.h>
 #	include <signal.h>
 #	include <errno.h>
@@ -530,6 +534,67 @@ namespace slib
 		}
 	}
 
+	sl_int32 Socket::sendFile(sl_file file, sl_uint64 offset, sl_uint32 size)
+	{
+		if (isOpened()) {
+			if (size == 0) {
+				return 0;
+			}
+			if (m_type != SocketType::Tcp && m_type != SocketType::TcpIPv6) {
+				_setError(SocketError::SendIsNotSupported);
+				return -1;
+			}
+#if defined(SLIB_PLATFORM_IS_LINUX)
+			off_t off = (off_t)offset;
+			sl_int32 ret = (sl_int32)(::sendfile((SOCKET)(m_socket), (int)file, &off, size));
+			if (ret >= 0) {
+				if (ret == 0) {
+					// end of file was reached before `size` bytes
+					ret = -1;
+				}
+				return ret;
+			} else {
+				if (_checkError() == SocketError::WouldBlock) {
+					return 0;
+				} else {
+					return -1;
+				}
+			}
+#elif defined(SLIB_PLATFORM_IS_APPLE)
+			off_t len = (off_t)size;
+			int iRet = ::sendfile((int)file, (SOCKET)(m_socket), (off_t)offset, &len, sl_null, 0);
+			if (iRet == 0) {
+				if (len == 0) {
+					return -1;
+				}
+				return (sl_int32)len;
+			} else {
+				if (_checkError() == SocketError::WouldBlock) {
+					// partial transfer is reported through `len` together with EAGAIN
+					return (sl_int32)len;
+				} else {
+					return -1;
+				}
+			}
+#else
+			_setError(SocketError::SendFileIsNotSupported);
+			return -1;
+#endif
+		} else {
+			_setClosedError();
+		}
+		return -1;
+	}
+
+	sl_bool Socket::isSupportingSendFile()
+	{
+#if defined(SLIB_PLATFORM_IS_LINUX) || defined(SLIB_PLATFORM_IS_APPLE)
+		return sl_true;
+#else
+		return sl_false;
+#endif
+	}
+
 	sl_int32 Socket::receive(void* buf, sl_uint32 size)
 	{
 		if (isOpened()) {
@@ -1313,6 +1378,8 @@ namespace slib
 				return "SendPacket to invalid address";
 			case SocketError::ReceivePacketIsNotSupported:
 				return "ReceivePacket is not supported";
+			case SocketError::SendFileIsNotSupported:
+				return "SendFile is not supported";
 			default:
 				break;
 		}
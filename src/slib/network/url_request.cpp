@@ -583,11 +583,28 @@ namespace slib
 		return m_flagError;
 	}
 	
+	String UrlRequest::getLastErrorMessage()
+	{
+		return m_lastErrorMessage;
+	}
+	
 	sl_bool UrlRequest::isClosed()
 	{
 		return m_flagClosed;
 	}
 	
+	sl_uint32 _g_url_request_max_connections_per_host = 0;
+	
+	sl_uint32 UrlRequest::getMaximumConnectionsPerHost()
+	{
+		return _g_url_request_max_connections_per_host;
+	}
+	
+	void UrlRequest::setMaximumConnectionsPerHost(sl_uint32 n)
+	{
+		_g_url_request_max_connections_per_host = n;
+	}
+	
 	void UrlRequest::_sendSync()
 	{
 		Ref<Event> ev = Event::create();
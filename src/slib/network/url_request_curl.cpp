@@ -1,36 +1,200 @@
 #include "slib/core/definition.h"
 
-#if defined(SLIB_PLATFORM_IS_TIZEN)
+#if defined(SLIB_PLATFORM_IS_TIZEN) || (defined(SLIB_PLATFORM_IS_LINUX) && defined(SLIB_PLATFORM_IS_DESKTOP))
 
 #include "slib/network/url_request.h"
 
 #include "slib/core/file.h"
 #include "slib/core/log.h"
+#include "slib/core/async.h"
+#include "slib/core/hash_map.h"
+#include "slib/core/queue.h"
+#include "slib/core/safe_static.h"
 
 #include <curl/curl.h>
-#include <net_connection.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/timerfd.h>
+
+#if defined(SLIB_PLATFORM_IS_TIZEN)
+#include <net_connection.h>
+#endif
+
+/*
+	All the requests are multiplexed on one curl_multi handle, which is driven by a dedicated AsyncIoLoop:
+	libcurl tells the sockets to watch (CURLMOPT_SOCKETFUNCTION) and the next timeout (CURLMOPT_TIMERFUNCTION, on a timerfd).
+	The multi handle owns the connection cache and the DNS cache, so the connections are kept alive and reused among the requests.
+
+	The loop is edge-triggered, so a socket is polled again after libcurl has handled it, and the sockets stay attached
+	while libcurl keeps them (also idle ones in the connection cache). They are detached and closed in the loop
+	when libcurl closes them (CURLOPT_CLOSESOCKETFUNCTION), so that a reused descriptor number can not be confused.
+*/
+
+// easy handles kept for the next requests
+#define _PRIV_URL_REQUEST_CURL_MAX_FREE_HANDLES 256
+// idle connections kept by the multi handle
+#define _PRIV_URL_REQUEST_CURL_MAX_CONNECTS 256
+// sockets handled in a loop step without waiting for the events
+#define _PRIV_URL_REQUEST_CURL_MAX_CHECKS 256
 
 namespace slib
 {
 
+	class UrlRequest_Impl;
+	class UrlRequest_CurlEngine;
+
+	class UrlRequest_CurlSocket : public AsyncIoInstance
+	{
+	public:
+		UrlRequest_CurlEngine* m_engine;
+		// CURL_POLL_IN, CURL_POLL_OUT or both. zero when libcurl does not watch the socket
+		int m_what;
+		sl_bool m_flagCloseSocket;
+
+	public:
+		UrlRequest_CurlSocket(UrlRequest_CurlEngine* engine, curl_socket_t s)
+		{
+			m_engine = engine;
+			m_what = 0;
+			m_flagCloseSocket = sl_false;
+			setHandle((sl_file)s);
+		}
+
+	public:
+		void close() override
+		{
+			if (m_flagCloseSocket) {
+				::close((int)(getHandle()));
+			}
+			setHandle(SLIB_FILE_INVALID_HANDLE);
+		}
+
+		void onOrder() override
+		{
+		}
+
+		void onEvent(EventDesc* pev) override;
+
+	};
+
+	class UrlRequest_CurlTimer : public AsyncIoInstance
+	{
+	public:
+		UrlRequest_CurlEngine* m_engine;
+
+	public:
+		UrlRequest_CurlTimer(UrlRequest_CurlEngine* engine, int fd)
+		{
+			m_engine = engine;
+			setHandle((sl_file)fd);
+		}
+
+	public:
+		void close() override
+		{
+			::close((int)(getHandle()));
+			setHandle(SLIB_FILE_INVALID_HANDLE);
+		}
+
+		void onOrder() override
+		{
+		}
+
+		void onEvent(EventDesc* pev) override;
+
+	};
+
+	class UrlRequest_CurlEngine
+	{
+	public:
+		Ref<AsyncIoLoop> m_loop;
+		CURLM* m_multi;
+		Ref<UrlRequest_CurlTimer> m_timer;
+		sl_uint32 m_nMaxConnectionsPerHost;
+
+		// below members are accessed only in the loop
+		CHashMap< curl_socket_t, Ref<UrlRequest_CurlSocket> > m_sockets;
+		Queue<curl_socket_t> m_socketsToCheck;
+		CHashMap< CURL*, Ref<UrlRequest_Impl> > m_requests;
+		CList<CURL*> m_freeHandles;
+
+#if defined(SLIB_PLATFORM_IS_TIZEN)
+		connection_h m_connection;
+		AtomicString m_proxy;
+#endif
+
+	public:
+		UrlRequest_CurlEngine();
+
+		~UrlRequest_CurlEngine();
+
+	public:
+		sl_bool isValid()
+		{
+			return m_multi != sl_null && m_loop.isNotNull();
+		}
+
+		// called on any thread
+		sl_bool addRequest(UrlRequest_Impl* request);
+
+		void cancelRequest(UrlRequest_Impl* request);
+
+	public:
+		void _start(const Ref<UrlRequest_Impl>& request);
+
+		void _stop(const Ref<UrlRequest_Impl>& request);
+
+		void _action(curl_socket_t s, int flags);
+
+		void _processChecks();
+
+		void _processDone();
+
+		void _finish(CURL* curl, const Ref<UrlRequest_Impl>& request, CURLcode err);
+
+		CURL* _getHandle();
+
+		void _releaseHandle(CURL* curl);
+
+		void _onSocketEvent(UrlRequest_CurlSocket* socket, sl_bool flagIn, sl_bool flagOut, sl_bool flagError);
+
+		void _onTimer();
+
+		static int callbackSocket(CURL* easy, curl_socket_t s, int what, void* userp, void* socketp);
+
+		static int callbackTimer(CURLM* multi, long timeout_ms, void* userp);
+
+		static int callbackCloseSocket(void* clientp, curl_socket_t s);
+
+#if defined(SLIB_PLATFORM_IS_TIZEN)
+		static void callbackProxyChanged(const char *ipv4_address, const char *ipv6_address, void *user_data);
+#endif
+
+	};
+
+	SLIB_SAFE_STATIC_GETTER(UrlRequest_CurlEngine, _priv_UrlRequest_getCurlEngine)
+
 	class UrlRequest_Impl : public UrlRequest
 	{
 	public:
 		CURL* m_curl;
-		sl_bool m_flagClosed;
+		curl_slist* m_curlHeaders;
 		sl_bool m_flagProcessResponse;
 
 	public:
 		UrlRequest_Impl()
 		{
 			m_curl = sl_null;
-			m_flagClosed = sl_false;
+			m_curlHeaders = sl_null;
 			m_flagProcessResponse = sl_false;
 		}
 
 		~UrlRequest_Impl()
 		{
+			if (m_curlHeaders) {
+				::curl_slist_free_all(m_curlHeaders);
+			}
 		}
 
 	public:
@@ -45,52 +209,37 @@ namespace slib
 
 		void _cancel() override
 		{
-			m_flagClosed = sl_true;
+			UrlRequest_CurlEngine* engine = _priv_UrlRequest_getCurlEngine();
+			if (engine) {
+				engine->cancelRequest(this);
+			}
 		}
 
-		void _sendSync() override
+		void _sendAsync() override
 		{
-			connection_h connection;
-			if (::connection_create(&connection) != CONNECTION_ERROR_NONE) {
-				onError();
-				return;
-			}
-
-			CURL* curl = ::curl_easy_init();
-			if (!curl) {
-				::connection_destroy(connection);
-				onError();
-				return;
+			UrlRequest_CurlEngine* engine = _priv_UrlRequest_getCurlEngine();
+			if (engine && engine->isValid()) {
+				if (engine->addRequest(this)) {
+					return;
+				}
 			}
+			onError();
+		}
 
+		// called in the loop of the engine
+		void _setup(CURL* curl)
+		{
 			m_curl = curl;
 
-			char* proxy_address;
-			sl_bool flagSetProxy = sl_false;
-			int conn_err = ::connection_get_proxy(connection, CONNECTION_ADDRESS_FAMILY_IPV4, &proxy_address);
-			if (conn_err == CONNECTION_ERROR_NONE && proxy_address) {
-				if (proxy_address[0]) {
-					::curl_easy_setopt(curl, CURLOPT_PROXY, proxy_address);
-					flagSetProxy = sl_true;
-				}
-				::free(proxy_address);
-			}
-			if (!flagSetProxy) {
-				conn_err = ::connection_get_proxy(connection, CONNECTION_ADDRESS_FAMILY_IPV6, &proxy_address);
-				if (conn_err == CONNECTION_ERROR_NONE && proxy_address) {
-					if (proxy_address[0]) {
-						::curl_easy_setopt(curl, CURLOPT_PROXY, proxy_address);
-					}
-					::free(proxy_address);
-				}
-			}
-			::connection_set_proxy_address_changed_cb(connection, UrlRequest_Impl::callbackProxyChanged, (void*)this);
-
 			String url = m_url;
 			::curl_easy_setopt(curl, CURLOPT_URL, url.getData());
 
 			::curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
 			::curl_easy_setopt(curl, CURLOPT_MAXREDIRS, 10L);
+			::curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+			::curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+			// waits for a connection which can be multiplexed (HTTP/2), rather than opening a new one
+			::curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
 
 			// Set http method
 			switch(m_method) {
@@ -98,13 +247,13 @@ namespace slib
 				::curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
 				break;
 			case HttpMethod::HEAD:
-				::curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "HEAD");
+				::curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
 				break;
 			case HttpMethod::POST:
 				::curl_easy_setopt(curl, CURLOPT_POST, 1L);
 				break;
 			case HttpMethod::PUT:
-				::curl_easy_setopt(curl, CURLOPT_PUT, 1L);
+				::curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
 				break;
 			case HttpMethod::DELETE:
 				::curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE");
@@ -141,17 +290,18 @@ namespace slib
 			}
 			if (headerChunk) {
 				::curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headerChunk);
+				m_curlHeaders = headerChunk;
 			}
 
 			// post data
-			Memory requestBody = m_requestBody;
 			if (m_method == HttpMethod::POST) {
-				::curl_easy_setopt(curl, CURLOPT_POSTFIELDS, requestBody.getData());
-				::curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, requestBody.getSize());
+				::curl_easy_setopt(curl, CURLOPT_POSTFIELDS, m_requestBody.getData());
+				::curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)(m_requestBody.getSize()));
 			} else {
-				if (requestBody.isNotEmpty()) {
+				if (m_requestBody.isNotEmpty()) {
 					::curl_easy_setopt(curl, CURLOPT_READFUNCTION, UrlRequest_Impl::callbackRead);
 					::curl_easy_setopt(curl, CURLOPT_READDATA, (void*)this);
+					::curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, (curl_off_t)(m_requestBody.getSize()));
 				}
 			}
 
@@ -162,28 +312,31 @@ namespace slib
 			// received data
 			::curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, UrlRequest_Impl::callbackWrite);
 			::curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void*)this);
+		}
 
-			/* getting data */
-			CURLcode err = ::curl_easy_perform(curl);
-
-			processResponse();
-
+		// called in the loop of the engine, after the handle is removed from the multi handle
+		void _finish(CURLcode err)
+		{
 			if (err == CURLE_OK) {
+				processResponse();
 				onComplete();
 			} else {
 				String strError = ::curl_easy_strerror(err);
-				LogError("UrlRequest", "Error: %s", strError);
+				if (!m_flagClosed) {
+					LogError("UrlRequest", "Error: %s", strError);
+				}
 				m_lastErrorMessage = strError;
 				onError();
 			}
-
-			if (headerChunk) {
-				::curl_slist_free_all(headerChunk);
+			// canceled requests are not completed by above calls
+			if (m_eventSync.isNotNull()) {
+				m_eventSync->set();
 			}
-
-			::curl_easy_cleanup(curl);
-			::connection_destroy(connection);
-
+			if (m_curlHeaders) {
+				::curl_slist_free_all(m_curlHeaders);
+				m_curlHeaders = sl_null;
+			}
+			m_curl = sl_null;
 		}
 
 		void processResponse()
@@ -211,15 +364,15 @@ namespace slib
 		sl_size onRead(void* data, sl_size size)
 		{
 			if (m_flagClosed) {
-				return 0;
+				return CURL_READFUNC_ABORT;
 			}
 			Memory body = m_requestBody;
 			sl_size total = body.getSize();
 			if (m_sizeBodySent + size > total) {
-				size = total - m_sizeBodySent;
+				size = (sl_size)(total - m_sizeBodySent);
 			}
 			if (size > 0) {
-				body.read(m_sizeBodySent, size, data);
+				body.read((sl_size)m_sizeBodySent, size, data);
 				m_sizeBodySent += size;
 				onUploadBody(size);
 			}
@@ -319,25 +472,384 @@ namespace slib
 			return 0;
 		}
 
-		void onProxyChanged(const char *ipv4_address, const char *ipv6_address)
-		{
-			if (m_flagClosed) {
+	};
+
+
+	void UrlRequest_CurlSocket::onEvent(EventDesc* pev)
+	{
+		m_engine->_onSocketEvent(this, pev->flagIn, pev->flagOut, pev->flagError);
+	}
+
+	void UrlRequest_CurlTimer::onEvent(EventDesc* pev)
+	{
+		sl_uint64 n;
+		while (::read((int)(getHandle()), &n, sizeof(n)) == sizeof(n)) {
+		}
+		m_engine->_onTimer();
+	}
+
+
+	UrlRequest_CurlEngine::UrlRequest_CurlEngine()
+	{
+		m_multi = sl_null;
+		m_nMaxConnectionsPerHost = 0;
+#if defined(SLIB_PLATFORM_IS_TIZEN)
+		m_connection = sl_null;
+#endif
+
+		::curl_global_init(CURL_GLOBAL_ALL);
+
+		CURLM* multi = ::curl_multi_init();
+		if (!multi) {
+			return;
+		}
+		Ref<AsyncIoLoop> loop = AsyncIoLoop::create();
+		if (loop.isNotNull()) {
+			int fdTimer = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+			if (fdTimer >= 0) {
+				Ref<UrlRequest_CurlTimer> timer = new UrlRequest_CurlTimer(this, fdTimer);
+				if (timer.isNotNull()) {
+					if (loop->attachInstance(timer.get(), AsyncIoMode::In)) {
+						::curl_multi_setopt(multi, CURLMOPT_SOCKETFUNCTION, callbackSocket);
+						::curl_multi_setopt(multi, CURLMOPT_SOCKETDATA, (void*)this);
+						::curl_multi_setopt(multi, CURLMOPT_TIMERFUNCTION, callbackTimer);
+						::curl_multi_setopt(multi, CURLMOPT_TIMERDATA, (void*)this);
+						::curl_multi_setopt(multi, CURLMOPT_PIPELINING, (long)CURLPIPE_MULTIPLEX);
+						::curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, (long)_PRIV_URL_REQUEST_CURL_MAX_CONNECTS);
+						m_multi = multi;
+						m_loop = loop;
+						m_timer = timer;
+#if defined(SLIB_PLATFORM_IS_TIZEN)
+						if (::connection_create(&m_connection) == CONNECTION_ERROR_NONE) {
+							char* proxy_address = sl_null;
+							int conn_err = ::connection_get_proxy(m_connection, CONNECTION_ADDRESS_FAMILY_IPV4, &proxy_address);
+							if (!(conn_err == CONNECTION_ERROR_NONE && proxy_address && proxy_address[0])) {
+								if (proxy_address) {
+									::free(proxy_address);
+									proxy_address = sl_null;
+								}
+								conn_err = ::connection_get_proxy(m_connection, CONNECTION_ADDRESS_FAMILY_IPV6, &proxy_address);
+							}
+							if (conn_err == CONNECTION_ERROR_NONE && proxy_address) {
+								m_proxy = proxy_address;
+								::free(proxy_address);
+							}
+							::connection_set_proxy_address_changed_cb(m_connection, callbackProxyChanged, (void*)this);
+						} else {
+							m_connection = sl_null;
+						}
+#endif
+						return;
+					}
+				} else {
+					::close(fdTimer);
+				}
+			}
+			loop->release();
+		}
+		::curl_multi_cleanup(multi);
+	}
+
+	UrlRequest_CurlEngine::~UrlRequest_CurlEngine()
+	{
+		if (m_loop.isNotNull()) {
+			m_loop->release();
+			// the loop is stopped: the sockets closed by libcurl below are closed directly
+			m_loop.setNull();
+		}
+		if (m_multi) {
+			for (auto& pair : m_requests) {
+				::curl_multi_remove_handle(m_multi, pair.key);
+				::curl_easy_cleanup(pair.key);
+			}
+			m_requests.removeAll_NoLock();
+			CURL* curl;
+			while (m_freeHandles.popBack_NoLock(&curl)) {
+				::curl_easy_cleanup(curl);
+			}
+			// closes the cached connections
+			::curl_multi_cleanup(m_multi);
+			m_multi = sl_null;
+		}
+		for (auto& pair : m_sockets) {
+			pair.value->m_flagCloseSocket = sl_true;
+			pair.value->close();
+		}
+		m_sockets.removeAll_NoLock();
+		if (m_timer.isNotNull()) {
+			m_timer->close();
+			m_timer.setNull();
+		}
+#if defined(SLIB_PLATFORM_IS_TIZEN)
+		if (m_connection) {
+			::connection_destroy(m_connection);
+		}
+#endif
+	}
+
+	sl_bool UrlRequest_CurlEngine::addRequest(UrlRequest_Impl* request)
+	{
+		return m_loop->addTask(SLIB_BIND_CLASS(void(), UrlRequest_CurlEngine, _start, this, Ref<UrlRequest_Impl>(request)));
+	}
+
+	void UrlRequest_CurlEngine::cancelRequest(UrlRequest_Impl* request)
+	{
+		if (m_loop.isNotNull()) {
+			m_loop->addTask(SLIB_BIND_CLASS(void(), UrlRequest_CurlEngine, _stop, this, Ref<UrlRequest_Impl>(request)));
+		}
+	}
+
+	void UrlRequest_CurlEngine::_start(const Ref<UrlRequest_Impl>& request)
+	{
+		if (request->isClosed()) {
+			return;
+		}
+		sl_uint32 nMaxConnectionsPerHost = UrlRequest::getMaximumConnectionsPerHost();
+		if (m_nMaxConnectionsPerHost != nMaxConnectionsPerHost) {
+			// requests over the limit are queued by libcurl
+			::curl_multi_setopt(m_multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long)nMaxConnectionsPerHost);
+			m_nMaxConnectionsPerHost = nMaxConnectionsPerHost;
+		}
+		CURL* curl = _getHandle();
+		if (!curl) {
+			request->_finish(CURLE_FAILED_INIT);
+			return;
+		}
+		request->_setup(curl);
+		::curl_easy_setopt(curl, CURLOPT_CLOSESOCKETFUNCTION, callbackCloseSocket);
+		::curl_easy_setopt(curl, CURLOPT_CLOSESOCKETDATA, (void*)this);
+#if defined(SLIB_PLATFORM_IS_TIZEN)
+		String proxy = m_proxy;
+		if (proxy.isNotEmpty()) {
+			::curl_easy_setopt(curl, CURLOPT_PROXY, proxy.getData());
+		}
+#endif
+		m_requests.put_NoLock(curl, request);
+		if (::curl_multi_add_handle(m_multi, curl) != CURLM_OK) {
+			m_requests.remove_NoLock(curl);
+			request->_finish(CURLE_FAILED_INIT);
+			_releaseHandle(curl);
+		}
+	}
+
+	void UrlRequest_CurlEngine::_stop(const Ref<UrlRequest_Impl>& request)
+	{
+		CURL* curl = request->m_curl;
+		if (curl && m_requests.remove_NoLock(curl)) {
+			::curl_multi_remove_handle(m_multi, curl);
+			request->_finish(CURLE_ABORTED_BY_CALLBACK);
+			_releaseHandle(curl);
+		}
+	}
+
+	void UrlRequest_CurlEngine::_action(curl_socket_t s, int flags)
+	{
+		int nRunning = 0;
+		::curl_multi_socket_action(m_multi, s, flags, &nRunning);
+		_processDone();
+		_processChecks();
+	}
+
+	void UrlRequest_CurlEngine::_processChecks()
+	{
+		sl_uint32 nChecks = 0;
+		curl_socket_t s;
+		while (m_socketsToCheck.pop_NoLock(&s)) {
+			Ref<UrlRequest_CurlSocket> socket;
+			if (!(m_sockets.get_NoLock(s, &socket))) {
+				continue;
+			}
+			int what = socket->m_what;
+			if (!what) {
+				continue;
+			}
+			if (nChecks >= _PRIV_URL_REQUEST_CURL_MAX_CHECKS) {
+				// continues in the next step, letting the other events in
+				m_socketsToCheck.push_NoLock(s);
+				m_loop->addTask(SLIB_BIND_CLASS(void(), UrlRequest_CurlEngine, _processChecks, this));
 				return;
 			}
-			if (ipv4_address) {
-				::curl_easy_setopt(m_curl, CURLOPT_PROXY, ipv4_address);
-			} else if (ipv6_address) {
-				::curl_easy_setopt(m_curl, CURLOPT_PROXY, ipv6_address);
+			nChecks++;
+			pollfd pfd;
+			pfd.fd = (int)s;
+			pfd.events = 0;
+			if (what & CURL_POLL_IN) {
+				pfd.events |= POLLIN;
+			}
+			if (what & CURL_POLL_OUT) {
+				pfd.events |= POLLOUT;
+			}
+			pfd.revents = 0;
+			if (::poll(&pfd, 1, 0) > 0) {
+				int flags = 0;
+				if (pfd.revents & (POLLIN | POLLHUP)) {
+					flags |= CURL_CSELECT_IN;
+				}
+				if (pfd.revents & POLLOUT) {
+					flags |= CURL_CSELECT_OUT;
+				}
+				if (pfd.revents & POLLERR) {
+					flags |= CURL_CSELECT_ERR;
+				}
+				if (flags) {
+					int nRunning = 0;
+					::curl_multi_socket_action(m_multi, s, flags, &nRunning);
+					_processDone();
+					// may still have the data which libcurl did not read
+					m_socketsToCheck.push_NoLock(s);
+				}
 			}
 		}
+	}
 
-		static void callbackProxyChanged(const char *ipv4_address, const char *ipv6_address, void *user_data)
-		{
-			UrlRequest_Impl* req = (UrlRequest_Impl*)user_data;
-			req->onProxyChanged(ipv4_address, ipv6_address);
+	void UrlRequest_CurlEngine::_processDone()
+	{
+		CURLMsg* msg;
+		int nLeft = 0;
+		while ((msg = ::curl_multi_info_read(m_multi, &nLeft))) {
+			if (msg->msg == CURLMSG_DONE) {
+				CURL* curl = msg->easy_handle;
+				CURLcode err = msg->data.result;
+				Ref<UrlRequest_Impl> request;
+				m_requests.get_NoLock(curl, &request);
+				m_requests.remove_NoLock(curl);
+				::curl_multi_remove_handle(m_multi, curl);
+				if (request.isNotNull()) {
+					request->_finish(err);
+				}
+				_releaseHandle(curl);
+			}
 		}
+	}
 
-	};
+	CURL* UrlRequest_CurlEngine::_getHandle()
+	{
+		CURL* curl;
+		if (m_freeHandles.popBack_NoLock(&curl)) {
+			return curl;
+		}
+		return ::curl_easy_init();
+	}
+
+	void UrlRequest_CurlEngine::_releaseHandle(CURL* curl)
+	{
+		::curl_easy_reset(curl);
+		if (m_freeHandles.getCount() < _PRIV_URL_REQUEST_CURL_MAX_FREE_HANDLES) {
+			if (m_freeHandles.add_NoLock(curl)) {
+				return;
+			}
+		}
+		::curl_easy_cleanup(curl);
+	}
+
+	void UrlRequest_CurlEngine::_onSocketEvent(UrlRequest_CurlSocket* socket, sl_bool flagIn, sl_bool flagOut, sl_bool flagError)
+	{
+		curl_socket_t s = (curl_socket_t)(socket->getHandle());
+		int what = socket->m_what;
+		if (!what) {
+			// checked again when libcurl watches the socket
+			return;
+		}
+		int flags = 0;
+		if (flagIn) {
+			flags |= CURL_CSELECT_IN;
+		}
+		if (flagOut) {
+			flags |= CURL_CSELECT_OUT;
+		}
+		if (flagError) {
+			flags |= CURL_CSELECT_ERR;
+		}
+		m_socketsToCheck.push_NoLock(s);
+		_action(s, flags);
+	}
+
+	void UrlRequest_CurlEngine::_onTimer()
+	{
+		_action(CURL_SOCKET_TIMEOUT, 0);
+	}
+
+	int UrlRequest_CurlEngine::callbackSocket(CURL* easy, curl_socket_t s, int what, void* userp, void* socketp)
+	{
+		UrlRequest_CurlEngine* engine = (UrlRequest_CurlEngine*)userp;
+		Ref<UrlRequest_CurlSocket> socket;
+		engine->m_sockets.get_NoLock(s, &socket);
+		if (what == CURL_POLL_REMOVE) {
+			// keeps attached until libcurl closes the socket
+			if (socket.isNotNull()) {
+				socket->m_what = 0;
+			}
+			return 0;
+		}
+		if (socket.isNull()) {
+			socket = new UrlRequest_CurlSocket(engine, s);
+			if (socket.isNull()) {
+				return -1;
+			}
+			if (!(engine->m_loop->attachInstance(socket.get(), AsyncIoMode::InOut))) {
+				return -1;
+			}
+			engine->m_sockets.put_NoLock(s, socket);
+		}
+		socket->m_what = what;
+		// the edge may have passed while the socket was not watched
+		engine->m_socketsToCheck.push_NoLock(s);
+		return 0;
+	}
+
+	int UrlRequest_CurlEngine::callbackTimer(CURLM* multi, long timeout_ms, void* userp)
+	{
+		UrlRequest_CurlEngine* engine = (UrlRequest_CurlEngine*)userp;
+		itimerspec its;
+		its.it_interval.tv_sec = 0;
+		its.it_interval.tv_nsec = 0;
+		if (timeout_ms < 0) {
+			its.it_value.tv_sec = 0;
+			its.it_value.tv_nsec = 0;
+		} else if (timeout_ms == 0) {
+			// zero disarms the timer
+			its.it_value.tv_sec = 0;
+			its.it_value.tv_nsec = 1;
+		} else {
+			its.it_value.tv_sec = timeout_ms / 1000;
+			its.it_value.tv_nsec = (timeout_ms % 1000) * 1000000;
+		}
+		::timerfd_settime((int)(engine->m_timer->getHandle()), 0, &its, sl_null);
+		return 0;
+	}
+
+	int UrlRequest_CurlEngine::callbackCloseSocket(void* clientp, curl_socket_t s)
+	{
+		UrlRequest_CurlEngine* engine = (UrlRequest_CurlEngine*)clientp;
+		Ref<UrlRequest_CurlSocket> socket;
+		if (engine->m_sockets.get_NoLock(s, &socket)) {
+			engine->m_sockets.remove_NoLock(s);
+			socket->m_what = 0;
+			socket->m_flagCloseSocket = sl_true;
+			if (engine->m_loop.isNotNull()) {
+				// closed after detached from the loop
+				engine->m_loop->closeInstance(socket.get());
+			} else {
+				socket->close();
+			}
+			return 0;
+		}
+		return ::close((int)s);
+	}
+
+#if defined(SLIB_PLATFORM_IS_TIZEN)
+	void UrlRequest_CurlEngine::callbackProxyChanged(const char *ipv4_address, const char *ipv6_address, void *user_data)
+	{
+		UrlRequest_CurlEngine* engine = (UrlRequest_CurlEngine*)user_data;
+		if (ipv4_address) {
+			engine->m_proxy = ipv4_address;
+		} else if (ipv6_address) {
+			engine->m_proxy = ipv6_address;
+		} else {
+			engine->m_proxy.setNull();
+		}
+	}
+#endif
 
 
 	Ref<UrlRequest> UrlRequest::_create(const UrlRequestParam& param, const String& url)
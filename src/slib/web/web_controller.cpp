@@ -19,6 +19,11 @@ namespace slib
 	SLIB_DEFINE_OBJECT(WebController, Object)
 
 	WebController::WebController()
+	{
+		m_flagRoutesChanged = sl_false;
+	}
+
+	WebController::~WebController()
 	{
 	}
 
@@ -30,19 +35,59 @@ namespace slib
 	void WebController::registerHandler(HttpMethod method, const String& path, const WebHandler& handler)
 	{
 		if (handler.isNotNull()) {
-			String sig = _getHandlerSignature(method, path);
-			m_handlers.put(sig, handler);
+			_Route route;
+			route.method = method;
+			route.path = path;
+			route.handler = handler;
+			ObjectLocker lock(this);
+			m_routes.add_NoLock(route);
+			m_flagRoutesChanged = sl_true;
+		}
+	}
+
+	void WebController::buildRouter()
+	{
+		ObjectLocker lock(this);
+		if (!m_flagRoutesChanged && m_router.isNotNull()) {
+			return;
+		}
+		Ref<WebRouter> router = WebRouter::create();
+		if (router.isNull()) {
+			return;
+		}
+		_Route* routes = m_routes.getData();
+		sl_size n = m_routes.getCount();
+		for (sl_size i = 0; i < n; i++) {
+			router->add(routes[i].method, routes[i].path, routes[i].handler);
 		}
+		m_router = router;
+		m_flagRoutesChanged = sl_false;
+	}
+
+	Ref<WebRouter> WebController::getRouter()
+	{
+		buildRouter();
+		return m_router;
 	}
 
 	sl_bool WebController::onHttpRequest(const Ref<HttpServiceContext>& context)
 	{
+		Ref<WebRouter> router = m_router;
+		if (m_flagRoutesChanged || router.isNull()) {
+			buildRouter();
+			router = m_router;
+			if (router.isNull()) {
+				return sl_false;
+			}
+		}
 		HttpMethod method = context->getMethod();
 		String path = context->getPath();
-		String sig = _getHandlerSignature(method, path);
-		WebHandler handler;
-		if (m_handlers.get(sig, &handler)) {
-			Variant ret(handler(context, method, path));
+		WebRouteMatch match;
+		if (router->match(method, path, &match)) {
+			for (sl_uint32 i = 0; i < match.countParams; i++) {
+				context->setParameter(*(match.params[i].name), match.getParameter(path, i));
+			}
+			Variant ret((*(match.handler))(context, method, path));
 			if (ret.isNotNull()) {
 				if (ret.isObject()) {
 					Ref<Referable> obj = ret.getObject();
@@ -52,7 +97,7 @@ namespace slib
 						} else if (CMemory* mem = CastInstance<CMemory>(obj.get())) {
 							context->write(mem);
 						} else {
-							context->write(ret.toJsonString());
+							context->writeJson(ret);
 						}
 					}
 				} else {
@@ -64,11 +109,6 @@ namespace slib
 		return sl_false;
 	}
 
-	String WebController::_getHandlerSignature(HttpMethod method, const String& path)
-	{
-		return HttpMethods::toString(method) + " " + path;
-	}
-
 
 	WebModule::WebModule(const String& path)
 	: m_path(path)
@@ -0,0 +1,377 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "slib/web/router.h"
+
+#include "slib/core/log.h"
+
+#define TAG "WebRouter"
+
+#define _PRIV_WEB_ROUTER_METHODS_COUNT ((sl_uint32)(HttpMethod::TRACE) + 1)
+
+namespace slib
+{
+
+	class WebRouterNode
+	{
+	public:
+		// static text of the node, or the name of the parameter
+		String text;
+		// cached from `text`, to avoid dereferencing the string container on lookup
+		const sl_char8* textData;
+		sl_size textLength;
+
+		// static children, sorted by the first character of their text
+		sl_char8* indices;
+		WebRouterNode** children;
+		sl_uint32 countChildren;
+
+		WebRouterNode* param;
+		WebRouterNode* wildcard;
+
+		// allocated only for the nodes ending routes, to keep the nodes small
+		WebHandler* handlers;
+
+	public:
+		WebRouterNode(const String& _text)
+		{
+			setText(_text);
+			indices = sl_null;
+			children = sl_null;
+			countChildren = 0;
+			param = sl_null;
+			wildcard = sl_null;
+			handlers = sl_null;
+		}
+
+		~WebRouterNode()
+		{
+			for (sl_uint32 i = 0; i < countChildren; i++) {
+				delete children[i];
+			}
+			if (children) {
+				delete[] children;
+				delete[] indices;
+			}
+			if (param) {
+				delete param;
+			}
+			if (wildcard) {
+				delete wildcard;
+			}
+			if (handlers) {
+				delete[] handlers;
+			}
+		}
+
+	public:
+		void setText(const String& _text)
+		{
+			text = _text;
+			textData = text.getData();
+			textLength = text.getLength();
+		}
+
+		sl_int32 findChild(sl_char8 ch) const
+		{
+			sl_uint32 n = countChildren;
+			if (n <= 8) {
+				for (sl_uint32 i = 0; i < n; i++) {
+					if (indices[i] == ch) {
+						return i;
+					}
+				}
+				return -1;
+			}
+			sl_uint32 start = 0;
+			sl_uint32 end = n;
+			while (start < end) {
+				sl_uint32 mid = (start + end) >> 1;
+				sl_char8 c = indices[mid];
+				if (c == ch) {
+					return mid;
+				}
+				if ((sl_uint8)c < (sl_uint8)ch) {
+					start = mid + 1;
+				} else {
+					end = mid;
+				}
+			}
+			return -1;
+		}
+
+		void insertChild(WebRouterNode* child)
+		{
+			sl_char8 ch = child->textData[0];
+			sl_uint32 n = countChildren;
+			sl_uint32 pos = 0;
+			while (pos < n && (sl_uint8)(indices[pos]) < (sl_uint8)ch) {
+				pos++;
+			}
+			sl_char8* newIndices = new sl_char8[n + 1];
+			WebRouterNode** newChildren = new WebRouterNode*[n + 1];
+			for (sl_uint32 i = 0; i < pos; i++) {
+				newIndices[i] = indices[i];
+				newChildren[i] = children[i];
+			}
+			newIndices[pos] = ch;
+			newChildren[pos] = child;
+			for (sl_uint32 i = pos; i < n; i++) {
+				newIndices[i + 1] = indices[i];
+				newChildren[i + 1] = children[i];
+			}
+			if (children) {
+				delete[] children;
+				delete[] indices;
+			}
+			indices = newIndices;
+			children = newChildren;
+			countChildren = n + 1;
+		}
+
+		sl_bool match(sl_uint32 method, const sl_char8* path, sl_size pos, sl_size length, WebRouteMatch* _out) const
+		{
+			if (pos == length) {
+				if (handlers && handlers[method].isNotNull()) {
+					_out->handler = handlers + method;
+					return sl_true;
+				}
+			} else {
+				sl_char8 ch = path[pos];
+				if (countChildren) {
+					sl_int32 index = findChild(ch);
+					if (index >= 0) {
+						WebRouterNode* child = children[index];
+						sl_size n = child->textLength;
+						if (n <= length - pos && Base::equalsMemory(child->textData, path + pos, n)) {
+							if (child->match(method, path, pos + n, length, _out)) {
+								return sl_true;
+							}
+						}
+					}
+				}
+				if (param && ch != '/' && _out->countParams < SLIB_WEB_ROUTER_MAX_PARAMS) {
+					sl_size end = pos + 1;
+					while (end < length && path[end] != '/') {
+						end++;
+					}
+					sl_uint32 iParam = _out->countParams;
+					WebRouteParam& p = _out->params[iParam];
+					p.name = &(param->text);
+					p.offset = pos;
+					p.length = end - pos;
+					_out->countParams = iParam + 1;
+					if (param->match(method, path, end, length, _out)) {
+						return sl_true;
+					}
+					_out->countParams = iParam;
+				}
+			}
+			if (wildcard && wildcard->handlers && wildcard->handlers[method].isNotNull() && _out->countParams < SLIB_WEB_ROUTER_MAX_PARAMS) {
+				WebRouteParam& p = _out->params[_out->countParams];
+				p.name = &(wildcard->text);
+				p.offset = pos;
+				p.length = length - pos;
+				_out->countParams++;
+				_out->handler = wildcard->handlers + method;
+				return sl_true;
+			}
+			return sl_false;
+		}
+
+		sl_size getNodesCount() const
+		{
+			sl_size n = 1;
+			for (sl_uint32 i = 0; i < countChildren; i++) {
+				n += children[i]->getNodesCount();
+			}
+			if (param) {
+				n += param->getNodesCount();
+			}
+			if (wildcard) {
+				n += wildcard->getNodesCount();
+			}
+			return n;
+		}
+
+	};
+
+
+	WebRouteMatch::WebRouteMatch()
+	{
+		handler = sl_null;
+		countParams = 0;
+	}
+
+	WebRouteMatch::~WebRouteMatch()
+	{
+	}
+
+	String WebRouteMatch::getParameter(const String& path, sl_uint32 index) const
+	{
+		if (index < countParams) {
+			return path.substring(params[index].offset, params[index].offset + params[index].length);
+		}
+		return sl_null;
+	}
+
+	String WebRouteMatch::getParameter(const String& path, const String& name) const
+	{
+		for (sl_uint32 i = 0; i < countParams; i++) {
+			if (*(params[i].name) == name) {
+				return path.substring(params[i].offset, params[i].offset + params[i].length);
+			}
+		}
+		return sl_null;
+	}
+
+
+	SLIB_DEFINE_OBJECT(WebRouter, Object)
+
+	WebRouter::WebRouter()
+	{
+		m_root = new WebRouterNode(String::null());
+		m_nRoutes = 0;
+		m_nNodes = 1;
+	}
+
+	WebRouter::~WebRouter()
+	{
+		delete m_root;
+	}
+
+	Ref<WebRouter> WebRouter::create()
+	{
+		return new WebRouter;
+	}
+
+	sl_bool WebRouter::add(HttpMethod method, const String& pattern, const WebHandler& handler)
+	{
+		sl_uint32 iMethod = (sl_uint32)method;
+		if (iMethod == 0 || iMethod >= _PRIV_WEB_ROUTER_METHODS_COUNT || handler.isNull()) {
+			return sl_false;
+		}
+		const sl_char8* s = pattern.getData();
+		sl_size len = pattern.getLength();
+		WebRouterNode* node = m_root;
+		sl_size pos = 0;
+		while (pos < len) {
+			sl_char8 ch = s[pos];
+			sl_bool flagSegmentStart = pos == 0 || s[pos - 1] == '/';
+			if (flagSegmentStart && (ch == ':' || ch == '*')) {
+				sl_size end = pos + 1;
+				while (end < len && s[end] != '/') {
+					end++;
+				}
+				String name = String::fromUtf8(s + pos + 1, end - pos - 1);
+				if (ch == '*') {
+					if (end != len) {
+						LogError(TAG, "Wildcard should be the last token: %s", pattern);
+						return sl_false;
+					}
+					if (node->wildcard) {
+						if (node->wildcard->text != name) {
+							LogError(TAG, "Conflicting wildcard name: %s", pattern);
+							return sl_false;
+						}
+					} else {
+						node->wildcard = new WebRouterNode(name);
+						m_nNodes++;
+					}
+					node = node->wildcard;
+				} else {
+					if (name.isEmpty()) {
+						LogError(TAG, "Empty parameter name: %s", pattern);
+						return sl_false;
+					}
+					if (node->param) {
+						if (node->param->text != name) {
+							LogError(TAG, "Conflicting parameter name: %s", pattern);
+							return sl_false;
+						}
+					} else {
+						node->param = new WebRouterNode(name);
+						m_nNodes++;
+					}
+					node = node->param;
+				}
+				pos = end;
+				continue;
+			}
+			// static text up to the next named segment or wildcard
+			sl_size end = pos + 1;
+			while (end < len && !(s[end - 1] == '/' && (s[end] == ':' || s[end] == '*'))) {
+				end++;
+			}
+			sl_int32 index = node->findChild(ch);
+			if (index < 0) {
+				WebRouterNode* child = new WebRouterNode(String::fromUtf8(s + pos, end - pos));
+				m_nNodes++;
+				node->insertChild(child);
+				node = child;
+				pos = end;
+				continue;
+			}
+			WebRouterNode* child = node->children[index];
+			const sl_char8* text = child->textData;
+			sl_size lenText = child->textLength;
+			sl_size k = 1;
+			while (k < lenText && pos + k < end && text[k] == s[pos + k]) {
+				k++;
+			}
+			if (k < lenText) {
+				// split the child at the common prefix
+				WebRouterNode* mid = new WebRouterNode(String::fromUtf8(text, k));
+				m_nNodes++;
+				child->setText(String::fromUtf8(text + k, lenText - k));
+				mid->insertChild(child);
+				node->children[index] = mid;
+				child = mid;
+			}
+			node = child;
+			pos += k;
+		}
+		if (!(node->handlers)) {
+			node->handlers = new WebHandler[_PRIV_WEB_ROUTER_METHODS_COUNT];
+		}
+		if (node->handlers[iMethod].isNull()) {
+			m_nRoutes++;
+		}
+		node->handlers[iMethod] = handler;
+		return sl_true;
+	}
+
+	sl_bool WebRouter::match(HttpMethod method, const sl_char8* path, sl_size length, WebRouteMatch* _out) const
+	{
+		sl_uint32 iMethod = (sl_uint32)method;
+		if (iMethod >= _PRIV_WEB_ROUTER_METHODS_COUNT) {
+			return sl_false;
+		}
+		_out->handler = sl_null;
+		_out->countParams = 0;
+		return m_root->match(iMethod, path, 0, length, _out);
+	}
+
+	sl_bool WebRouter::match(HttpMethod method, const String& path, WebRouteMatch* _out) const
+	{
+		return match(method, path.getData(), path.getLength(), _out);
+	}
+
+	sl_size WebRouter::getRoutesCount() const
+	{
+		return m_nRoutes;
+	}
+
+	sl_size WebRouter::getNodesCount() const
+	{
+		return m_nNodes;
+	}
+
+}
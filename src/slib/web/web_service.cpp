@@ -61,6 +61,7 @@ namespace slib
 		if (Service::dispatchStartService()) {
 			m_http = HttpService::create(m_httpParam);
 			if (m_http.isNotNull()) {
+				m_controller->buildRouter();
 				m_http->addProcessor(m_controller);
 				return sl_true;
 			}